@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/BatchLowering.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/Type.hpp>
+#include <llvm-abi/TypeBuilder.hpp>
+
+// Measures lowering a large batch of declarations (e.g. from a C
+// header) with ABI::lowerBatch(), compared with a sequential loop
+// over getFunctionType() and getAttributes():
+//
+// * 'classify' is the parallel part (getLoweringPlans()).
+// * 'lowerBatch' also creates the LLVM types on the main thread.
+//
+// Each measurement uses a new ABI, so they all start with cold
+// caches. The corpus is generated from a fixed seed, so runs are
+// comparable.
+
+static const size_t DefaultSignatures = 100000;
+
+// Small deterministic generator (so results don't depend on the
+// standard library's distributions).
+class Random {
+public:
+	Random(const unsigned seed)
+	: state_(seed) { }
+	
+	size_t next(const size_t limit) {
+		state_ = state_ * 1103515245 + 12345;
+		return (state_ >> 16) % limit;
+	}
+	
+private:
+	unsigned state_;
+	
+};
+
+static llvm_abi::Type
+createType(const llvm_abi::TypeBuilder& typeBuilder, Random& random,
+           const unsigned depth) {
+	using namespace llvm_abi;
+	static const Type scalarTypes[] = {
+		CharTy, ShortTy, IntTy, LongTy, LongLongTy, FloatTy, DoubleTy,
+		LongDoubleTy, PointerTy
+	};
+	const size_t numScalarTypes = sizeof(scalarTypes) / sizeof(scalarTypes[0]);
+	
+	const auto choice = depth < 2 ? random.next(8) : 0;
+	switch (choice) {
+		case 0:
+		case 1:
+		case 2:
+		case 3:
+			return scalarTypes[random.next(numScalarTypes)];
+		case 4:
+		case 5: {
+			llvm::SmallVector<Type, 8> members;
+			const auto numMembers = 1 + random.next(4);
+			for (size_t i = 0; i < numMembers; i++) {
+				members.push_back(createType(typeBuilder, random, depth + 1));
+			}
+			return typeBuilder.getStructTy(members);
+		}
+		case 6:
+			return typeBuilder.getArrayTy(1 + random.next(8),
+			                              createType(typeBuilder, random, depth + 1));
+		default:
+			return typeBuilder.getUnionTy({ createType(typeBuilder, random, depth + 1),
+			                                createType(typeBuilder, random, depth + 1) });
+	}
+}
+
+static std::vector<llvm_abi::FunctionType>
+createCorpus(const llvm_abi::TypeBuilder& typeBuilder, const size_t size) {
+	using namespace llvm_abi;
+	Random random(42);
+	std::vector<FunctionType> functionTypes;
+	functionTypes.reserve(size);
+	for (size_t i = 0; i < size; i++) {
+		const auto returnType = random.next(4) == 0 ? VoidTy :
+		                        createType(typeBuilder, random, 0);
+		std::vector<Type> argumentTypes;
+		const auto numArguments = random.next(7);
+		for (size_t j = 0; j < numArguments; j++) {
+			argumentTypes.push_back(createType(typeBuilder, random, 0));
+		}
+		functionTypes.push_back(FunctionType(CC_CDefault, returnType,
+		                                     argumentTypes));
+	}
+	return functionTypes;
+}
+
+template <typename Fn>
+double measureMilliseconds(Fn fn) {
+	const auto start = std::chrono::steady_clock::now();
+	fn();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Measures the function with a new module and ABI, and a corpus
+// built with that ABI's type builder, so that no layouts or LLVM
+// types are cached from an earlier measurement. Creating the corpus
+// isn't measured.
+template <typename Fn>
+double measureColdMilliseconds(const llvm::Triple& triple,
+                               const size_t numSignatures, Fn fn) {
+	llvm::LLVMContext context;
+	llvm::Module module("BatchLoweringBenchmark", context);
+	const auto abi = llvm_abi::createABI(module, triple);
+	const auto corpus = createCorpus(abi->typeInfo().typeBuilder(),
+	                                 numSignatures);
+	return measureMilliseconds([&] {
+		fn(*abi, corpus);
+	});
+}
+
+int main(int argc, char** argv) {
+	const size_t numSignatures = argc > 1 ? strtoul(argv[1], nullptr, 10) : DefaultSignatures;
+	const unsigned maxThreads = std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+	
+	const llvm::Triple triple("x86_64-unknown-linux-gnu");
+	
+	printf("%zu signatures\n", numSignatures);
+	printf("threads  classify (ms)  lowerBatch (ms)  sequential (ms)\n");
+	
+	double baseClassifyTime = 0.0;
+	
+	for (unsigned numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+		typedef std::vector<llvm_abi::FunctionType> Corpus;
+		
+		const auto classifyTime = measureColdMilliseconds(triple, numSignatures,
+			[&](const llvm_abi::ABI& abi, const Corpus& corpus) {
+				(void) llvm_abi::getLoweringPlans(abi, corpus, numThreads);
+			});
+		
+		const auto lowerBatchTime = measureColdMilliseconds(triple, numSignatures,
+			[&](const llvm_abi::ABI& abi, const Corpus& corpus) {
+				(void) abi.lowerBatch(corpus, numThreads);
+			});
+		
+		const auto sequentialTime = measureColdMilliseconds(triple, numSignatures,
+			[&](const llvm_abi::ABI& abi, const Corpus& corpus) {
+				for (const auto& functionType: corpus) {
+					(void) abi.getFunctionType(functionType);
+					(void) abi.getAttributes(functionType,
+					                         functionType.argumentTypes());
+				}
+			});
+		
+		if (numThreads == 1) {
+			baseClassifyTime = classifyTime;
+		}
+		
+		printf("%7u  %8.1f (%.2fx)  %15.1f  %15.1f\n", numThreads,
+		       classifyTime, baseClassifyTime / classifyTime,
+		       lowerBatchTime, sequentialTime);
+	}
+	
+	return 0;
+}
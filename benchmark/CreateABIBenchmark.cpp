@@ -0,0 +1,64 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <llvm-abi/ABI.hpp>
+
+#include <llvm-abi/x86/CPUFeatures.hpp>
+#include <llvm-abi/x86/CPUKind.hpp>
+
+// Measures the start-up cost of an ABI: createABI() and the CPU
+// feature lookup it performs.
+
+static const size_t DefaultIterations = 100000;
+
+template <typename Fn>
+double measureNanoseconds(const size_t iterations, Fn fn) {
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < iterations; i++) {
+		fn();
+	}
+	const auto end = std::chrono::steady_clock::now();
+	const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+	return double(duration.count()) / double(iterations);
+}
+
+int main(int argc, char** argv) {
+	const size_t iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : DefaultIterations;
+	
+	llvm::LLVMContext context;
+	llvm::Module module("CreateABIBenchmark", context);
+	
+	const char* const triples[] = { "x86_64-unknown-linux-gnu", "i386-unknown-linux-gnu" };
+	const char* const cpuNames[] = { "", "x86-64", "sandybridge", "skylake", "native" };
+	
+	for (const auto tripleName: triples) {
+		const llvm::Triple triple(tripleName);
+		for (const auto cpuName: cpuNames) {
+			const auto createTime = measureNanoseconds(iterations, [&] {
+				const auto abi = llvm_abi::createABI(module, triple, cpuName);
+				(void) abi;
+			});
+			printf("createABI(%s, \"%s\"): %.1f ns\n", tripleName, cpuName,
+			       createTime);
+		}
+	}
+	
+	const llvm::Triple triple(triples[0]);
+	volatile bool hasAVX = false;
+	const auto featuresTime = measureNanoseconds(iterations, [&] {
+		const auto cpuKind = llvm_abi::x86::getCPUKind(triple, "skylake");
+		const auto features = llvm_abi::x86::getCPUFeatures(triple, cpuKind);
+		const auto copy = features;
+		hasAVX = copy.hasAVX();
+	});
+	printf("getCPUFeatures(\"skylake\") + copy + hasAVX(): %.1f ns\n",
+	       featuresTime);
+	
+	return 0;
+}
@@ -0,0 +1,280 @@
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/TargetRegistry.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Target/TargetOptions.h>
+
+#if LLVMABI_LLVM_VERSION >= 307
+#include <llvm/IR/LegacyPassManager.h>
+#endif
+
+#include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/Builder.hpp>
+#include <llvm-abi/DataSize.hpp>
+#include <llvm-abi/LLVMUtils.hpp>
+
+// Compares the code for small copies (e.g. of arguments passed in
+// memory) emitted inline by createMemCpy() with the code for the
+// memcpy intrinsic, which is what was emitted for every copy before.
+//
+// For each copy size it reports, with the backend's -O0 and -O2
+// settings:
+//
+// * The number of machine instructions in a function that only does
+//   the copy (including the return).
+// * Whether the copy became a call to the library memcpy ('+call').
+//
+// The IR column is the number of loads and stores createMemCpy()
+// emits, which shows the copy unit it picked (the widest vector the
+// target has, halved for the tail).
+//
+// By default createMemCpy() inlines copies of up to 64 bytes (see
+// Builder::getInlineCopyThreshold()); this shows the code either way
+// for sizes on both sides of that. Machine instruction counts need
+// LLVM 3.7 or later.
+
+class CopyBuilder: public llvm_abi::Builder {
+public:
+	CopyBuilder(llvm::BasicBlock* const basicBlock,
+	            const size_t inlineCopyThreshold)
+	: builder_(basicBlock),
+	inlineCopyThreshold_(inlineCopyThreshold) { }
+	
+	llvm_abi::IRBuilder& getEntryBuilder() {
+		return builder_;
+	}
+	
+	llvm_abi::IRBuilder& getBuilder() {
+		return builder_;
+	}
+	
+	size_t getInlineCopyThreshold() {
+		return inlineCopyThreshold_;
+	}
+	
+private:
+	llvm_abi::IRBuilder builder_;
+	size_t inlineCopyThreshold_;
+	
+};
+
+struct CopyCounts {
+	CopyCounts()
+	: numIRMemoryOps(0), numMachineInstructions(0),
+	hasCall(false) { }
+	
+	size_t numIRMemoryOps;
+	size_t numMachineInstructions;
+	bool hasCall;
+};
+
+// Creates 'void copy(i8* dest, i8* source)'.
+static llvm::Function* createCopyFunction(const llvm_abi::ABI& abi,
+                                          llvm::Module& module,
+                                          const size_t size,
+                                          const size_t align,
+                                          const size_t inlineCopyThreshold) {
+	auto& context = module.getContext();
+	const auto i8PtrType = llvm::Type::getInt8PtrTy(context);
+	llvm::Type* const argumentTypes[] = { i8PtrType, i8PtrType };
+	const auto functionType = llvm::FunctionType::get(llvm::Type::getVoidTy(context),
+	                                                  argumentTypes, false);
+	const auto function = llvm::Function::Create(functionType,
+	                                             llvm::Function::ExternalLinkage,
+	                                             "copy", &module);
+	const auto basicBlock = llvm::BasicBlock::Create(context, "", function);
+	CopyBuilder builder(basicBlock, inlineCopyThreshold);
+	
+	auto argIterator = function->arg_begin();
+	const auto dest = &*argIterator++;
+	const auto source = &*argIterator++;
+	llvm_abi::createMemCpy(abi.typeInfo(), builder, dest, source,
+	                       llvm_abi::DataSize::Bytes(size), align);
+	builder.getBuilder().CreateRetVoid();
+	return function;
+}
+
+static size_t countIRMemoryOps(const llvm::Function& function) {
+	size_t count = 0;
+	for (const auto& basicBlock: function) {
+		for (const auto& instruction: basicBlock) {
+			if (llvm::isa<llvm::LoadInst>(instruction) ||
+			    llvm::isa<llvm::StoreInst>(instruction)) {
+				count++;
+			}
+		}
+	}
+	return count;
+}
+
+#if LLVMABI_LLVM_VERSION >= 307
+static std::string emitAssembly(const llvm::Triple& triple,
+                                const std::string& cpuName,
+                                const llvm::CodeGenOpt::Level optLevel,
+                                llvm::Module& module) {
+	std::string errorString;
+	const auto target = llvm::TargetRegistry::lookupTarget(triple.str(),
+	                                                       errorString);
+	if (target == nullptr) {
+		throw std::runtime_error(errorString);
+	}
+	
+#if LLVMABI_LLVM_VERSION >= 309
+	const llvm::Optional<llvm::Reloc::Model> relocModel;
+#else
+	const auto relocModel = llvm::Reloc::Default;
+#endif
+	
+	llvm::TargetOptions options;
+	std::unique_ptr<llvm::TargetMachine> targetMachine(
+		target->createTargetMachine(triple.str(), cpuName, "", options,
+		                            relocModel, llvm::CodeModel::Default,
+		                            optLevel));
+	
+#if LLVMABI_LLVM_VERSION >= 308
+	module.setDataLayout(targetMachine->createDataLayout());
+#else
+	module.setDataLayout(*(targetMachine->getDataLayout()));
+#endif
+	
+	llvm::SmallString<1024> assembly;
+	llvm::raw_svector_ostream stream(assembly);
+	llvm::legacy::PassManager passManager;
+	if (targetMachine->addPassesToEmitFile(passManager, stream,
+	                                       llvm::TargetMachine::CGFT_AssemblyFile)) {
+		throw std::runtime_error("Target can't emit assembly.");
+	}
+	passManager.run(module);
+	return assembly.str().str();
+}
+
+// Counts instruction lines (skipping labels, directives and
+// comments) and looks for calls to memcpy.
+static void countMachineInstructions(const std::string& assembly,
+                                     CopyCounts& counts) {
+	std::istringstream stream(assembly);
+	std::string line;
+	while (std::getline(stream, line)) {
+		const auto start = line.find_first_not_of(" \t");
+		if (start == 0 || start == std::string::npos) {
+			continue;
+		}
+		if (line[start] == '.' || line[start] == '#') {
+			continue;
+		}
+		counts.numMachineInstructions++;
+		if (line.find("call") != std::string::npos &&
+		    line.find("memcpy") != std::string::npos) {
+			counts.hasCall = true;
+		}
+	}
+}
+#endif
+
+static CopyCounts measureCopy(const llvm::Triple& triple,
+                              const std::string& cpuName,
+                              const bool isOptimised,
+                              const size_t size,
+                              const size_t align,
+                              const size_t inlineCopyThreshold) {
+	llvm::LLVMContext context;
+	llvm::Module module("MemCopyBenchmark", context);
+	module.setTargetTriple(triple.str());
+	const auto abi = llvm_abi::createABI(module, triple, cpuName);
+	const auto function = createCopyFunction(*abi, module, size, align,
+	                                         inlineCopyThreshold);
+	
+	CopyCounts counts;
+	counts.numIRMemoryOps = countIRMemoryOps(*function);
+	
+#if LLVMABI_LLVM_VERSION >= 307
+	const auto optLevel = isOptimised ? llvm::CodeGenOpt::Default :
+	                                    llvm::CodeGenOpt::None;
+	countMachineInstructions(emitAssembly(triple, cpuName, optLevel, module),
+	                         counts);
+#else
+	(void) isOptimised;
+#endif
+	return counts;
+}
+
+static std::string formatCounts(const CopyCounts& counts) {
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%zu%s", counts.numMachineInstructions,
+	         counts.hasCall ? "+call" : "");
+	return buffer;
+}
+
+int main() {
+	llvm::InitializeAllTargetInfos();
+	llvm::InitializeAllTargets();
+	llvm::InitializeAllTargetMCs();
+	llvm::InitializeAllAsmPrinters();
+	
+	struct Target {
+		const char* tripleName;
+		const char* cpuName;
+	};
+	const Target targets[] = {
+		{ "x86_64-unknown-linux-gnu", "x86-64" },
+		{ "x86_64-unknown-linux-gnu", "haswell" },
+		{ "i386-unknown-linux-gnu", "pentium4" }
+	};
+	
+	const size_t sizes[] = { 1, 3, 4, 8, 12, 16, 24, 32, 48, 64, 96, 128, 256 };
+	const size_t aligns[] = { 1, 8 };
+	
+	// Inline every copy, or none of them.
+	const size_t inlineThreshold = SIZE_MAX;
+	const size_t intrinsicThreshold = 0;
+	
+	for (const auto& target: targets) {
+		const llvm::Triple triple(target.tripleName);
+		
+		llvm::LLVMContext context;
+		llvm::Module module("MemCopyBenchmark", context);
+		const auto abi = llvm_abi::createABI(module, triple, target.cpuName);
+		printf("%s (%s): copy unit %zu bytes\n", target.tripleName,
+		       target.cpuName,
+		       size_t(abi->typeInfo().getMaxCopyUnitSize().asBytes()));
+		printf("   size  align  inline IR ops  inline -O0  memcpy -O0  inline -O2  memcpy -O2\n");
+		
+		for (const auto size: sizes) {
+			for (const auto align: aligns) {
+				const auto inlineO0 = measureCopy(triple, target.cpuName, false,
+				                                  size, align, inlineThreshold);
+				const auto memcpyO0 = measureCopy(triple, target.cpuName, false,
+				                                  size, align, intrinsicThreshold);
+				const auto inlineO2 = measureCopy(triple, target.cpuName, true,
+				                                  size, align, inlineThreshold);
+				const auto memcpyO2 = measureCopy(triple, target.cpuName, true,
+				                                  size, align, intrinsicThreshold);
+				printf("%7zu  %5zu  %13zu  %10s  %10s  %10s  %10s\n", size, align,
+				       inlineO0.numIRMemoryOps,
+				       formatCounts(inlineO0).c_str(),
+				       formatCounts(memcpyO0).c_str(),
+				       formatCounts(inlineO2).c_str(),
+				       formatCounts(memcpyO2).c_str());
+			}
+		}
+		printf("\n");
+	}
+	
+	return 0;
+}
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABIRegistry.hpp>
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/Type.hpp>
+#include <llvm-abi/TypeBuilder.hpp>
+
+// Measures how lowering scales with the number of threads:
+//
+// * Layout queries against one ABI shared by every thread.
+// * Signature lowering where each thread has its own LLVM context and
+//   module, with ABIs created by a shared ABIRegistry.
+//
+// Configure with -DCMAKE_CXX_FLAGS=-fsanitize=thread to check the
+// caches for data races.
+
+static const size_t DefaultIterations = 200000;
+
+static std::vector<llvm_abi::Type>
+createTypes(const llvm_abi::TypeBuilder& typeBuilder) {
+	using namespace llvm_abi;
+	std::vector<Type> types;
+	const auto pairType = typeBuilder.getStructTy({ IntTy, DoubleTy });
+	const auto vecType = typeBuilder.getStructTy({ FloatTy, FloatTy, FloatTy });
+	types.push_back(pairType);
+	types.push_back(vecType);
+	types.push_back(typeBuilder.getStructTy({ pairType, vecType, CharTy }));
+	types.push_back(typeBuilder.getArrayTy(4, pairType));
+	types.push_back(typeBuilder.getUnionTy({ LongTy, DoubleTy }));
+	types.push_back(typeBuilder.getStructTy({ typeBuilder.getArrayTy(8, CharTy), PointerTy }));
+	return types;
+}
+
+static std::vector<llvm_abi::FunctionType>
+createFunctionTypes(const std::vector<llvm_abi::Type>& types) {
+	using namespace llvm_abi;
+	std::vector<FunctionType> functionTypes;
+	for (size_t i = 0; i < types.size(); i++) {
+		const auto& other = types[(i + 1) % types.size()];
+		functionTypes.push_back(FunctionType(CC_CDefault, types[i],
+		                                     { other, IntTy, types[i] }));
+		functionTypes.push_back(FunctionType(CC_CDefault, VoidTy,
+		                                     { DoubleTy, other, PointerTy }));
+	}
+	return functionTypes;
+}
+
+template <typename Fn>
+double measureNanoseconds(const size_t numThreads, const size_t iterations,
+                          Fn fn) {
+	std::vector<std::thread> threads;
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < numThreads; i++) {
+		threads.push_back(std::thread([&] { fn(iterations); }));
+	}
+	for (auto& thread: threads) {
+		thread.join();
+	}
+	const auto end = std::chrono::steady_clock::now();
+	const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+	
+	// Wall time per operation per thread; constant under perfect
+	// scaling.
+	return double(duration.count()) / double(iterations);
+}
+
+int main(int argc, char** argv) {
+	const size_t iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : DefaultIterations;
+	const size_t maxThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	
+	const llvm::Triple triple("x86_64-unknown-linux-gnu");
+	llvm_abi::ABIRegistry registry;
+	
+	llvm::LLVMContext sharedContext;
+	llvm::Module sharedModule("ParallelLoweringBenchmark", sharedContext);
+	const auto sharedABI = registry.createABI(sharedModule, triple);
+	const auto sharedTypes = createTypes(sharedABI->typeInfo().typeBuilder());
+	
+	printf("threads  layout (ns/op)  lowering (ns/op)\n");
+	
+	double baseLayoutTime = 0.0;
+	double baseLoweringTime = 0.0;
+	
+	for (size_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+		const auto layoutTime = measureNanoseconds(numThreads, iterations, [&](const size_t count) {
+			const auto& typeInfo = sharedABI->typeInfo();
+			volatile uint64_t total = 0;
+			for (size_t i = 0; i < count; i++) {
+				const auto& type = sharedTypes[i % sharedTypes.size()];
+				total += typeInfo.getTypeAllocSize(type).asBytes() +
+				         typeInfo.getTypeRequiredAlign(type).asBytes();
+			}
+		});
+		
+		const auto loweringTime = measureNanoseconds(numThreads, iterations / 10, [&](const size_t count) {
+			llvm::LLVMContext context;
+			llvm::Module module("ParallelLoweringBenchmark", context);
+			const auto abi = registry.createABI(module, triple);
+			const auto functionTypes = createFunctionTypes(createTypes(abi->typeInfo().typeBuilder()));
+			for (size_t i = 0; i < count; i++) {
+				(void) abi->getFunctionType(functionTypes[i % functionTypes.size()]);
+			}
+		});
+		
+		if (numThreads == 1) {
+			baseLayoutTime = layoutTime;
+			baseLoweringTime = loweringTime;
+		}
+		
+		printf("%7zu  %8.1f (%.2fx)  %8.1f (%.2fx)\n", numThreads,
+		       layoutTime, numThreads * baseLayoutTime / layoutTime,
+		       loweringTime, numThreads * baseLoweringTime / loweringTime);
+	}
+	
+	return 0;
+}
@@ -6,12 +6,15 @@
 #include <vector>
 
 #include <llvm/ADT/Triple.h>
+#include <llvm/IR/Function.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 
+#include <llvm-abi/BatchLowering.hpp>
 #include <llvm-abi/CallingConvention.hpp>
+#include <llvm-abi/LoweringPlan.hpp>
 #include <llvm-abi/TypedValue.hpp>
 
 namespace llvm_abi {
@@ -31,6 +34,14 @@ namespace llvm_abi {
 	 * to the ABI, such as type sizes/alignments. It also
 	 * provides methods to encode/decode values when making
 	 * function calls.
+	 * 
+	 * ABIs are thread-safe: type information queries (and the
+	 * caches behind them) can be used from multiple threads.
+	 * However methods that create LLVM types or IR use the
+	 * module's LLVMContext, which LLVM only allows one thread to
+	 * use at a time; for parallel code generation create an ABI
+	 * per thread's module with an ABIRegistry, so that they share
+	 * layout caches.
 	 */
 	class ABI {
 	public:
@@ -71,6 +82,42 @@ namespace llvm_abi {
 		 */
 		virtual llvm::FunctionType* getFunctionType(const FunctionType& functionType) const = 0;
 		
+		/**
+		 * \brief Get the lowering plan for a function type.
+		 * 
+		 * The plan describes the ABI-encoding of the function in
+		 * terms of ABI types (see LoweringPlan), and can be used to
+		 * emit signatures with the LoweringPlan overloads of
+		 * getFunctionType() and getFunctionAttributes().
+		 * 
+		 * \param functionType The ABI function type.
+		 * \param argumentTypes The argument types, including any
+		 *                      varargs arguments (which are
+		 *                      promoted).
+		 * \return The lowering plan.
+		 */
+		virtual LoweringPlan getLoweringPlan(const FunctionType& functionType,
+		                                     llvm::ArrayRef<Type> argumentTypes) const = 0;
+		
+		/**
+		 * \brief Lower a batch of function types.
+		 * 
+		 * Equivalent to calling getFunctionType() and getAttributes()
+		 * for each function type, but classifies the function types
+		 * in parallel and then creates the LLVM types on the calling
+		 * thread (see llvm_abi::lowerBatch()). This is useful for
+		 * declaring large numbers of functions (e.g. from a header).
+		 * 
+		 * \param functionTypes The ABI function types.
+		 * \param numThreads The number of threads, or 0 to use one
+		 *                   per hardware thread.
+		 * \return The lowered function types, in the same order as
+		 *         the function types.
+		 */
+		virtual std::vector<LoweredFunctionType>
+		lowerBatch(llvm::ArrayRef<FunctionType> functionTypes,
+		           unsigned numThreads = 0) const = 0;
+		
 		/**
 		 * \brief Get function attributes for ABI.
 		 * 
@@ -80,6 +127,10 @@ namespace llvm_abi {
 		 * (e.g. 'readnone' disabled when arguments are passed via
 		 * indirect pointers).
 		 * 
+		 * The returned attributes describe hidden pointer arguments
+		 * (e.g. their size and alignment) and so should be applied to
+		 * call sites as well as the function declaration.
+		 * 
 		 * \param functionType The ABI function type.
 		 * \param existingAttributes The existing function attributes.
 		 * \return The set of attributes for the ABI.
@@ -111,6 +162,120 @@ namespace llvm_abi {
 		                                std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
 		                                llvm::ArrayRef<TypedValue> arguments) const = 0;
 		
+		/**
+		 * \brief Query whether a call can be a guaranteed tail call.
+		 * 
+		 * Determines whether the lowered signatures of the caller and
+		 * callee are compatible, such that a call emitted by
+		 * createTailCall() can be marked 'musttail'.
+		 * 
+		 * \param callerType The ABI function type of the calling function.
+		 * \param calleeType The ABI function type of the called function.
+		 * \return Whether the call can be marked 'musttail'.
+		 */
+		virtual bool isTailCallCompatible(const FunctionType& callerType,
+		                                  const FunctionType& calleeType) const = 0;
+		
+		/**
+		 * \brief Create a tail call.
+		 * 
+		 * Emits a function call that can be marked 'musttail' by the
+		 * call builder (see isTailCallCompatible()). Unlike createCall(),
+		 * the struct-return pointer of the calling function is forwarded
+		 * to the callee and the ABI-encoded return value is returned
+		 * without decoding; the caller should return it immediately.
+		 * 
+		 * Arguments passed indirectly (e.g. 'byval') must be given as
+		 * pointers to their value (e.g. the caller's own incoming
+		 * arguments) so that they are forwarded rather than copied
+		 * into temporaries in the caller's frame; other arguments are
+		 * given by value.
+		 * 
+		 * \param builder The builder for emitting instructions.
+		 * \param functionType The ABI function type.
+		 * \param callBuilder A function that should emit the necessary call.
+		 * \param arguments The function arguments, with indirect
+		 *                  arguments given as pointers.
+		 * \param returnValuePtr The struct-return pointer of the calling
+		 *                       function, if any (see
+		 *                       FunctionEncoder::returnValuePointer()).
+		 * \return The ABI-encoded function return value.
+		 */
+		virtual llvm::Value* createTailCall(Builder& builder,
+		                                    const FunctionType& functionType,
+		                                    std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+		                                    llvm::ArrayRef<TypedValue> arguments,
+		                                    llvm::Value* returnValuePtr) const = 0;
+		
+		/**
+		 * \brief Create a function call with in-memory aggregates.
+		 * 
+		 * Like createCall(), but aggregate values are given and
+		 * returned as pointers rather than as first-class aggregate
+		 * values, which avoids the loads and stores of large aggregate
+		 * values that LLVM handles poorly.
+		 * 
+		 * Arguments may be given either as a value or as a pointer to
+		 * the value; arguments passed in memory (e.g. 'byval') are then
+		 * forwarded without a copy where possible. An aggregate return
+		 * value is returned as a pointer, which is the return value
+		 * pointer if one is given and the value is returned in memory.
+		 * 
+		 * \param builder The builder for emitting instructions.
+		 * \param functionType The ABI function type.
+		 * \param callBuilder A function that should emit the necessary call.
+		 * \param arguments The function arguments, each either a value
+		 *                  or a pointer to the value.
+		 * \param returnValuePtr Pointer to storage for the return value,
+		 *                       or NULL.
+		 * \return The decoded function return value, or a pointer to it
+		 *         for aggregates.
+		 */
+		virtual llvm::Value* createInMemoryCall(Builder& builder,
+		                                        const FunctionType& functionType,
+		                                        std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+		                                        llvm::ArrayRef<TypedValue> arguments,
+		                                        llvm::Value* returnValuePtr) const = 0;
+		
+		/**
+		 * \brief Create a function call that constructs arguments in place.
+		 * 
+		 * Like createInMemoryCall(), but non-trivial record arguments
+		 * (see Type::isNonTrivialRecord()) aren't copied by the ABI.
+		 * Instead the argument constructor is given the address of
+		 * the memory the callee receives each of them in and should
+		 * construct the argument there (e.g. by calling its copy
+		 * constructor); the call is emitted once all of them have
+		 * been constructed.
+		 * 
+		 * For arguments in an inalloca block (32-bit MSVC) the address
+		 * is the argument's slot in the block, which is only allocated
+		 * after the stack pointer is saved for the call; otherwise it
+		 * is a temporary in the caller's frame.
+		 * 
+		 * \param builder The builder for emitting instructions.
+		 * \param functionType The ABI function type.
+		 * \param argumentConstructor A function that should construct
+		 *                            the argument with the given index
+		 *                            at the given address (a pointer to
+		 *                            the argument's LLVM type).
+		 * \param callBuilder A function that should emit the necessary call.
+		 * \param arguments The function arguments, as for
+		 *                  createInMemoryCall(); the values of
+		 *                  non-trivial record arguments are ignored and
+		 *                  may be NULL.
+		 * \param returnValuePtr Pointer to storage for the return value,
+		 *                       or NULL.
+		 * \return The decoded function return value, or a pointer to it
+		 *         for aggregates.
+		 */
+		virtual llvm::Value* createConstructingCall(Builder& builder,
+		                                            const FunctionType& functionType,
+		                                            std::function<void (size_t, llvm::Value*)> argumentConstructor,
+		                                            std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+		                                            llvm::ArrayRef<TypedValue> arguments,
+		                                            llvm::Value* returnValuePtr) const = 0;
+		
 		/**
 		 * \brief Create function encoder.
 		 * 
@@ -127,18 +292,50 @@ namespace llvm_abi {
 		                                                               const FunctionType& functionType,
 		                                                               llvm::ArrayRef<llvm::Value*> arguments) const = 0;
 		
+		/**
+		 * \brief Get the ABI for a set of target features.
+		 * 
+		 * Returns an ABI that lowers according to this ABI's CPU
+		 * features with an LLVM target features string (e.g.
+		 * "+avx2,-avx512f") applied, so that functions with 'target'
+		 * attributes can use different rules (e.g. for passing
+		 * vectors in YMM registers). ABIs are cached per resulting
+		 * feature set and live as long as this ABI.
+		 * 
+		 * \param targetFeatures The LLVM target features.
+		 * \return The ABI for the target features.
+		 */
+		virtual const ABI& withTargetFeatures(const std::string& targetFeatures) const = 0;
+		
 	};
 	
 	/**
 	 * \brief Create an ABI for the specified target triple.
 	 * 
+	 * Use an ABIRegistry instead to share target data (such as
+	 * computed type layouts) between the ABIs of many modules.
+	 * 
 	 * \param module The LLVM module.
 	 * \param targetTriple the LLVM target triple.
+	 * \param cpu The CPU name, or "native" for the host CPU.
 	 * \return The ABI for the target.
 	 */
 	std::unique_ptr<ABI> createABI(llvm::Module& module,
 	                               const llvm::Triple& targetTriple,
 	                               const std::string& cpu = "");
+	
+	/**
+	 * \brief Get the ABI for a function.
+	 * 
+	 * Applies the function's "target-features" attribute, if any,
+	 * via ABI::withTargetFeatures().
+	 * 
+	 * \param abi The module's ABI.
+	 * \param function The function.
+	 * \return The ABI for the function.
+	 */
+	const ABI& getFunctionABI(const ABI& abi,
+	                          const llvm::Function& function);
 
 }
 
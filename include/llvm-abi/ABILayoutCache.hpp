@@ -0,0 +1,57 @@
+#ifndef LLVMABI_ABILAYOUTCACHE_HPP
+#define LLVMABI_ABILAYOUTCACHE_HPP
+
+#include <llvm-abi/ConcurrentCache.hpp>
+#include <llvm-abi/DataSize.hpp>
+#include <llvm-abi/Type.hpp>
+
+namespace llvm_abi {
+	
+	/**
+	 * \brief ABI Layout Cache
+	 * 
+	 * Memoises the sizes and alignments of aggregate types, which
+	 * would otherwise be recomputed from their members on every
+	 * query. Layout doesn't depend on an LLVM context, so the cache
+	 * can be shared by the ABIs of modules with the same target, and
+	 * it can be queried from multiple threads.
+	 */
+	class ABILayoutCache {
+	public:
+		enum Query {
+			RawSize,
+			AllocSize,
+			StoreSize,
+			RequiredAlign,
+			PreferredAlign,
+			NumQueries
+		};
+		
+		ABILayoutCache() { }
+		
+		/**
+		 * \brief Get a cached layout value.
+		 * 
+		 * \param query The layout query.
+		 * \param type The ABI type.
+		 * \param computeFn Computes the value if it isn't cached.
+		 * \return The layout value.
+		 */
+		template <typename ComputeFn>
+		DataSize get(const Query query, const Type type,
+		             ComputeFn computeFn) {
+			return caches_[query].get(type, computeFn);
+		}
+		
+	private:
+		// Non-copyable.
+		ABILayoutCache(const ABILayoutCache&) = delete;
+		ABILayoutCache& operator=(const ABILayoutCache&) = delete;
+		
+		ConcurrentCache<Type, DataSize> caches_[NumQueries];
+		
+	};
+	
+}
+
+#endif
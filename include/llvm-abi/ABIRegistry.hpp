@@ -0,0 +1,84 @@
+#ifndef LLVMABI_ABIREGISTRY_HPP
+#define LLVMABI_ABIREGISTRY_HPP
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/Module.h>
+
+#include <llvm-abi/ABI.hpp>
+#include <llvm-abi/LoweringPlan.hpp>
+
+namespace llvm_abi {
+	
+	/**
+	 * \brief ABI Registry
+	 * 
+	 * Creates ABIs like createABI(), but resolves each (triple, CPU)
+	 * pair only once and gives every ABI created for it the same
+	 * ABITargetData, so type layouts computed while lowering one
+	 * module are reused for the next. Types created with one of these
+	 * ABIs' type builders can be used with any of the others.
+	 * 
+	 * LLVM types are still cached per ABI, since they belong to the
+	 * module's LLVM context.
+	 * 
+	 * The registry and the target data it shares can be used from
+	 * multiple threads, so each code generation thread can create
+	 * ABIs for its own module (and LLVM context).
+	 */
+	class ABIRegistry {
+	public:
+		ABIRegistry();
+		~ABIRegistry();
+		
+		/**
+		 * \brief Create an ABI for the specified target triple.
+		 * 
+		 * \param module The LLVM module.
+		 * \param targetTriple the LLVM target triple.
+		 * \param cpu The CPU name, or "native" for the host CPU.
+		 * \return The ABI for the target.
+		 */
+		std::unique_ptr<ABI> createABI(llvm::Module& module,
+		                               const llvm::Triple& targetTriple,
+		                               const std::string& cpu = "");
+		
+		/**
+		 * \brief Create a lowering planner for the specified target triple.
+		 * 
+		 * The planner shares target data with the ABIs created for
+		 * the same triple and CPU, so lowering plans use the same
+		 * ABI types and layout caches.
+		 * 
+		 * \param targetTriple the LLVM target triple.
+		 * \param cpu The CPU name, or "native" for the host CPU.
+		 * \return The lowering planner for the target.
+		 */
+		std::unique_ptr<LoweringPlanner>
+		createLoweringPlanner(const llvm::Triple& targetTriple,
+		                      const std::string& cpu = "");
+		
+	private:
+		// Non-copyable.
+		ABIRegistry(const ABIRegistry&) = delete;
+		ABIRegistry& operator=(const ABIRegistry&) = delete;
+		
+		struct Target;
+		
+		const Target& getTarget(const llvm::Triple& targetTriple,
+		                        const std::string& cpuName);
+		
+		std::mutex mutex_;
+		std::map<std::pair<std::string, std::string>,
+		         std::unique_ptr<Target>> targets_;
+		
+	};
+	
+}
+
+#endif
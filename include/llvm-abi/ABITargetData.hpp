@@ -0,0 +1,43 @@
+#ifndef LLVMABI_ABITARGETDATA_HPP
+#define LLVMABI_ABITARGETDATA_HPP
+
+#include <llvm-abi/ABILayoutCache.hpp>
+#include <llvm-abi/LoweringPlanCache.hpp>
+#include <llvm-abi/TypeBuilder.hpp>
+
+namespace llvm_abi {
+	
+	/**
+	 * \brief ABI Target Data
+	 * 
+	 * The parts of an ABI that don't depend on an LLVM context: the
+	 * type builder that uniques ABI types, and the layout and
+	 * lowering plan caches keyed by those types. ABIs hold this by shared pointer so that an
+	 * ABIRegistry can hand the same (warm) instance to the ABIs of
+	 * every module for a target.
+	 */
+	class ABITargetData {
+	public:
+		ABITargetData();
+		~ABITargetData();
+		
+		const TypeBuilder& typeBuilder() const;
+		
+		ABILayoutCache& layoutCache() const;
+		
+		LoweringPlanCache& loweringPlanCache() const;
+		
+	private:
+		// Non-copyable.
+		ABITargetData(const ABITargetData&) = delete;
+		ABITargetData& operator=(const ABITargetData&) = delete;
+		
+		TypeBuilder typeBuilder_;
+		mutable ABILayoutCache layoutCache_;
+		mutable LoweringPlanCache loweringPlanCache_;
+		
+	};
+	
+}
+
+#endif
@@ -90,6 +90,17 @@ namespace llvm_abi {
 		 */
 		virtual bool isLegalVectorType(Type type) const = 0;
 		
+		/**
+		 * \brief Get the widest load/store to use for inline copies.
+		 * 
+		 * Small memory copies are emitted as a sequence of integer
+		 * (or, above 8 bytes, i64 vector) loads and stores, using
+		 * accesses up to this size.
+		 * 
+		 * \return The widest access size, which is a power of two.
+		 */
+		virtual DataSize getMaxCopyUnitSize() const = 0;
+		
 		/**
 		 * \brief Queries whether ABI is big-endian.
 		 * 
@@ -0,0 +1,89 @@
+#ifndef LLVMABI_BATCHLOWERING_HPP
+#define LLVMABI_BATCHLOWERING_HPP
+
+#include <vector>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/IR/Attributes.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/LLVMContext.h>
+
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/LoweringPlan.hpp>
+
+namespace llvm_abi {
+	
+	class ABI;
+	
+	/**
+	 * \brief Lowered Function Type
+	 * 
+	 * The ABI-encoded LLVM function type and attributes for a
+	 * function type, as returned by ABI::getFunctionType() and
+	 * ABI::getAttributes().
+	 */
+	struct LoweredFunctionType {
+		llvm::FunctionType* functionType;
+		llvm::AttributeSet attributes;
+	};
+	
+	/**
+	 * \brief Compute lowering plans in parallel.
+	 * 
+	 * Splits the function types into chunks that are classified on
+	 * a pool of threads, where idle threads steal chunks from busy
+	 * ones. Each plan uses its own classifier, and type layouts
+	 * are shared through the target data's caches.
+	 * 
+	 * \param abi The ABI.
+	 * \param functionTypes The ABI function types.
+	 * \param numThreads The number of threads, or 0 to use one per
+	 *                   hardware thread.
+	 * \return The lowering plans, in the same order as the function
+	 *         types.
+	 */
+	std::vector<LoweringPlan>
+	getLoweringPlans(const ABI& abi,
+	                 llvm::ArrayRef<FunctionType> functionTypes,
+	                 unsigned numThreads = 0);
+	
+	/**
+	 * \brief Compute lowering plans in parallel.
+	 * 
+	 * \param planner The lowering planner.
+	 * \param functionTypes The ABI function types.
+	 * \param numThreads The number of threads, or 0 to use one per
+	 *                   hardware thread.
+	 * \return The lowering plans, in the same order as the function
+	 *         types.
+	 */
+	std::vector<LoweringPlan>
+	getLoweringPlans(const LoweringPlanner& planner,
+	                 llvm::ArrayRef<FunctionType> functionTypes,
+	                 unsigned numThreads = 0);
+	
+	/**
+	 * \brief Lower a batch of function types.
+	 * 
+	 * Classifies the function types in parallel (see
+	 * getLoweringPlans()) and then creates their LLVM types and
+	 * attributes on the calling thread, since the LLVM context can
+	 * only be used by one thread.
+	 * 
+	 * \param context The LLVM context.
+	 * \param abi The ABI.
+	 * \param functionTypes The ABI function types.
+	 * \param numThreads The number of threads, or 0 to use one per
+	 *                   hardware thread.
+	 * \return The lowered function types, in the same order as the
+	 *         function types.
+	 */
+	std::vector<LoweredFunctionType>
+	lowerBatch(llvm::LLVMContext& context,
+	           const ABI& abi,
+	           llvm::ArrayRef<FunctionType> functionTypes,
+	           unsigned numThreads = 0);
+	
+}
+
+#endif
@@ -34,6 +34,19 @@ namespace llvm_abi {
 		 */
 		virtual IRBuilder& getBuilder() = 0;
 		
+		/**
+		 * \brief Get the largest memory copy to emit inline.
+		 * 
+		 * Copies up to this size are emitted as straight-line loads
+		 * and stores; larger copies use the memcpy intrinsic, which
+		 * typically remains a library call when not optimised.
+		 * 
+		 * \return Maximum inline copy size, in bytes.
+		 */
+		virtual size_t getInlineCopyThreshold() {
+			return 64;
+		}
+		
 	protected:
 		// Prevent destructor calls via this class.
 		~Builder() { }
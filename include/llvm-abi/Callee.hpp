@@ -26,9 +26,52 @@ namespace llvm_abi {
 		
 		/**
 		 * \brief Decode function arguments.
+		 * 
+		 * If in-memory decoding is requested, aggregate arguments
+		 * (structs, unions and arrays) are returned as a pointer to
+		 * their value (e.g. the incoming 'byval' pointer or an alloca)
+		 * rather than as a first-class aggregate value; other arguments
+		 * are unaffected.
+		 * 
+		 * \param encodedArguments The ABI-encoded function arguments.
+		 * \param inMemory Whether to decode aggregates to pointers.
+		 * \return The decoded function arguments.
 		 */
 		llvm::SmallVector<llvm::Value*, 8>
-		decodeArguments(llvm::ArrayRef<llvm::Value*> encodedArguments);
+		decodeArguments(llvm::ArrayRef<llvm::Value*> encodedArguments,
+		                bool inMemory = false);
+		
+		/**
+		 * \brief Decode a single function argument.
+		 * 
+		 * Emits the code to decode the argument at the builder's
+		 * current position (see decodeArguments()).
+		 */
+		llvm::Value*
+		decodeArgument(size_t argIndex,
+		               llvm::ArrayRef<llvm::Value*> encodedArguments,
+		               bool inMemory = false);
+		
+		/**
+		 * \brief Query whether an argument's value is decoded via
+		 *        memory.
+		 * 
+		 * If so, decoding the argument's value is the same as
+		 * loading it (see loadArgument()) from the pointer decoded
+		 * with in-memory decoding.
+		 */
+		bool isDecodedViaMemory(size_t argIndex) const;
+		
+		/**
+		 * \brief Load an aggregate argument from memory.
+		 * 
+		 * Emits the load that produces an aggregate argument's value
+		 * from the pointer returned by decodeArgument() with in-memory
+		 * decoding, so an argument needed both ways is only decoded
+		 * once.
+		 */
+		llvm::Value*
+		loadArgument(size_t argIndex, llvm::Value* pointer);
 		
 		/**
 		 * \brief Encode return value.
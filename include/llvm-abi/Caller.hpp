@@ -1,6 +1,8 @@
 #ifndef LLVMABI_CALLER_HPP
 #define LLVMABI_CALLER_HPP
 
+#include <functional>
+
 #include <llvm/ADT/SmallVector.h>
 #include <llvm/IR/Value.h>
 
@@ -32,30 +34,104 @@ namespace llvm_abi {
 		 * to be avoided in some cases (by passing this pointer directly
 		 * as a struct-ret in function calls).
 		 * 
+		 * Similarly, arguments that are already in memory can be marked
+		 * as such, in which case their value is a pointer to the
+		 * argument and is forwarded directly for arguments passed
+		 * indirectly (e.g. 'byval').
+		 * 
+		 * Arguments passed with 'inalloca' are stored into a single
+		 * argument struct, allocated on the stack after saving the
+		 * stack pointer; the stack is restored by decodeReturnValue(),
+		 * which must be called immediately after the call.
+		 * 
+		 * Non-trivial records can't be copied into the argument
+		 * struct, so if one is given in memory it must be constructed
+		 * in place instead: given an argument constructor, each
+		 * non-trivial record argument is constructed by it directly
+		 * in the memory it is passed in (and its value is ignored).
+		 * 
 		 * \param arguments Arguments for function call.
 		 * \param returnValuePtr Pointer to return value, if any.
+		 * \param argumentsInMemory Whether each argument is given as a
+		 *                          pointer to its value; missing
+		 *                          entries are treated as false.
+		 * \param argumentConstructor A function that constructs the
+		 *                            argument with the given index at
+		 *                            the given address, or NULL.
 		 * \return The ABI-encoded arguments.
 		 */
 		llvm::SmallVector<llvm::Value*, 8>
 		encodeArguments(llvm::ArrayRef<TypedValue> arguments,
-		                llvm::Value* returnValuePtr = nullptr);
+		                llvm::Value* returnValuePtr = nullptr,
+		                llvm::ArrayRef<bool> argumentsInMemory = llvm::ArrayRef<bool>(),
+		                std::function<void (size_t, llvm::Value*)> argumentConstructor = nullptr);
 		
 		/**
 		 * \brief Decode return value.
+		 * 
+		 * If in-memory decoding is requested, an aggregate return
+		 * value (struct, union or array) is returned as a pointer to
+		 * its value rather than as a first-class aggregate value. This
+		 * is the struct-return pointer, the return value pointer (if
+		 * given) or a temporary alloca, so it may differ from the
+		 * given return value pointer.
+		 * 
+		 * \param encodedArguments The ABI-encoded call arguments.
+		 * \param encodedReturnValue The ABI-encoded return value.
+		 * \param returnValuePtr Pointer to return value, if any.
+		 * \param inMemory Whether to decode an aggregate to a pointer.
+		 * \return The decoded return value.
 		 */
 		llvm::Value*
 		decodeReturnValue(llvm::ArrayRef<llvm::Value*> encodedArguments,
 		                  llvm::Value* encodedReturnValue,
-		                  llvm::Value* returnValuePtr = nullptr);
+		                  llvm::Value* returnValuePtr = nullptr,
+		                  bool inMemory = false);
 		
 	private:
 		const ABITypeInfo& typeInfo_;
 		FunctionType functionType_;
 		const FunctionIRMapping& functionIRMapping_;
 		Builder& builder_;
+		llvm::Value* inallocaStackSave_;
+		llvm::Value* inallocaStructRetPtr_;
 		
 	};
 	
+	/**
+	 * \brief Create a tail call.
+	 * 
+	 * Shared implementation of ABI::createTailCall(), using the
+	 * ABI's IR mapping for the call. Arguments passed indirectly
+	 * (i.e. with an Indirect ArgInfo, such as 'byval') must be given
+	 * as pointers to their value, which are forwarded to the callee;
+	 * all other arguments are given by value.
+	 * 
+	 * Throws if the call needs memory in the caller's frame: for
+	 * arguments in an inalloca block, for an indirect argument
+	 * not given as a pointer, or for a struct-return without a
+	 * return value pointer.
+	 * 
+	 * \param typeInfo The ABI type information.
+	 * \param builder The builder for emitting instructions.
+	 * \param functionType The ABI function type.
+	 * \param functionIRMapping The IR mapping for the function type
+	 *                          and the (promoted) argument types.
+	 * \param callBuilder A function that should emit the necessary call.
+	 * \param arguments The function arguments.
+	 * \param returnValuePtr The struct-return pointer of the calling
+	 *                       function, if any.
+	 * \return The ABI-encoded function return value.
+	 */
+	llvm::Value*
+	createTailCall(const ABITypeInfo& typeInfo,
+	               Builder& builder,
+	               const FunctionType& functionType,
+	               const FunctionIRMapping& functionIRMapping,
+	               std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+	               llvm::ArrayRef<TypedValue> arguments,
+	               llvm::Value* returnValuePtr);
+	
 }
 
 #endif
@@ -50,7 +50,36 @@ namespace llvm_abi {
 		 * \brief MSVC calling convention that passes vectors and
 		 *        vector aggregates in SSE registers.
 		 */
-		CC_VectorCall
+		CC_VectorCall,
+		
+		/**
+		 * \brief Intel 'regcall' calling convention
+		 * 
+		 * Passes as many values as possible in registers,
+		 * including structs expanded into their fields.
+		 */
+		CC_RegCall,
+		
+		/**
+		 * \brief Fast calling convention for internal calls
+		 * 
+		 * Only usable when both caller and callee are generated
+		 * by the same frontend (i.e. not for exported or external
+		 * symbols); aggregates are passed and returned in
+		 * registers where possible, rather than following the C
+		 * ABI's memory rules.
+		 */
+		CC_FastInternal,
+		
+		/**
+		 * \brief Swift calling convention
+		 * 
+		 * Arguments follow the C calling convention, but
+		 * aggregates too large to be returned in registers by
+		 * the C ABI are split across up to four integer and four
+		 * floating point return registers.
+		 */
+		CC_Swift
 	};
 	
 	inline const char*
@@ -72,6 +101,12 @@ namespace llvm_abi {
 				return "pascal";
 			case CC_VectorCall:
 				return "vectorcall";
+			case CC_RegCall:
+				return "regcall";
+			case CC_FastInternal:
+				return "fast-internal";
+			case CC_Swift:
+				return "swift";
 		}
 		llvm_unreachable("Unknown calling convention.");
 	}
@@ -0,0 +1,154 @@
+#ifndef LLVMABI_CONCURRENTCACHE_HPP
+#define LLVMABI_CONCURRENTCACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace llvm_abi {
+	
+	/**
+	 * \brief Concurrent Cache
+	 * 
+	 * A thread-safe memoisation table for read-mostly caches (e.g.
+	 * type layouts), where values are pure functions of their keys.
+	 * 
+	 * Lookups first search a list of immutable 'levels' without
+	 * taking a lock. New entries are kept in a 'pending' map guarded
+	 * by a mutex, and are published as a new level when one of them
+	 * is looked up again (or once there are MinPublishSize of them),
+	 * so an entry only takes the lock for its first two lookups.
+	 * 
+	 * When a level is published, the levels after it are merged
+	 * into it until the next one is at least twice its size. Each
+	 * level is therefore at least twice the size of the one before
+	 * it, so there are at most log2(N) + 1 levels to search and each
+	 * entry is copied at most O(log N) times.
+	 * 
+	 * Old levels may still be in use by readers so they are only
+	 * freed with the cache.
+	 */
+	template <typename Key, typename Value>
+	class ConcurrentCache {
+	public:
+		/**
+		 * \brief The number of pending entries to publish.
+		 */
+		enum { MinPublishSize = 16 };
+		
+		ConcurrentCache()
+		: head_(nullptr) { }
+		
+		/**
+		 * \brief Get a cached value.
+		 * 
+		 * The value is computed without holding a lock, since
+		 * computing it may recursively query the cache. If
+		 * several threads miss on the same key, the first value
+		 * to be inserted is returned to all of them.
+		 * 
+		 * \param key The key.
+		 * \param computeFn Computes the value if it isn't cached.
+		 * \return The cached value.
+		 */
+		template <typename ComputeFn>
+		Value get(const Key& key, ComputeFn computeFn) {
+			const auto publishedValue = findPublished(key);
+			if (publishedValue != nullptr) {
+				return *publishedValue;
+			}
+			
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				const auto iterator = pending_.find(key);
+				if (iterator != pending_.end()) {
+					// The entry is in use, so publish it to
+					// make later lookups lock-free.
+					const auto value = iterator->second;
+					publish();
+					return value;
+				}
+			}
+			
+			const auto value = computeFn();
+			
+			std::lock_guard<std::mutex> lock(mutex_);
+			
+			// Another thread may have published the key since it
+			// was looked up.
+			const auto currentValue = findPublished(key);
+			if (currentValue != nullptr) {
+				return *currentValue;
+			}
+			
+			const auto result = pending_.insert(std::make_pair(key, value));
+			const auto insertedValue = result.first->second;
+			if (pending_.size() >= MinPublishSize) {
+				publish();
+			}
+			return insertedValue;
+		}
+		
+		/**
+		 * \brief Query whether a key is published.
+		 * 
+		 * \param key The key.
+		 * \return Whether lookups of the key are lock-free.
+		 */
+		bool isPublished(const Key& key) const {
+			return findPublished(key) != nullptr;
+		}
+		
+	private:
+		// Non-copyable.
+		ConcurrentCache(const ConcurrentCache&) = delete;
+		ConcurrentCache& operator=(const ConcurrentCache&) = delete;
+		
+		typedef std::unordered_map<Key, Value> Map;
+		
+		struct Level {
+			Map map;
+			const Level* next;
+		};
+		
+		const Value* findPublished(const Key& key) const {
+			for (auto level = head_.load(std::memory_order_acquire);
+			     level != nullptr; level = level->next) {
+				const auto iterator = level->map.find(key);
+				if (iterator != level->map.end()) {
+					return &(iterator->second);
+				}
+			}
+			return nullptr;
+		}
+		
+		// Must be called with the mutex held.
+		void publish() {
+			std::unique_ptr<Level> newLevel(new Level());
+			newLevel->map.swap(pending_);
+			
+			auto next = head_.load(std::memory_order_relaxed);
+			while (next != nullptr && next->map.size() < 2 * newLevel->map.size()) {
+				newLevel->map.insert(next->map.begin(), next->map.end());
+				next = next->next;
+			}
+			newLevel->next = next;
+			
+			head_.store(newLevel.get(), std::memory_order_release);
+			levels_.push_back(std::move(newLevel));
+		}
+		
+		std::atomic<const Level*> head_;
+		std::mutex mutex_;
+		Map pending_;
+		std::vector<std::unique_ptr<Level>> levels_;
+		
+	};
+	
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef LLVMABI_DATASIZE_HPP
 #define LLVMABI_DATASIZE_HPP
 
+#include <cassert>
 #include <stdint.h>
 
 namespace llvm_abi {
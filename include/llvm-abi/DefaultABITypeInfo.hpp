@@ -2,6 +2,7 @@
 #define LLVMABI_DEFAULTABITYPEINFO_HPP
 
 #include <map>
+#include <mutex>
 #include <string>
 
 #include <llvm/IR/Type.h>
@@ -42,14 +43,28 @@ namespace llvm_abi {
 	 * 
 	 * This class contains ABI type information functionality that is
 	 * typically common to all ABIs, such as how to layout structs.
+	 * 
+	 * Without an LLVM context only layout queries are available, which
+	 * is sufficient for computing lowering plans.
 	 */
 	class DefaultABITypeInfo {
 	public:
 		DefaultABITypeInfo(llvm::LLVMContext& llvmContext,
 		                   const ABITypeInfo& typeInfo,
 		                   const DefaultABITypeInfoDelegate& delegate);
+		DefaultABITypeInfo(const ABITypeInfo& typeInfo,
+		                   const DefaultABITypeInfoDelegate& delegate);
 		~DefaultABITypeInfo();
 		
+		/**
+		 * \brief Get the LLVM context.
+		 * 
+		 * Throws if this type information is layout-only.
+		 * 
+		 * \return The LLVM context.
+		 */
+		llvm::LLVMContext& context() const;
+		
 		/**
 		 * \brief Get the size of a type for this ABI.
 		 * 
@@ -118,9 +133,10 @@ namespace llvm_abi {
 		calculateDefaultStructOffsets(llvm::ArrayRef<RecordMember> structMembers) const;
 		
 	private:
-		llvm::LLVMContext& llvmContext_;
+		llvm::LLVMContext* llvmContext_;
 		const ABITypeInfo& typeInfo_;
 		const DefaultABITypeInfoDelegate& delegate_;
+		mutable std::mutex structTypesMutex_;
 		mutable std::map<std::string, llvm::StructType*> structTypes_;
 		
 	};
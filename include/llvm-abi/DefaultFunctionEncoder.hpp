@@ -0,0 +1,68 @@
+#ifndef LLVMABI_DEFAULTFUNCTIONENCODER_HPP
+#define LLVMABI_DEFAULTFUNCTIONENCODER_HPP
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Value.h>
+
+#include <llvm-abi/FunctionEncoder.hpp>
+#include <llvm-abi/FunctionIRMapping.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/LazyArgumentDecoder.hpp>
+#include <llvm-abi/SharedReturnBlock.hpp>
+
+namespace llvm_abi {
+	
+	class ABITypeInfo;
+	class Builder;
+	
+	/**
+	 * \brief Default Function Encoder
+	 * 
+	 * Implements argument decoding and return value encoding from a
+	 * function's IR mapping, leaving only the target-specific
+	 * variadic argument handling to subclasses.
+	 */
+	class DefaultFunctionEncoder: public FunctionEncoder {
+	public:
+		DefaultFunctionEncoder(const ABITypeInfo& typeInfo,
+		                       Builder& builder,
+		                       const FunctionType& functionType,
+		                       FunctionIRMapping functionIRMapping,
+		                       llvm::ArrayRef<llvm::Value*> arguments);
+		
+		llvm::ArrayRef<llvm::Value*> arguments() const;
+		
+		llvm::Value* argument(size_t index) const;
+		
+		llvm::Value* argumentPointer(size_t index) const;
+		
+		llvm::ReturnInst* returnValue(llvm::Value* value);
+		
+		llvm::BranchInst* branchToReturn(llvm::Value* value);
+		
+		llvm::Value* returnValuePointer() const;
+		
+	protected:
+		const ABITypeInfo& typeInfo() const {
+			return typeInfo_;
+		}
+		
+		Builder& builder() const {
+			return builder_;
+		}
+		
+	private:
+		const ABITypeInfo& typeInfo_;
+		Builder& builder_;
+		FunctionType functionType_;
+		FunctionIRMapping functionIRMapping_;
+		llvm::SmallVector<llvm::Value*, 8> encodedArguments_;
+		mutable LazyArgumentDecoder arguments_;
+		SharedReturnBlock sharedReturnBlock_;
+		
+	};
+	
+}
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef LLVMABI_FASTINTERNALCLASSIFIER_HPP
+#define LLVMABI_FASTINTERNALCLASSIFIER_HPP
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/SmallVector.h>
+
+#include <llvm-abi/ArgInfo.hpp>
+#include <llvm-abi/RegisterUsage.hpp>
+#include <llvm-abi/Type.hpp>
+
+namespace llvm_abi {
+	
+	class ABITypeInfo;
+	class FunctionType;
+	
+	/**
+	 * \brief Fast Internal Register Budget
+	 * 
+	 * The registers a target's 'fastcc' lowering can use for
+	 * arguments and return values.
+	 */
+	struct FastInternalRegisterBudget {
+		FastInternalRegisterBudget(const unsigned argNumIntArgRegs,
+		                           const unsigned argNumFloatArgRegs,
+		                           const unsigned argNumIntReturnRegs,
+		                           const unsigned argNumFloatReturnRegs,
+		                           const bool argUseInRegForArgs)
+		: numIntArgRegs(argNumIntArgRegs),
+		numFloatArgRegs(argNumFloatArgRegs),
+		numIntReturnRegs(argNumIntReturnRegs),
+		numFloatReturnRegs(argNumFloatReturnRegs),
+		useInRegForArgs(argUseInRegForArgs) { }
+		
+		unsigned numIntArgRegs;
+		unsigned numFloatArgRegs;
+		unsigned numIntReturnRegs;
+		unsigned numFloatReturnRegs;
+		
+		// Whether arguments must be marked 'inreg' to be
+		// assigned to registers (e.g. x86-32 fastcc).
+		bool useInRegForArgs;
+	};
+	
+	/**
+	 * \brief Fast Internal Classifier
+	 * 
+	 * This class classifies function types using the CC_FastInternal
+	 * calling convention, which is only valid between functions
+	 * compiled by the same frontend. Aggregates are expanded into
+	 * scalars (or passed as first class values) and returned in
+	 * registers while they fit in the target's register budget,
+	 * rather than going through byval/sret memory; only aggregates
+	 * that don't fit are passed by reference.
+	 */
+	class FastInternalClassifier {
+	public:
+		FastInternalClassifier(const ABITypeInfo& typeInfo,
+		                       FastInternalRegisterBudget budget);
+		
+		/**
+		 * \brief Count registers needed to hold a value.
+		 * 
+		 * \return Whether the value can be held in registers.
+		 */
+		bool countRegisters(Type type,
+		                    unsigned& numIntRegs,
+		                    unsigned& numFloatRegs) const;
+		
+		/**
+		 * \brief Query whether an aggregate can be expanded.
+		 */
+		bool canExpand(Type type) const;
+		
+		ArgInfo classifyReturnType(Type type) const;
+		
+		ArgInfo classifyArgumentType(Type type,
+		                             unsigned& freeIntRegs,
+		                             unsigned& freeFloatRegs) const;
+		
+		llvm::SmallVector<ArgInfo, 8>
+		classifyFunctionType(const FunctionType& functionType,
+		                     llvm::ArrayRef<Type> argumentTypes,
+		                     RegisterUsage* registerUsage = nullptr) const;
+		
+	private:
+		const ABITypeInfo& typeInfo_;
+		FastInternalRegisterBudget budget_;
+		
+	};
+	
+}
+
+#endif
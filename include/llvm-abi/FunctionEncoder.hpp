@@ -1,8 +1,11 @@
 #ifndef LLVMABI_FUNCTIONENCODER_HPP
 #define LLVMABI_FUNCTIONENCODER_HPP
 
+#include <llvm/IR/Instructions.h>
 #include <llvm/IR/Value.h>
 
+#include <llvm-abi/Type.hpp>
+
 namespace llvm_abi {
 	
 	/**
@@ -27,17 +30,57 @@ namespace llvm_abi {
 		 */
 		virtual llvm::ArrayRef<llvm::Value*> arguments() const = 0;
 		
+		/**
+		 * \brief Get a function argument.
+		 * 
+		 * This returns a single argument in ABI-independent form.
+		 * 
+		 * Arguments are decoded on first use, so arguments that are
+		 * never requested (via this method or arguments()) don't
+		 * generate any code.
+		 * 
+		 * \param index The argument index.
+		 * \return Decoded function argument.
+		 */
+		virtual llvm::Value* argument(size_t index) const = 0;
+		
+		/**
+		 * \brief Get a pointer to a function argument.
+		 * 
+		 * For aggregates (structs, unions and arrays), this returns a
+		 * pointer to the argument's value (e.g. the incoming 'byval'
+		 * pointer) rather than a first-class aggregate value; other
+		 * arguments are returned as by argument().
+		 * 
+		 * \param index The argument index.
+		 * \return Decoded function argument, or pointer to it.
+		 */
+		virtual llvm::Value* argumentPointer(size_t index) const = 0;
+		
 		/**
 		 * \brief Return a value.
 		 * 
 		 * Emits code to return the given value as an encoded return
 		 * value.
 		 * 
-		 * \param Return value.
+		 * \param value The (ABI-independent) return value.
 		 * \return The return instruction emitted.
 		 */
 		virtual llvm::ReturnInst* returnValue(llvm::Value* value) = 0;
 		
+		/**
+		 * \brief Return a value via a shared return block.
+		 * 
+		 * Emits a branch to a return block shared by all callers of
+		 * this method, which contains the only copy of the code to
+		 * encode the return value. This is preferable to returnValue()
+		 * for functions with many return sites.
+		 * 
+		 * \param value The (ABI-independent) return value.
+		 * \return The branch instruction emitted.
+		 */
+		virtual llvm::BranchInst* branchToReturn(llvm::Value* value) = 0;
+		
 		/**
 		 * \brief Get return value pointer, if any.
 		 * 
@@ -45,6 +88,56 @@ namespace llvm_abi {
 		 */
 		virtual llvm::Value* returnValuePointer() const = 0;
 		
+		/**
+		 * \brief Get the va_list type.
+		 * 
+		 * Returns the LLVM type of a 'va_list', so that one can be
+		 * allocated and initialised by 'llvm.va_start' for use with
+		 * the methods below.
+		 * 
+		 * \return The va_list type.
+		 */
+		virtual llvm::Type* vaListType() const = 0;
+		
+		/**
+		 * \brief Get the next variadic argument.
+		 * 
+		 * Emits code to read the next variadic argument from a
+		 * 'va_list' that has been initialised by 'llvm.va_start' (or
+		 * copied from one that has been). The type must be the
+		 * argument's type after default argument promotion (e.g.
+		 * 'int' rather than 'char', 'double' rather than 'float').
+		 * 
+		 * \param vaList Pointer to the va_list.
+		 * \param type The argument type.
+		 * \return The argument value.
+		 */
+		virtual llvm::Value* vaArg(llvm::Value* vaList, Type type) = 0;
+		
+		/**
+		 * \brief Copy a va_list.
+		 * 
+		 * Emits an inline copy of the source va_list's state into the
+		 * destination va_list, as for 'va_copy'. Unlike the
+		 * 'llvm.va_copy' intrinsic this is plain loads and stores.
+		 * 
+		 * \param destVaList Pointer to the destination va_list.
+		 * \param sourceVaList Pointer to the source va_list.
+		 */
+		virtual void vaCopy(llvm::Value* destVaList, llvm::Value* sourceVaList) = 0;
+		
+		/**
+		 * \brief Get a va_list argument value.
+		 * 
+		 * Returns the value to pass for a 'va_list' parameter (e.g.
+		 * of vprintf) to forward the given va_list. This is a
+		 * pointer, so the parameter's type is PointerTy.
+		 * 
+		 * \param vaList Pointer to the va_list.
+		 * \return The va_list argument value.
+		 */
+		virtual llvm::Value* vaListArgument(llvm::Value* vaList) = 0;
+		
 	};
 	
 }
@@ -61,6 +61,25 @@ namespace llvm_abi {
 			inallocaArgIndex_ = argIndex;
 		}
 		
+		/**
+		 * \brief Get the field types of the 'inalloca' argument struct.
+		 * 
+		 * Each 'inalloca' argument (and the 'sret' pointer, if it
+		 * is passed in memory) has a field in the argument struct,
+		 * followed by any padding needed to reach the next stack
+		 * slot.
+		 */
+		llvm::ArrayRef<Type> inallocaFieldTypes() const {
+			return inallocaFieldTypes_;
+		}
+		
+		/**
+		 * \brief Set the field types of the 'inalloca' argument struct.
+		 */
+		void setInallocaFieldTypes(llvm::ArrayRef<Type> fieldTypes) {
+			inallocaFieldTypes_.assign(fieldTypes.begin(), fieldTypes.end());
+		}
+		
 		/**
 		 * \brief Query whether function has 'sret' argument.
 		 */
@@ -134,6 +153,7 @@ namespace llvm_abi {
 		size_t structRetArgIndex_;
 		size_t totalIRArgs_;
 		llvm::SmallVector<ArgumentIRMapping, 8> arguments_;
+		llvm::SmallVector<Type, 8> inallocaFieldTypes_;
 		
 	};
 	
@@ -147,6 +167,22 @@ namespace llvm_abi {
 	getFunctionIRMapping(const ABITypeInfo& typeInfo,
 	                     llvm::ArrayRef<ArgInfo> argInfoArray);
 	
+	/**
+	 * \brief Get 'inalloca' argument struct type.
+	 * 
+	 * The argument struct is packed, since its fields are laid
+	 * out exactly as the arguments appear on the stack.
+	 * 
+	 * \param context The LLVM context.
+	 * \param typeInfo The ABI type information.
+	 * \param functionIRMapping The ABI function IR mapping.
+	 * \return The packed LLVM struct type.
+	 */
+	llvm::StructType*
+	getInallocaStructType(llvm::LLVMContext& context,
+	                      const ABITypeInfo& typeInfo,
+	                      const FunctionIRMapping& functionIRMapping);
+	
 	/**
 	 * \brief Get LLVM function type.
 	 * 
@@ -165,8 +201,16 @@ namespace llvm_abi {
 	/**
 	 * \brief Get LLVM function attributes.
 	 * 
+	 * Hidden pointers (i.e. 'sret' and indirect arguments) are
+	 * also given attributes describing the memory they point to,
+	 * such as 'nonnull' and 'dereferenceable', so these should
+	 * be applied to call sites as well as declarations.
+	 * 
 	 * \param context The LLVM context.
 	 * \param typeInfo The ABI type information.
+	 * \param functionType The ABI function type.
+	 * \param argumentTypes The (promoted) argument types, including
+	 *                      any varargs arguments.
 	 * \param functionIRMapping The ABI function IR mapping.
 	 * \param existingAttributes Any existing attributes (that may need to
 	 *                           be removed).
@@ -175,9 +219,37 @@ namespace llvm_abi {
 	llvm::AttributeSet
 	getFunctionAttributes(llvm::LLVMContext& llvmContext,
 	                      const ABITypeInfo& typeInfo,
+	                      const FunctionType& functionType,
+	                      llvm::ArrayRef<Type> argumentTypes,
 	                      const FunctionIRMapping& functionIRMapping,
 	                      const llvm::AttributeSet existingAttributes);
 	
+	/**
+	 * \brief Query whether a call can be a guaranteed tail call.
+	 * 
+	 * A call from the caller function to the callee function can
+	 * be marked 'musttail' if both have the same calling convention,
+	 * return type and LLVM IR signature, with matching ABI-impacting
+	 * attributes (e.g. 'sret', 'byval', 'inreg'). Functions that use
+	 * 'inalloca' are never compatible, since the argument memory
+	 * lives in the caller's frame.
+	 * 
+	 * \param context The LLVM context.
+	 * \param typeInfo The ABI type information.
+	 * \param callerType The ABI function type of the caller.
+	 * \param callerIRMapping The caller's function IR mapping.
+	 * \param calleeType The ABI function type of the callee.
+	 * \param calleeIRMapping The callee's function IR mapping.
+	 * \return Whether the call can be marked 'musttail'.
+	 */
+	bool
+	isTailCallCompatible(llvm::LLVMContext& context,
+	                     const ABITypeInfo& typeInfo,
+	                     const FunctionType& callerType,
+	                     const FunctionIRMapping& callerIRMapping,
+	                     const FunctionType& calleeType,
+	                     const FunctionIRMapping& calleeIRMapping);
+	
 }
 
 #endif
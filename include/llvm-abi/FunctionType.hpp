@@ -22,6 +22,8 @@ namespace llvm_abi {
 		             bool pIsVarArg = false)
 		: callingConvention_(pCallingConvention),
 		isVarArg_(pIsVarArg),
+		hasRegParm_(false),
+		regParm_(0),
 		returnType_(pReturnType),
 		argumentTypes_(pArgumentTypes.begin(), pArgumentTypes.end()) { }
 		
@@ -31,6 +33,8 @@ namespace llvm_abi {
 		             bool pIsVarArg = false)
 		: callingConvention_(pCallingConvention),
 		isVarArg_(pIsVarArg),
+		hasRegParm_(false),
+		regParm_(0),
 		returnType_(pReturnType),
 		argumentTypes_(pArgumentTypes.begin(), pArgumentTypes.end()) { }
 		
@@ -42,6 +46,35 @@ namespace llvm_abi {
 			return isVarArg_;
 		}
 		
+		/**
+		 * \brief Query whether a register parameter count was given.
+		 * 
+		 * This corresponds to GCC's 'regparm' function attribute;
+		 * when absent the ABI's default number of register
+		 * parameters is used.
+		 */
+		bool hasRegParm() const {
+			return hasRegParm_;
+		}
+		
+		/**
+		 * \brief Get number of integer registers used for parameters.
+		 */
+		unsigned regParm() const {
+			return regParm_;
+		}
+		
+		/**
+		 * \brief Set number of integer registers used for parameters.
+		 * 
+		 * Only meaningful for ABIs that support 'regparm' (i.e.
+		 * x86-32); other ABIs ignore it.
+		 */
+		void setRegParm(const unsigned pRegParm) {
+			hasRegParm_ = true;
+			regParm_ = pRegParm;
+		}
+		
 		Type returnType() const {
 			return returnType_;
 		}
@@ -54,6 +87,10 @@ namespace llvm_abi {
 			std::string string;
 			string += "FunctionType(callingConvention: ";
 			string += callingConventionString(callingConvention());
+			if (hasRegParm()) {
+				string += ", regParm: ";
+				string += std::to_string(regParm());
+			}
 			string += ", returnType: ";
 			string += returnType().toString();
 			string += ", argumentTypes: [";
@@ -73,6 +110,8 @@ namespace llvm_abi {
 	private:
 		CallingConvention callingConvention_;
 		bool isVarArg_;
+		bool hasRegParm_;
+		unsigned regParm_;
 		Type returnType_;
 		llvm::SmallVector<Type, 8> argumentTypes_;
 		
@@ -0,0 +1,44 @@
+#ifndef LLVMABI_INSERTPOINTBUILDER_HPP
+#define LLVMABI_INSERTPOINTBUILDER_HPP
+
+#include <llvm/IR/BasicBlock.h>
+
+#include <llvm-abi/Builder.hpp>
+
+namespace llvm_abi {
+	
+	/**
+	 * \brief Insert Point Builder
+	 * 
+	 * A builder that emits instructions at its own insertion point
+	 * (e.g. in a function's prologue or epilogue) rather than the
+	 * client's current position. Allocas are still emitted via the
+	 * parent builder.
+	 */
+	class InsertPointBuilder: public Builder {
+	public:
+		InsertPointBuilder(Builder& parent, llvm::BasicBlock* const block)
+		: parent_(parent),
+		builder_(block) { }
+		
+		IRBuilder& getEntryBuilder() {
+			return parent_.getEntryBuilder();
+		}
+		
+		IRBuilder& getBuilder() {
+			return builder_;
+		}
+		
+		size_t getInlineCopyThreshold() {
+			return parent_.getInlineCopyThreshold();
+		}
+		
+	private:
+		Builder& parent_;
+		IRBuilder builder_;
+		
+	};
+	
+}
+
+#endif
@@ -1,12 +1,17 @@
 #ifndef LLVMABI_LLVMUTILS_HPP
 #define LLVMABI_LLVMUTILS_HPP
 
+#include <llvm/ADT/SmallVector.h>
 #include <llvm/IR/Value.h>
 
+#include <llvm-abi/TypedValue.hpp>
+
 namespace llvm_abi {
 	
 	class ABITypeInfo;
 	class Builder;
+	class DataSize;
+	class FunctionType;
 	
 	llvm::AllocaInst* createTempAlloca(const ABITypeInfo& typeInfo,
 	                                   Builder& builder,
@@ -22,6 +27,39 @@ namespace llvm_abi {
 	                             llvm::Value* const value,
 	                             llvm::Value* const ptr);
 	
+	/**
+	 * \brief Emit a memory copy.
+	 * 
+	 * Copies no larger than the builder's inline copy threshold are
+	 * emitted as straight-line loads and stores, using the widest
+	 * accesses allowed by the ABI; larger copies use memcpy.
+	 */
+	void createMemCpy(const ABITypeInfo& typeInfo,
+	                  Builder& builder,
+	                  llvm::Value* dest,
+	                  llvm::Value* source,
+	                  DataSize size,
+	                  size_t align);
+	
+	/**
+	 * \brief Determine which call arguments are given in memory.
+	 * 
+	 * An argument is in memory if its value is a pointer to its
+	 * type's LLVM type. Varargs arguments may need to be promoted,
+	 * so any given in memory are loaded and passed by value.
+	 * Arguments without a value (which are constructed in place)
+	 * aren't in memory.
+	 * 
+	 * \param arguments The arguments; in-memory varargs arguments
+	 *                  are replaced by their loaded value.
+	 * \return Whether each argument is in memory.
+	 */
+	llvm::SmallVector<bool, 8>
+	prepareInMemoryArguments(const ABITypeInfo& typeInfo,
+	                         Builder& builder,
+	                         const FunctionType& functionType,
+	                         llvm::SmallVectorImpl<TypedValue>& arguments);
+	
 	llvm::Value* createConstGEP2_32(Builder& builder,
 	                                llvm::Type* type, llvm::Value* ptr,
 	                                unsigned idx0, unsigned idx1,
@@ -0,0 +1,88 @@
+#ifndef LLVMABI_LAZYARGUMENTDECODER_HPP
+#define LLVMABI_LAZYARGUMENTDECODER_HPP
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/Value.h>
+
+#include <llvm-abi/Builder.hpp>
+#include <llvm-abi/Callee.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/InsertPointBuilder.hpp>
+
+namespace llvm_abi {
+	
+	class ABITypeInfo;
+	class FunctionIRMapping;
+	
+	/**
+	 * \brief Lazy Argument Decoder
+	 * 
+	 * Decodes function arguments on first use, so that arguments
+	 * the function body never reads cost no IR.
+	 * 
+	 * The decoding code is emitted at the end of the function
+	 * prologue (i.e. the builder's position when the decoder is
+	 * created) rather than at the point of use, so decoded values
+	 * dominate the whole function body.
+	 */
+	class LazyArgumentDecoder {
+	public:
+		LazyArgumentDecoder(const ABITypeInfo& typeInfo,
+		                    const FunctionType& functionType,
+		                    const FunctionIRMapping& functionIRMapping,
+		                    Builder& builder,
+		                    llvm::ArrayRef<llvm::Value*> encodedArguments);
+		
+		/**
+		 * \brief Get number of arguments.
+		 */
+		size_t size() const;
+		
+		/**
+		 * \brief Get decoded argument, decoding it if necessary.
+		 * 
+		 * Aggregates are loaded from the pointer returned by
+		 * getPointer(), so they're only decoded once however they're
+		 * accessed.
+		 */
+		llvm::Value* get(size_t index);
+		
+		/**
+		 * \brief Get decoded argument in memory, decoding it if
+		 *        necessary.
+		 * 
+		 * Aggregates are returned as a pointer to their value (see
+		 * Callee::decodeArgument()); other arguments are returned as
+		 * by get().
+		 */
+		llvm::Value* getPointer(size_t index);
+		
+		/**
+		 * \brief Get all decoded arguments, decoding any that
+		 *        haven't been decoded yet.
+		 */
+		llvm::ArrayRef<llvm::Value*> getAll();
+		
+	private:
+		void beginPrologue();
+		
+		void endPrologue();
+		
+		llvm::Value* decodeInPrologue(size_t index, bool inMemory);
+		
+		bool isLoadedFromPointer(size_t index) const;
+		
+		FunctionType functionType_;
+		InsertPointBuilder prologueBuilder_;
+		llvm::BasicBlock* prologueBlock_;
+		llvm::Instruction* prologueEnd_;
+		Callee callee_;
+		llvm::SmallVector<llvm::Value*, 8> encodedArguments_;
+		llvm::SmallVector<llvm::Value*, 8> arguments_;
+		llvm::SmallVector<llvm::Value*, 8> argumentPointers_;
+		
+	};
+	
+}
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef LLVMABI_LOWERINGPLAN_HPP
+#define LLVMABI_LOWERINGPLAN_HPP
+
+#include <memory>
+#include <string>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/Attributes.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/LLVMContext.h>
+
+#include <llvm-abi/ArgInfo.hpp>
+#include <llvm-abi/FunctionIRMapping.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/RegisterUsage.hpp>
+#include <llvm-abi/Type.hpp>
+
+namespace llvm_abi {
+	
+	class ABITypeInfo;
+	
+	/**
+	 * \brief Lowering Plan
+	 * 
+	 * Describes how a function type is lowered by an ABI: the ArgInfo
+	 * for the return value and each argument (with coercions given as
+	 * ABI types), how they map to IR arguments and the registers they
+	 * consume.
+	 * 
+	 * Plans are plain values computed from type layouts alone, so they
+	 * can be computed on any thread without an LLVM context, cached
+	 * and reused for any module with the same target. Their ABI types
+	 * remain valid as long as the type builder that created them.
+	 */
+	class LoweringPlan {
+	public:
+		LoweringPlan(const FunctionType& functionType,
+		             llvm::ArrayRef<Type> argumentTypes,
+		             FunctionIRMapping irMapping,
+		             RegisterUsage registerUsage);
+		
+		const FunctionType& functionType() const;
+		
+		/**
+		 * \brief Get the argument types.
+		 * 
+		 * \return The (promoted) argument types, including any
+		 *         varargs arguments.
+		 */
+		llvm::ArrayRef<Type> argumentTypes() const;
+		
+		const FunctionIRMapping& irMapping() const;
+		
+		const ArgInfo& returnInfo() const;
+		
+		const ArgInfo& argumentInfo(size_t index) const;
+		
+		const RegisterUsage& registerUsage() const;
+		
+		std::string toString() const;
+		
+	private:
+		FunctionType functionType_;
+		llvm::SmallVector<Type, 8> argumentTypes_;
+		FunctionIRMapping irMapping_;
+		RegisterUsage registerUsage_;
+		
+	};
+	
+	/**
+	 * \brief Lowering Planner
+	 * 
+	 * Computes lowering plans for a target, using only layout-only
+	 * ABI type information (i.e. without an LLVM context). Planners
+	 * can be used from multiple threads.
+	 */
+	class LoweringPlanner {
+	public:
+		virtual ~LoweringPlanner() { }
+		
+		/**
+		 * \brief Get layout-only ABI type information.
+		 * 
+		 * \return ABI type information (getLLVMType() isn't
+		 *         available).
+		 */
+		virtual const ABITypeInfo& typeInfo() const = 0;
+		
+		/**
+		 * \brief Get the lowering plan for a function type.
+		 * 
+		 * \param functionType The ABI function type.
+		 * \param argumentTypes The argument types, including any
+		 *                      varargs arguments (which are
+		 *                      promoted).
+		 * \return The lowering plan.
+		 */
+		virtual LoweringPlan getLoweringPlan(const FunctionType& functionType,
+		                                     llvm::ArrayRef<Type> argumentTypes) const = 0;
+		
+	};
+	
+	/**
+	 * \brief Create a lowering planner for the specified target triple.
+	 * 
+	 * \param targetTriple the LLVM target triple.
+	 * \param cpu The CPU name, or "native" for the host CPU.
+	 * \return The lowering planner for the target.
+	 */
+	std::unique_ptr<LoweringPlanner>
+	createLoweringPlanner(const llvm::Triple& targetTriple,
+	                      const std::string& cpu = "");
+	
+	/**
+	 * \brief Get LLVM function type for a lowering plan.
+	 * 
+	 * \param context The LLVM context.
+	 * \param typeInfo The ABI type information.
+	 * \param plan The lowering plan, which mustn't include any
+	 *             varargs arguments.
+	 * \return The ABI-encoded LLVM function type.
+	 */
+	llvm::FunctionType *
+	getFunctionType(llvm::LLVMContext& context,
+	                const ABITypeInfo& typeInfo,
+	                const LoweringPlan& plan);
+	
+	/**
+	 * \brief Get LLVM function attributes for a lowering plan.
+	 * 
+	 * \param context The LLVM context.
+	 * \param typeInfo The ABI type information.
+	 * \param plan The lowering plan.
+	 * \param existingAttributes Any existing attributes (that may need to
+	 *                           be removed).
+	 * \return The ABI-encoded LLVM function attributes.
+	 */
+	llvm::AttributeSet
+	getFunctionAttributes(llvm::LLVMContext& context,
+	                      const ABITypeInfo& typeInfo,
+	                      const LoweringPlan& plan,
+	                      llvm::AttributeSet existingAttributes);
+	
+}
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef LLVMABI_LOWERINGPLANCACHE_HPP
+#define LLVMABI_LOWERINGPLANCACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/SmallVector.h>
+
+#include <llvm-abi/ConcurrentCache.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/LoweringPlan.hpp>
+#include <llvm-abi/Type.hpp>
+
+namespace llvm_abi {
+	
+	/**
+	 * \brief Lowering Plan Key
+	 * 
+	 * Identifies a lowering plan: the function type, the (promoted)
+	 * argument types and a target-specific variant for settings that
+	 * change the lowering but not the layout (e.g. the CPU feature
+	 * mask on x86_64).
+	 */
+	class LoweringPlanKey {
+	public:
+		LoweringPlanKey(const FunctionType& functionType,
+		                llvm::ArrayRef<Type> argumentTypes,
+		                uint64_t variant);
+		
+		bool operator==(const LoweringPlanKey& other) const;
+		
+		size_t hash() const;
+		
+	private:
+		FunctionType functionType_;
+		llvm::SmallVector<Type, 8> argumentTypes_;
+		uint64_t variant_;
+		
+	};
+	
+}
+
+namespace std {
+	
+	template <> struct hash<llvm_abi::LoweringPlanKey> {
+		size_t operator()(const llvm_abi::LoweringPlanKey& key) const {
+			return key.hash();
+		}
+	};
+	
+}
+
+namespace llvm_abi {
+	
+	/**
+	 * \brief Lowering Plan Cache
+	 * 
+	 * Memoises lowering plans, which would otherwise be recomputed
+	 * by classifying every argument each time a function type is
+	 * lowered. Like the layout cache, plans don't depend on an LLVM
+	 * context, so the cache can be shared by the ABIs of modules with
+	 * the same target, and it can be queried from multiple threads.
+	 */
+	class LoweringPlanCache {
+	public:
+		LoweringPlanCache() { }
+		
+		/**
+		 * \brief Get a cached lowering plan.
+		 * 
+		 * \param functionType The ABI function type.
+		 * \param argumentTypes The (already promoted) argument types.
+		 * \param variant The target-specific variant.
+		 * \param computeFn Computes the plan if it isn't cached.
+		 * \return The lowering plan.
+		 */
+		template <typename ComputeFn>
+		LoweringPlan get(const FunctionType& functionType,
+		                 llvm::ArrayRef<Type> argumentTypes,
+		                 const uint64_t variant,
+		                 ComputeFn computeFn) {
+			return cache_.get(LoweringPlanKey(functionType,
+			                                  argumentTypes,
+			                                  variant),
+			                  computeFn);
+		}
+		
+	private:
+		// Non-copyable.
+		LoweringPlanCache(const LoweringPlanCache&) = delete;
+		LoweringPlanCache& operator=(const LoweringPlanCache&) = delete;
+		
+		ConcurrentCache<LoweringPlanKey, LoweringPlan> cache_;
+		
+	};
+	
+}
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef LLVMABI_REGISTERUSAGE_HPP
+#define LLVMABI_REGISTERUSAGE_HPP
+
+namespace llvm_abi {
+	
+	/**
+	 * \brief Register Usage
+	 * 
+	 * The number of argument registers consumed by a function's
+	 * arguments (including hidden arguments such as the struct-return
+	 * pointer), as determined by classification.
+	 */
+	struct RegisterUsage {
+		RegisterUsage()
+		: numIntRegs(0), numVectorRegs(0) { }
+		
+		RegisterUsage(const unsigned argNumIntRegs,
+		              const unsigned argNumVectorRegs)
+		: numIntRegs(argNumIntRegs),
+		numVectorRegs(argNumVectorRegs) { }
+		
+		unsigned numIntRegs;
+		unsigned numVectorRegs;
+	};
+	
+}
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef LLVMABI_SHAREDRETURNBLOCK_HPP
+#define LLVMABI_SHAREDRETURNBLOCK_HPP
+
+#include <memory>
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/Instructions.h>
+
+#include <llvm-abi/Builder.hpp>
+#include <llvm-abi/Callee.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/InsertPointBuilder.hpp>
+
+namespace llvm_abi {
+	
+	class ABITypeInfo;
+	class FunctionIRMapping;
+	
+	/**
+	 * \brief Shared Return Block
+	 * 
+	 * Funnels all of a function's returns through a single epilogue
+	 * block, which takes the return value via a phi and contains the
+	 * only copy of the return value encoding code. This keeps code
+	 * size independent of the number of return sites.
+	 * 
+	 * Values returned in memory (e.g. via an 'sret' pointer) are
+	 * instead stored at each return site, since merging them would
+	 * need a phi of first-class aggregates; the return block then
+	 * just returns.
+	 */
+	class SharedReturnBlock {
+	public:
+		/**
+		 * \brief Constructor.
+		 * 
+		 * \param typeInfo The ABI type information.
+		 * \param functionType The ABI function type.
+		 * \param functionIRMapping The function's IR mapping.
+		 * \param builder The builder for emitting instructions.
+		 * \param encodedArguments The ABI-encoded function arguments.
+		 */
+		SharedReturnBlock(const ABITypeInfo& typeInfo,
+		                  const FunctionType& functionType,
+		                  const FunctionIRMapping& functionIRMapping,
+		                  Builder& builder,
+		                  llvm::ArrayRef<llvm::Value*> encodedArguments);
+		
+		/**
+		 * \brief Branch to the return block.
+		 * 
+		 * Emits a branch at the builder's current position to the
+		 * return block (creating it on first use), returning the
+		 * given value.
+		 * 
+		 * \param value The (ABI-independent) return value.
+		 * \return The branch instruction emitted.
+		 */
+		llvm::BranchInst* branchTo(llvm::Value* value);
+		
+	private:
+		bool isReturnedInMemory() const;
+		
+		void createBlock();
+		
+		const ABITypeInfo& typeInfo_;
+		FunctionType functionType_;
+		const FunctionIRMapping& functionIRMapping_;
+		Builder& builder_;
+		llvm::SmallVector<llvm::Value*, 8> encodedArguments_;
+		std::unique_ptr<InsertPointBuilder> returnBuilder_;
+		std::unique_ptr<Callee> callee_;
+		llvm::BasicBlock* block_;
+		llvm::PHINode* phi_;
+		
+	};
+	
+}
+
+#endif
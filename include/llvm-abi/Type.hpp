@@ -121,6 +121,18 @@ namespace llvm_abi {
 			static Type AutoStruct(const TypeBuilder& typeBuilder, llvm::ArrayRef<Type> memberTypes,
 			                        std::string name="");
 			
+			/**
+			 * \brief Auto-aligned Non-Trivial Struct Type
+			 * 
+			 * A C++ struct that is non-trivial for the purposes of
+			 * calls (i.e. it has a non-trivial copy constructor or
+			 * destructor), so it can't be copied by the ABI and must
+			 * be passed and returned in memory.
+			 */
+			static Type NonTrivialAutoStruct(const TypeBuilder& typeBuilder,
+			                                 llvm::ArrayRef<Type> memberTypes,
+			                                 std::string name="");
+			
 			/**
 			 * \brief Union Type
 			 */
@@ -161,6 +173,7 @@ namespace llvm_abi {
 			bool integerIsSigned() const;
 			
 			bool isFloatingPoint() const;
+			bool isHalfFloat() const;
 			bool isFloat() const;
 			bool isDouble() const;
 			bool isLongDouble() const;
@@ -187,6 +200,14 @@ namespace llvm_abi {
 			
 			bool hasFlexibleArrayMember() const;
 			
+			/**
+			 * \brief Query whether type is a non-trivial record.
+			 * 
+			 * Non-trivial records can't be copied by the ABI, so
+			 * they are always passed and returned in memory.
+			 */
+			bool isNonTrivialRecord() const;
+			
 			bool isArray() const;
 			
 			size_t arrayElementCount() const;
@@ -484,9 +505,13 @@ namespace llvm_abi {
 	};
 	
 	struct Type::TypeData {
-		struct {
+		struct RecordTypeData {
 			std::string name;
 			llvm::SmallVector<RecordMember, 8> members;
+			bool isNonTrivial;
+			
+			RecordTypeData()
+			: isNonTrivial(false) { }
 		} recordType;
 		
 		struct ArrayTypeData {
@@ -514,6 +539,10 @@ namespace llvm_abi {
 				return recordType.members < other.recordType.members;
 			}
 			
+			if (recordType.isNonTrivial != other.recordType.isNonTrivial) {
+				return recordType.isNonTrivial < other.recordType.isNonTrivial;
+			}
+			
 			if (arrayType.elementCount != other.arrayType.elementCount) {
 				return arrayType.elementCount < other.arrayType.elementCount;
 			}
@@ -1,6 +1,7 @@
 #ifndef LLVMABI_TYPEBUILDER_HPP
 #define LLVMABI_TYPEBUILDER_HPP
 
+#include <mutex>
 #include <set>
 
 #include <llvm-abi/Type.hpp>
@@ -14,6 +15,8 @@ namespace llvm_abi {
 	 * with an internal pointer which means that comparison simply involves
 	 * comparing the pointers and copying is just copying the pointers. It
 	 * also has convenience methods for primitive values (e.g. int).
+	 * 
+	 * Types can be created from multiple threads.
 	 */
 	class TypeBuilder {
 		public:
@@ -42,6 +45,9 @@ namespace llvm_abi {
 			Type getStructTy(llvm::ArrayRef<Type> memberTypes,
 			                 std::string name="") const;
 			
+			Type getNonTrivialStructTy(llvm::ArrayRef<Type> memberTypes,
+			                           std::string name="") const;
+			
 			Type getUnionTy(std::initializer_list<Type> memberTypes,
 			                std::string name="") const;
 			Type getUnionTy(llvm::ArrayRef<Type> memberTypes,
@@ -56,6 +62,7 @@ namespace llvm_abi {
 			TypeBuilder(const TypeBuilder&) = delete;
 			TypeBuilder& operator=(const TypeBuilder&) = delete;
 			
+			mutable std::mutex mutex_;
 			mutable std::set<Type::TypeData> typeDataSet_;
 			
 	};
@@ -1,9 +1,11 @@
 #ifndef LLVMABI_X86_CPUFEATURES_HPP
 #define LLVMABI_X86_CPUFEATURES_HPP
 
-#include <set>
+#include <bitset>
+#include <cstdint>
 #include <string>
 
+#include <llvm/ADT/StringRef.h>
 #include <llvm/ADT/Triple.h>
 
 #include <llvm-abi/x86/CPUKind.hpp>
@@ -25,25 +27,140 @@ namespace llvm_abi {
 			AVX512F
 		};
 		
+		/**
+		 * \brief CPU feature.
+		 * 
+		 * Features are interned to this enumeration so that a feature
+		 * set is a fixed-size bitset.
+		 */
+		enum CPUFeature {
+			Feature3DNow,
+			Feature3DNowA,
+			FeatureADX,
+			FeatureAES,
+			FeatureAVX,
+			FeatureAVX2,
+			FeatureAVX512BW,
+			FeatureAVX512CD,
+			FeatureAVX512DQ,
+			FeatureAVX512ER,
+			FeatureAVX512F,
+			FeatureAVX512PF,
+			FeatureAVX512VL,
+			FeatureBMI,
+			FeatureBMI2,
+			FeatureCX16,
+			FeatureF16C,
+			FeatureFMA,
+			FeatureFMA4,
+			FeatureFSGSBase,
+			FeatureLZCNT,
+			FeatureMMX,
+			FeaturePCLMUL,
+			FeaturePOPCNT,
+			FeaturePRFCHW,
+			FeatureRDRND,
+			FeatureRDSEED,
+			FeatureRTM,
+			FeatureSSE,
+			FeatureSSE2,
+			FeatureSSE3,
+			FeatureSSE41,
+			FeatureSSE42,
+			FeatureSSE4A,
+			FeatureSSSE3,
+			FeatureTBM,
+			FeatureXOP,
+			
+			NumCPUFeatures
+		};
+		
+		static_assert(NumCPUFeatures <= 64,
+		              "CPU feature masks must fit in 64 bits.");
+		
+		/**
+		 * \brief Get the mask bit for a CPU feature.
+		 */
+		constexpr uint64_t getCPUFeatureMask(const CPUFeature feature) {
+			return uint64_t(1) << feature;
+		}
+		
 		class CPUFeatures {
 		public:
 			CPUFeatures();
 			
+			explicit CPUFeatures(uint64_t mask);
+			
+			void add(CPUFeature feature);
+			
+			/**
+			 * \brief Add a feature by its LLVM name.
+			 * 
+			 * Unknown names are ignored.
+			 */
 			void add(const std::string& feature);
 			
+			/**
+			 * \brief Remove a feature.
+			 * 
+			 * Features that depend on the removed feature are also
+			 * removed (e.g. removing 'avx' removes 'fma' and 'avx2').
+			 */
+			void remove(CPUFeature feature);
+			
+			bool has(CPUFeature feature) const;
+			
+			uint64_t mask() const;
+			
+			bool operator==(const CPUFeatures& other) const;
+			
+			bool operator!=(const CPUFeatures& other) const;
+			
 			bool hasAVX() const;
 			
+			bool hasAVX512F() const;
+			
 			SSELevel sseLevel() const;
 			
 		private:
-			std::set<std::string> features_;
-			SSELevel sseLevel_;
+			std::bitset<NumCPUFeatures> features_;
 			
 		};
 		
 		CPUFeatures getCPUFeatures(const llvm::Triple& targetTriple,
 		                           const CPUKind cpu);
 		
+		/**
+		 * \brief Get CPU features for a CPU name.
+		 * 
+		 * The name "native" selects the features of the host CPU (see
+		 * getHostCPUFeatures()); other names select the features of
+		 * the corresponding CPUKind.
+		 */
+		CPUFeatures getCPUFeatures(const llvm::Triple& targetTriple,
+		                           const std::string& cpuName);
+		
+		/**
+		 * \brief Get the host CPU's features.
+		 * 
+		 * Queries CPUID on x86 hosts, only reporting AVX and AVX-512
+		 * features if the OS saves the corresponding register state;
+		 * on other hosts no features are reported. This is computed
+		 * once per process.
+		 */
+		const CPUFeatures& getHostCPUFeatures();
+		
+		/**
+		 * \brief Apply LLVM target features.
+		 * 
+		 * Applies a comma separated list of LLVM target features, as
+		 * in a function's "target-features" attribute (e.g.
+		 * "+avx2,+fma,-avx512f"), to a base feature set. Unknown
+		 * features are ignored.
+		 */
+		CPUFeatures applyTargetFeatures(CPUFeatures features,
+		                                llvm::StringRef targetFeatures);
+		
 	}
 	
 }
@@ -1,9 +1,13 @@
 #ifndef LLVMABI_X86_64_CLASSIFIER_HPP
 #define LLVMABI_X86_64_CLASSIFIER_HPP
 
+#include <llvm/ADT/ArrayRef.h>
+
 #include <llvm-abi/ABITypeInfo.hpp>
 #include <llvm-abi/ArgInfo.hpp>
 #include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/RegisterUsage.hpp>
+#include <llvm-abi/x86/ArgClass.hpp>
 
 namespace llvm_abi {
 	
@@ -27,11 +31,34 @@ namespace llvm_abi {
 			
 			ArgInfo classifyReturnType(Type type);
 			
+			/// classifyRegCallStructType - Classify a struct for the
+			/// regcall convention, which expands it into its fields and
+			/// passes each one in registers; the registers needed are
+			/// summed into neededInt/neededSse.
+			ArgInfo classifyRegCallStructType(Type type,
+			                                  unsigned& neededInt,
+			                                  unsigned& neededSse);
+			
+			/// classifySwiftReturnType - Classify a return value for
+			/// the swift convention, which splits aggregates that the
+			/// C ABI would return in memory across up to four integer
+			/// and four SSE registers.
+			ArgInfo classifySwiftReturnType(Type type);
+			
 			llvm::SmallVector<ArgInfo, 8>
 			classifyFunctionType(const FunctionType& functionType,
-			                     llvm::ArrayRef<Type> argumentTypes);
+			                     llvm::ArrayRef<Type> argumentTypes,
+			                     RegisterUsage* registerUsage = nullptr);
 			
 		private:
+			ArgInfo classifyRegCallStructTypeImpl(Type type,
+			                                      unsigned& neededInt,
+			                                      unsigned& neededSse);
+			
+			bool classifySwiftEightbytes(Type type,
+			                             DataSize offset,
+			                             llvm::MutableArrayRef<ArgClass> classes);
+			
 			const ABITypeInfo& typeInfo_;
 			
 		};
@@ -0,0 +1,72 @@
+#ifndef LLVMABI_X86_FUNCTIONDISPATCHER_HPP
+#define LLVMABI_X86_FUNCTIONDISPATCHER_HPP
+
+#include <string>
+#include <utility>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+
+namespace llvm_abi {
+	
+	class ABI;
+	class FunctionType;
+	
+	namespace x86 {
+		
+		/**
+		 * \brief Function Version
+		 * 
+		 * A version of a function compiled for a set of target
+		 * features; the function must have been declared using the
+		 * ABI returned by ABI::withTargetFeatures() for them.
+		 */
+		struct FunctionVersion {
+			FunctionVersion(std::string argTargetFeatures,
+			                llvm::Function* const argFunction)
+			: targetFeatures(std::move(argTargetFeatures)),
+			function(argFunction) { }
+			
+			std::string targetFeatures;
+			llvm::Function* function;
+		};
+		
+		/**
+		 * \brief Create a function dispatcher.
+		 * 
+		 * Creates a function with the given ABI's lowering of the
+		 * function type, which calls the first of the versions whose
+		 * target features the running CPU supports (as reported by
+		 * the '__cpu_model' data of libgcc/compiler-rt). The last
+		 * version is the default and is called if no other version
+		 * is supported; its features aren't checked. Features that
+		 * '__cpu_model' doesn't report are accepted if every CPU has
+		 * them (e.g. 'x87') or they come with another listed feature
+		 * (e.g. 'f16c' with 'avx2'); otherwise an exception is thrown.
+		 * 
+		 * The choice is made on the first call and cached in a
+		 * table. Versions whose lowering differs from the given ABI
+		 * (e.g. because they pass vectors in YMM registers) are
+		 * called via bridge functions that decode the arguments and
+		 * re-encode them for the version; bridges get the version's
+		 * "target-features" so that they can do so.
+		 * 
+		 * \param abi The ABI for the dispatcher (e.g. the baseline).
+		 * \param module The module in which to create the dispatcher.
+		 * \param functionType The ABI function type.
+		 * \param name The dispatcher function name.
+		 * \param versions The function versions, in order of preference.
+		 * \return The dispatcher function.
+		 */
+		llvm::Function* createFunctionDispatcher(const ABI& abi,
+		                                         llvm::Module& module,
+		                                         const FunctionType& functionType,
+		                                         const std::string& name,
+		                                         llvm::ArrayRef<FunctionVersion> versions);
+		
+	}
+	
+}
+
+#endif
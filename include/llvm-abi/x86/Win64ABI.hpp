@@ -30,6 +30,13 @@ namespace llvm_abi {
 			
 			llvm::FunctionType* getFunctionType(const FunctionType& functionType) const;
 			
+			LoweringPlan getLoweringPlan(const FunctionType& functionType,
+			                             llvm::ArrayRef<Type> argumentTypes) const;
+			
+			std::vector<LoweredFunctionType>
+			lowerBatch(llvm::ArrayRef<FunctionType> functionTypes,
+			           unsigned numThreads) const;
+			
 			llvm::AttributeSet getAttributes(const FunctionType& functionType,
 			                                 llvm::ArrayRef<Type> argumentTypes,
 			                                 llvm::AttributeSet existingAttributes) const;
@@ -39,10 +46,34 @@ namespace llvm_abi {
 			                        std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
 			                        llvm::ArrayRef<TypedValue> arguments) const;
 			
+			bool isTailCallCompatible(const FunctionType& callerType,
+			                          const FunctionType& calleeType) const;
+			
+			llvm::Value* createTailCall(Builder& builder,
+			                            const FunctionType& functionType,
+			                            std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+			                            llvm::ArrayRef<TypedValue> arguments,
+			                            llvm::Value* returnValuePtr) const;
+			
+			llvm::Value* createInMemoryCall(Builder& builder,
+			                                const FunctionType& functionType,
+			                                std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+			                                llvm::ArrayRef<TypedValue> arguments,
+			                                llvm::Value* returnValuePtr) const;
+			
+			llvm::Value* createConstructingCall(Builder& builder,
+			                                    const FunctionType& functionType,
+			                                    std::function<void (size_t, llvm::Value*)> argumentConstructor,
+			                                    std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+			                                    llvm::ArrayRef<TypedValue> arguments,
+			                                    llvm::Value* returnValuePtr) const;
+			
 			std::unique_ptr<FunctionEncoder> createFunctionEncoder(Builder& builder,
 			                                                       const FunctionType& functionType,
 			                                                       llvm::ArrayRef<llvm::Value*> arguments) const;
 			
+			const ABI& withTargetFeatures(const std::string& targetFeatures) const;
+			
 		private:
 			llvm::LLVMContext& llvmContext_;
 			
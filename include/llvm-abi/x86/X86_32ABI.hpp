@@ -1,12 +1,14 @@
 #ifndef LLVMABI_X86_X86_32ABI_HPP
 #define LLVMABI_X86_X86_32ABI_HPP
 
+#include <memory>
 #include <vector>
 
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 
 #include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABITargetData.hpp>
 #include <llvm-abi/CallingConvention.hpp>
 #include <llvm-abi/Type.hpp>
 #include <llvm-abi/TypeBuilder.hpp>
@@ -20,7 +22,12 @@ namespace llvm_abi {
 		class X86_32ABI: public ABI {
 		public:
 			X86_32ABI(llvm::Module* module,
-			       llvm::Triple targetTriple);
+			       llvm::Triple targetTriple,
+			       unsigned numRegisterParameters = 0);
+			X86_32ABI(llvm::Module* module,
+			       llvm::Triple targetTriple,
+			       std::shared_ptr<const ABITargetData> targetData,
+			       unsigned numRegisterParameters = 0);
 			~X86_32ABI();
 			
 			std::string name() const;
@@ -31,6 +38,13 @@ namespace llvm_abi {
 			
 			llvm::FunctionType* getFunctionType(const FunctionType& functionType) const;
 			
+			LoweringPlan getLoweringPlan(const FunctionType& functionType,
+			                             llvm::ArrayRef<Type> argumentTypes) const;
+			
+			std::vector<LoweredFunctionType>
+			lowerBatch(llvm::ArrayRef<FunctionType> functionTypes,
+			           unsigned numThreads) const;
+			
 			llvm::AttributeSet getAttributes(const FunctionType& functionType,
 			                                 llvm::ArrayRef<Type> argumentTypes,
 			                                 llvm::AttributeSet existingAttributes) const;
@@ -40,15 +54,40 @@ namespace llvm_abi {
 			                        std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
 			                        llvm::ArrayRef<TypedValue> arguments) const;
 			
+			bool isTailCallCompatible(const FunctionType& callerType,
+			                          const FunctionType& calleeType) const;
+			
+			llvm::Value* createTailCall(Builder& builder,
+			                            const FunctionType& functionType,
+			                            std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+			                            llvm::ArrayRef<TypedValue> arguments,
+			                            llvm::Value* returnValuePtr) const;
+			
+			llvm::Value* createInMemoryCall(Builder& builder,
+			                                const FunctionType& functionType,
+			                                std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+			                                llvm::ArrayRef<TypedValue> arguments,
+			                                llvm::Value* returnValuePtr) const;
+			
+			llvm::Value* createConstructingCall(Builder& builder,
+			                                    const FunctionType& functionType,
+			                                    std::function<void (size_t, llvm::Value*)> argumentConstructor,
+			                                    std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+			                                    llvm::ArrayRef<TypedValue> arguments,
+			                                    llvm::Value* returnValuePtr) const;
+			
 			std::unique_ptr<FunctionEncoder>
 			createFunctionEncoder(Builder& builder,
 			                      const FunctionType& functionType,
 			                      llvm::ArrayRef<llvm::Value*> arguments) const;
 			
+			const ABI& withTargetFeatures(const std::string& targetFeatures) const;
+			
 		private:
 			llvm::LLVMContext& llvmContext_;
 			llvm::Triple targetTriple_;
-			TypeBuilder typeBuilder_;
+			unsigned numRegisterParameters_;
+			std::shared_ptr<const ABITargetData> targetData_;
 			X86_32ABITypeInfo typeInfo_;
 			
 		};
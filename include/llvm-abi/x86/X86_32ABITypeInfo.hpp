@@ -4,7 +4,9 @@
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 
+#include <llvm-abi/ABITargetData.hpp>
 #include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/ConcurrentCache.hpp>
 #include <llvm-abi/DefaultABITypeInfo.hpp>
 #include <llvm-abi/Type.hpp>
 #include <llvm-abi/TypeBuilder.hpp>
@@ -16,7 +18,16 @@ namespace llvm_abi {
 		class X86_32ABITypeInfo: public ABITypeInfo,
 		                         public DefaultABITypeInfoDelegate {
 		public:
-			X86_32ABITypeInfo(llvm::LLVMContext& llvmContext);
+			X86_32ABITypeInfo(llvm::LLVMContext& llvmContext,
+			                  const ABITargetData& targetData);
+			
+			/**
+			 * \brief Create layout-only type information.
+			 * 
+			 * This doesn't need an LLVM context, but getLLVMType()
+			 * isn't available.
+			 */
+			X86_32ABITypeInfo(const ABITargetData& targetData);
 			
 			const TypeBuilder& typeBuilder() const;
 			
@@ -37,6 +48,8 @@ namespace llvm_abi {
 			
 			bool isLegalVectorType(Type type) const;
 			
+			DataSize getMaxCopyUnitSize() const;
+			
 			bool isBigEndian() const;
 			
 			bool isCharSigned() const;
@@ -64,9 +77,9 @@ namespace llvm_abi {
 			llvm::Type* getLongDoubleIRType() const;
 			
 		private:
-			llvm::LLVMContext& llvmContext_;
-			TypeBuilder typeBuilder_;
+			const ABITargetData& targetData_;
 			DefaultABITypeInfo defaultABITypeInfo_;
+			mutable ConcurrentCache<Type, llvm::Type*> llvmTypeCache_;
 			
 		};
 		
@@ -7,6 +7,7 @@
 #include <llvm-abi/ArgInfo.hpp>
 #include <llvm-abi/CallingConvention.hpp>
 #include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/RegisterUsage.hpp>
 #include <llvm-abi/TypeBuilder.hpp>
 
 namespace llvm_abi {
@@ -32,7 +33,8 @@ namespace llvm_abi {
 			
 			X86_32Classifier(const ABITypeInfo& typeInfo,
 			                 const TypeBuilder& typeBuilder,
-			                 llvm::Triple targetTriple);
+			                 llvm::Triple targetTriple,
+			                 unsigned numRegisterParameters = 0);
 			
 			bool isDarwinVectorABI() const;
 			bool isSmallStructInRegABI() const;
@@ -76,14 +78,36 @@ namespace llvm_abi {
 			ArgInfo classifyArgumentType(Type type,
 			                             CCState& state) const;
 			
+			/// addFieldToArgStruct - Add a field for an argument to the inalloca
+			/// argument struct, followed by any padding needed to keep the next
+			/// field aligned to a stack slot.
+			void addFieldToArgStruct(llvm::SmallVectorImpl<Type>& fieldTypes,
+			                         DataSize& stackOffset,
+			                         ArgInfo& argInfo,
+			                         Type type) const;
+			
+			/// rewriteWithInAlloca - Rewrite all the memory arguments of a
+			/// function to be fields of a single inalloca argument struct.
+			void rewriteWithInAlloca(const FunctionType& functionType,
+			                         llvm::ArrayRef<Type> argumentTypes,
+			                         llvm::SmallVectorImpl<ArgInfo>& argInfoArray,
+			                         llvm::SmallVectorImpl<Type>& inallocaFieldTypes) const;
+			
 			llvm::SmallVector<ArgInfo, 8>
 			classifyFunctionType(const FunctionType& functionType,
 			                     llvm::ArrayRef<Type> argumentTypes) const;
 			
+			llvm::SmallVector<ArgInfo, 8>
+			classifyFunctionType(const FunctionType& functionType,
+			                     llvm::ArrayRef<Type> argumentTypes,
+			                     llvm::SmallVectorImpl<Type>& inallocaFieldTypes,
+			                     RegisterUsage* registerUsage = nullptr) const;
+			
 		private:
 			const ABITypeInfo& typeInfo_;
 			const TypeBuilder& typeBuilder_;
 			llvm::Triple targetTriple_;
+			unsigned numRegisterParameters_;
 			
 		};
 		
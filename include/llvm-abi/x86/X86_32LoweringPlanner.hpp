@@ -0,0 +1,71 @@
+#ifndef LLVMABI_X86_X86_32LOWERINGPLANNER_HPP
+#define LLVMABI_X86_X86_32LOWERINGPLANNER_HPP
+
+#include <memory>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/Triple.h>
+
+#include <llvm-abi/ABITargetData.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/LoweringPlan.hpp>
+#include <llvm-abi/Type.hpp>
+#include <llvm-abi/TypeBuilder.hpp>
+
+#include <llvm-abi/x86/X86_32ABITypeInfo.hpp>
+
+namespace llvm_abi {
+	
+	class ABITypeInfo;
+	
+	namespace x86 {
+		
+		/**
+		 * \brief Get an x86 (32-bit) lowering plan.
+		 * 
+		 * Plans are cached in the target data, keyed by the function
+		 * type, the argument types and the number of register
+		 * parameters (the target data is only shared by ABIs for the
+		 * same target triple).
+		 * 
+		 * \param typeInfo The ABI type information.
+		 * \param targetData The target data (with the type builder
+		 *                   for inalloca structs).
+		 * \param targetTriple The target triple.
+		 * \param numRegisterParameters The number of 'inreg'
+		 *                              parameters (i.e. -mregparm).
+		 * \param functionType The ABI function type.
+		 * \param argumentTypes The (already promoted) argument types.
+		 * \return The lowering plan.
+		 */
+		LoweringPlan getX86_32LoweringPlan(const ABITypeInfo& typeInfo,
+		                                   const ABITargetData& targetData,
+		                                   const llvm::Triple& targetTriple,
+		                                   unsigned numRegisterParameters,
+		                                   const FunctionType& functionType,
+		                                   llvm::ArrayRef<Type> argumentTypes);
+		
+		class X86_32LoweringPlanner: public LoweringPlanner {
+		public:
+			X86_32LoweringPlanner(const llvm::Triple& targetTriple,
+			                      std::shared_ptr<const ABITargetData> targetData,
+			                      unsigned numRegisterParameters = 0);
+			
+			const ABITypeInfo& typeInfo() const;
+			
+			LoweringPlan getLoweringPlan(const FunctionType& functionType,
+			                             llvm::ArrayRef<Type> argumentTypes) const;
+			
+		private:
+			llvm::Triple targetTriple_;
+			unsigned numRegisterParameters_;
+			std::shared_ptr<const ABITargetData> targetData_;
+			X86_32ABITypeInfo typeInfo_;
+			
+		};
+		
+	}
+	
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef LLVMABI_X86_X86_32VAARG_HPP
+#define LLVMABI_X86_X86_32VAARG_HPP
+
+#include <llvm/IR/Value.h>
+
+#include <llvm-abi/Type.hpp>
+
+namespace llvm_abi {
+	
+	class ABITypeInfo;
+	class Builder;
+	
+	namespace x86 {
+		
+		class X86_32Classifier;
+		
+		/**
+		 * \brief Emit an x86_32 'va_arg'.
+		 * 
+		 * On x86_32 a va_list is a pointer into the argument area, so
+		 * this loads the value at the current position (realigned as
+		 * per X86_32Classifier::getTypeStackAlignInBytes(), which
+		 * accounts for the Darwin vector ABI) and advances the
+		 * pointer past it in 4 byte slots.
+		 * 
+		 * \param classifier The x86_32 classifier.
+		 * \param typeInfo The ABI type information.
+		 * \param builder The IR builder.
+		 * \param vaList Pointer to the va_list.
+		 * \param type The (promoted) argument type.
+		 * \return The argument value.
+		 */
+		llvm::Value* emitX86_32VAArg(const X86_32Classifier& classifier,
+		                             const ABITypeInfo& typeInfo,
+		                             Builder& builder,
+		                             llvm::Value* vaList,
+		                             Type type);
+		
+		/**
+		 * \brief Emit an x86_32 'va_copy'.
+		 * 
+		 * \param builder The IR builder.
+		 * \param destVaList Pointer to the destination va_list.
+		 * \param sourceVaList Pointer to the source va_list.
+		 */
+		void emitX86_32VACopy(Builder& builder,
+		                      llvm::Value* destVaList,
+		                      llvm::Value* sourceVaList);
+		
+	}
+	
+}
+
+#endif
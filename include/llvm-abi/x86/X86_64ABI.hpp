@@ -1,6 +1,9 @@
 #ifndef LLVMABI_X86_64_X86_64ABI_HPP
 #define LLVMABI_X86_64_X86_64ABI_HPP
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -10,6 +13,7 @@
 #include <llvm/IR/Value.h>
 
 #include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABITargetData.hpp>
 #include <llvm-abi/CallingConvention.hpp>
 #include <llvm-abi/Type.hpp>
 
@@ -21,14 +25,15 @@ namespace llvm_abi {
 	
 	namespace x86 {
 		
-		using ABISizeCache = std::unordered_map<Type, size_t>;
-		using ABITypeCache = std::unordered_map<Type, llvm::Type*>;
-		
 		class X86_64ABI: public ABI {
 		public:
 			X86_64ABI(llvm::Module* module,
 			          const llvm::Triple& targetTriple,
 			          const std::string& cpuName);
+			X86_64ABI(llvm::Module* module,
+			          CPUKind cpuKind,
+			          const CPUFeatures& cpuFeatures,
+			          std::shared_ptr<const ABITargetData> targetData);
 			~X86_64ABI();
 			
 			llvm::LLVMContext& context() const {
@@ -47,6 +52,13 @@ namespace llvm_abi {
 			
 			llvm::FunctionType* getFunctionType(const FunctionType& functionType) const;
 			
+			LoweringPlan getLoweringPlan(const FunctionType& functionType,
+			                             llvm::ArrayRef<Type> argumentTypes) const;
+			
+			std::vector<LoweredFunctionType>
+			lowerBatch(llvm::ArrayRef<FunctionType> functionTypes,
+			           unsigned numThreads) const;
+			
 			llvm::AttributeSet getAttributes(const FunctionType& functionType,
 			                                 llvm::ArrayRef<Type> argumentTypes,
 		                                         llvm::AttributeSet existingAttributes) const;
@@ -56,20 +68,44 @@ namespace llvm_abi {
 			                        std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
 			                        llvm::ArrayRef<TypedValue> arguments) const;
 			
+			bool isTailCallCompatible(const FunctionType& callerType,
+			                          const FunctionType& calleeType) const;
+			
+			llvm::Value* createTailCall(Builder& builder,
+			                            const FunctionType& functionType,
+			                            std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+			                            llvm::ArrayRef<TypedValue> arguments,
+			                            llvm::Value* returnValuePtr) const;
+			
+			llvm::Value* createInMemoryCall(Builder& builder,
+			                                const FunctionType& functionType,
+			                                std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+			                                llvm::ArrayRef<TypedValue> arguments,
+			                                llvm::Value* returnValuePtr) const;
+			
+			llvm::Value* createConstructingCall(Builder& builder,
+			                                    const FunctionType& functionType,
+			                                    std::function<void (size_t, llvm::Value*)> argumentConstructor,
+			                                    std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+			                                    llvm::ArrayRef<TypedValue> arguments,
+			                                    llvm::Value* returnValuePtr) const;
+			
 			std::unique_ptr<FunctionEncoder>
 			createFunctionEncoder(Builder& builder,
 			                      const FunctionType& functionType,
 			                      llvm::ArrayRef<llvm::Value*> arguments) const;
 			
+			const ABI& withTargetFeatures(const std::string& targetFeatures) const;
+			
 		private:
 			llvm::LLVMContext& llvmContext_;
 			CPUKind cpuKind_;
 			CPUFeatures cpuFeatures_;
 			llvm::Module* module_;
+			std::shared_ptr<const ABITargetData> targetData_;
 			X86_64ABITypeInfo typeInfo_;
-			mutable ABITypeCache abiTypeCache_;
-			mutable ABISizeCache alignOfCache_;
-			mutable ABISizeCache sizeOfCache_;
+			mutable std::mutex featureABICacheMutex_;
+			mutable std::unordered_map<uint64_t, std::unique_ptr<X86_64ABI>> featureABICache_;
 			
 		};
 		
@@ -6,7 +6,9 @@
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 
+#include <llvm-abi/ABITargetData.hpp>
 #include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/ConcurrentCache.hpp>
 #include <llvm-abi/DefaultABITypeInfo.hpp>
 #include <llvm-abi/Type.hpp>
 #include <llvm-abi/TypeBuilder.hpp>
@@ -21,10 +23,24 @@ namespace llvm_abi {
 		                         public DefaultABITypeInfoDelegate {
 		public:
 			X86_64ABITypeInfo(llvm::LLVMContext& llvmContext,
-			                  const CPUFeatures& cpuFeatures);
+			                  const CPUFeatures& cpuFeatures,
+			                  const ABITargetData& targetData);
+			
+			/**
+			 * \brief Create layout-only type information.
+			 * 
+			 * This doesn't need an LLVM context, but getLLVMType()
+			 * isn't available.
+			 */
+			X86_64ABITypeInfo(const CPUFeatures& cpuFeatures,
+			                  const ABITargetData& targetData);
 			
 			const TypeBuilder& typeBuilder() const;
 			
+			const CPUFeatures& cpuFeatures() const;
+			
+			const ABITargetData& targetData() const;
+			
 			DataSize getTypeRawSize(Type type) const;
 			
 			DataSize getTypeAllocSize(Type type) const;
@@ -42,6 +58,10 @@ namespace llvm_abi {
 			
 			bool isLegalVectorType(Type type) const;
 			
+			DataSize getNativeVectorSize() const;
+			
+			DataSize getMaxCopyUnitSize() const;
+			
 			bool isBigEndian() const;
 			
 			bool isCharSigned() const;
@@ -73,10 +93,10 @@ namespace llvm_abi {
 			llvm::Type* getLongDoubleIRType() const;
 			
 		private:
-			llvm::LLVMContext& llvmContext_;
 			const CPUFeatures& cpuFeatures_;
-			TypeBuilder typeBuilder_;
+			const ABITargetData& targetData_;
 			DefaultABITypeInfo defaultABITypeInfo_;
+			mutable ConcurrentCache<Type, llvm::Type*> llvmTypeCache_;
 		};
 		
 	}
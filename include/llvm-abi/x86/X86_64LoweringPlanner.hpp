@@ -0,0 +1,59 @@
+#ifndef LLVMABI_X86_X86_64LOWERINGPLANNER_HPP
+#define LLVMABI_X86_X86_64LOWERINGPLANNER_HPP
+
+#include <memory>
+
+#include <llvm/ADT/ArrayRef.h>
+
+#include <llvm-abi/ABITargetData.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/LoweringPlan.hpp>
+#include <llvm-abi/Type.hpp>
+
+#include <llvm-abi/x86/CPUFeatures.hpp>
+#include <llvm-abi/x86/X86_64ABITypeInfo.hpp>
+
+namespace llvm_abi {
+	
+	class ABITypeInfo;
+	
+	namespace x86 {
+		
+		/**
+		 * \brief Get an x86_64 lowering plan.
+		 * 
+		 * Plans are cached in the type information's target data,
+		 * keyed by the function type, the argument types and the
+		 * CPU features.
+		 * 
+		 * \param typeInfo The ABI type information.
+		 * \param functionType The ABI function type.
+		 * \param argumentTypes The (already promoted) argument types.
+		 * \return The lowering plan.
+		 */
+		LoweringPlan getX86_64LoweringPlan(const X86_64ABITypeInfo& typeInfo,
+		                                   const FunctionType& functionType,
+		                                   llvm::ArrayRef<Type> argumentTypes);
+		
+		class X86_64LoweringPlanner: public LoweringPlanner {
+		public:
+			X86_64LoweringPlanner(const CPUFeatures& cpuFeatures,
+			                      std::shared_ptr<const ABITargetData> targetData);
+			
+			const ABITypeInfo& typeInfo() const;
+			
+			LoweringPlan getLoweringPlan(const FunctionType& functionType,
+			                             llvm::ArrayRef<Type> argumentTypes) const;
+			
+		private:
+			CPUFeatures cpuFeatures_;
+			std::shared_ptr<const ABITargetData> targetData_;
+			X86_64ABITypeInfo typeInfo_;
+			
+		};
+		
+	}
+	
+}
+
+#endif
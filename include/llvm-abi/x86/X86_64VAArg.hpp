@@ -0,0 +1,69 @@
+#ifndef LLVMABI_X86_64_X86_64VAARG_HPP
+#define LLVMABI_X86_64_X86_64VAARG_HPP
+
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Type.h>
+#include <llvm/IR/Value.h>
+
+#include <llvm-abi/Type.hpp>
+
+namespace llvm_abi {
+	
+	class ABITypeInfo;
+	class Builder;
+	
+	namespace x86 {
+		
+		/**
+		 * \brief Get the x86_64 va_list type.
+		 * 
+		 * AMD64-ABI 3.5.7p5: a one element array of the va_list
+		 * structure, so that it decays to a pointer.
+		 * 
+		 * \param context The LLVM context.
+		 * \return The va_list type.
+		 */
+		llvm::Type* getX86_64VAListType(llvm::LLVMContext& context);
+		
+		/**
+		 * \brief Emit an x86_64 'va_arg'.
+		 * 
+		 * Emits the System V (AMD64-ABI 3.5.7) 'va_arg' sequence
+		 * inline: the value is loaded from the register save area
+		 * if enough registers remain (per the Classifier's decision
+		 * for the type) and otherwise from the overflow area, rather
+		 * than relying on LLVM's 'va_arg' instruction (which doesn't
+		 * handle aggregates).
+		 * 
+		 * \param typeInfo The ABI type information.
+		 * \param builder The IR builder.
+		 * \param vaList Pointer to the va_list.
+		 * \param type The (promoted) argument type.
+		 * \return The argument value.
+		 */
+		llvm::Value* emitX86_64VAArg(const ABITypeInfo& typeInfo,
+		                             Builder& builder,
+		                             llvm::Value* vaList,
+		                             Type type);
+		
+		/**
+		 * \brief Emit an x86_64 'va_copy'.
+		 * 
+		 * Copies the va_list's offsets and area pointers with plain
+		 * loads and stores.
+		 * 
+		 * \param typeInfo The ABI type information.
+		 * \param builder The IR builder.
+		 * \param destVaList Pointer to the destination va_list.
+		 * \param sourceVaList Pointer to the source va_list.
+		 */
+		void emitX86_64VACopy(const ABITypeInfo& typeInfo,
+		                      Builder& builder,
+		                      llvm::Value* destVaList,
+		                      llvm::Value* sourceVaList);
+		
+	}
+	
+}
+
+#endif
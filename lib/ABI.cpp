@@ -2,6 +2,9 @@
 #include <stdexcept>
 #include <string>
 
+#include <llvm/IR/Attributes.h>
+#include <llvm/IR/Function.h>
+
 #include <llvm-abi/ABI.hpp>
 
 #include <llvm-abi/x86/Win64ABI.hpp>
@@ -35,5 +38,16 @@ namespace llvm_abi {
 		throw std::runtime_error(errorString);
 	}
 	
+	const ABI& getFunctionABI(const ABI& abi,
+	                          const llvm::Function& function) {
+		const auto attribute = function.getAttributes().getAttribute(llvm::AttributeSet::FunctionIndex,
+		                                                             "target-features");
+		if (!attribute.isStringAttribute()) {
+			return abi;
+		}
+		
+		return abi.withTargetFeatures(attribute.getValueAsString());
+	}
+	
 }
 
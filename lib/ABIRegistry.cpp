@@ -0,0 +1,114 @@
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/Module.h>
+
+#include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABIRegistry.hpp>
+#include <llvm-abi/ABITargetData.hpp>
+#include <llvm-abi/LoweringPlan.hpp>
+
+#include <llvm-abi/x86/CPUFeatures.hpp>
+#include <llvm-abi/x86/CPUKind.hpp>
+#include <llvm-abi/x86/Win64ABI.hpp>
+#include <llvm-abi/x86/X86_32ABI.hpp>
+#include <llvm-abi/x86/X86_32LoweringPlanner.hpp>
+#include <llvm-abi/x86/X86_64ABI.hpp>
+#include <llvm-abi/x86/X86_64LoweringPlanner.hpp>
+
+namespace llvm_abi {
+	
+	struct ABIRegistry::Target {
+		x86::CPUKind cpuKind;
+		x86::CPUFeatures cpuFeatures;
+		std::shared_ptr<const ABITargetData> targetData;
+	};
+	
+	ABIRegistry::ABIRegistry() { }
+	
+	ABIRegistry::~ABIRegistry() { }
+	
+	const ABIRegistry::Target&
+	ABIRegistry::getTarget(const llvm::Triple& targetTriple,
+	                       const std::string& cpuName) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		
+		// Targets are never removed or modified once created, so
+		// the reference remains valid after the lock is released.
+		auto& target = targets_[std::make_pair(targetTriple.str(),
+		                                       cpuName)];
+		if (target == nullptr) {
+			target.reset(new Target());
+			if (targetTriple.getArch() == llvm::Triple::x86_64) {
+				target->cpuKind = x86::getCPUKind(targetTriple,
+				                                  cpuName);
+				target->cpuFeatures = x86::getCPUFeatures(targetTriple,
+				                                          cpuName);
+			}
+			target->targetData = std::make_shared<ABITargetData>();
+		}
+		return *target;
+	}
+	
+	std::unique_ptr<ABI> ABIRegistry::createABI(llvm::Module& module,
+	                                            const llvm::Triple& targetTriple,
+	                                            const std::string& cpuName) {
+		switch (targetTriple.getArch()) {
+			case llvm::Triple::x86: {
+				const auto& target = getTarget(targetTriple, cpuName);
+				return std::unique_ptr<ABI>(new x86::X86_32ABI(&module,
+				                                               targetTriple,
+				                                               target.targetData));
+			}
+			case llvm::Triple::x86_64: {
+				if (targetTriple.isOSWindows()) {
+					// Win64 doesn't have any target data to share.
+					return std::unique_ptr<ABI>(new x86::Win64ABI(&module));
+				}
+				
+				const auto& target = getTarget(targetTriple, cpuName);
+				return std::unique_ptr<ABI>(new x86::X86_64ABI(&module,
+				                                               target.cpuKind,
+				                                               target.cpuFeatures,
+				                                               target.targetData));
+			}
+			default:
+				// Reports the unsupported triple.
+				return llvm_abi::createABI(module, targetTriple, cpuName);
+		}
+	}
+	
+	std::unique_ptr<LoweringPlanner>
+	ABIRegistry::createLoweringPlanner(const llvm::Triple& targetTriple,
+	                                   const std::string& cpuName) {
+		switch (targetTriple.getArch()) {
+			case llvm::Triple::x86: {
+				const auto& target = getTarget(targetTriple, cpuName);
+				return std::unique_ptr<LoweringPlanner>(
+					new x86::X86_32LoweringPlanner(targetTriple,
+					                               target.targetData));
+			}
+			case llvm::Triple::x86_64: {
+				if (targetTriple.isOSWindows()) {
+					break;
+				}
+				
+				const auto& target = getTarget(targetTriple, cpuName);
+				return std::unique_ptr<LoweringPlanner>(
+					new x86::X86_64LoweringPlanner(target.cpuFeatures,
+					                               target.targetData));
+			}
+			default:
+				break;
+		}
+		
+		// Reports the unsupported triple.
+		return llvm_abi::createLoweringPlanner(targetTriple, cpuName);
+	}
+	
+}
+
@@ -0,0 +1,25 @@
+#include <llvm-abi/ABILayoutCache.hpp>
+#include <llvm-abi/ABITargetData.hpp>
+#include <llvm-abi/LoweringPlanCache.hpp>
+#include <llvm-abi/TypeBuilder.hpp>
+
+namespace llvm_abi {
+	
+	ABITargetData::ABITargetData() { }
+	
+	ABITargetData::~ABITargetData() { }
+	
+	const TypeBuilder& ABITargetData::typeBuilder() const {
+		return typeBuilder_;
+	}
+	
+	ABILayoutCache& ABITargetData::layoutCache() const {
+		return layoutCache_;
+	}
+	
+	LoweringPlanCache& ABITargetData::loweringPlanCache() const {
+		return loweringPlanCache_;
+	}
+	
+}
+
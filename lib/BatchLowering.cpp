@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/IR/Attributes.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/LLVMContext.h>
+
+#include <llvm-abi/ABI.hpp>
+#include <llvm-abi/BatchLowering.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/LoweringPlan.hpp>
+
+namespace llvm_abi {
+	
+	// Number of function types classified per task; large enough
+	// that stealing is rare, small enough to balance the load.
+	static const size_t ChunkSize = 64;
+	
+	namespace {
+		
+		/**
+		 * \brief Work-stealing queue of index ranges.
+		 * 
+		 * The owner takes chunks from the back of its queue while
+		 * other workers steal from the front, so they only contend
+		 * once the owner's work is nearly done.
+		 */
+		class WorkQueue {
+		public:
+			void push(const std::pair<size_t, size_t> range) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				ranges_.push_back(range);
+			}
+			
+			bool pop(std::pair<size_t, size_t>& range) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				if (ranges_.empty()) {
+					return false;
+				}
+				range = ranges_.back();
+				ranges_.pop_back();
+				return true;
+			}
+			
+			bool steal(std::pair<size_t, size_t>& range) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				if (ranges_.empty()) {
+					return false;
+				}
+				range = ranges_.front();
+				ranges_.pop_front();
+				return true;
+			}
+			
+		private:
+			std::mutex mutex_;
+			std::deque<std::pair<size_t, size_t>> ranges_;
+			
+		};
+		
+	}
+	
+	template <typename PlanFn>
+	static std::vector<LoweringPlan>
+	computeLoweringPlans(llvm::ArrayRef<FunctionType> functionTypes,
+	                     const unsigned requestedThreads,
+	                     PlanFn planFn) {
+		const size_t numChunks = (functionTypes.size() + ChunkSize - 1) / ChunkSize;
+		const size_t numThreads = std::min<size_t>(requestedThreads != 0 ?
+		                                           requestedThreads :
+		                                           std::max<unsigned>(std::thread::hardware_concurrency(), 1),
+		                                           numChunks);
+		
+		if (numThreads <= 1) {
+			std::vector<LoweringPlan> plans;
+			plans.reserve(functionTypes.size());
+			for (const auto& functionType: functionTypes) {
+				plans.push_back(planFn(functionType));
+			}
+			return plans;
+		}
+		
+		// LoweringPlan isn't default constructible, so workers fill
+		// slots that are moved into the result afterwards.
+		std::vector<std::unique_ptr<LoweringPlan>> results(functionTypes.size());
+		
+		// Give each worker a contiguous block of chunks, so
+		// neighbouring (and often similar) signatures are
+		// classified on the same thread.
+		std::vector<WorkQueue> queues(numThreads);
+		for (size_t i = 0; i < numChunks; i++) {
+			const size_t begin = i * ChunkSize;
+			const size_t end = std::min(begin + ChunkSize, functionTypes.size());
+			queues[i * numThreads / numChunks].push(std::make_pair(begin, end));
+		}
+		
+		std::vector<std::exception_ptr> errors(numThreads);
+		
+		const auto worker = [&](const size_t workerIndex) {
+			try {
+				std::pair<size_t, size_t> range;
+				while (true) {
+					bool found = queues[workerIndex].pop(range);
+					for (size_t i = 1; !found && i < numThreads; i++) {
+						found = queues[(workerIndex + i) % numThreads].steal(range);
+					}
+					
+					// Tasks never create more tasks, so once every
+					// queue is empty there's nothing left to do.
+					if (!found) {
+						return;
+					}
+					
+					for (size_t i = range.first; i < range.second; i++) {
+						results[i].reset(new LoweringPlan(planFn(functionTypes[i])));
+					}
+				}
+			} catch (...) {
+				errors[workerIndex] = std::current_exception();
+			}
+		};
+		
+		std::vector<std::thread> threads;
+		for (size_t i = 1; i < numThreads; i++) {
+			threads.push_back(std::thread(worker, i));
+		}
+		worker(0);
+		for (auto& thread: threads) {
+			thread.join();
+		}
+		
+		for (const auto& error: errors) {
+			if (error) {
+				std::rethrow_exception(error);
+			}
+		}
+		
+		std::vector<LoweringPlan> plans;
+		plans.reserve(functionTypes.size());
+		for (auto& result: results) {
+			plans.push_back(std::move(*result));
+		}
+		return plans;
+	}
+	
+	std::vector<LoweringPlan>
+	getLoweringPlans(const ABI& abi,
+	                 llvm::ArrayRef<FunctionType> functionTypes,
+	                 const unsigned numThreads) {
+		return computeLoweringPlans(functionTypes, numThreads,
+			[&](const FunctionType& functionType) {
+				return abi.getLoweringPlan(functionType,
+				                           functionType.argumentTypes());
+			});
+	}
+	
+	std::vector<LoweringPlan>
+	getLoweringPlans(const LoweringPlanner& planner,
+	                 llvm::ArrayRef<FunctionType> functionTypes,
+	                 const unsigned numThreads) {
+		return computeLoweringPlans(functionTypes, numThreads,
+			[&](const FunctionType& functionType) {
+				return planner.getLoweringPlan(functionType,
+				                               functionType.argumentTypes());
+			});
+	}
+	
+	std::vector<LoweredFunctionType>
+	lowerBatch(llvm::LLVMContext& context,
+	           const ABI& abi,
+	           llvm::ArrayRef<FunctionType> functionTypes,
+	           const unsigned numThreads) {
+		const auto plans = getLoweringPlans(abi, functionTypes, numThreads);
+		
+		std::vector<LoweredFunctionType> loweredTypes;
+		loweredTypes.reserve(plans.size());
+		for (const auto& plan: plans) {
+			LoweredFunctionType loweredType;
+			loweredType.functionType = getFunctionType(context,
+			                                           abi.typeInfo(),
+			                                           plan);
+			loweredType.attributes = getFunctionAttributes(context,
+			                                               abi.typeInfo(),
+			                                               plan,
+			                                               llvm::AttributeSet());
+			loweredTypes.push_back(loweredType);
+		}
+		return loweredTypes;
+	}
+	
+}
+
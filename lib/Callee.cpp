@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <llvm-abi/ABITypeInfo.hpp>
 #include <llvm-abi/Builder.hpp>
 #include <llvm-abi/Callee.hpp>
@@ -191,10 +193,8 @@ namespace llvm_abi {
 			const auto casted = builder.getBuilder().CreateBitCast(tmpAlloca, i8PtrType);
 			const auto sourceCasted = builder.getBuilder().CreateBitCast(sourcePtr, i8PtrType);
 			// FIXME: Use better alignment.
-			builder.getBuilder().CreateMemCpy(casted, sourceCasted,
-			                                  llvm::ConstantInt::get(typeInfo.getLLVMType(IntPtrTy),
-			                                                         sourceSize.asBytes()),
-			                                  1, false);
+			createMemCpy(typeInfo, builder, casted, sourceCasted,
+			             sourceSize, 1);
 			return builder.getBuilder().CreateLoad(tmpAlloca);
 		}
 	}
@@ -301,11 +301,8 @@ namespace llvm_abi {
 			const auto casted = builder.getBuilder().CreateBitCast(tempAlloca, i8PtrType);
 			const auto destCasted = builder.getBuilder().CreateBitCast(destPtr, i8PtrType);
 			// FIXME: Use better alignment.
-			builder.getBuilder().CreateMemCpy(destCasted,
-			                                  casted,
-			                                  llvm::ConstantInt::get(typeInfo.getLLVMType(IntPtrTy),
-			                                                         destSize.asBytes()),
-			                                  1, false);
+			createMemCpy(typeInfo, builder, destCasted, casted,
+			             destSize, 1);
 		}
 	}
 	
@@ -375,7 +372,15 @@ namespace llvm_abi {
 			expandTypeFromArgs(typeInfo, builder, largestType,
 			                   castAddress, iterator);
 		} else if (type.isComplex()) {
-			llvm_unreachable("TODO");
+			const auto elementAlign = typeInfo.getTypeRequiredAlign(type.complexFloatingPointType());
+			for (unsigned i = 0; i < 2; i++) {
+				const auto partAddress = createConstGEP2_32(builder,
+				                                            typeInfo.getLLVMType(type),
+				                                            alloca,
+				                                            0, i);
+				const auto storeInst = createStore(builder.getBuilder(), *iterator++, partAddress);
+				storeInst->setAlignment(elementAlign.asBytes());
+			}
 		} else {
 			const auto value = *iterator++;
 			const auto storeInst = createStore(builder.getBuilder(), value, alloca);
@@ -393,17 +398,10 @@ namespace llvm_abi {
 	builder_(builder) { }
 	
 	llvm::SmallVector<llvm::Value*, 8>
-	Callee::decodeArguments(llvm::ArrayRef<llvm::Value*> encodedArguments) {
+	Callee::decodeArguments(llvm::ArrayRef<llvm::Value*> encodedArguments,
+	                        const bool inMemory) {
 		assert(functionIRMapping_.totalIRArgs() == encodedArguments.size());
 		
-		// If we're using inalloca, all the memory arguments are GEPs off of the last
-		// parameter, which is a pointer to the complete memory area.
-		llvm::Value* argStruct = nullptr;
-		if (functionIRMapping_.hasInallocaArg()) {
-			argStruct = encodedArguments[functionIRMapping_.inallocaArgIndex()];
-			//assert(argStruct->getType() == FI.getArgStruct()->getPointerTo());
-		}
-		
 		// Name the struct return parameter.
 		if (functionIRMapping_.hasStructRetArg()) {
 			const auto structRetArgValue = encodedArguments[functionIRMapping_.structRetArgIndex()];
@@ -413,218 +411,325 @@ namespace llvm_abi {
 		llvm::SmallVector<llvm::Value*, 8> arguments;
 		
 		for (size_t argIndex = 0; argIndex < functionType_.argumentTypes().size(); argIndex++) {
-			const auto& argumentType = functionType_.argumentTypes()[argIndex];
-			const auto& argInfo = functionIRMapping_.arguments()[argIndex].argInfo;
-			
-			unsigned firstIRArg, numIRArgs;
-			std::tie(firstIRArg, numIRArgs) = functionIRMapping_.getIRArgRange(argIndex);
-			
-			switch (argInfo.getKind()) {
-				case ArgInfo::InAlloca: {
-					assert(numIRArgs == 0);
-					const auto value = createStructGEP(builder_,
-					                                   argStruct->getType()->getPointerElementType(),
-					                                   argStruct,
-					                                   argInfo.getInAllocaFieldIndex(),
-					                                   "inalloca.arg");
-					arguments.push_back(value);
-					break;
+			arguments.push_back(decodeArgument(argIndex, encodedArguments,
+			                                   inMemory));
+		}
+		
+		return arguments;
+	}
+	
+	llvm::Value*
+	Callee::decodeArgument(const size_t argIndex,
+	                       llvm::ArrayRef<llvm::Value*> encodedArguments,
+	                       const bool inMemory) {
+		assert(functionIRMapping_.totalIRArgs() == encodedArguments.size());
+		assert(argIndex < functionType_.argumentTypes().size());
+		
+		// If we're using inalloca, all the memory arguments are GEPs off of the last
+		// parameter, which is a pointer to the complete memory area.
+		llvm::StructType* argStructType = nullptr;
+		llvm::Value* argStruct = nullptr;
+		if (functionIRMapping_.hasInallocaArg()) {
+			argStructType = getInallocaStructType(builder_.getBuilder().getContext(),
+			                                      typeInfo_,
+			                                      functionIRMapping_);
+			argStruct = encodedArguments[functionIRMapping_.inallocaArgIndex()];
+			assert(argStruct->getType() == argStructType->getPointerTo());
+		}
+		
+		const auto& argumentType = functionType_.argumentTypes()[argIndex];
+		const auto& argInfo = functionIRMapping_.arguments()[argIndex].argInfo;
+		
+		// Aggregates can be decoded to a pointer rather than a
+		// first-class aggregate value.
+		const bool decodeToPointer = inMemory && argumentType.isAggregateType();
+		
+		unsigned firstIRArg, numIRArgs;
+		std::tie(firstIRArg, numIRArgs) = functionIRMapping_.getIRArgRange(argIndex);
+		
+		switch (argInfo.getKind()) {
+			case ArgInfo::InAlloca: {
+				assert(numIRArgs == 0);
+				assert(argStruct != nullptr);
+				const auto address = createStructGEP(builder_,
+				                                     argStructType,
+				                                     argStruct,
+				                                     argInfo.getInAllocaFieldIndex(),
+				                                     "inalloca.arg");
+				if (decodeToPointer) {
+					// The argument already lives in the caller's
+					// argument area, so no copy is needed.
+					return address;
 				}
-				case ArgInfo::Indirect: {
-					assert(numIRArgs == 1);
-					auto value = encodedArguments[firstIRArg];
-					
-					if (argumentType.isArray() || argumentType.isStruct()) {
-						// Aggregates and complex variables are accessed by reference.
-						// All we need to do is realign the value, if requested.
-						if (argInfo.getIndirectRealign()) {
-							const auto alignedTempAlloca = createMemTemp(typeInfo_,
-							                                             builder_,
-							                                             argumentType,
-							                                             "coerce");
-							
-							// Copy from the incoming argument pointer to the temporary with the
-							// appropriate alignment.
-							//
-							// FIXME: We should have a common utility for generating an aggregate
-							// copy.
-							const auto i8PtrType = builder_.getBuilder().getInt8PtrTy();
-							
-							const auto typeSize = typeInfo_.getTypeAllocSize(argumentType);
-							const auto dest = builder_.getBuilder().CreateBitCast(alignedTempAlloca,
-							                                                      i8PtrType);
-							const auto source = builder_.getBuilder().CreateBitCast(value,
-							                                                        i8PtrType);
-							builder_.getBuilder().CreateMemCpy(dest, source,
-							                                   llvm::ConstantInt::get(typeInfo_.getLLVMType(IntPtrTy),
-							                                                          typeSize.asBytes()),
-							                                   argInfo.getIndirectAlign(),
-							                                   false);
-							value = alignedTempAlloca;
-						}
+				
+				return loadArgument(argIndex, address);
+			}
+			case ArgInfo::Indirect: {
+				assert(numIRArgs == 1);
+				auto value = encodedArguments[firstIRArg];
+				
+				if (argumentType.isArray() || argumentType.isStruct() ||
+				    argumentType.isComplex()) {
+					// Aggregates and complex variables are accessed by reference.
+					// All we need to do is realign the value, if requested.
+					if (argInfo.getIndirectRealign()) {
+						const auto alignedTempAlloca = createMemTemp(typeInfo_,
+						                                             builder_,
+						                                             argumentType,
+						                                             "coerce");
 						
-						const auto typeAlign = typeInfo_.getTypeRequiredAlign(argumentType);
-						const auto loadInst = builder_.getBuilder().CreateLoad(value);
-						const auto loadAlign = std::max<size_t>(typeAlign.asBytes(),
-						                                        argInfo.getIndirectAlign());
-						loadInst->setAlignment(loadAlign);
-						arguments.push_back(loadInst);
-					} else {
-						// Load scalar value from indirect argument.
-						// TODO: this needs to handle issues such
-						// as truncation of bool values, efficiently
-						// loading vectors etc.
-						const auto loadInst = builder_.getBuilder().CreateLoad(value);
-						loadInst->setAlignment(argInfo.getIndirectAlign());
-						arguments.push_back(loadInst);
+						// Copy from the incoming argument pointer to the temporary with the
+						// appropriate alignment.
+						const auto typeSize = typeInfo_.getTypeAllocSize(argumentType);
+						createMemCpy(typeInfo_, builder_,
+						             alignedTempAlloca, value,
+						             typeSize, argInfo.getIndirectAlign());
+						value = alignedTempAlloca;
+					}
+					
+					if (decodeToPointer) {
+						return value;
 					}
-					break;
+					
+					return loadArgument(argIndex, value);
+				} else if (decodeToPointer) {
+					return value;
+				} else {
+					// Load scalar value from indirect argument.
+					// TODO: this needs to handle issues such
+					// as truncation of bool values, efficiently
+					// loading vectors etc.
+					const auto loadInst = builder_.getBuilder().CreateLoad(value);
+					loadInst->setAlignment(argInfo.getIndirectAlign());
+					return loadInst;
 				}
+			}
+			
+			case ArgInfo::ExtendInteger:
+			case ArgInfo::Direct: {
+				const auto coerceType = argInfo.getCoerceToType();
 				
-				case ArgInfo::ExtendInteger:
-				case ArgInfo::Direct: {
-					const auto coerceType = argInfo.getCoerceToType();
+				// If we have the trivial case, handle it with no muss and fuss.
+				if (!coerceType.isStruct() &&
+				    coerceType == argumentType &&
+				    argInfo.getDirectOffset() == 0) {
+					assert(numIRArgs == 1);
+					
+					auto value = encodedArguments[firstIRArg];
+					
+					// Ensure the argument is the correct type.
+					if (value->getType() != typeInfo_.getLLVMType(coerceType)) {
+						value = builder_.getBuilder().CreateBitCast(value, typeInfo_.getLLVMType(coerceType));
+					}
 					
-					// If we have the trivial case, handle it with no muss and fuss.
-					if (!coerceType.isStruct() &&
-					    coerceType == argumentType &&
-					    argInfo.getDirectOffset() == 0) {
-						assert(numIRArgs == 1);
-						
-						auto value = encodedArguments[firstIRArg];
-						
-						// Ensure the argument is the correct type.
-						if (value->getType() != typeInfo_.getLLVMType(coerceType)) {
-							value = builder_.getBuilder().CreateBitCast(value, typeInfo_.getLLVMType(coerceType));
-						}
-						
 // 						if (isPromoted) {
 // 							value = emitArgumentDemotion(value);
 // 						}
-						
-						if (value->getType() != typeInfo_.getLLVMType(argumentType)) {
-							value = builder_.getBuilder().CreateBitCast(value, typeInfo_.getLLVMType(argumentType));
-						}
-						
-						arguments.push_back(value);
-						break;
-					}
 					
-					const auto alloca = createMemTemp(typeInfo_,
-					                                  builder_,
-					                                  argumentType,
-					                                  "coerce.mem");
+					if (value->getType() != typeInfo_.getLLVMType(argumentType)) {
+						value = builder_.getBuilder().CreateBitCast(value, typeInfo_.getLLVMType(argumentType));
+					}
 					
-					// The alignment we need to use is the max of the requested alignment for
-					// the argument plus the alignment required by our access code below.
-					const auto alignmentToUse = std::max(typeInfo_.getTypeRequiredAlign(coerceType),
-					                                     typeInfo_.getTypeRequiredAlign(argumentType));
-					alloca->setAlignment(alignmentToUse.asBytes());
+					if (decodeToPointer) {
+						const auto alloca = createMemTemp(typeInfo_,
+						                                  builder_,
+						                                  argumentType,
+						                                  "arg.mem");
+						createStore(builder_.getBuilder(), value, alloca);
+						return alloca;
+					}
 					
-					llvm::Value* destPtr = alloca; // Pointer to store into.
-					auto destType = argumentType;
+					return value;
+				}
+				
+				const auto alloca = createMemTemp(typeInfo_,
+				                                  builder_,
+				                                  argumentType,
+				                                  "coerce.mem");
+				
+				// The alignment we need to use is the max of the requested alignment for
+				// the argument plus the alignment required by our access code below.
+				const auto alignmentToUse = std::max(typeInfo_.getTypeRequiredAlign(coerceType),
+				                                     typeInfo_.getTypeRequiredAlign(argumentType));
+				alloca->setAlignment(alignmentToUse.asBytes());
+				
+				llvm::Value* destPtr = alloca; // Pointer to store into.
+				auto destType = argumentType;
+				
+				// If the value is offset in memory, apply the offset now.
+				if (argInfo.getDirectOffset() != 0) {
+					destPtr = builder_.getBuilder().CreateBitCast(destPtr, llvm::PointerType::getUnqual(typeInfo_.getLLVMType(Int8Ty)));
+					destPtr = builder_.getBuilder().CreateConstGEP1_32(destPtr, argInfo.getDirectOffset());
+					destPtr = builder_.getBuilder().CreateBitCast(destPtr, llvm::PointerType::getUnqual(typeInfo_.getLLVMType(coerceType)));
+					destType = coerceType;
+				}
+				
+				// Fast-isel and the optimizer generally like scalar values better than
+				// FCAs, so we flatten them if this is safe to do for this argument.
+				if (argInfo.isDirect() &&
+				    argInfo.getCanBeFlattened() &&
+				    coerceType.isStruct() &&
+				    coerceType.structMembers().size() > 1) {
+					assert(coerceType.structMembers().size() == numIRArgs);
 					
-					// If the value is offset in memory, apply the offset now.
-					if (argInfo.getDirectOffset() != 0) {
-						destPtr = builder_.getBuilder().CreateBitCast(destPtr, llvm::PointerType::getUnqual(typeInfo_.getLLVMType(Int8Ty)));
-						destPtr = builder_.getBuilder().CreateConstGEP1_32(destPtr, argInfo.getDirectOffset());
-						destPtr = builder_.getBuilder().CreateBitCast(destPtr, llvm::PointerType::getUnqual(typeInfo_.getLLVMType(coerceType)));
-						destType = coerceType;
-					}
+					const auto sourceSize = typeInfo_.getTypeAllocSize(coerceType);
+					const auto destSize = typeInfo_.getTypeAllocSize(argumentType);
 					
-					// Fast-isel and the optimizer generally like scalar values better than
-					// FCAs, so we flatten them if this is safe to do for this argument.
-					if (argInfo.isDirect() &&
-					    argInfo.getCanBeFlattened() &&
-					    coerceType.isStruct() &&
-					    coerceType.structMembers().size() > 1) {
-						assert(coerceType.structMembers().size() == numIRArgs);
+					if (sourceSize <= destSize) {
+						destPtr = builder_.getBuilder().CreateBitCast(destPtr,
+						                                              llvm::PointerType::getUnqual(typeInfo_.getLLVMType(coerceType)));
 						
-						const auto sourceSize = typeInfo_.getTypeAllocSize(coerceType);
-						const auto destSize = typeInfo_.getTypeAllocSize(argumentType);
-						
-						if (sourceSize <= destSize) {
-							destPtr = builder_.getBuilder().CreateBitCast(destPtr,
-							                                              llvm::PointerType::getUnqual(typeInfo_.getLLVMType(coerceType)));
-							
-							for (size_t i = 0; i < coerceType.structMembers().size(); i++) {
-								const auto argValue = encodedArguments[firstIRArg + i];
-								argValue->setName("coerce" + llvm::Twine(i));
-								const auto elementPtr = createConstGEP2_32(builder_,
-								                                           typeInfo_.getLLVMType(coerceType),
-								                                           destPtr,
-								                                           0, i);
-								createStore(builder_.getBuilder(), argValue, elementPtr);
-							}
-						} else {
-							const auto tempAlloca = createTempAlloca(typeInfo_,
-							                                         builder_,
-							                                         coerceType,
-							                                         "coerce");
-							tempAlloca->setAlignment(alignmentToUse.asBytes());
-							
-							for (size_t i = 0; i < coerceType.structMembers().size(); i++) {
-								const auto argValue = encodedArguments[firstIRArg + i];
-								argValue->setName("coerce" + llvm::Twine(i));
-								const auto elementPtr = createConstGEP2_32(builder_,
-								                                           typeInfo_.getLLVMType(coerceType),
-								                                           tempAlloca,
-								                                           0, i);
-								createStore(builder_.getBuilder(), argValue, elementPtr);
-							}
-							
-							builder_.getBuilder().CreateMemCpy(destPtr,
-							                                   tempAlloca,
-							                                   destSize.asBytes(),
-							                                   alignmentToUse.asBytes());
+						for (size_t i = 0; i < coerceType.structMembers().size(); i++) {
+							const auto argValue = encodedArguments[firstIRArg + i];
+							argValue->setName("coerce" + llvm::Twine(i));
+							const auto elementPtr = createConstGEP2_32(builder_,
+							                                           typeInfo_.getLLVMType(coerceType),
+							                                           destPtr,
+							                                           0, i);
+							createStore(builder_.getBuilder(), argValue, elementPtr);
 						}
 					} else {
-						// Simple case, just do a coerced store of the argument into the alloca.
-						assert(numIRArgs == 1);
+						const auto tempAlloca = createTempAlloca(typeInfo_,
+						                                         builder_,
+						                                         coerceType,
+						                                         "coerce");
+						tempAlloca->setAlignment(alignmentToUse.asBytes());
+						
+						for (size_t i = 0; i < coerceType.structMembers().size(); i++) {
+							const auto argValue = encodedArguments[firstIRArg + i];
+							argValue->setName("coerce" + llvm::Twine(i));
+							const auto elementPtr = createConstGEP2_32(builder_,
+							                                           typeInfo_.getLLVMType(coerceType),
+							                                           tempAlloca,
+							                                           0, i);
+							createStore(builder_.getBuilder(), argValue, elementPtr);
+						}
 						
-						const auto argValue = encodedArguments[firstIRArg];
-						argValue->setName("coerce");
-						createCoercedStore(typeInfo_,
-						                   builder_,
-						                   argValue,
-						                   destPtr,
-						                   coerceType,
-						                   destType);
+						createMemCpy(typeInfo_, builder_,
+						             destPtr, tempAlloca,
+						             destSize, alignmentToUse.asBytes());
 					}
+				} else {
+					// Simple case, just do a coerced store of the argument into the alloca.
+					assert(numIRArgs == 1);
 					
-					arguments.push_back(builder_.getBuilder().CreateLoad(alloca));
-					break;
+					const auto argValue = encodedArguments[firstIRArg];
+					argValue->setName("coerce");
+					createCoercedStore(typeInfo_,
+					                   builder_,
+					                   argValue,
+					                   destPtr,
+					                   coerceType,
+					                   destType);
 				}
-				case ArgInfo::Expand: {
-					// If this structure was expanded into multiple arguments then
-					// we need to create a temporary and reconstruct it from the
-					// arguments.
-					const auto alloca = createMemTemp(typeInfo_,
-					                                  builder_,
-					                                  argumentType,
-					                                  "expand.dest.arg");
-					
-					auto iterator = encodedArguments.begin() + firstIRArg;
-					expandTypeFromArgs(typeInfo_, builder_,
-					                   argumentType,
-					                   alloca,
-					                   iterator);
-					assert(iterator == encodedArguments.begin() + firstIRArg + numIRArgs);
-					
-					const auto loadInst = builder_.getBuilder().CreateLoad(alloca);
-					loadInst->setAlignment(typeInfo_.getTypeRequiredAlign(argumentType).asBytes());
-					arguments.push_back(loadInst);
-					break;
+				
+				if (decodeToPointer) {
+					return alloca;
+				}
+				
+				return loadArgument(argIndex, alloca);
+			}
+			case ArgInfo::Expand: {
+				// If this structure was expanded into multiple arguments then
+				// we need to create a temporary and reconstruct it from the
+				// arguments.
+				const auto alloca = createMemTemp(typeInfo_,
+				                                  builder_,
+				                                  argumentType,
+				                                  "expand.dest.arg");
+				
+				auto iterator = encodedArguments.begin() + firstIRArg;
+				expandTypeFromArgs(typeInfo_, builder_,
+				                   argumentType,
+				                   alloca,
+				                   iterator);
+				assert(iterator == encodedArguments.begin() + firstIRArg + numIRArgs);
+				
+				if (decodeToPointer) {
+					return alloca;
 				}
-				case ArgInfo::Ignore: {
-					assert(numIRArgs == 0);
-					arguments.push_back(llvm::UndefValue::get(typeInfo_.getLLVMType(argumentType)));
-					break;
+				
+				return loadArgument(argIndex, alloca);
+			}
+			case ArgInfo::Ignore: {
+				assert(numIRArgs == 0);
+				if (decodeToPointer) {
+					return createMemTemp(typeInfo_,
+					                     builder_,
+					                     argumentType,
+					                     "arg.mem");
 				}
+				return llvm::UndefValue::get(typeInfo_.getLLVMType(argumentType));
 			}
 		}
 		
-		return arguments;
+		llvm_unreachable("Unknown ArgInfo kind.");
+	}
+	
+	bool Callee::isDecodedViaMemory(const size_t argIndex) const {
+		assert(argIndex < functionType_.argumentTypes().size());
+		
+		const auto& argumentType = functionType_.argumentTypes()[argIndex];
+		const auto& argInfo = functionIRMapping_.arguments()[argIndex].argInfo;
+		
+		switch (argInfo.getKind()) {
+			case ArgInfo::InAlloca:
+			case ArgInfo::Indirect:
+			case ArgInfo::Expand:
+				return true;
+			case ArgInfo::ExtendInteger:
+			case ArgInfo::Direct: {
+				// The trivial case passes the value through as-is.
+				const auto coerceType = argInfo.getCoerceToType();
+				return coerceType.isStruct() ||
+				       coerceType != argumentType ||
+				       argInfo.getDirectOffset() != 0;
+			}
+			case ArgInfo::Ignore:
+				return false;
+		}
+		
+		llvm_unreachable("Unknown ArgInfo kind.");
+	}
+	
+	llvm::Value*
+	Callee::loadArgument(const size_t argIndex, llvm::Value* const pointer) {
+		assert(argIndex < functionType_.argumentTypes().size());
+		
+		const auto& argumentType = functionType_.argumentTypes()[argIndex];
+		const auto& argInfo = functionIRMapping_.arguments()[argIndex].argInfo;
+		const auto typeAlign = typeInfo_.getTypeRequiredAlign(argumentType);
+		
+		switch (argInfo.getKind()) {
+			case ArgInfo::InAlloca: {
+				// Fields are only guaranteed to be aligned to a stack slot.
+				const auto loadInst = builder_.getBuilder().CreateLoad(pointer);
+				loadInst->setAlignment(std::min(typeInfo_.getTypeRequiredAlign(PointerTy),
+				                                typeAlign).asBytes());
+				return loadInst;
+			}
+			case ArgInfo::Indirect: {
+				const auto loadInst = builder_.getBuilder().CreateLoad(pointer);
+				const auto loadAlign = std::max<size_t>(typeAlign.asBytes(),
+				                                        argInfo.getIndirectAlign());
+				loadInst->setAlignment(loadAlign);
+				return loadInst;
+			}
+			case ArgInfo::ExtendInteger:
+			case ArgInfo::Direct: {
+				return builder_.getBuilder().CreateLoad(pointer);
+			}
+			case ArgInfo::Expand: {
+				const auto loadInst = builder_.getBuilder().CreateLoad(pointer);
+				loadInst->setAlignment(typeAlign.asBytes());
+				return loadInst;
+			}
+			case ArgInfo::Ignore: {
+				return llvm::UndefValue::get(typeInfo_.getLLVMType(argumentType));
+			}
+		}
+		
+		llvm_unreachable("Unknown ArgInfo kind.");
 	}
 	
 	llvm::Value*
@@ -640,15 +745,27 @@ namespace llvm_abi {
 		switch (returnArgInfo.getKind()) {
 			case ArgInfo::InAlloca: {
 				assert(returnType.isArray() || returnType.isStruct());
-				// Aggregrates get evaluated directly into the destination.
+				// The struct-ret pointer is passed in the argument struct.
+				auto& irBuilder = builder_.getBuilder();
+				const auto argStructType = getInallocaStructType(irBuilder.getContext(),
+				                                                 typeInfo_,
+				                                                 functionIRMapping_);
+				const auto argStruct = encodedArguments[functionIRMapping_.inallocaArgIndex()];
+				const auto structRetAddress = createStructGEP(builder_,
+				                                              argStructType,
+				                                              argStruct,
+				                                              returnArgInfo.getInAllocaFieldIndex());
+				const auto structRetLoad = irBuilder.CreateLoad(structRetAddress, "sret");
+				structRetLoad->setAlignment(typeInfo_.getTypeRequiredAlign(PointerTy).asBytes());
+				const auto structRet = irBuilder.CreatePointerCast(structRetLoad,
+				                                                   typeInfo_.getLLVMType(returnType)->getPointerTo());
+				
+				// Value is returned by storing it into the struct-ret pointer.
+				createStore(irBuilder, returnValue, structRet);
+				
 				// Sometimes we need to return the sret value in a register, though.
 				if (returnArgInfo.getInAllocaSRet()) {
-					const auto argStruct = encodedArguments.back();
-					const auto structRet = createStructGEP(builder_,
-					                                       argStruct->getType()->getPointerElementType(),
-					                                       argStruct,
-					                                       returnArgInfo.getInAllocaFieldIndex());
-					return builder_.getBuilder().CreateLoad(structRet, "sret");
+					return structRet;
 				} else {
 					return llvm::UndefValue::get(typeInfo_.getLLVMType(VoidTy));
 				}
@@ -1,3 +1,8 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Intrinsics.h>
 
 #include <llvm-abi/ABITypeInfo.hpp>
 #include <llvm-abi/Builder.hpp>
@@ -5,6 +10,7 @@
 #include <llvm-abi/FunctionIRMapping.hpp>
 #include <llvm-abi/FunctionType.hpp>
 #include <llvm-abi/LLVMUtils.hpp>
+#include <llvm-abi/TypePromoter.hpp>
 
 namespace llvm_abi {
 	
@@ -15,7 +21,9 @@ namespace llvm_abi {
 	: typeInfo_(typeInfo),
 	functionType_(functionType),
 	functionIRMapping_(functionIRMapping),
-	builder_(builder) { }
+	builder_(builder),
+	inallocaStackSave_(nullptr),
+	inallocaStructRetPtr_(nullptr) { }
 	
 	/// EnterStructPointerForCoercedAccess - Given a struct pointer that we are
 	/// accessing some number of bytes out of it, try to gep into the struct to get
@@ -202,10 +210,8 @@ namespace llvm_abi {
 			const auto casted = builder.getBuilder().CreateBitCast(tmpAlloca, i8PtrType);
 			const auto sourceCasted = builder.getBuilder().CreateBitCast(sourcePtr, i8PtrType);
 			// FIXME: Use better alignment.
-			builder.getBuilder().CreateMemCpy(casted, sourceCasted,
-			                                  llvm::ConstantInt::get(typeInfo.getLLVMType(IntPtrTy),
-			                                                         sourceSize.asBytes()),
-			                                  1, false);
+			createMemCpy(typeInfo, builder, casted, sourceCasted,
+			             sourceSize, 1);
 			return builder.getBuilder().CreateLoad(tmpAlloca);
 		}
 	}
@@ -313,11 +319,8 @@ namespace llvm_abi {
 			const auto casted = builder.getBuilder().CreateBitCast(tempAlloca, i8PtrType);
 			const auto destCasted = builder.getBuilder().CreateBitCast(destPtr, i8PtrType);
 			// FIXME: Use better alignment.
-			builder.getBuilder().CreateMemCpy(destCasted,
-			                                  casted,
-			                                  llvm::ConstantInt::get(typeInfo.getLLVMType(IntPtrTy),
-			                                                         destSize.asBytes()),
-			                                  1, false);
+			createMemCpy(typeInfo, builder, destCasted, casted,
+			             destSize, 1);
 		}
 	}
 	
@@ -391,7 +394,16 @@ namespace llvm_abi {
 			expandTypeToArgs(typeInfo, builder, largestType,
 			                 castAddress, iterator);
 		} else if (type.isComplex()) {
-			llvm_unreachable("TODO");
+			const auto elementAlign = typeInfo.getTypeRequiredAlign(type.complexFloatingPointType());
+			for (unsigned i = 0; i < 2; i++) {
+				const auto partAddress = createConstGEP2_32(builder,
+				                                            typeInfo.getLLVMType(type),
+				                                            alloca,
+				                                            0, i);
+				const auto loadInst = builder.getBuilder().CreateLoad(partAddress);
+				loadInst->setAlignment(elementAlign.asBytes());
+				*iterator++ = loadInst;
+			}
 		} else {
 			const auto loadInst = builder.getBuilder().CreateLoad(alloca);
 			loadInst->setAlignment(typeInfo.getTypeRequiredAlign(type).asBytes());
@@ -399,9 +411,275 @@ namespace llvm_abi {
 		}
 	}
 	
+	/// Write the in-memory representation of a constant of the given
+	/// type into a little-endian byte buffer at the given offset.
+	/// Returns false if the constant can't be represented as bytes
+	/// (e.g. a non-null pointer or a constant expression).
+	static bool writeConstantBytes(const ABITypeInfo& typeInfo,
+	                               llvm::Constant* const constant,
+	                               const Type type,
+	                               const uint64_t offset,
+	                               llvm::MutableArrayRef<uint8_t> bytes) {
+		// Undefined bytes are folded as zero, which is a valid
+		// refinement of undef.
+		if (llvm::isa<llvm::UndefValue>(constant) || constant->isNullValue()) {
+			return true;
+		}
+		
+		if (type.isInteger() || type.isFloatingPoint()) {
+			llvm::APInt value;
+			if (const auto constantInt = llvm::dyn_cast<llvm::ConstantInt>(constant)) {
+				value = constantInt->getValue();
+			} else if (const auto constantFP = llvm::dyn_cast<llvm::ConstantFP>(constant)) {
+				value = constantFP->getValueAPF().bitcastToAPInt();
+			} else {
+				return false;
+			}
+			
+			const auto storeSize = typeInfo.getTypeStoreSize(type).asBytes();
+			const auto rawData = value.getRawData();
+			for (uint64_t i = 0; i < storeSize && (i / 8) < value.getNumWords(); i++) {
+				if (offset + i >= bytes.size()) {
+					break;
+				}
+				bytes[offset + i] = static_cast<uint8_t>(rawData[i / 8] >> ((i % 8) * 8));
+			}
+			return true;
+		} else if (type.isStruct()) {
+			const auto& members = type.structMembers();
+			if (constant->getNumOperands() != members.size()) {
+				return false;
+			}
+			
+			const auto offsets = typeInfo.calculateStructOffsets(members);
+			for (size_t i = 0; i < members.size(); i++) {
+				if (members[i].isBitField()) {
+					return false;
+				}
+				if (!writeConstantBytes(typeInfo, constant->getAggregateElement(i),
+				                        members[i].type(),
+				                        offset + offsets[i].asBytes(), bytes)) {
+					return false;
+				}
+			}
+			return true;
+		} else if (type.isUnion()) {
+			// The IR type of a union only holds its largest member.
+			const auto element = constant->getAggregateElement(0U);
+			if (element == nullptr) {
+				return false;
+			}
+			
+			for (const auto& member: type.unionMembers()) {
+				if (!member.isBitField() &&
+				    typeInfo.getLLVMType(member.type()) == element->getType()) {
+					return writeConstantBytes(typeInfo, element,
+					                          member.type(), offset,
+					                          bytes);
+				}
+			}
+			return false;
+		} else if (type.isArray() || type.isVector()) {
+			const auto elementType = type.isArray() ?
+				type.arrayElementType() : type.vectorElementType();
+			const auto elementCount = type.isArray() ?
+				type.arrayElementCount() : type.vectorElementCount();
+			const auto elementSize = typeInfo.getTypeAllocSize(elementType).asBytes();
+			for (size_t i = 0; i < elementCount; i++) {
+				const auto element = constant->getAggregateElement(i);
+				if (element == nullptr ||
+				    !writeConstantBytes(typeInfo, element, elementType,
+				                        offset + i * elementSize, bytes)) {
+					return false;
+				}
+			}
+			return true;
+		} else {
+			// Non-null pointers and complex values aren't folded.
+			return false;
+		}
+	}
+	
+	/// Build a constant of the given type from the little-endian byte
+	/// buffer at the given offset, as if it were loaded from memory.
+	/// Returns nullptr if the type can't be built from raw bytes.
+	static llvm::Constant* readConstantBytes(const ABITypeInfo& typeInfo,
+	                                         const Type type,
+	                                         const uint64_t offset,
+	                                         llvm::ArrayRef<uint8_t> bytes) {
+		const auto llvmType = typeInfo.getLLVMType(type);
+		
+		if (type.isInteger() || type.isFloatingPoint() || type.isPointer()) {
+			const auto bitWidth = type.isPointer() ?
+				typeInfo.getTypeRawSize(type).asBits() :
+				llvmType->getPrimitiveSizeInBits();
+			llvm::SmallVector<uint64_t, 2> words((bitWidth + 63) / 64, 0);
+			for (uint64_t i = 0; i < (bitWidth + 7) / 8; i++) {
+				if (offset + i >= bytes.size()) {
+					break;
+				}
+				words[i / 8] |= static_cast<uint64_t>(bytes[offset + i]) << ((i % 8) * 8);
+			}
+			
+			const auto value = llvm::APInt(bitWidth, words);
+			if (type.isPointer()) {
+				if (value != 0) {
+					return nullptr;
+				}
+				return llvm::ConstantPointerNull::get(llvm::cast<llvm::PointerType>(llvmType));
+			}
+			
+			const auto constantInt = llvm::ConstantInt::get(llvmType->getContext(), value);
+			if (type.isInteger()) {
+				return constantInt;
+			}
+			
+			// Folds to a ConstantFP.
+			return llvm::ConstantExpr::getBitCast(constantInt, llvmType);
+		} else if (type.isStruct()) {
+			const auto& members = type.structMembers();
+			const auto offsets = typeInfo.calculateStructOffsets(members);
+			llvm::SmallVector<llvm::Constant*, 8> elements;
+			for (size_t i = 0; i < members.size(); i++) {
+				if (members[i].isBitField()) {
+					return nullptr;
+				}
+				const auto element = readConstantBytes(typeInfo, members[i].type(),
+				                                       offset + offsets[i].asBytes(),
+				                                       bytes);
+				if (element == nullptr) {
+					return nullptr;
+				}
+				elements.push_back(element);
+			}
+			return llvm::ConstantStruct::get(llvm::cast<llvm::StructType>(llvmType),
+			                                 elements);
+		} else if (type.isArray() || type.isVector()) {
+			const auto elementType = type.isArray() ?
+				type.arrayElementType() : type.vectorElementType();
+			const auto elementCount = type.isArray() ?
+				type.arrayElementCount() : type.vectorElementCount();
+			const auto elementSize = typeInfo.getTypeAllocSize(elementType).asBytes();
+			llvm::SmallVector<llvm::Constant*, 8> elements;
+			for (size_t i = 0; i < elementCount; i++) {
+				const auto element = readConstantBytes(typeInfo, elementType,
+				                                       offset + i * elementSize,
+				                                       bytes);
+				if (element == nullptr) {
+					return nullptr;
+				}
+				elements.push_back(element);
+			}
+			if (type.isArray()) {
+				return llvm::ConstantArray::get(llvm::cast<llvm::ArrayType>(llvmType),
+				                                elements);
+			} else {
+				return llvm::ConstantVector::get(elements);
+			}
+		} else {
+			return nullptr;
+		}
+	}
+	
+	/// Encode a constant argument passed directly, re-packing it into
+	/// the coerced type(s) without emitting any instructions. This
+	/// mirrors the memory round trip performed by the non-constant
+	/// path (store to a temporary, then a coerced load).
+	///
+	/// Returns false if the constant can't be folded, in which case the
+	/// caller should fall back to the memory round trip.
+	static bool encodeConstantDirectArgument(const ABITypeInfo& typeInfo,
+	                                         llvm::Constant* const constant,
+	                                         const Type argumentType,
+	                                         const ArgInfo& argInfo,
+	                                         llvm::MutableArrayRef<llvm::Value*> irArgs) {
+		const auto coerceType = argInfo.getCoerceToType();
+		const auto directOffset = argInfo.getDirectOffset();
+		
+		const auto sourceSize = typeInfo.getTypeAllocSize(argumentType).asBytes();
+		const auto destSize = typeInfo.getTypeAllocSize(coerceType).asBytes();
+		llvm::SmallVector<uint8_t, 32> bytes(std::max<uint64_t>(sourceSize,
+		                                                         directOffset + destSize),
+		                                     0);
+		if (!writeConstantBytes(typeInfo, constant, argumentType, 0, bytes)) {
+			return false;
+		}
+		
+		llvm::SmallVector<llvm::Constant*, 4> values;
+		if (coerceType.isStruct() && argInfo.isDirect() && argInfo.getCanBeFlattened()) {
+			const auto& members = coerceType.structMembers();
+			const auto offsets = typeInfo.calculateStructOffsets(members);
+			for (size_t i = 0; i < members.size(); i++) {
+				values.push_back(readConstantBytes(typeInfo, members[i].type(),
+				                                   directOffset + offsets[i].asBytes(),
+				                                   bytes));
+			}
+		} else {
+			values.push_back(readConstantBytes(typeInfo, coerceType,
+			                                   directOffset, bytes));
+		}
+		
+		if (values.size() != irArgs.size() ||
+		    std::find(values.begin(), values.end(), nullptr) != values.end()) {
+			return false;
+		}
+		
+		std::copy(values.begin(), values.end(), irArgs.begin());
+		return true;
+	}
+	
+	/// Expand a constant aggregate into arguments; the constant
+	/// counterpart of expandTypeToArgs().
+	static bool expandConstantToArgs(const ABITypeInfo& typeInfo,
+	                                 const Type type,
+	                                 llvm::Constant* const constant,
+	                                 llvm::SmallVectorImpl<llvm::Value*>::iterator& iterator) {
+		if (type.isArray()) {
+			for (size_t i = 0; i < type.arrayElementCount(); i++) {
+				const auto element = constant->getAggregateElement(i);
+				if (element == nullptr ||
+				    !expandConstantToArgs(typeInfo, type.arrayElementType(),
+				                          element, iterator)) {
+					return false;
+				}
+			}
+			return true;
+		} else if (type.isStruct()) {
+			for (size_t i = 0; i < type.structMembers().size(); i++) {
+				const auto& field = type.structMembers()[i];
+				if (field.isBitField()) {
+					return false;
+				}
+				const auto element = constant->getAggregateElement(i);
+				if (element == nullptr ||
+				    !expandConstantToArgs(typeInfo, field.type(),
+				                          element, iterator)) {
+					return false;
+				}
+			}
+			return true;
+		} else if (type.isComplex()) {
+			for (unsigned i = 0; i < 2; i++) {
+				const auto element = constant->getAggregateElement(i);
+				if (element == nullptr) {
+					return false;
+				}
+				*iterator++ = element;
+			}
+			return true;
+		} else if (type.isUnion()) {
+			return false;
+		} else {
+			*iterator++ = constant;
+			return true;
+		}
+	}
+	
 	llvm::SmallVector<llvm::Value*, 8>
 	Caller::encodeArguments(llvm::ArrayRef<TypedValue> arguments,
-	                        llvm::Value* const returnValuePtr) {
+	                        llvm::Value* const returnValuePtr,
+	                        llvm::ArrayRef<bool> argumentsInMemory,
+	                        std::function<void (size_t, llvm::Value*)> argumentConstructor) {
 		// Number of arguments must be equal to or exceed (in the case
 		// of varargs) the number of specified argument types.
 		assert(arguments.size() >= functionType_.argumentTypes().size());
@@ -410,16 +688,33 @@ namespace llvm_abi {
 		const auto& returnArgInfo = functionIRMapping_.returnArgInfo();
 		
 		// If we're using inalloca, insert the allocation after the stack save.
- 		llvm::Value* argMemory = nullptr;
-// 		if (llvm::StructType* argStruct = callInfo.getArgStruct()) {
-// 			llvm::AllocaInst* const allocaInst =
-// 				builder_.getEntryBuilder().CreateAlloca(argStruct);
-// 			allocaInst->setUsedWithInAlloca(true);
-// 			assert(allocaInst->isUsedWithInAlloca() &&
-// 			       !allocaInst->isStaticAlloca());
-// 			argMemory = allocaInst;
-// 			irCallArgs[functionIRMapping_.getInallocaArgNo()] = argMemory;
-// 		}
+		llvm::StructType* argStructType = nullptr;
+		llvm::AllocaInst* argMemory = nullptr;
+		if (functionIRMapping_.hasInallocaArg()) {
+#if LLVMABI_LLVM_VERSION >= 305
+			auto& irBuilder = builder_.getBuilder();
+			const auto module = irBuilder.GetInsertBlock()->getParent()->getParent();
+			
+			const auto stackSaveFunction =
+				llvm::Intrinsic::getDeclaration(module, llvm::Intrinsic::stacksave);
+			inallocaStackSave_ = irBuilder.CreateCall(stackSaveFunction,
+			                                          llvm::ArrayRef<llvm::Value*>(),
+			                                          "inalloca.save");
+			
+			argStructType = getInallocaStructType(irBuilder.getContext(),
+			                                      typeInfo_,
+			                                      functionIRMapping_);
+			argMemory = irBuilder.CreateAlloca(argStructType, nullptr, "argmem");
+			// The argument struct is laid out in stack slots.
+			argMemory->setAlignment(typeInfo_.getTypeRequiredAlign(PointerTy).asBytes());
+			argMemory->setUsedWithInAlloca(true);
+			assert(argMemory->isUsedWithInAlloca() &&
+			       !argMemory->isStaticAlloca());
+			irCallArgs[functionIRMapping_.inallocaArgIndex()] = argMemory;
+#else
+			throw std::runtime_error("InAlloca not supported by version of LLVM built against (need LLVM 3.5+.)");
+#endif
+		}
 		
 		// If the call returns a temporary with struct return, create a
 		// temporary alloca to hold the result, unless one is given to us.
@@ -435,9 +730,12 @@ namespace llvm_abi {
 			} else {
 				assert(argMemory != nullptr);
 				llvm::Value* const address =
-					createStructGEP(builder_, argMemory->getType()->getPointerElementType(),
+					createStructGEP(builder_, argStructType,
 					                argMemory, returnArgInfo.getInAllocaFieldIndex());
-				createStore(builder_.getBuilder(), structRetPtr, address);
+				const auto storeInst = createStore(builder_.getBuilder(),
+				                                   structRetPtr, address);
+				storeInst->setAlignment(argMemory->getAlignment());
+				inallocaStructRetPtr_ = structRetPtr;
 			}
 		}
 		
@@ -448,8 +746,16 @@ namespace llvm_abi {
 			const auto& argumentType = arguments[argumentNumber].type();
 			const auto& argInfo = functionIRMapping_.arguments()[argumentNumber].argInfo;
 			
-			// TODO: add support for values already being in memory.
-			const bool isArgumentInMemory = false;
+			const bool isArgumentInMemory = argumentNumber < argumentsInMemory.size() &&
+			                                argumentsInMemory[argumentNumber];
+			assert(!isArgumentInMemory ||
+			       argumentValue->getType() == typeInfo_.getLLVMType(argumentType)->getPointerTo());
+			
+			// Non-trivial records are always passed in memory, which
+			// the frontend can construct them in.
+			const bool isArgumentConstructed = argumentConstructor &&
+			                                   argumentType.isNonTrivialRecord();
+			assert(!isArgumentConstructed || argInfo.isInAlloca() || argInfo.isIndirect());
 			
 			const bool isVarArgArgument = argumentNumber >= functionType_.argumentTypes().size();
 			(void) isVarArgArgument;
@@ -466,20 +772,43 @@ namespace llvm_abi {
 			switch (argInfo.getKind()) {
 				case ArgInfo::InAlloca: {
 					assert(numIRArgs == 0);
-// 					assert(getTarget().getTriple().getArch() == llvm::Triple::x86);
-					if (isArgumentInMemory) {
-						// Replace the placeholder with the appropriate argument slot GEP.
-						llvm_unreachable("TODO");
+					assert(argMemory != nullptr);
+					const auto address = createStructGEP(builder_,
+					                                     argStructType,
+					                                     argMemory,
+					                                     argInfo.getInAllocaFieldIndex());
+					
+					// Fields are only guaranteed to be aligned to a stack slot.
+					const auto align = std::min<size_t>(argMemory->getAlignment(),
+					                                    typeInfo_.getTypeRequiredAlign(argumentType).asBytes());
+					if (isArgumentConstructed) {
+						// Construct the object in its argument slot.
+						argumentConstructor(argumentNumber, address);
+					} else if (isArgumentInMemory) {
+						if (argumentType.isNonTrivialRecord()) {
+							throw std::runtime_error("Non-trivial record arguments can't be copied into an inalloca block; they must be constructed in place.");
+						}
+						
+						// Copy the object into its argument slot.
+						createMemCpy(typeInfo_,
+						             builder_,
+						             address,
+						             argumentValue,
+						             typeInfo_.getTypeAllocSize(argumentType),
+						             align);
 					} else {
-						// Store the RValue into the argument struct.
-						llvm_unreachable("TODO");
+						// Store the value into the argument struct.
+						const auto storeInst = createStore(builder_.getBuilder(),
+						                                   argumentValue,
+						                                   address);
+						storeInst->setAlignment(align);
 					}
 					break;
 				}
 
 				case ArgInfo::Indirect: {
 					assert(numIRArgs == 1);
-					if (!isArgumentInMemory) {
+					if (isArgumentConstructed || !isArgumentInMemory) {
 						// Make a temporary alloca to pass the argument.
 						const auto allocaInst = createMemTemp(typeInfo_,
 						                                      builder_,
@@ -490,10 +819,14 @@ namespace llvm_abi {
 						}
 						irCallArgs[firstIRArg] = allocaInst;
 						
-						const auto storeInst = createStore(builder_.getBuilder(),
-						                                   argumentValue,
-						                                   allocaInst);
-						storeInst->setAlignment(allocaInst->getAlignment());
+						if (isArgumentConstructed) {
+							argumentConstructor(argumentNumber, allocaInst);
+						} else {
+							const auto storeInst = createStore(builder_.getBuilder(),
+							                                   argumentValue,
+							                                   allocaInst);
+							storeInst->setAlignment(allocaInst->getAlignment());
+						}
 					} else {
 						// We want to avoid creating an unnecessary temporary+copy here;
 						// however, we need one in three cases:
@@ -503,7 +836,33 @@ namespace llvm_abi {
 						//		we cannot force it to be sufficiently aligned.
 						// 3. If the argument is byval, but RV is located in an address space
 						//		different than that of the argument (0).
-						llvm_unreachable("TODO");
+						// Case 1 doesn't apply to x86; for case 2 we can only force
+						// the alignment of our own allocas.
+						llvm::Value* pointer = argumentValue;
+						const auto allocaInst = llvm::dyn_cast<llvm::AllocaInst>(pointer);
+						if (allocaInst != nullptr &&
+						    argInfo.getIndirectAlign() > allocaInst->getAlignment()) {
+							allocaInst->setAlignment(argInfo.getIndirectAlign());
+						}
+						
+						if (pointer->getType()->getPointerAddressSpace() != 0) {
+							const auto tempAlloca = createMemTemp(typeInfo_,
+							                                      builder_,
+							                                      argumentType,
+							                                      "byval.temp");
+							if (argInfo.getIndirectAlign() > tempAlloca->getAlignment()) {
+								tempAlloca->setAlignment(argInfo.getIndirectAlign());
+							}
+							const auto loadInst = builder_.getBuilder().CreateLoad(pointer);
+							loadInst->setAlignment(typeInfo_.getTypeRequiredAlign(argumentType).asBytes());
+							const auto storeInst = createStore(builder_.getBuilder(),
+							                                   loadInst,
+							                                   tempAlloca);
+							storeInst->setAlignment(tempAlloca->getAlignment());
+							pointer = tempAlloca;
+						}
+						
+						irCallArgs[firstIRArg] = pointer;
 					}
 					break;
 				}
@@ -523,6 +882,12 @@ namespace llvm_abi {
 						assert(numIRArgs == 1);
 						auto value = argumentValue;
 						
+						if (isArgumentInMemory) {
+							const auto loadInst = builder_.getBuilder().CreateLoad(value);
+							loadInst->setAlignment(typeInfo_.getTypeRequiredAlign(argumentType).asBytes());
+							value = loadInst;
+						}
+						
 						const auto llvmArgType = typeInfo_.getLLVMType(argumentType);
 						
 						// We might have to widen integers, but we should never truncate.
@@ -544,6 +909,16 @@ namespace llvm_abi {
 						break;
 					}
 					
+					// Constant aggregates are re-packed directly into
+					// the coerced constant(s).
+					const auto constant = llvm::dyn_cast<llvm::Constant>(argumentValue);
+					if (!isArgumentInMemory && constant != nullptr &&
+					    encodeConstantDirectArgument(typeInfo_, constant,
+					                                 argumentType, argInfo,
+					                                 llvm::MutableArrayRef<llvm::Value*>(irCallArgs).slice(firstIRArg, numIRArgs))) {
+						break;
+					}
+					
 					llvm::Value* sourcePtr = nullptr;
 					if (!isArgumentInMemory) {
 						sourcePtr = createMemTemp(typeInfo_,
@@ -578,10 +953,9 @@ namespace llvm_abi {
 							                                         builder_,
 							                                         coerceType,
 							                                         sourcePtr->getName() + ".coerce");
-							builder_.getBuilder().CreateMemCpy(tempAlloca,
-							                                   sourcePtr,
-							                                   sourceSize.asBytes(),
-							                                   0);
+							createMemCpy(typeInfo_, builder_,
+							             tempAlloca, sourcePtr,
+							             sourceSize, 0);
 							sourcePtr = tempAlloca;
 						} else {
 							sourcePtr = builder_.getBuilder().CreateBitCast(sourcePtr, llvm::PointerType::getUnqual(typeInfo_.getLLVMType(coerceType)));
@@ -612,14 +986,27 @@ namespace llvm_abi {
 				}
 
 				case ArgInfo::Expand: {
- 					const auto alloca = createMemTemp(typeInfo_,
-					                                  builder_,
-					                                  argumentType,
-					                                  "expand.source.arg");
+					if (!isArgumentInMemory && llvm::isa<llvm::Constant>(argumentValue)) {
+						auto iterator = irCallArgs.begin() + firstIRArg;
+						if (expandConstantToArgs(typeInfo_, argumentType,
+						                         llvm::cast<llvm::Constant>(argumentValue),
+						                         iterator)) {
+							assert(iterator == irCallArgs.begin() + firstIRArg + numIRArgs);
+							break;
+						}
+					}
 					
-					const auto storeInst = createStore(builder_.getBuilder(),
-					                                   argumentValue, alloca);
-					storeInst->setAlignment(typeInfo_.getTypeRequiredAlign(argumentType).asBytes());
+					llvm::Value* alloca = argumentValue;
+					if (!isArgumentInMemory) {
+						alloca = createMemTemp(typeInfo_,
+						                       builder_,
+						                       argumentType,
+						                       "expand.source.arg");
+						
+						const auto storeInst = createStore(builder_.getBuilder(),
+						                                   argumentValue, alloca);
+						storeInst->setAlignment(typeInfo_.getTypeRequiredAlign(argumentType).asBytes());
+					}
 					
 					auto iterator = irCallArgs.begin() + firstIRArg;
 					expandTypeToArgs(typeInfo_,
@@ -639,20 +1026,52 @@ namespace llvm_abi {
 	llvm::Value*
 	Caller::decodeReturnValue(llvm::ArrayRef<llvm::Value*> encodedArguments,
 	                          llvm::Value* const encodedReturnValue,
-	                          llvm::Value* const returnValuePtr) {
+	                          llvm::Value* const returnValuePtr,
+	                          const bool inMemory) {
 		const auto& returnArgInfo = functionIRMapping_.returnArgInfo();
 		const auto returnType = functionType_.returnType();
+		
+		// Pop the inalloca argument memory now the call is done.
+		if (inallocaStackSave_ != nullptr) {
+			auto& irBuilder = builder_.getBuilder();
+			const auto module = irBuilder.GetInsertBlock()->getParent()->getParent();
+			const auto stackRestoreFunction =
+				llvm::Intrinsic::getDeclaration(module, llvm::Intrinsic::stackrestore);
+			irBuilder.CreateCall(stackRestoreFunction, inallocaStackSave_);
+			inallocaStackSave_ = nullptr;
+		}
+		
+		// Aggregates can be decoded to a pointer rather than a
+		// first-class aggregate value.
+		const bool decodeToPointer = inMemory && returnType.isAggregateType();
 		switch (returnArgInfo.getKind()) {
 			case ArgInfo::InAlloca: {
-				llvm_unreachable("TODO");
+				// The callee constructed the return value in the
+				// memory we passed in the argument struct.
+				assert(inallocaStructRetPtr_ != nullptr);
+				if (decodeToPointer) {
+					return inallocaStructRetPtr_;
+				}
+				
+				const auto loadInst = builder_.getBuilder().CreateLoad(inallocaStructRetPtr_);
+				loadInst->setAlignment(typeInfo_.getTypeRequiredAlign(returnType).asBytes());
+				return loadInst;
 			}
 			case ArgInfo::Indirect: {
 				const auto returnValuePointer = encodedArguments[functionIRMapping_.structRetArgIndex()];
+				if (decodeToPointer) {
+					return returnValuePointer;
+				}
+				
 				const auto loadInst = builder_.getBuilder().CreateLoad(returnValuePointer);
 				loadInst->setAlignment(returnArgInfo.getIndirectAlign());
 				return loadInst;
 			}
 			case ArgInfo::Ignore: {
+				if (decodeToPointer) {
+					return returnValuePtr != nullptr ? returnValuePtr :
+						createMemTemp(typeInfo_, builder_, returnType, "agg.tmp");
+				}
 				return encodedReturnValue;
 			}
 			case ArgInfo::ExtendInteger:
@@ -664,7 +1083,7 @@ namespace llvm_abi {
 				
 				if (coerceLLVMType == returnLLVMType &&
 				    returnArgInfo.getDirectOffset() == 0) {
-					if (returnType.isArray() || returnType.isStruct()) {
+					if (returnType.isArray() || returnType.isStruct() || decodeToPointer) {
 						auto destPtr = returnValuePtr;
 						
 						if (destPtr == nullptr) {
@@ -679,6 +1098,10 @@ namespace llvm_abi {
 						              destPtr,
 						              /*lowAlignment=*/false);
 						
+						if (decodeToPointer) {
+							return destPtr;
+						}
+						
 						const auto loadInst = builder_.getBuilder().CreateLoad(destPtr);
 						loadInst->setAlignment(typeInfo_.getTypeRequiredAlign(returnType).asBytes());
 						return loadInst;
@@ -694,10 +1117,17 @@ namespace llvm_abi {
 					}
 				}
 				
-				auto destPtr = createMemTemp(typeInfo_,
-				                             builder_,
-				                             returnType,
-				                             "coerce");
+				// Store the returned registers straight into the
+				// caller's destination where there is one, so that
+				// values split across several registers (e.g. swiftcc
+				// aggregates) aren't copied through a temporary.
+				auto destPtr = returnValuePtr;
+				if (destPtr == nullptr) {
+					destPtr = createMemTemp(typeInfo_,
+					                        builder_,
+					                        returnType,
+					                        "coerce");
+				}
 				
 				auto destType = returnType;
 				
@@ -717,6 +1147,10 @@ namespace llvm_abi {
 				                   coerceType,
 				                   destType);
 				
+				if (decodeToPointer) {
+					return destPtr;
+				}
+				
 				const auto loadInst = builder_.getBuilder().CreateLoad(destPtr);
 				loadInst->setAlignment(typeInfo_.getTypeRequiredAlign(returnType).asBytes());
 				return loadInst;
@@ -729,4 +1163,67 @@ namespace llvm_abi {
 		llvm_unreachable("Unhandled ArgInfo::Kind");
 	}
 	
+	llvm::Value*
+	createTailCall(const ABITypeInfo& typeInfo,
+	               Builder& builder,
+	               const FunctionType& functionType,
+	               const FunctionIRMapping& functionIRMapping,
+	               std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+	               llvm::ArrayRef<TypedValue> rawArguments,
+	               llvm::Value* const returnValuePtr) {
+		assert(functionIRMapping.arguments().size() == rawArguments.size());
+		
+		// Arguments in an inalloca block are in the caller's frame.
+		if (functionIRMapping.hasInallocaArg()) {
+			throw std::runtime_error("Tail call can't pass arguments in an inalloca block.");
+		}
+		
+		// A temporary for the return value would be in the caller's
+		// frame, so the caller's struct-return pointer is required.
+		if (functionIRMapping.hasStructRetArg() && returnValuePtr == nullptr) {
+			throw std::runtime_error("Tail call requires a return value pointer for struct-return.");
+		}
+		
+		TypePromoter typePromoter(typeInfo);
+		
+		llvm::SmallVector<TypedValue, 8> arguments;
+		llvm::SmallVector<bool, 8> argumentsInMemory;
+		
+		for (size_t i = 0; i < rawArguments.size(); i++) {
+			const auto& argument = rawArguments[i];
+			const auto& argInfo = functionIRMapping.arguments()[i].argInfo;
+			
+			// An indirect argument is forwarded from memory, since a
+			// temporary would be in the caller's frame.
+			if (argInfo.isIndirect()) {
+				if (argument.llvmValue()->getType() !=
+				    typeInfo.getLLVMType(argument.type())->getPointerTo()) {
+					throw std::runtime_error("Tail call requires a pointer to each argument passed indirectly.");
+				}
+				arguments.push_back(argument);
+				argumentsInMemory.push_back(true);
+				continue;
+			}
+			
+			if (i >= functionType.argumentTypes().size()) {
+				arguments.push_back(typePromoter.promoteVarArgsArgument(builder,
+				                                                        argument));
+			} else {
+				arguments.push_back(argument);
+			}
+			argumentsInMemory.push_back(false);
+		}
+		
+		Caller caller(typeInfo,
+		              functionType,
+		              functionIRMapping,
+		              builder);
+		
+		const auto encodedArguments = caller.encodeArguments(arguments,
+		                                                     returnValuePtr,
+		                                                     argumentsInMemory);
+		
+		return callBuilder(encodedArguments);
+	}
+	
 }
@@ -1,3 +1,6 @@
+#include <mutex>
+#include <stdexcept>
+
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/Type.h>
 
@@ -10,12 +13,25 @@ namespace llvm_abi {
 	DefaultABITypeInfo::DefaultABITypeInfo(llvm::LLVMContext& llvmContext,
 	                                       const ABITypeInfo& typeInfo,
 	                                       const DefaultABITypeInfoDelegate& delegate)
-	: llvmContext_(llvmContext),
+	: llvmContext_(&llvmContext),
+	typeInfo_(typeInfo),
+	delegate_(delegate) { }
+	
+	DefaultABITypeInfo::DefaultABITypeInfo(const ABITypeInfo& typeInfo,
+	                                       const DefaultABITypeInfoDelegate& delegate)
+	: llvmContext_(nullptr),
 	typeInfo_(typeInfo),
 	delegate_(delegate) { }
 	
 	DefaultABITypeInfo::~DefaultABITypeInfo() { }
 	
+	llvm::LLVMContext& DefaultABITypeInfo::context() const {
+		if (llvmContext_ == nullptr) {
+			throw std::runtime_error("LLVM types aren't available from layout-only ABI type information.");
+		}
+		return *llvmContext_;
+	}
+	
 	DataSize
 	DefaultABITypeInfo::getDefaultTypeRawSize(const Type type) const {
 		switch (type.kind()) {
@@ -140,15 +156,20 @@ namespace llvm_abi {
 	DefaultABITypeInfo::getLLVMStructType(const std::string& name,
 	                                      llvm::ArrayRef<llvm::Type*> members) const {
 		if (name.empty()) {
-			return llvm::StructType::get(llvmContext_, members);
+			return llvm::StructType::get(context(), members);
 		}
 		
+		// Hold the lock while creating the type, otherwise
+		// another thread could create a second type with the
+		// same name (which LLVM would rename).
+		std::lock_guard<std::mutex> lock(structTypesMutex_);
+		
 		const auto iterator = structTypes_.find(name);
 		if (iterator != structTypes_.end()) {
 			return iterator->second;
 		}
 		
-		const auto structType = llvm::StructType::create(llvmContext_, members,
+		const auto structType = llvm::StructType::create(context(), members,
 		                                                 name);
 		structTypes_.insert(std::make_pair(name, structType));
 		return structType;
@@ -158,31 +179,34 @@ namespace llvm_abi {
 	DefaultABITypeInfo::getDefaultLLVMType(const Type type) const {
 		switch (type.kind()) {
 			case VoidType:
-				return llvm::Type::getVoidTy(llvmContext_);
+				return llvm::Type::getVoidTy(context());
 			case PointerType:
-				return llvm::Type::getInt8PtrTy(llvmContext_);
+				return llvm::Type::getInt8PtrTy(context());
 			case UnspecifiedWidthIntegerType:
 			case FixedWidthIntegerType: {
-				return llvm::IntegerType::get(llvmContext_,
+				return llvm::IntegerType::get(context(),
 				                              typeInfo_.getTypeRawSize(type).asBits());
 			}
 			case FloatingPointType: {
 				switch (type.floatingPointKind()) {
 					case HalfFloat:
-						llvm_unreachable("TODO");
+						return llvm::Type::getHalfTy(context());
 					case Float:
-						return llvm::Type::getFloatTy(llvmContext_);
+						return llvm::Type::getFloatTy(context());
 					case Double:
-						return llvm::Type::getDoubleTy(llvmContext_);
+						return llvm::Type::getDoubleTy(context());
 					case LongDouble:
 						return delegate_.getLongDoubleIRType();
 					case Float128:
-						return llvm::Type::getFP128Ty(llvmContext_);
+						return llvm::Type::getFP128Ty(context());
 				}
 				llvm_unreachable("Unknown Float type kind.");
 			}
 			case ComplexType: {
-				llvm_unreachable("TODO");
+				// Complex values are laid out as { real, imaginary }.
+				const auto elementType = typeInfo_.getLLVMType(type.complexFloatingPointType());
+				llvm::Type* const members[] = { elementType, elementType };
+				return getLLVMStructType("", members);
 			}
 			case StructType: {
 				llvm::SmallVector<llvm::Type*, 8> members;
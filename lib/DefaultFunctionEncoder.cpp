@@ -0,0 +1,72 @@
+#include <utility>
+
+#include <llvm/IR/Instructions.h>
+
+#include <llvm-abi/Builder.hpp>
+#include <llvm-abi/Callee.hpp>
+#include <llvm-abi/DefaultFunctionEncoder.hpp>
+#include <llvm-abi/FunctionIRMapping.hpp>
+#include <llvm-abi/FunctionType.hpp>
+
+namespace llvm_abi {
+	
+	DefaultFunctionEncoder::DefaultFunctionEncoder(const ABITypeInfo& typeInfo,
+	                                               Builder& builder,
+	                                               const FunctionType& functionType,
+	                                               FunctionIRMapping functionIRMapping,
+	                                               llvm::ArrayRef<llvm::Value*> pArguments)
+	: typeInfo_(typeInfo),
+	builder_(builder),
+	functionType_(functionType),
+	functionIRMapping_(std::move(functionIRMapping)),
+	encodedArguments_(pArguments.begin(), pArguments.end()),
+	arguments_(typeInfo,
+	           functionType,
+	           functionIRMapping_,
+	           builder,
+	           pArguments),
+	sharedReturnBlock_(typeInfo,
+	                   functionType,
+	                   functionIRMapping_,
+	                   builder,
+	                   pArguments) { }
+	
+	llvm::ArrayRef<llvm::Value*> DefaultFunctionEncoder::arguments() const {
+		return arguments_.getAll();
+	}
+	
+	llvm::Value* DefaultFunctionEncoder::argument(const size_t index) const {
+		return arguments_.get(index);
+	}
+	
+	llvm::Value* DefaultFunctionEncoder::argumentPointer(const size_t index) const {
+		return arguments_.getPointer(index);
+	}
+	
+	llvm::ReturnInst* DefaultFunctionEncoder::returnValue(llvm::Value* const value) {
+		Callee callee(typeInfo_,
+		              functionType_,
+		              functionIRMapping_,
+		              builder_);
+		const auto encodedReturnValue = callee.encodeReturnValue(value,
+		                                                         encodedArguments_);
+		if (encodedReturnValue->getType()->isVoidTy()) {
+			return builder_.getBuilder().CreateRetVoid();
+		} else {
+			return builder_.getBuilder().CreateRet(encodedReturnValue);
+		}
+	}
+	
+	llvm::BranchInst* DefaultFunctionEncoder::branchToReturn(llvm::Value* const value) {
+		return sharedReturnBlock_.branchTo(value);
+	}
+	
+	llvm::Value* DefaultFunctionEncoder::returnValuePointer() const {
+		if (!functionIRMapping_.hasStructRetArg()) {
+			return nullptr;
+		}
+		
+		return encodedArguments_[functionIRMapping_.structRetArgIndex()];
+	}
+	
+}
@@ -0,0 +1,243 @@
+#include <stdexcept>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Support/ErrorHandling.h>
+
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/ArgInfo.hpp>
+#include <llvm-abi/FastInternalClassifier.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/RegisterUsage.hpp>
+#include <llvm-abi/Type.hpp>
+
+namespace llvm_abi {
+	
+	// Arrays larger than this are never held in registers, to
+	// avoid creating huge numbers of arguments.
+	static const size_t MaxRegisterArrayElements = 16;
+	
+	FastInternalClassifier::FastInternalClassifier(const ABITypeInfo& typeInfo,
+	                                               const FastInternalRegisterBudget budget)
+	: typeInfo_(typeInfo), budget_(budget) { }
+	
+	bool FastInternalClassifier::countRegisters(const Type type,
+	                                            unsigned& numIntRegs,
+	                                            unsigned& numFloatRegs) const {
+		switch (type.kind()) {
+			case VoidType:
+				return true;
+			case PointerType:
+			case UnspecifiedWidthIntegerType:
+			case FixedWidthIntegerType: {
+				const auto registerSize = typeInfo_.getTypeAllocSize(PointerTy);
+				const auto size = typeInfo_.getTypeAllocSize(type);
+				numIntRegs += size.roundUpToAlign(registerSize) / registerSize;
+				return true;
+			}
+			case FloatingPointType: {
+				// x87 values never live in vector registers.
+				if (type.floatingPointKind() == LongDouble) {
+					return false;
+				}
+				numFloatRegs++;
+				return true;
+			}
+			case ComplexType: {
+				if (type.complexKind() == LongDouble) {
+					return false;
+				}
+				numFloatRegs += 2;
+				return true;
+			}
+			case StructType: {
+				if (type.hasFlexibleArrayMember()) {
+					return false;
+				}
+				for (const auto& member: type.structMembers()) {
+					if (!countRegisters(member.type(),
+					                    numIntRegs,
+					                    numFloatRegs)) {
+						return false;
+					}
+				}
+				return true;
+			}
+			case UnionType: {
+				// Unions are passed as their integer representation.
+				const auto registerSize = typeInfo_.getTypeAllocSize(PointerTy);
+				const auto size = typeInfo_.getTypeAllocSize(type);
+				numIntRegs += size.roundUpToAlign(registerSize) / registerSize;
+				return true;
+			}
+			case ArrayType: {
+				if (type.arrayElementCount() > MaxRegisterArrayElements) {
+					return false;
+				}
+				for (size_t i = 0; i < type.arrayElementCount(); i++) {
+					if (!countRegisters(type.arrayElementType(),
+					                    numIntRegs,
+					                    numFloatRegs)) {
+						return false;
+					}
+				}
+				return true;
+			}
+			case VectorType: {
+				if (!typeInfo_.isLegalVectorType(type)) {
+					return false;
+				}
+				numFloatRegs++;
+				return true;
+			}
+		}
+		llvm_unreachable("Unknown type kind.");
+	}
+	
+	bool FastInternalClassifier::canExpand(const Type type) const {
+		if (type.isArray()) {
+			return canExpand(type.arrayElementType());
+		}
+		
+		if (type.isStruct()) {
+			if (type.hasFlexibleArrayMember()) {
+				return false;
+			}
+			
+			for (const auto& member: type.structMembers()) {
+				if (member.isBitField() || !canExpand(member.type())) {
+					return false;
+				}
+			}
+			
+			return true;
+		}
+		
+		// Expanding a union would only pass its largest member.
+		return !type.isUnion();
+	}
+	
+	ArgInfo FastInternalClassifier::classifyReturnType(const Type type) const {
+		if (type.isVoid()) {
+			return ArgInfo::getIgnore();
+		}
+		
+		if (!type.isAggregateType()) {
+			return ArgInfo::getDirect(type);
+		}
+		
+		// Non-trivial C++ records must be constructed in place.
+		if (type.isNonTrivialRecord()) {
+			return ArgInfo::getIndirect(/*alignment=*/0, /*byVal=*/false);
+		}
+		
+		if (type.isEmptyRecord(/*allowArrays=*/true)) {
+			return ArgInfo::getIgnore();
+		}
+		
+		unsigned numIntRegs = 0;
+		unsigned numFloatRegs = 0;
+		if (countRegisters(type, numIntRegs, numFloatRegs) &&
+		    numIntRegs <= budget_.numIntReturnRegs &&
+		    numFloatRegs <= budget_.numFloatReturnRegs) {
+			// Return the aggregate as a first class value, which
+			// the backend splits across the return registers.
+			return ArgInfo::getDirect(type);
+		}
+		
+		return ArgInfo::getIndirect(/*alignment=*/0, /*byVal=*/false);
+	}
+	
+	ArgInfo FastInternalClassifier::classifyArgumentType(const Type type,
+	                                                     unsigned& freeIntRegs,
+	                                                     unsigned& freeFloatRegs) const {
+		unsigned numIntRegs = 0;
+		unsigned numFloatRegs = 0;
+		
+		if (!type.isAggregateType()) {
+			if (countRegisters(type, numIntRegs, numFloatRegs) &&
+			    numIntRegs <= freeIntRegs &&
+			    numFloatRegs <= freeFloatRegs) {
+				freeIntRegs -= numIntRegs;
+				freeFloatRegs -= numFloatRegs;
+				if (budget_.useInRegForArgs) {
+					return ArgInfo::getDirectInReg(type);
+				}
+			}
+			return ArgInfo::getDirect(type);
+		}
+		
+		const auto align = typeInfo_.getTypeRequiredAlign(type).asBytes();
+		
+		// Non-trivial C++ records can't be copied, so they're passed by
+		// reference to a copy made by the caller.
+		if (type.isNonTrivialRecord()) {
+			return ArgInfo::getIndirect(align, /*byVal=*/false);
+		}
+		
+		if (type.isEmptyRecord(/*allowArrays=*/true)) {
+			return ArgInfo::getIgnore();
+		}
+		
+		if (!countRegisters(type, numIntRegs, numFloatRegs) ||
+		    numIntRegs > freeIntRegs ||
+		    numFloatRegs > freeFloatRegs) {
+			// Too big for registers; pass a pointer to the caller's
+			// copy rather than copying it onto the stack.
+			return ArgInfo::getIndirect(align, /*byVal=*/false);
+		}
+		
+		// Aggregates can't be marked 'inreg', so they only consume
+		// registers if the target assigns them implicitly.
+		if (!budget_.useInRegForArgs) {
+			freeIntRegs -= numIntRegs;
+			freeFloatRegs -= numFloatRegs;
+		}
+		
+		if (!canExpand(type)) {
+			return ArgInfo::getDirect(type,
+			                          /*offset=*/0,
+			                          /*padding=*/VoidTy,
+			                          /*canBeFlattened=*/false);
+		}
+		
+		return ArgInfo::getExpand(type);
+	}
+	
+	llvm::SmallVector<ArgInfo, 8>
+	FastInternalClassifier::classifyFunctionType(const FunctionType& functionType,
+	                                             llvm::ArrayRef<Type> argumentTypes,
+	                                             RegisterUsage* const registerUsage) const {
+		if (functionType.isVarArg()) {
+			throw std::runtime_error("Fast internal calling convention doesn't support varargs.");
+		}
+		
+		llvm::SmallVector<ArgInfo, 8> argInfoArray;
+		
+		const auto returnInfo = classifyReturnType(functionType.returnType());
+		argInfoArray.push_back(returnInfo);
+		
+		unsigned freeIntRegs = budget_.numIntArgRegs;
+		unsigned freeFloatRegs = budget_.numFloatArgRegs;
+		
+		// The hidden return pointer consumes an integer register.
+		if (returnInfo.isIndirect() && !budget_.useInRegForArgs &&
+		    freeIntRegs > 0) {
+			freeIntRegs--;
+		}
+		
+		for (const auto& argumentType: argumentTypes) {
+			argInfoArray.push_back(classifyArgumentType(argumentType,
+			                                            freeIntRegs,
+			                                            freeFloatRegs));
+		}
+		
+		if (registerUsage != nullptr) {
+			*registerUsage = RegisterUsage(budget_.numIntArgRegs - freeIntRegs,
+			                               budget_.numFloatArgRegs - freeFloatRegs);
+		}
+		
+		return argInfoArray;
+	}
+	
+}
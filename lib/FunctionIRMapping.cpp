@@ -207,15 +207,35 @@ namespace llvm_abi {
 			functionIRMapping.arguments().push_back(argumentIRMapping);
 		}
 		
-// 		if (FI.usesInAlloca()) {
-// 			functionIRMapping.setInallocaArgIndex(irArgumentNumber++);
-// 		}
+		// The 'inalloca' argument struct pointer comes last.
+		bool usesInAllocaArg = returnArgInfo.isInAlloca();
+		for (const auto& argument: functionIRMapping.arguments()) {
+			usesInAllocaArg |= argument.argInfo.isInAlloca();
+		}
+		
+		if (usesInAllocaArg) {
+			functionIRMapping.setInallocaArgIndex(irArgumentNumber++);
+		}
 		
 		functionIRMapping.setTotalIRArgs(irArgumentNumber);
 		
 		return functionIRMapping;
 	}
 	
+	llvm::StructType*
+	getInallocaStructType(llvm::LLVMContext& context,
+	                      const ABITypeInfo& typeInfo,
+	                      const FunctionIRMapping& functionIRMapping) {
+		assert(functionIRMapping.hasInallocaArg());
+		
+		llvm::SmallVector<llvm::Type*, 8> fieldTypes;
+		for (const auto& fieldType: functionIRMapping.inallocaFieldTypes()) {
+			fieldTypes.push_back(typeInfo.getLLVMType(fieldType));
+		}
+		
+		return llvm::StructType::get(context, fieldTypes, /*isPacked=*/true);
+	}
+	
 	llvm::FunctionType *
 	getFunctionType(llvm::LLVMContext& context,
 	                const ABITypeInfo& typeInfo,
@@ -268,10 +288,11 @@ namespace llvm_abi {
 		
 		// Add type for inalloca argument.
 		if (functionIRMapping.hasInallocaArg()) {
-			llvm_unreachable("TODO");
-// 			auto argStruct = FI.getArgStruct();
-// 			assert(argStruct);
-// 			argumentTypes[functionIRMapping.inallocaArgNo()] = argStruct->getPointerTo();
+			const auto argStructType = getInallocaStructType(context,
+			                                                 typeInfo,
+			                                                 functionIRMapping);
+			argumentTypes[functionIRMapping.inallocaArgIndex()] =
+				argStructType->getPointerTo();
 		}
 		
 		// Add in all of the required arguments.
@@ -336,11 +357,35 @@ namespace llvm_abi {
 		return llvm::FunctionType::get(resultType, argumentTypes, functionType.isVarArg());
 	}
 	
+	/**
+	 * \brief Add attributes describing a hidden pointer's pointee.
+	 */
+	static void
+	addPointeeAttributes(llvm::AttrBuilder& attrs,
+	                     const ABITypeInfo& typeInfo,
+	                     const Type pointeeType) {
+#if LLVMABI_LLVM_VERSION >= 305
+		// NonNull support was added in LLVM 3.5.
+		attrs.addAttribute(llvm::Attribute::NonNull);
+#endif
+#if LLVMABI_LLVM_VERSION >= 306
+		// Dereferenceable support was added in LLVM 3.6.
+		attrs.addDereferenceableAttr(typeInfo.getTypeAllocSize(pointeeType).asBytes());
+#else
+		(void) typeInfo;
+		(void) pointeeType;
+#endif
+	}
+	
 	llvm::AttributeSet
 	getFunctionAttributes(llvm::LLVMContext& llvmContext,
 	                      const ABITypeInfo& typeInfo,
+	                      const FunctionType& functionType,
+	                      llvm::ArrayRef<Type> argumentTypes,
 	                      const FunctionIRMapping& functionIRMapping,
 	                      const llvm::AttributeSet existingAttributes) {
+		assert(argumentTypes.size() == functionIRMapping.arguments().size());
+		
 		llvm::SmallVector<llvm::AttributeSet, 8> attributes;
 		llvm::AttrBuilder functionAttrs(existingAttributes, llvm::AttributeSet::FunctionIndex);
 		llvm::AttrBuilder returnAttrs(existingAttributes, llvm::AttributeSet::ReturnIndex);
@@ -388,6 +433,11 @@ namespace llvm_abi {
 			if (returnArgInfo.getInReg()) {
 				structRetAttrs.addAttribute(llvm::Attribute::InReg);
 			}
+			// The return slot isn't marked 'nocapture', since a value
+			// constructed in place may legitimately refer to itself.
+			addPointeeAttributes(structRetAttrs, typeInfo,
+			                     functionType.returnType());
+			structRetAttrs.addAlignmentAttr(typeInfo.getTypeRequiredAlign(functionType.returnType()).asBytes());
 			attributes.push_back(llvm::AttributeSet::get(
 					llvmContext, functionIRMapping.structRetArgIndex() + 1, structRetAttrs));
 		}
@@ -440,8 +490,16 @@ namespace llvm_abi {
 					
 					if (argInfo.getIndirectByVal()) {
 						attrs.addAttribute(llvm::Attribute::ByVal);
+						
+						// The callee receives its own copy of the
+						// argument, so the pointer can't alias or
+						// escape anything visible to the caller.
+						attrs.addAttribute(llvm::Attribute::NoAlias);
+						attrs.addAttribute(llvm::Attribute::NoCapture);
 					}
 					
+					addPointeeAttributes(attrs, typeInfo,
+					                     argumentTypes[argIndex]);
 					attrs.addAlignmentAttr(argInfo.getIndirectAlign());
 					
 					// byval disables readnone and readonly.
@@ -474,4 +532,56 @@ namespace llvm_abi {
 		return llvm::AttributeSet::get(llvmContext, attributes);
 	}
 	
+	static bool
+	usesInAlloca(const FunctionIRMapping& functionIRMapping) {
+		if (functionIRMapping.hasInallocaArg() ||
+		    functionIRMapping.returnArgInfo().isInAlloca()) {
+			return true;
+		}
+		
+		for (const auto& argument: functionIRMapping.arguments()) {
+			if (argument.argInfo.isInAlloca()) {
+				return true;
+			}
+		}
+		
+		return false;
+	}
+	
+	bool
+	isTailCallCompatible(llvm::LLVMContext& context,
+	                     const ABITypeInfo& typeInfo,
+	                     const FunctionType& callerType,
+	                     const FunctionIRMapping& callerIRMapping,
+	                     const FunctionType& calleeType,
+	                     const FunctionIRMapping& calleeIRMapping) {
+		if (callerType.callingConvention() != calleeType.callingConvention() ||
+		    callerType.isVarArg() != calleeType.isVarArg()) {
+			return false;
+		}
+		
+		// The callee's encoded return value is returned directly
+		// by the caller, so it must mean the same thing.
+		if (callerType.returnType() != calleeType.returnType()) {
+			return false;
+		}
+		
+		// Arguments in an inalloca block are in the caller's frame.
+		if (usesInAlloca(callerIRMapping) || usesInAlloca(calleeIRMapping)) {
+			return false;
+		}
+		
+		// LLVM types and attribute sets are uniqued, so pointer/value
+		// comparison is sufficient here.
+		if (getFunctionType(context, typeInfo, callerType, callerIRMapping) !=
+		    getFunctionType(context, typeInfo, calleeType, calleeIRMapping)) {
+			return false;
+		}
+		
+		return getFunctionAttributes(context, typeInfo, callerType, callerType.argumentTypes(),
+		                             callerIRMapping, llvm::AttributeSet()) ==
+		       getFunctionAttributes(context, typeInfo, calleeType, calleeType.argumentTypes(),
+		                             calleeIRMapping, llvm::AttributeSet());
+	}
+	
 }
@@ -1,5 +1,11 @@
+#include <algorithm>
+
+#include <llvm/Support/MathExtras.h>
+
 #include <llvm-abi/ABITypeInfo.hpp>
 #include <llvm-abi/Builder.hpp>
+#include <llvm-abi/DataSize.hpp>
+#include <llvm-abi/FunctionType.hpp>
 #include <llvm-abi/LLVMUtils.hpp>
 
 namespace llvm_abi {
@@ -34,6 +40,97 @@ namespace llvm_abi {
 		return builder.CreateStore(value, castPtr);
 	}
 	
+	void createMemCpy(const ABITypeInfo& typeInfo,
+	                  Builder& builder,
+	                  llvm::Value* const dest,
+	                  llvm::Value* const source,
+	                  const DataSize size,
+	                  const size_t align) {
+		auto& irBuilder = builder.getBuilder();
+		const auto i8PtrType = irBuilder.getInt8PtrTy();
+		const auto destBytes = irBuilder.CreateBitCast(dest, i8PtrType);
+		const auto sourceBytes = irBuilder.CreateBitCast(source, i8PtrType);
+		
+		const auto sizeBytes = size.asBytes();
+		if (sizeBytes > builder.getInlineCopyThreshold()) {
+			irBuilder.CreateMemCpy(destBytes, sourceBytes,
+			                       llvm::ConstantInt::get(typeInfo.getLLVMType(IntPtrTy),
+			                                              sizeBytes),
+			                       align, false);
+			return;
+		}
+		
+		const auto maxUnitSize = typeInfo.getMaxCopyUnitSize().asBytes();
+		const auto alignBytes = std::max<size_t>(align, 1);
+		
+		size_t offset = 0;
+		while (offset < sizeBytes) {
+			// Use the widest access that doesn't go past the end.
+			size_t unitSize = maxUnitSize;
+			while (unitSize > sizeBytes - offset) {
+				unitSize /= 2;
+			}
+			
+			llvm::Type* unitType = nullptr;
+			if (unitSize > 8) {
+				unitType = llvm::VectorType::get(irBuilder.getInt64Ty(), unitSize / 8);
+			} else {
+				unitType = irBuilder.getIntNTy(unitSize * 8);
+			}
+			const auto unitPtrType = unitType->getPointerTo();
+			const auto unitAlign = llvm::MinAlign(alignBytes, offset);
+			
+			llvm::Value* sourcePtr = sourceBytes;
+			if (offset != 0) {
+				sourcePtr = irBuilder.CreateConstGEP1_32(sourcePtr, offset);
+			}
+			sourcePtr = irBuilder.CreateBitCast(sourcePtr, unitPtrType);
+			const auto loadInst = irBuilder.CreateLoad(sourcePtr);
+			loadInst->setAlignment(unitAlign);
+			
+			llvm::Value* destPtr = destBytes;
+			if (offset != 0) {
+				destPtr = irBuilder.CreateConstGEP1_32(destPtr, offset);
+			}
+			destPtr = irBuilder.CreateBitCast(destPtr, unitPtrType);
+			const auto storeInst = irBuilder.CreateStore(loadInst, destPtr);
+			storeInst->setAlignment(unitAlign);
+			
+			offset += unitSize;
+		}
+	}
+	
+	llvm::SmallVector<bool, 8>
+	prepareInMemoryArguments(const ABITypeInfo& typeInfo,
+	                         Builder& builder,
+	                         const FunctionType& functionType,
+	                         llvm::SmallVectorImpl<TypedValue>& arguments) {
+		llvm::SmallVector<bool, 8> argumentsInMemory;
+		
+		for (size_t i = 0; i < arguments.size(); i++) {
+			const auto& argument = arguments[i];
+			if (argument.llvmValue() == nullptr) {
+				// The argument is constructed in place.
+				argumentsInMemory.push_back(false);
+				continue;
+			}
+			
+			const auto llvmType = typeInfo.getLLVMType(argument.type());
+			const bool isInMemory = argument.llvmValue()->getType() == llvmType->getPointerTo();
+			
+			if (isInMemory && i >= functionType.argumentTypes().size()) {
+				const auto loadInst = builder.getBuilder().CreateLoad(argument.llvmValue());
+				loadInst->setAlignment(typeInfo.getTypeRequiredAlign(argument.type()).asBytes());
+				arguments[i] = TypedValue(loadInst, argument.type());
+				argumentsInMemory.push_back(false);
+			} else {
+				argumentsInMemory.push_back(isInMemory);
+			}
+		}
+		
+		return argumentsInMemory;
+	}
+	
 	llvm::Value* createConstGEP2_32(Builder& builder,
 	                                llvm::Type* type, llvm::Value* ptr,
 	                                unsigned idx0, unsigned idx1,
@@ -0,0 +1,123 @@
+#include <iterator>
+
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Instruction.h>
+
+#include <llvm-abi/Builder.hpp>
+#include <llvm-abi/Callee.hpp>
+#include <llvm-abi/FunctionIRMapping.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/LazyArgumentDecoder.hpp>
+
+namespace llvm_abi {
+	
+	LazyArgumentDecoder::LazyArgumentDecoder(const ABITypeInfo& typeInfo,
+	                                         const FunctionType& functionType,
+	                                         const FunctionIRMapping& functionIRMapping,
+	                                         Builder& builder,
+	                                         llvm::ArrayRef<llvm::Value*> encodedArguments)
+	: functionType_(functionType),
+	prologueBuilder_(builder, builder.getBuilder().GetInsertBlock()),
+	prologueBlock_(builder.getBuilder().GetInsertBlock()),
+	prologueEnd_(nullptr),
+	callee_(typeInfo,
+	        functionType,
+	        functionIRMapping,
+	        prologueBuilder_),
+	encodedArguments_(encodedArguments.begin(), encodedArguments.end()),
+	arguments_(functionType.argumentTypes().size(), nullptr),
+	argumentPointers_(functionType.argumentTypes().size(), nullptr) {
+		assert(prologueBlock_ != nullptr);
+		
+		// Remember the instruction before the insert point, since
+		// the insert point itself may be the end of the block, which
+		// would move as the function body is emitted.
+		const auto insertPoint = builder.getBuilder().GetInsertPoint();
+		if (insertPoint != prologueBlock_->begin()) {
+			prologueEnd_ = &*std::prev(insertPoint);
+		}
+		
+		// Name the struct return parameter.
+		if (functionIRMapping.hasStructRetArg()) {
+			encodedArguments_[functionIRMapping.structRetArgIndex()]->setName("agg.result");
+		}
+	}
+	
+	size_t LazyArgumentDecoder::size() const {
+		return arguments_.size();
+	}
+	
+	llvm::Value* LazyArgumentDecoder::get(const size_t index) {
+		assert(index < arguments_.size());
+		if (arguments_[index] != nullptr) {
+			return arguments_[index];
+		}
+		
+		if (!isLoadedFromPointer(index)) {
+			arguments_[index] = decodeInPrologue(index, /*inMemory=*/false);
+			return arguments_[index];
+		}
+		
+		const auto pointer = getPointer(index);
+		beginPrologue();
+		arguments_[index] = callee_.loadArgument(index, pointer);
+		endPrologue();
+		return arguments_[index];
+	}
+	
+	llvm::Value* LazyArgumentDecoder::getPointer(const size_t index) {
+		assert(index < argumentPointers_.size());
+		if (!functionType_.argumentTypes()[index].isAggregateType()) {
+			return get(index);
+		}
+		
+		if (argumentPointers_[index] == nullptr) {
+			argumentPointers_[index] = decodeInPrologue(index, /*inMemory=*/true);
+		}
+		return argumentPointers_[index];
+	}
+	
+	void LazyArgumentDecoder::beginPrologue() {
+		auto& irBuilder = prologueBuilder_.getBuilder();
+		
+		// Emit immediately after any previously decoded arguments.
+		if (prologueEnd_ != nullptr && prologueEnd_->getNextNode() != nullptr) {
+			irBuilder.SetInsertPoint(prologueEnd_->getNextNode());
+		} else if (prologueEnd_ == nullptr && !prologueBlock_->empty()) {
+			irBuilder.SetInsertPoint(&(prologueBlock_->front()));
+		} else {
+			irBuilder.SetInsertPoint(prologueBlock_);
+		}
+	}
+	
+	void LazyArgumentDecoder::endPrologue() {
+		const auto insertPoint = prologueBuilder_.getBuilder().GetInsertPoint();
+		if (insertPoint != prologueBlock_->begin()) {
+			prologueEnd_ = &*std::prev(insertPoint);
+		}
+	}
+	
+	llvm::Value* LazyArgumentDecoder::decodeInPrologue(const size_t index,
+	                                                   const bool inMemory) {
+		beginPrologue();
+		const auto value = callee_.decodeArgument(index, encodedArguments_,
+		                                          inMemory);
+		endPrologue();
+		return value;
+	}
+	
+	bool LazyArgumentDecoder::isLoadedFromPointer(const size_t index) const {
+		// Arguments that are passed through as-is (or are ignored)
+		// aren't worth putting in memory just to load them again.
+		return functionType_.argumentTypes()[index].isAggregateType() &&
+		       callee_.isDecodedViaMemory(index);
+	}
+	
+	llvm::ArrayRef<llvm::Value*> LazyArgumentDecoder::getAll() {
+		for (size_t i = 0; i < arguments_.size(); i++) {
+			(void) get(i);
+		}
+		return arguments_;
+	}
+	
+}
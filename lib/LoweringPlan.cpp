@@ -0,0 +1,130 @@
+#include <cassert>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/Attributes.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/LLVMContext.h>
+
+#include <llvm-abi/ABITargetData.hpp>
+#include <llvm-abi/ArgInfo.hpp>
+#include <llvm-abi/FunctionIRMapping.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/LoweringPlan.hpp>
+#include <llvm-abi/RegisterUsage.hpp>
+#include <llvm-abi/Type.hpp>
+
+#include <llvm-abi/x86/CPUFeatures.hpp>
+#include <llvm-abi/x86/X86_32LoweringPlanner.hpp>
+#include <llvm-abi/x86/X86_64LoweringPlanner.hpp>
+
+namespace llvm_abi {
+	
+	LoweringPlan::LoweringPlan(const FunctionType& functionType,
+	                           llvm::ArrayRef<Type> argumentTypes,
+	                           FunctionIRMapping irMapping,
+	                           const RegisterUsage registerUsage)
+	: functionType_(functionType),
+	argumentTypes_(argumentTypes.begin(), argumentTypes.end()),
+	irMapping_(std::move(irMapping)),
+	registerUsage_(registerUsage) { }
+	
+	const FunctionType& LoweringPlan::functionType() const {
+		return functionType_;
+	}
+	
+	llvm::ArrayRef<Type> LoweringPlan::argumentTypes() const {
+		return argumentTypes_;
+	}
+	
+	const FunctionIRMapping& LoweringPlan::irMapping() const {
+		return irMapping_;
+	}
+	
+	const ArgInfo& LoweringPlan::returnInfo() const {
+		return irMapping_.returnArgInfo();
+	}
+	
+	const ArgInfo& LoweringPlan::argumentInfo(const size_t index) const {
+		return irMapping_.arguments()[index].argInfo;
+	}
+	
+	const RegisterUsage& LoweringPlan::registerUsage() const {
+		return registerUsage_;
+	}
+	
+	std::string LoweringPlan::toString() const {
+		std::ostringstream OS;
+		OS << "LoweringPlan(functionType: " << functionType_.toString();
+		OS << ", return: " << returnInfo().toString();
+		for (size_t i = 0; i < argumentTypes_.size(); i++) {
+			const auto& argument = irMapping_.arguments()[i];
+			OS << ", argument " << i << ": " << argumentTypes_[i].toString();
+			OS << " " << argument.argInfo.toString();
+			if (argument.numberOfIRArgs > 0) {
+				OS << " IRArgs=[" << argument.firstArgIndex << ", "
+				   << (argument.firstArgIndex + argument.numberOfIRArgs) << ")";
+			}
+		}
+		OS << ", totalIRArgs: " << irMapping_.totalIRArgs();
+		OS << ", intRegs: " << registerUsage_.numIntRegs;
+		OS << ", vectorRegs: " << registerUsage_.numVectorRegs << ")";
+		return OS.str();
+	}
+	
+	std::unique_ptr<LoweringPlanner>
+	createLoweringPlanner(const llvm::Triple& targetTriple,
+	                      const std::string& cpuName) {
+		switch (targetTriple.getArch()) {
+			case llvm::Triple::x86:
+				return std::unique_ptr<LoweringPlanner>(
+					new x86::X86_32LoweringPlanner(targetTriple,
+					                               std::make_shared<ABITargetData>()));
+			case llvm::Triple::x86_64: {
+				if (targetTriple.isOSWindows()) {
+					break;
+				}
+				return std::unique_ptr<LoweringPlanner>(
+					new x86::X86_64LoweringPlanner(x86::getCPUFeatures(targetTriple,
+					                                                   cpuName),
+					                               std::make_shared<ABITargetData>()));
+			}
+			default:
+				break;
+		}
+		
+		std::string errorString = "No lowering planner available for triple: ";
+		errorString += targetTriple.str();
+		throw std::runtime_error(errorString);
+	}
+	
+	llvm::FunctionType *
+	getFunctionType(llvm::LLVMContext& context,
+	                const ABITypeInfo& typeInfo,
+	                const LoweringPlan& plan) {
+		assert(plan.argumentTypes().size() == plan.functionType().argumentTypes().size());
+		return getFunctionType(context,
+		                       typeInfo,
+		                       plan.functionType(),
+		                       plan.irMapping());
+	}
+	
+	llvm::AttributeSet
+	getFunctionAttributes(llvm::LLVMContext& context,
+	                      const ABITypeInfo& typeInfo,
+	                      const LoweringPlan& plan,
+	                      const llvm::AttributeSet existingAttributes) {
+		return getFunctionAttributes(context,
+		                             typeInfo,
+		                             plan.functionType(),
+		                             plan.argumentTypes(),
+		                             plan.irMapping(),
+		                             existingAttributes);
+	}
+	
+}
+
@@ -0,0 +1,49 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include <llvm/ADT/ArrayRef.h>
+
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/LoweringPlanCache.hpp>
+#include <llvm-abi/Type.hpp>
+
+namespace llvm_abi {
+	
+	LoweringPlanKey::LoweringPlanKey(const FunctionType& functionType,
+	                                 llvm::ArrayRef<Type> argumentTypes,
+	                                 const uint64_t variant)
+	: functionType_(functionType),
+	argumentTypes_(argumentTypes.begin(), argumentTypes.end()),
+	variant_(variant) { }
+	
+	bool LoweringPlanKey::operator==(const LoweringPlanKey& other) const {
+		return functionType_.callingConvention() == other.functionType_.callingConvention() &&
+		       functionType_.isVarArg() == other.functionType_.isVarArg() &&
+		       functionType_.hasRegParm() == other.functionType_.hasRegParm() &&
+		       functionType_.regParm() == other.functionType_.regParm() &&
+		       functionType_.returnType() == other.functionType_.returnType() &&
+		       functionType_.argumentTypes().equals(other.functionType_.argumentTypes()) &&
+		       llvm::ArrayRef<Type>(argumentTypes_).equals(other.argumentTypes_) &&
+		       variant_ == other.variant_;
+	}
+	
+	size_t LoweringPlanKey::hash() const {
+		size_t value = std::hash<uint64_t>()(variant_);
+		const auto combine = [&](const size_t elementValue) {
+			value = (value * 31) ^ elementValue;
+		};
+		combine(std::hash<unsigned long long>()(functionType_.callingConvention()));
+		combine(std::hash<bool>()(functionType_.isVarArg()));
+		combine(std::hash<unsigned>()(functionType_.regParm()));
+		combine(functionType_.returnType().hash());
+		
+		// The function type's argument types are included in (the
+		// promoted) argument types, so they needn't be hashed.
+		for (const auto& argumentType: argumentTypes_) {
+			combine(argumentType.hash());
+		}
+		return value;
+	}
+	
+}
@@ -0,0 +1,102 @@
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/Builder.hpp>
+#include <llvm-abi/Callee.hpp>
+#include <llvm-abi/FunctionIRMapping.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/InsertPointBuilder.hpp>
+#include <llvm-abi/SharedReturnBlock.hpp>
+
+namespace llvm_abi {
+	
+	SharedReturnBlock::SharedReturnBlock(const ABITypeInfo& typeInfo,
+	                                     const FunctionType& functionType,
+	                                     const FunctionIRMapping& functionIRMapping,
+	                                     Builder& builder,
+	                                     llvm::ArrayRef<llvm::Value*> encodedArguments)
+	: typeInfo_(typeInfo),
+	functionType_(functionType),
+	functionIRMapping_(functionIRMapping),
+	builder_(builder),
+	encodedArguments_(encodedArguments.begin(), encodedArguments.end()),
+	block_(nullptr),
+	phi_(nullptr) { }
+	
+	bool SharedReturnBlock::isReturnedInMemory() const {
+		const auto& returnArgInfo = functionIRMapping_.returnArgInfo();
+		return returnArgInfo.isIndirect() || returnArgInfo.isInAlloca();
+	}
+	
+	void SharedReturnBlock::createBlock() {
+		const auto function = builder_.getBuilder().GetInsertBlock()->getParent();
+		block_ = llvm::BasicBlock::Create(function->getContext(), "return",
+		                                  function);
+		
+		returnBuilder_.reset(new InsertPointBuilder(builder_, block_));
+		
+		auto& irBuilder = returnBuilder_->getBuilder();
+		
+		const auto returnType = typeInfo_.getLLVMType(functionType_.returnType());
+		if (returnType->isVoidTy()) {
+			irBuilder.CreateRetVoid();
+			return;
+		}
+		
+		if (isReturnedInMemory()) {
+			// The value has already been stored by each return
+			// site, though the 'sret' pointer may also need to be
+			// returned in a register.
+			const auto encodedReturnType = function->getReturnType();
+			if (encodedReturnType->isVoidTy()) {
+				irBuilder.CreateRetVoid();
+			} else {
+				phi_ = irBuilder.CreatePHI(encodedReturnType, 0, "retval");
+				irBuilder.CreateRet(phi_);
+			}
+			return;
+		}
+		
+		callee_.reset(new Callee(typeInfo_,
+		                         functionType_,
+		                         functionIRMapping_,
+		                         *returnBuilder_));
+		
+		// The return value encoding code is only emitted here, with
+		// each return site supplying its value via the phi.
+		phi_ = irBuilder.CreatePHI(returnType, 0, "retval");
+		
+		const auto encodedReturnValue = callee_->encodeReturnValue(phi_,
+		                                                           encodedArguments_);
+		if (encodedReturnValue->getType()->isVoidTy()) {
+			irBuilder.CreateRetVoid();
+		} else {
+			irBuilder.CreateRet(encodedReturnValue);
+		}
+	}
+	
+	llvm::BranchInst* SharedReturnBlock::branchTo(llvm::Value* const value) {
+		if (block_ == nullptr) {
+			createBlock();
+		}
+		
+		auto& irBuilder = builder_.getBuilder();
+		
+		auto incomingValue = value;
+		if (isReturnedInMemory()) {
+			Callee callee(typeInfo_,
+			              functionType_,
+			              functionIRMapping_,
+			              builder_);
+			incomingValue = callee.encodeReturnValue(value, encodedArguments_);
+		}
+		
+		if (phi_ != nullptr) {
+			phi_->addIncoming(incomingValue, irBuilder.GetInsertBlock());
+		}
+		return irBuilder.CreateBr(block_);
+	}
+	
+}
@@ -74,6 +74,24 @@ namespace llvm_abi {
 		return type;
 	}
 	
+	Type Type::NonTrivialAutoStruct(const TypeBuilder& typeBuilder,
+	                                llvm::ArrayRef<Type> memberTypes,
+	                                std::string name) {
+		TypeData typeData;
+		typeData.recordType.name = std::move(name);
+		typeData.recordType.members.reserve(memberTypes.size());
+		for (auto& memberType: memberTypes) {
+			typeData.recordType.members.push_back(RecordMember::AutoOffset(memberType));
+		}
+		typeData.recordType.isNonTrivial = true;
+		
+		const auto typeDataPtr = typeBuilder.getUniquedTypeData(std::move(typeData));
+		
+		Type type(StructType);
+		type.subKind_.uniquedPointer = typeDataPtr;
+		return type;
+	}
+	
 	Type Type::Union(const TypeBuilder& typeBuilder, llvm::ArrayRef<Type> memberTypes,
 	                 std::string name) {
 		TypeData typeData;
@@ -227,6 +245,10 @@ namespace llvm_abi {
 		return kind() == FloatingPointType;
 	}
 	
+	bool Type::isHalfFloat() const {
+		return *this == HalfFloatTy;
+	}
+	
 	bool Type::isFloat() const {
 		return *this == FloatTy;
 	}
@@ -285,6 +307,11 @@ namespace llvm_abi {
 		return subKind_.uniquedPointer->recordType.members;
 	}
 	
+	bool Type::isNonTrivialRecord() const {
+		return isRecordType() &&
+		       subKind_.uniquedPointer->recordType.isNonTrivial;
+	}
+	
 	bool Type::isArray() const {
 		return kind() == ArrayType;
 	}
@@ -368,7 +395,8 @@ namespace llvm_abi {
 		}
 		
 		if (isRecordType() && other.isRecordType() && kind() == other.kind()) {
-			return recordMembers() == other.recordMembers();
+			return recordMembers() == other.recordMembers() &&
+			       isNonTrivialRecord() == other.isNonTrivialRecord();
 		}
 		
 		return false;
@@ -834,7 +862,7 @@ namespace llvm_abi {
 			case ComplexType:
 				return std::string("Complex(") + floatKindToString(complexKind()) + ")";
 			case StructType: {
-				std::string s = "Struct(";
+				std::string s = isNonTrivialRecord() ? "NonTrivialStruct(" : "Struct(";
 				const auto& members = structMembers();
 				for (size_t i = 0; i < members.size(); i++) {
 					if (i > 0) {
@@ -1,3 +1,4 @@
+#include <mutex>
 #include <set>
 
 #include <llvm-abi/Type.hpp>
@@ -8,6 +9,9 @@ namespace llvm_abi {
 	TypeBuilder::TypeBuilder() { }
 	
 	const Type::TypeData* TypeBuilder::getUniquedTypeData(Type::TypeData typeData) const {
+		// Set nodes are never moved or removed, so the pointer
+		// remains valid after the lock is released.
+		std::lock_guard<std::mutex> lock(mutex_);
 		auto result = typeDataSet_.insert(std::move(typeData));
 		return &(*(result.first));
 	}
@@ -86,6 +90,11 @@ namespace llvm_abi {
 		return Type::AutoStruct(*this, memberTypes, std::move(name));
 	}
 	
+	Type TypeBuilder::getNonTrivialStructTy(llvm::ArrayRef<Type> memberTypes,
+	                                        std::string name) const {
+		return Type::NonTrivialAutoStruct(*this, memberTypes, std::move(name));
+	}
+	
 	Type TypeBuilder::getArrayTy(const size_t elementCount,
 	                             const Type elementType) const {
 		return Type::Array(*this, elementCount, elementType);
@@ -66,7 +66,6 @@ namespace llvm_abi {
 		} else if (type.isFloatingPoint()) {
 			switch (type.floatingPointKind()) {
 				case HalfFloat:
-					llvm_unreachable("TODO");
 				case Float:
 					return DoubleTy;
 				case Double:
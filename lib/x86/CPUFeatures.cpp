@@ -1,6 +1,12 @@
-#include <set>
+#include <cstdint>
 #include <string>
 
+#if (defined(__i386__) || defined(__x86_64__)) && defined(__GNUC__)
+#include <cpuid.h>
+#define LLVMABI_HOST_HAS_CPUID 1
+#endif
+
+#include <llvm/ADT/StringRef.h>
 #include <llvm/ADT/StringSwitch.h>
 #include <llvm/ADT/Triple.h>
 
@@ -11,53 +17,251 @@ namespace llvm_abi {
 	
 	namespace x86 {
 		
-		CPUFeatures::CPUFeatures()
-		: sseLevel_(NoSSE) { }
+		// Features that raise the SSE level to each level.
+		constexpr uint64_t SSE1LevelMask = getCPUFeatureMask(FeatureSSE);
+		constexpr uint64_t SSE2LevelMask = getCPUFeatureMask(FeatureSSE2) |
+		                                   getCPUFeatureMask(FeatureAES) |
+		                                   getCPUFeatureMask(FeaturePCLMUL);
+		constexpr uint64_t SSE3LevelMask = getCPUFeatureMask(FeatureSSE3);
+		constexpr uint64_t SSSE3LevelMask = getCPUFeatureMask(FeatureSSSE3);
+		constexpr uint64_t SSE41LevelMask = getCPUFeatureMask(FeatureSSE41);
+		constexpr uint64_t SSE42LevelMask = getCPUFeatureMask(FeatureSSE42);
+		constexpr uint64_t AVXLevelMask = getCPUFeatureMask(FeatureAVX) |
+		                                  getCPUFeatureMask(FeatureFMA);
+		constexpr uint64_t AVX2LevelMask = getCPUFeatureMask(FeatureAVX2);
+		constexpr uint64_t AVX512FLevelMask = getCPUFeatureMask(FeatureAVX512F) |
+		                                      getCPUFeatureMask(FeatureAVX512CD) |
+		                                      getCPUFeatureMask(FeatureAVX512ER) |
+		                                      getCPUFeatureMask(FeatureAVX512PF) |
+		                                      getCPUFeatureMask(FeatureAVX512DQ) |
+		                                      getCPUFeatureMask(FeatureAVX512BW) |
+		                                      getCPUFeatureMask(FeatureAVX512VL);
+		
+		// Features of each CPU kind, built up in the same way as
+		// Clang's fall-through chains.
+		constexpr uint64_t MMXFeatures = getCPUFeatureMask(FeatureMMX);
+		constexpr uint64_t SSEFeatures = getCPUFeatureMask(FeatureSSE);
+		constexpr uint64_t SSE2Features = getCPUFeatureMask(FeatureSSE2);
+		constexpr uint64_t SSE3Features = getCPUFeatureMask(FeatureSSE3) |
+		                                  getCPUFeatureMask(FeatureCX16);
+		constexpr uint64_t SSSE3Features = getCPUFeatureMask(FeatureSSSE3) |
+		                                   getCPUFeatureMask(FeatureCX16);
+		constexpr uint64_t PenrynFeatures = getCPUFeatureMask(FeatureSSE41) |
+		                                    getCPUFeatureMask(FeatureCX16);
+		constexpr uint64_t NehalemFeatures = getCPUFeatureMask(FeatureSSE42) |
+		                                     getCPUFeatureMask(FeatureCX16);
+		constexpr uint64_t WestmereFeatures = NehalemFeatures |
+		                                      getCPUFeatureMask(FeatureAES) |
+		                                      getCPUFeatureMask(FeaturePCLMUL);
+		constexpr uint64_t SandyBridgeFeatures = WestmereFeatures |
+		                                         getCPUFeatureMask(FeatureAVX);
+		constexpr uint64_t IvyBridgeFeatures = SandyBridgeFeatures |
+		                                       getCPUFeatureMask(FeatureRDRND) |
+		                                       getCPUFeatureMask(FeatureF16C) |
+		                                       getCPUFeatureMask(FeatureFSGSBase);
+		constexpr uint64_t HaswellFeatures = IvyBridgeFeatures |
+		                                     getCPUFeatureMask(FeatureAVX2) |
+		                                     getCPUFeatureMask(FeatureLZCNT) |
+		                                     getCPUFeatureMask(FeatureBMI) |
+		                                     getCPUFeatureMask(FeatureBMI2) |
+		                                     getCPUFeatureMask(FeatureRTM) |
+		                                     getCPUFeatureMask(FeatureFMA);
+		constexpr uint64_t BroadwellFeatures = HaswellFeatures |
+		                                       getCPUFeatureMask(FeatureRDSEED) |
+		                                       getCPUFeatureMask(FeatureADX);
+		constexpr uint64_t SkylakeFeatures = BroadwellFeatures |
+		                                     getCPUFeatureMask(FeatureAVX512F) |
+		                                     getCPUFeatureMask(FeatureAVX512CD) |
+		                                     getCPUFeatureMask(FeatureAVX512DQ) |
+		                                     getCPUFeatureMask(FeatureAVX512BW) |
+		                                     getCPUFeatureMask(FeatureAVX512VL);
+		constexpr uint64_t KNLFeatures = getCPUFeatureMask(FeatureAVX512F) |
+		                                 getCPUFeatureMask(FeatureAVX512CD) |
+		                                 getCPUFeatureMask(FeatureAVX512ER) |
+		                                 getCPUFeatureMask(FeatureAVX512PF) |
+		                                 getCPUFeatureMask(FeatureRDSEED) |
+		                                 getCPUFeatureMask(FeatureADX) |
+		                                 getCPUFeatureMask(FeatureLZCNT) |
+		                                 getCPUFeatureMask(FeatureBMI) |
+		                                 getCPUFeatureMask(FeatureBMI2) |
+		                                 getCPUFeatureMask(FeatureRTM) |
+		                                 getCPUFeatureMask(FeatureFMA) |
+		                                 getCPUFeatureMask(FeatureRDRND) |
+		                                 getCPUFeatureMask(FeatureF16C) |
+		                                 getCPUFeatureMask(FeatureFSGSBase) |
+		                                 getCPUFeatureMask(FeatureAES) |
+		                                 getCPUFeatureMask(FeaturePCLMUL) |
+		                                 getCPUFeatureMask(FeatureCX16);
+		constexpr uint64_t ThreeDNowFeatures = getCPUFeatureMask(Feature3DNow);
+		constexpr uint64_t ThreeDNowAFeatures = getCPUFeatureMask(Feature3DNowA);
+		constexpr uint64_t Athlon4Features = ThreeDNowAFeatures |
+		                                     getCPUFeatureMask(FeatureSSE);
+		constexpr uint64_t K8Features = ThreeDNowAFeatures |
+		                                getCPUFeatureMask(FeatureSSE2);
+		constexpr uint64_t K8SSE3Features = ThreeDNowAFeatures |
+		                                    getCPUFeatureMask(FeatureSSE3);
+		constexpr uint64_t AMDFAM10Features = K8SSE3Features |
+		                                      getCPUFeatureMask(FeatureSSE4A) |
+		                                      getCPUFeatureMask(FeatureLZCNT) |
+		                                      getCPUFeatureMask(FeaturePOPCNT);
+		constexpr uint64_t BTVER1Features = getCPUFeatureMask(FeatureSSSE3) |
+		                                    getCPUFeatureMask(FeatureSSE4A) |
+		                                    getCPUFeatureMask(FeatureLZCNT) |
+		                                    getCPUFeatureMask(FeaturePOPCNT) |
+		                                    getCPUFeatureMask(FeaturePRFCHW) |
+		                                    getCPUFeatureMask(FeatureCX16);
+		constexpr uint64_t BTVER2Features = BTVER1Features |
+		                                    getCPUFeatureMask(FeatureAVX) |
+		                                    getCPUFeatureMask(FeatureAES) |
+		                                    getCPUFeatureMask(FeaturePCLMUL) |
+		                                    getCPUFeatureMask(FeatureBMI) |
+		                                    getCPUFeatureMask(FeatureF16C);
+		// xop implies avx, sse4a and fma4.
+		constexpr uint64_t BDVER1Features = getCPUFeatureMask(FeatureXOP) |
+		                                    getCPUFeatureMask(FeatureLZCNT) |
+		                                    getCPUFeatureMask(FeatureAES) |
+		                                    getCPUFeatureMask(FeaturePCLMUL) |
+		                                    getCPUFeatureMask(FeaturePRFCHW) |
+		                                    getCPUFeatureMask(FeatureCX16);
+		constexpr uint64_t BDVER2Features = BDVER1Features |
+		                                    getCPUFeatureMask(FeatureBMI) |
+		                                    getCPUFeatureMask(FeatureFMA) |
+		                                    getCPUFeatureMask(FeatureF16C) |
+		                                    getCPUFeatureMask(FeatureTBM);
+		constexpr uint64_t BDVER3Features = BDVER2Features |
+		                                    getCPUFeatureMask(FeatureFSGSBase);
+		constexpr uint64_t BDVER4Features = BDVER3Features |
+		                                    getCPUFeatureMask(FeatureAVX2) |
+		                                    getCPUFeatureMask(FeatureBMI2);
+		
+		CPUFeatures::CPUFeatures() { }
+		
+		CPUFeatures::CPUFeatures(const uint64_t mask)
+		: features_(mask) { }
+		
+		void CPUFeatures::add(const CPUFeature feature) {
+			features_.set(feature);
+		}
+		
+		static CPUFeature getCPUFeatureByName(const llvm::StringRef name) {
+			return llvm::StringSwitch<CPUFeature>(name)
+				.Case("3dnow", Feature3DNow)
+				.Case("3dnowa", Feature3DNowA)
+				.Case("adx", FeatureADX)
+				.Case("aes", FeatureAES)
+				.Case("avx", FeatureAVX)
+				.Case("avx2", FeatureAVX2)
+				.Case("avx512bw", FeatureAVX512BW)
+				.Case("avx512cd", FeatureAVX512CD)
+				.Case("avx512dq", FeatureAVX512DQ)
+				.Case("avx512er", FeatureAVX512ER)
+				.Case("avx512f", FeatureAVX512F)
+				.Case("avx512pf", FeatureAVX512PF)
+				.Case("avx512vl", FeatureAVX512VL)
+				.Case("bmi", FeatureBMI)
+				.Case("bmi2", FeatureBMI2)
+				.Case("cx16", FeatureCX16)
+				.Case("f16c", FeatureF16C)
+				.Case("fma", FeatureFMA)
+				.Case("fma4", FeatureFMA4)
+				.Case("fsgsbase", FeatureFSGSBase)
+				.Case("lzcnt", FeatureLZCNT)
+				.Case("mmx", FeatureMMX)
+				.Case("pclmul", FeaturePCLMUL)
+				.Case("popcnt", FeaturePOPCNT)
+				.Case("prfchw", FeaturePRFCHW)
+				.Case("rdrnd", FeatureRDRND)
+				.Case("rdseed", FeatureRDSEED)
+				.Case("rtm", FeatureRTM)
+				.Case("sse", FeatureSSE)
+				.Case("sse2", FeatureSSE2)
+				.Case("sse3", FeatureSSE3)
+				.Case("sse4", FeatureSSE42)
+				.Case("sse4.1", FeatureSSE41)
+				.Case("sse4.2", FeatureSSE42)
+				.Case("sse4a", FeatureSSE4A)
+				.Case("ssse3", FeatureSSSE3)
+				.Case("tbm", FeatureTBM)
+				.Case("xop", FeatureXOP)
+				.Default(NumCPUFeatures);
+		}
 		
 		void CPUFeatures::add(const std::string& feature) {
-			(void) features_.insert(feature);
-			
-			const auto level = llvm::StringSwitch<SSELevel>(feature)
-				.Case("avx512f", AVX512F)
-				.Case("avx512cd", AVX512F)
-				.Case("avx512er", AVX512F)
-				.Case("avx512pf", AVX512F)
-				.Case("avx512dq", AVX512F)
-				.Case("avx512bw", AVX512F)
-				.Case("avx512vl", AVX512F)
-				.Case("avx2", AVX2)
-				.Case("fma", AVX)
-				.Case("avx", AVX)
-				.Case("sse4", SSE42)
-				.Case("sse4.2", SSE42)
-				.Case("sse4.1", SSE41)
-				.Case("ssse3", SSSE3)
-				.Case("sse3", SSE3)
-				.Case("aes", SSE2)
-				.Case("pclmul", SSE2)
-				.Case("sse2", SSE2)
-				.Case("sse", SSE1)
-				.Default(NoSSE);
-			sseLevel_ = std::max(sseLevel_, level);
+			const auto featureEnum = getCPUFeatureByName(feature);
+			if (featureEnum != NumCPUFeatures) {
+				add(featureEnum);
+			}
+		}
+		
+		void CPUFeatures::remove(const CPUFeature feature) {
+			// Each SSE level's features depend on the level's base
+			// feature, as do all features of higher levels.
+			const struct {
+				CPUFeature baseFeature;
+				uint64_t levelMask;
+			} levels[] = {
+				{ FeatureSSE, SSE1LevelMask },
+				{ FeatureSSE2, SSE2LevelMask },
+				{ FeatureSSE3, SSE3LevelMask },
+				{ FeatureSSSE3, SSSE3LevelMask },
+				{ FeatureSSE41, SSE41LevelMask },
+				{ FeatureSSE42, SSE42LevelMask },
+				{ FeatureAVX, AVXLevelMask },
+				{ FeatureAVX2, AVX2LevelMask },
+				{ FeatureAVX512F, AVX512FLevelMask }
+			};
+			
+			uint64_t removeMask = getCPUFeatureMask(feature);
+			bool isDependent = false;
+			for (const auto& level: levels) {
+				isDependent = isDependent || level.baseFeature == feature;
+				if (isDependent) {
+					removeMask |= level.levelMask;
+				}
+			}
+			
+			features_ &= std::bitset<NumCPUFeatures>(~removeMask);
+		}
+		
+		bool CPUFeatures::has(const CPUFeature feature) const {
+			return features_.test(feature);
+		}
+		
+		uint64_t CPUFeatures::mask() const {
+			return features_.to_ullong();
+		}
+		
+		bool CPUFeatures::operator==(const CPUFeatures& other) const {
+			return features_ == other.features_;
+		}
+		
+		bool CPUFeatures::operator!=(const CPUFeatures& other) const {
+			return features_ != other.features_;
 		}
 		
 		bool CPUFeatures::hasAVX() const {
 			return sseLevel() >= AVX;
 		}
 		
+		bool CPUFeatures::hasAVX512F() const {
+			return sseLevel() >= AVX512F;
+		}
+		
 		SSELevel CPUFeatures::sseLevel() const {
-			return sseLevel_;
+			const uint64_t mask = this->mask();
+			if ((mask & AVX512FLevelMask) != 0) return AVX512F;
+			if ((mask & AVX2LevelMask) != 0) return AVX2;
+			if ((mask & AVXLevelMask) != 0) return AVX;
+			if ((mask & SSE42LevelMask) != 0) return SSE42;
+			if ((mask & SSE41LevelMask) != 0) return SSE41;
+			if ((mask & SSSE3LevelMask) != 0) return SSSE3;
+			if ((mask & SSE3LevelMask) != 0) return SSE3;
+			if ((mask & SSE2LevelMask) != 0) return SSE2;
+			if ((mask & SSE1LevelMask) != 0) return SSE1;
+			return NoSSE;
 		}
 		
-		CPUFeatures getCPUFeatures(const llvm::Triple& targetTriple,
-		                           const CPUKind cpu) {
-			CPUFeatures features;
-			
-			// X86_64 always has SSE2.
-			if (targetTriple.getArch() == llvm::Triple::x86_64) {
-				features.add("sse2");
-			}
-			
+		static uint64_t getCPUKindFeatureMask(const CPUKind cpu) {
 			switch (cpu) {
 				case CK_Generic:
 				case CK_i386:
@@ -66,166 +270,235 @@ namespace llvm_abi {
 				case CK_Pentium:
 				case CK_i686:
 				case CK_PentiumPro:
-					break;
+					return 0;
 				case CK_PentiumMMX:
 				case CK_Pentium2:
 				case CK_K6:
 				case CK_WinChipC6:
-					features.add("mmx");
-					break;
+					return MMXFeatures;
 				case CK_Pentium3:
 				case CK_Pentium3M:
 				case CK_C3_2:
-					features.add("sse");
-					break;
+					return SSEFeatures;
 				case CK_PentiumM:
 				case CK_Pentium4:
 				case CK_Pentium4M:
 				case CK_x86_64:
-					features.add("sse2");
-					break;
+					return SSE2Features;
 				case CK_Yonah:
 				case CK_Prescott:
 				case CK_Nocona:
-					features.add("sse3");
-					features.add("cx16");
-					break;
+					return SSE3Features;
 				case CK_Core2:
 				case CK_Bonnell:
-					features.add("ssse3");
-					features.add("cx16");
-					break;
+					return SSSE3Features;
 				case CK_Penryn:
-					features.add("sse4.1");
-					features.add("cx16");
-					break;
+					return PenrynFeatures;
 				case CK_Skylake:
-					features.add("avx512f");
-					features.add("avx512cd");
-					features.add("avx512dq");
-					features.add("avx512bw");
-					features.add("avx512vl");
-					// FALLTHROUGH
+					return SkylakeFeatures;
 				case CK_Broadwell:
-					features.add("rdseed");
-					features.add("adx");
-					// FALLTHROUGH
+					return BroadwellFeatures;
 				case CK_Haswell:
-					features.add("avx2");
-					features.add("lzcnt");
-					features.add("bmi");
-					features.add("bmi2");
-					features.add("rtm");
-					features.add("fma");
-					// FALLTHROUGH
+					return HaswellFeatures;
 				case CK_IvyBridge:
-					features.add("rdrnd");
-					features.add("f16c");
-					features.add("fsgsbase");
-					// FALLTHROUGH
+					return IvyBridgeFeatures;
 				case CK_SandyBridge:
-					features.add("avx");
-					// FALLTHROUGH
+					return SandyBridgeFeatures;
 				case CK_Westmere:
 				case CK_Silvermont:
-					features.add("aes");
-					features.add("pclmul");
-					// FALLTHROUGH
+					return WestmereFeatures;
 				case CK_Nehalem:
-					features.add("sse4.2");
-					features.add("cx16");
-					break;
+					return NehalemFeatures;
 				case CK_KNL:
-					features.add("avx512f");
-					features.add("avx512cd");
-					features.add("avx512er");
-					features.add("avx512pf");
-					features.add("rdseed");
-					features.add("adx");
-					features.add("lzcnt");
-					features.add("bmi");
-					features.add("bmi2");
-					features.add("rtm");
-					features.add("fma");
-					features.add("rdrnd");
-					features.add("f16c");
-					features.add("fsgsbase");
-					features.add("aes");
-					features.add("pclmul");
-					features.add("cx16");
-					break;
+					return KNLFeatures;
 				case CK_K6_2:
 				case CK_K6_3:
 				case CK_WinChip2:
 				case CK_C3:
-					features.add("3dnow");
-					break;
+					return ThreeDNowFeatures;
 				case CK_Athlon:
 				case CK_AthlonThunderbird:
 				case CK_Geode:
-					features.add("3dnowa");
-					break;
+					return ThreeDNowAFeatures;
 				case CK_Athlon4:
 				case CK_AthlonXP:
 				case CK_AthlonMP:
-					features.add("sse");
-					features.add("3dnowa");
-					break;
+					return Athlon4Features;
 				case CK_K8:
 				case CK_Opteron:
 				case CK_Athlon64:
 				case CK_AthlonFX:
-					features.add("sse2");
-					features.add("3dnowa");
-					break;
+					return K8Features;
 				case CK_AMDFAM10:
-					features.add("sse4a");
-					features.add("lzcnt");
-					features.add("popcnt");
-					// FALLTHROUGH
+					return AMDFAM10Features;
 				case CK_K8SSE3:
 				case CK_OpteronSSE3:
 				case CK_Athlon64SSE3:
-					features.add("sse3");
-					features.add("3dnowa");
-					break;
+					return K8SSE3Features;
 				case CK_BTVER2:
-					features.add("avx");
-					features.add("aes");
-					features.add("pclmul");
-					features.add("bmi");
-					features.add("f16c");
-					// FALLTHROUGH
+					return BTVER2Features;
 				case CK_BTVER1:
-					features.add("ssse3");
-					features.add("sse4a");
-					features.add("lzcnt");
-					features.add("popcnt");
-					features.add("prfchw");
-					features.add("cx16");
-					break;
+					return BTVER1Features;
 				case CK_BDVER4:
-					features.add("avx2");
-					features.add("bmi2");
-					// FALLTHROUGH
+					return BDVER4Features;
 				case CK_BDVER3:
-					features.add("fsgsbase");
-					// FALLTHROUGH
+					return BDVER3Features;
 				case CK_BDVER2:
-					features.add("bmi");
-					features.add("fma");
-					features.add("f16c");
-					features.add("tbm");
-					// FALLTHROUGH
+					return BDVER2Features;
 				case CK_BDVER1:
-					// xop implies avx, sse4a and fma4.
-					features.add("xop");
-					features.add("lzcnt");
-					features.add("aes");
-					features.add("pclmul");
-					features.add("prfchw");
-					features.add("cx16");
-					break;
+					return BDVER1Features;
+			}
+			
+			return 0;
+		}
+		
+		CPUFeatures getCPUFeatures(const llvm::Triple& targetTriple,
+		                           const CPUKind cpu) {
+			CPUFeatures features(getCPUKindFeatureMask(cpu));
+			
+			// X86_64 always has SSE2.
+			if (targetTriple.getArch() == llvm::Triple::x86_64) {
+				features.add(FeatureSSE2);
+			}
+			
+			return features;
+		}
+		
+		CPUFeatures getCPUFeatures(const llvm::Triple& targetTriple,
+		                           const std::string& cpuName) {
+			if (cpuName != "native") {
+				return getCPUFeatures(targetTriple,
+				                      getCPUKind(targetTriple, cpuName));
+			}
+			
+			auto features = getHostCPUFeatures();
+			
+			// X86_64 always has SSE2.
+			if (targetTriple.getArch() == llvm::Triple::x86_64) {
+				features.add(FeatureSSE2);
+			}
+			
+			return features;
+		}
+		
+#ifdef LLVMABI_HOST_HAS_CPUID
+		static bool isBitSet(const unsigned value, const unsigned bit) {
+			return ((value >> bit) & 1) != 0;
+		}
+		
+		static unsigned getXCR0() {
+			unsigned eax, edx;
+			// xgetbv, which older assemblers don't know.
+			__asm__ volatile(".byte 0x0f, 0x01, 0xd0"
+			                 : "=a"(eax), "=d"(edx)
+			                 : "c"(0));
+			(void) edx;
+			return eax;
+		}
+		
+		static CPUFeatures computeHostCPUFeatures() {
+			CPUFeatures features;
+			
+			unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+			const auto maxLeaf = __get_cpuid_max(0, nullptr);
+			if (maxLeaf < 1 || !__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+				return features;
+			}
+			
+			if (isBitSet(edx, 23)) features.add(FeatureMMX);
+			if (isBitSet(edx, 25)) features.add(FeatureSSE);
+			if (isBitSet(edx, 26)) features.add(FeatureSSE2);
+			if (isBitSet(ecx, 0)) features.add(FeatureSSE3);
+			if (isBitSet(ecx, 1)) features.add(FeaturePCLMUL);
+			if (isBitSet(ecx, 9)) features.add(FeatureSSSE3);
+			if (isBitSet(ecx, 13)) features.add(FeatureCX16);
+			if (isBitSet(ecx, 19)) features.add(FeatureSSE41);
+			if (isBitSet(ecx, 20)) features.add(FeatureSSE42);
+			if (isBitSet(ecx, 23)) features.add(FeaturePOPCNT);
+			if (isBitSet(ecx, 25)) features.add(FeatureAES);
+			if (isBitSet(ecx, 30)) features.add(FeatureRDRND);
+			
+			// AVX registers are only usable if the OS saves the YMM
+			// state (and, for AVX-512, the opmask and ZMM state).
+			const bool hasOSXSave = isBitSet(ecx, 27);
+			const auto xcr0 = hasOSXSave ? getXCR0() : 0;
+			const bool hasAVXSave = hasOSXSave && (xcr0 & 0x6) == 0x6;
+			const bool hasAVX512Save = hasAVXSave && (xcr0 & 0xe0) == 0xe0;
+			
+			if (hasAVXSave) {
+				if (isBitSet(ecx, 28)) features.add(FeatureAVX);
+				if (isBitSet(ecx, 12)) features.add(FeatureFMA);
+				if (isBitSet(ecx, 29)) features.add(FeatureF16C);
+			}
+			
+			if (maxLeaf >= 7) {
+				__cpuid_count(7, 0, eax, ebx, ecx, edx);
+				
+				if (isBitSet(ebx, 0)) features.add(FeatureFSGSBase);
+				if (isBitSet(ebx, 3)) features.add(FeatureBMI);
+				if (isBitSet(ebx, 8)) features.add(FeatureBMI2);
+				if (isBitSet(ebx, 11)) features.add(FeatureRTM);
+				if (isBitSet(ebx, 18)) features.add(FeatureRDSEED);
+				if (isBitSet(ebx, 19)) features.add(FeatureADX);
+				if (hasAVXSave && isBitSet(ebx, 5)) features.add(FeatureAVX2);
+				
+				if (hasAVX512Save) {
+					if (isBitSet(ebx, 16)) features.add(FeatureAVX512F);
+					if (isBitSet(ebx, 17)) features.add(FeatureAVX512DQ);
+					if (isBitSet(ebx, 26)) features.add(FeatureAVX512PF);
+					if (isBitSet(ebx, 27)) features.add(FeatureAVX512ER);
+					if (isBitSet(ebx, 28)) features.add(FeatureAVX512CD);
+					if (isBitSet(ebx, 30)) features.add(FeatureAVX512BW);
+					if (isBitSet(ebx, 31)) features.add(FeatureAVX512VL);
+				}
+			}
+			
+			const auto maxExtLeaf = __get_cpuid_max(0x80000000, nullptr);
+			if (maxExtLeaf >= 0x80000001 &&
+			    __get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx)) {
+				if (isBitSet(ecx, 5)) features.add(FeatureLZCNT);
+				if (isBitSet(ecx, 6)) features.add(FeatureSSE4A);
+				if (isBitSet(ecx, 8)) features.add(FeaturePRFCHW);
+				if (hasAVXSave && isBitSet(ecx, 11)) features.add(FeatureXOP);
+				if (hasAVXSave && isBitSet(ecx, 16)) features.add(FeatureFMA4);
+				if (isBitSet(edx, 30)) features.add(Feature3DNowA);
+				if (isBitSet(edx, 31)) features.add(Feature3DNow);
+			}
+			
+			return features;
+		}
+#else
+		static CPUFeatures computeHostCPUFeatures() {
+			return CPUFeatures();
+		}
+#endif
+		
+		const CPUFeatures& getHostCPUFeatures() {
+			static const CPUFeatures hostFeatures = computeHostCPUFeatures();
+			return hostFeatures;
+		}
+		
+		CPUFeatures applyTargetFeatures(CPUFeatures features,
+		                                llvm::StringRef targetFeatures) {
+			while (!targetFeatures.empty()) {
+				const auto split = targetFeatures.split(',');
+				const auto featureString = split.first.trim();
+				targetFeatures = split.second;
+				
+				if (featureString.size() < 2) {
+					continue;
+				}
+				
+				const auto feature = getCPUFeatureByName(featureString.substr(1));
+				if (feature == NumCPUFeatures) {
+					continue;
+				}
+				
+				if (featureString[0] == '+') {
+					features.add(feature);
+				} else if (featureString[0] == '-') {
+					features.remove(feature);
+				}
 			}
 			
 			return features;
@@ -2,6 +2,7 @@
 
 #include <llvm/ADT/StringSwitch.h>
 #include <llvm/ADT/Triple.h>
+#include <llvm/Support/Host.h>
 
 #include <llvm-abi/x86/CPUKind.hpp>
 
@@ -11,6 +12,10 @@ namespace llvm_abi {
 		
 		std::string selectCPUName(const llvm::Triple& /*targetTriple*/,
 		                          const std::string& cpu) {
+			if (cpu == "native") {
+				return llvm::sys::getHostCPUName().str();
+			}
+			
 			// TODO!
 			return !cpu.empty() ? cpu : "x86-64";
 		}
@@ -58,6 +63,7 @@ namespace llvm_abi {
 				.Case("broadwell", CK_Broadwell)
 				.Case("skylake", CK_Skylake)
 				.Case("skx", CK_Skylake) // Legacy name.
+				.Case("skylake-avx512", CK_Skylake)
 				.Case("knl", CK_KNL)
 				.Case("k6", CK_K6)
 				.Case("k6-2", CK_K6_2)
@@ -86,6 +92,15 @@ namespace llvm_abi {
 				.Case("geode", CK_Geode)
 				.Default(CK_Generic);
 			
+			if (cpu == CK_Generic && userCPUString == "native") {
+				// The host CPU may be newer than any CPU we know
+				// (or just "generic"); its features are queried
+				// directly (see getHostCPUFeatures()), so only a
+				// baseline kind is needed.
+				return targetTriple.getArch() == llvm::Triple::x86_64 ?
+				       CK_x86_64 : CK_i686;
+			}
+			
 			// Perform any per-CPU checks necessary to determine if
 			// this CPU is acceptable.
 			switch (cpu) {
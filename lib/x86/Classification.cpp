@@ -153,14 +153,15 @@ namespace llvm_abi {
 							addField(offset, Sse);
 						}
 					} else if (size.asBits() == 128 ||
-						   (isNamedArg && size.asBits() == 256 && typeInfo.isLegalVectorType(type))) {
-						// Arguments of 256-bits are split into four eightbyte chunks. The
-						// least significant one belongs to class SSE and all the others to class
-						// SSEUP. The original Lo and Hi design considers that types can't be
-						// greater than 128-bits, so a 64-bit split in Hi and Lo makes sense.
-						// This design isn't correct for 256-bits, but since there're no cases
-						// where the upper parts would need to be inspected, avoid adding
-						// complexity and just consider Hi to match the 64-256 part.
+						   (isNamedArg && typeInfo.isLegalVectorType(type))) {
+						// Arguments of 256-bits (or 512-bits with AVX-512) are split into
+						// four (or eight) eightbyte chunks. The least significant one belongs
+						// to class SSE and all the others to class SSEUP. The original Lo and
+						// Hi design considers that types can't be greater than 128-bits, so a
+						// 64-bit split in Hi and Lo makes sense. This design isn't correct for
+						// larger vectors, but since there're no cases where the upper parts
+						// would need to be inspected, avoid adding complexity and just
+						// consider Hi to match the 64-512 part.
 						//
 						// Note that per 3.5.7 of AMD64-ABI, 256-bit args are only passed in
 						// registers if they are "named", i.e. not part of the "..." of a
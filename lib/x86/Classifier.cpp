@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <climits>
 #include <cstddef>
 
 #include <llvm/IR/DataLayout.h>
@@ -8,6 +9,7 @@
 #include <llvm-abi/ABITypeInfo.hpp>
 #include <llvm-abi/ArgInfo.hpp>
 #include <llvm-abi/DataSize.hpp>
+#include <llvm-abi/FastInternalClassifier.hpp>
 #include <llvm-abi/FunctionType.hpp>
 #include <llvm-abi/Type.hpp>
 #include <llvm-abi/TypeBuilder.hpp>
@@ -41,8 +43,9 @@ namespace llvm_abi {
 		
 		ArgInfo getIndirectReturnResult(const Type type) {
 			// If this is a scalar LLVM value then assume LLVM will
-			// pass it in the right place naturally.
-			if (!type.isAggregateType()) {
+			// pass it in the right place naturally. (Complex values
+			// are aggregates as far as the ABI is concerned.)
+			if (!type.isAggregateType() && !type.isComplex()) {
 				return type.isPromotableIntegerType() ?
 				       ArgInfo::getExtend(type) : ArgInfo::getDirect(type);
 			}
@@ -61,12 +64,19 @@ namespace llvm_abi {
 			// the argument in the free register. This does not seem to happen currently,
 			// but this code would be much safer if we could mark the argument with
 			// 'onstack'. See PR12193.
-			if (!type.isAggregateType() &&
+			if (!type.isAggregateType() && !type.isComplex() &&
 			    (!type.isVector() || typeInfo.isLegalVectorType(type))) {
 				return type.isPromotableIntegerType() ?
 					ArgInfo::getExtend(type) : ArgInfo::getDirect(type);
 			}
 			
+			// Non-trivial C++ records are passed by reference to a copy made
+			// by the caller, since the ABI can't copy them itself.
+			if (type.isNonTrivialRecord()) {
+				return ArgInfo::getIndirect(typeInfo.getTypeRequiredAlign(type).asBytes(),
+				                            /*ByVal=*/false);
+			}
+			
 			// Compute the byval alignment. We specify the alignment of the byval in all
 			// cases so that the mid-level optimizer knows the alignment of the byval.
 			const auto align = std::max<DataSize>(typeInfo.getTypeRequiredAlign(type), DataSize::Bytes(8));
@@ -106,8 +116,8 @@ namespace llvm_abi {
 			return ArgInfo::getIndirect(align.asBytes());
 		}
 		
-		/// The ABI specifies that a value should be passed in a full vector XMM/YMM
-		/// register. Pick an LLVM IR type that will be passed as a vector register.
+		/// The ABI specifies that a value should be passed in a full vector
+		/// XMM/YMM/ZMM register. Pick an LLVM IR type that will be passed as a vector register.
 		Type getByteVectorType(const ABITypeInfo& typeInfo, Type type) {
 			// Wrapper structs/arrays that only contain vectors are passed just like
 			// vectors; strip them off if present.
@@ -122,8 +132,9 @@ namespace llvm_abi {
 				const auto width = typeInfo.getTypeRawSize(type);
 				const auto elementType = type.vectorElementType();
 				const auto elementSize = typeInfo.getTypeRawSize(elementType);
-				if ((width.asBits() >= 128 && width.asBits() <= 256) &&
-					(elementType.isFloat() || elementType.isDouble() ||
+				if ((width.asBits() >= 128 && width.asBits() <= 512) &&
+					(elementType.isHalfFloat() ||
+					 elementType.isFloat() || elementType.isDouble() ||
 					 (elementType.isInteger() &&
 					  (elementSize.asBits() == 8 ||
 					   elementSize.asBits() == 16 ||
@@ -138,17 +149,17 @@ namespace llvm_abi {
 		}
 		
 		/**
-		 * Return true if the specified LLVM IR type has a float member
-		 * at the specified offset.  For example, {int,{float}} has a
-		 * float at offset 4.  It is conservatively correct for this
-		 * routine to return false.
+		 * Return the floating point type of the specified LLVM IR type's
+		 * member at the specified offset, or void if there isn't one.
+		 * For example, {int,{float}} has a float at offset 4.  It is
+		 * conservatively correct for this routine to return void.
 		 */
-		static bool containsFloatAtOffset(const ABITypeInfo& typeInfo,
-		                                  const Type type,
-		                                  const DataSize offset) {
-			// Base case if we find a float.
-			if (offset.asBytes() == 0 && type.isFloat()) {
-				return true;
+		static Type getFloatingPointTypeAtOffset(const ABITypeInfo& typeInfo,
+		                                         const Type type,
+		                                         const DataSize offset) {
+			// Base case if we find a floating point value.
+			if (offset.asBytes() == 0 && type.isFloatingPoint()) {
+				return type;
 			}
 			
 			// If this is a struct, recurse into the field at the specified offset.
@@ -157,9 +168,9 @@ namespace llvm_abi {
 				const auto fieldIndex = getFieldContainingOffset(fieldOffsets, offset);
 				assert(fieldOffsets[fieldIndex] <= offset);
 				const auto relativeOffset = offset - fieldOffsets[fieldIndex];
-				return containsFloatAtOffset(typeInfo,
-				                             type.structMembers()[fieldIndex].type(),
-				                             relativeOffset);
+				return getFloatingPointTypeAtOffset(typeInfo,
+				                                    type.structMembers()[fieldIndex].type(),
+				                                    relativeOffset);
 			}
 			
 			// If this is an array, recurse into the field at the specified offset.
@@ -169,12 +180,36 @@ namespace llvm_abi {
 				const auto elementOffset = elementSize * (offset / elementSize);
 				assert(elementOffset <= offset);
 				const auto relativeOffset = offset - elementOffset;
-				return containsFloatAtOffset(typeInfo,
-				                             elementType,
-				                             relativeOffset);
+				return getFloatingPointTypeAtOffset(typeInfo,
+				                                    elementType,
+				                                    relativeOffset);
 			}
 			
-			return false;
+			// A complex value holds its real part followed by its
+			// imaginary part, so '_Complex float' has floats at 0 and 4.
+			if (type.isComplex()) {
+				const auto elementType = type.complexFloatingPointType();
+				const auto elementSize = typeInfo.getTypeAllocSize(elementType);
+				if (offset >= elementSize * 2) {
+					return VoidTy;
+				}
+				const auto relativeOffset = offset - elementSize * (offset / elementSize);
+				return getFloatingPointTypeAtOffset(typeInfo,
+				                                    elementType,
+				                                    relativeOffset);
+			}
+			
+			return VoidTy;
+		}
+		
+		/**
+		 * Return true if the specified LLVM IR type has a float member
+		 * at the specified offset.
+		 */
+		static bool containsFloatAtOffset(const ABITypeInfo& typeInfo,
+		                                  const Type type,
+		                                  const DataSize offset) {
+			return getFloatingPointTypeAtOffset(typeInfo, type, offset).isFloat();
 		}
 		
 		/**
@@ -192,12 +227,26 @@ namespace llvm_abi {
 			assert(sourceOffset.asBytes() == 0 ||
 			       sourceOffset.asBytes() == 8);
 			
-			// The only three choices we have are either double,
-			// <2 x float>, or float.
+			// The choices we have are double, <2 x float>, float,
+			// or (for _Float16 values) half, <2 x half> and
+			// <4 x half>.
+			const auto firstType = getFloatingPointTypeAtOffset(typeInfo, type, offset);
+			const auto secondType = getFloatingPointTypeAtOffset(typeInfo, type, offset + DataSize::Bytes(4));
 			
 			if (sourceType.bitsContainNoUserData(typeInfo,
 			                                     sourceOffset.asBits() + 32,
 			                                     sourceOffset.asBits() + 64)) {
+				if (firstType.isHalfFloat()) {
+					// Pass a lone half as half, otherwise
+					// the low 4 bytes hold two halves.
+					if (sourceType.bitsContainNoUserData(typeInfo,
+					                                     sourceOffset.asBits() + 16,
+					                                     sourceOffset.asBits() + 32)) {
+						return HalfFloatTy;
+					}
+					return typeInfo.typeBuilder().getVectorTy(2, HalfFloatTy);
+				}
+				
 				// We pass as float if the last 4 bytes is just
 				// padding.  This happens for structs that
 				// contain 3 floats.
@@ -207,11 +256,16 @@ namespace llvm_abi {
 			// We want to pass as <2 x float> if the LLVM IR type
 			// contains a float at offset+0 and offset+4.  Walk
 			// the type to find out if this is the case.
-			if (containsFloatAtOffset(typeInfo, type, offset) &&
-			    containsFloatAtOffset(typeInfo, type, offset + DataSize::Bytes(4))) {
+			if (firstType.isFloat() && secondType.isFloat()) {
 				return typeInfo.typeBuilder().getVectorTy(2, FloatTy);
 			}
 			
+			// Eightbytes mixing halves with other floating point
+			// values are passed as <4 x half>.
+			if (firstType.isHalfFloat() || secondType.isHalfFloat()) {
+				return typeInfo.typeBuilder().getVectorTy(4, HalfFloatTy);
+			}
+			
 			return DoubleTy;
 		}
 		
@@ -372,9 +426,17 @@ namespace llvm_abi {
 		                                    const bool isNamedArg) {
 			Classification classification;
 			
-			if (typeInfo_.getTypeAllocSize(type).asBytes() > 32 ||
+			// AMD64-ABI 3.2.3p1: Rule 2. If a C++ object has either a non-trivial
+			// copy constructor or a non-trivial destructor, it is passed by
+			// invisible reference.
+			if (type.isNonTrivialRecord()) {
+				classification.addField(0, Memory);
+				return classification;
+			}
+			
+			if (typeInfo_.getTypeAllocSize(type).asBytes() > 64 ||
 			    type.hasUnalignedFields(typeInfo_)) {
-				// If size exceeds "four eightbytes" or type
+				// If size exceeds "eight eightbytes" or type
 				// has "unaligned fields", pass in memory.
 				classification.addField(0, Memory);
 				return classification;
@@ -395,8 +457,10 @@ namespace llvm_abi {
 			// If the size of the aggregate exceeds two eightbytes
 			// and the first eight-byte isn’t SSE or any other
 			// eightbyte isn’t SSEUP, the whole argument is passed
-			// in memory.
-			if (typeInfo_.getTypeAllocSize(type).asBytes() > 16 &&
+			// in memory. (This doesn't apply to complex long double,
+			// which is classified as COMPLEX_X87.)
+			if (type.isAggregateType() &&
+			    typeInfo_.getTypeAllocSize(type).asBytes() > 16 &&
 			    (classification.low() != Sse ||
 			     classification.high() != SseUp)) {
 				classification.addField(0, Memory);
@@ -540,9 +604,7 @@ namespace llvm_abi {
 				case X87: {
 					llvm_unreachable("High word can't be X87.");
 				}
-				case ComplexX87: {
-					llvm_unreachable("High word can't be ComplexX87.");
-				}
+				case ComplexX87:
 				case NoClass: {
 					// Already handled.
 					break;
@@ -631,17 +693,265 @@ namespace llvm_abi {
 			                    /*isNamedArg=*/true);
 		}
 		
+		ArgInfo Classifier::classifyRegCallStructTypeImpl(const Type type,
+		                                                  unsigned& neededInt,
+		                                                  unsigned& neededSse) {
+			assert(type.isStruct());
+			
+			if (type.hasFlexibleArrayMember() ||
+			    type.isNonTrivialRecord()) {
+				neededInt = neededSse = 0;
+				return getIndirectReturnResult(type);
+			}
+			
+			// Sum up members.
+			for (const auto& member: type.structMembers()) {
+				const auto memberType = member.type();
+				if (memberType.isStruct()) {
+					if (classifyRegCallStructTypeImpl(memberType,
+					                                  neededInt,
+					                                  neededSse).isIndirect()) {
+						neededInt = neededSse = 0;
+						return getIndirectReturnResult(type);
+					}
+				} else {
+					unsigned localNeededInt = 0;
+					unsigned localNeededSse = 0;
+					if (classifyType(memberType,
+					                 /*isArgument=*/true,
+					                 /*freeIntRegs=*/UINT_MAX,
+					                 localNeededInt,
+					                 localNeededSse,
+					                 /*isNamedArg=*/true).isIndirect()) {
+						neededInt = neededSse = 0;
+						return getIndirectReturnResult(type);
+					}
+					neededInt += localNeededInt;
+					neededSse += localNeededSse;
+				}
+			}
+			
+			return ArgInfo::getDirect(type);
+		}
+		
+		ArgInfo Classifier::classifyRegCallStructType(const Type type,
+		                                              unsigned& neededInt,
+		                                              unsigned& neededSse) {
+			neededInt = 0;
+			neededSse = 0;
+			return classifyRegCallStructTypeImpl(type,
+			                                     neededInt,
+			                                     neededSse);
+		}
+		
+		bool Classifier::classifySwiftEightbytes(const Type type,
+		                                         const DataSize offset,
+		                                         llvm::MutableArrayRef<ArgClass> classes) {
+			const auto size = typeInfo_.getTypeAllocSize(type);
+			if (size.asBytes() == 0) {
+				return true;
+			}
+			
+			if (type.isStruct()) {
+				const auto& members = type.structMembers();
+				const auto fieldOffsets = typeInfo_.calculateStructOffsets(members);
+				for (size_t i = 0; i < members.size(); i++) {
+					if (!classifySwiftEightbytes(members[i].type(),
+					                             offset + fieldOffsets[i],
+					                             classes)) {
+						return false;
+					}
+				}
+				return true;
+			}
+			
+			if (type.isUnion()) {
+				for (const auto& member: type.unionMembers()) {
+					if (!classifySwiftEightbytes(member.type(),
+					                             offset,
+					                             classes)) {
+						return false;
+					}
+				}
+				return true;
+			}
+			
+			if (type.isArray()) {
+				const auto elementType = type.arrayElementType();
+				const auto elementSize = typeInfo_.getTypeAllocSize(elementType);
+				for (size_t i = 0; i < type.arrayElementCount(); i++) {
+					if (!classifySwiftEightbytes(elementType,
+					                             offset + elementSize * i,
+					                             classes)) {
+						return false;
+					}
+				}
+				return true;
+			}
+			
+			if (type.isComplex()) {
+				const auto elementType = type.complexFloatingPointType();
+				const auto elementSize = typeInfo_.getTypeAllocSize(elementType);
+				return classifySwiftEightbytes(elementType, offset, classes) &&
+				       classifySwiftEightbytes(elementType, offset + elementSize, classes);
+			}
+			
+			ArgClass leafClass;
+			if (type.isPointer() || type.isInteger()) {
+				leafClass = Integer;
+			} else if ((type.isFloatingPoint() || type.isVector()) &&
+			           size.asBytes() <= 8) {
+				leafClass = Sse;
+			} else {
+				// x87 and wide vector values keep the C ABI's rules.
+				return false;
+			}
+			
+			const size_t first = offset.asBytes() / 8;
+			const size_t last = std::min<size_t>((offset + size).asBytes() - 1,
+			                                     classes.size() * 8 - 1) / 8;
+			if (first != last && leafClass == Sse) {
+				// Unaligned floating point values can't be split
+				// across registers.
+				return false;
+			}
+			
+			for (size_t i = first; i <= last; i++) {
+				classes[i] = mergeClasses(classes[i], leafClass);
+			}
+			
+			return true;
+		}
+		
+		ArgInfo Classifier::classifySwiftReturnType(const Type type) {
+			const auto returnInfo = classifyReturnType(type);
+			if (!returnInfo.isIndirect() ||
+			    type.isNonTrivialRecord() ||
+			    (type.isRecordType() && type.hasFlexibleArrayMember())) {
+				return returnInfo;
+			}
+			
+			const size_t numEightbytes = (typeInfo_.getTypeAllocSize(type).asBytes() + 7) / 8;
+			if (numEightbytes > 8) {
+				return returnInfo;
+			}
+			
+			llvm::SmallVector<ArgClass, 8> classes(numEightbytes, NoClass);
+			if (!classifySwiftEightbytes(type, DataSize::Bytes(0), classes)) {
+				return returnInfo;
+			}
+			
+			// Tail padding doesn't need to be returned.
+			while (!classes.empty() && classes.back() == NoClass) {
+				classes.pop_back();
+			}
+			
+			// Build a struct with one register-sized element per
+			// eightbyte; each element must stay 8-byte aligned so
+			// only the final element can be narrowed.
+			llvm::SmallVector<Type, 8> elementTypes;
+			unsigned numInt = 0;
+			unsigned numSse = 0;
+			for (size_t i = 0; i < classes.size(); i++) {
+				const auto elementOffset = DataSize::Bytes(i * 8);
+				const bool isLast = (i + 1) == classes.size();
+				const bool upperIsPadding =
+					type.bitsContainNoUserData(typeInfo_,
+					                           elementOffset.asBits() + 32,
+					                           elementOffset.asBits() + 64);
+					
+				if (classes[i] == Sse) {
+					numSse++;
+					if (isLast && upperIsPadding) {
+						elementTypes.push_back(FloatTy);
+					} else if (containsFloatAtOffset(typeInfo_, type, elementOffset) &&
+					           (upperIsPadding ||
+					            containsFloatAtOffset(typeInfo_, type, elementOffset + DataSize::Bytes(4)))) {
+						elementTypes.push_back(typeInfo_.typeBuilder().getVectorTy(2, FloatTy));
+					} else {
+						elementTypes.push_back(DoubleTy);
+					}
+					continue;
+				}
+				
+				// Padding between fields is returned in an integer
+				// register to keep the remaining elements in place.
+				numInt++;
+				Type elementType = Int64Ty;
+				if (isLast) {
+					for (const auto& narrowType: { Int8Ty, Int16Ty, Int32Ty }) {
+						const auto narrowSize = narrowType.integerWidth();
+						if (type.bitsContainNoUserData(typeInfo_,
+						                               elementOffset.asBits() + narrowSize.asBits(),
+						                               elementOffset.asBits() + 64)) {
+							elementType = narrowType;
+							break;
+						}
+					}
+				}
+				elementTypes.push_back(elementType);
+			}
+			
+			// swiftcc returns in RAX, RDX, RCX, R8 and XMM0-3.
+			if (numInt > 4 || numSse > 4) {
+				return returnInfo;
+			}
+			
+			return ArgInfo::getDirect(typeInfo_.typeBuilder().getStructTy(elementTypes));
+		}
+		
 		llvm::SmallVector<ArgInfo, 8>
 		Classifier::classifyFunctionType(const FunctionType& functionType,
-		                                 llvm::ArrayRef<Type> argumentTypes) {
-			ArgInfo returnInfo = classifyReturnType(functionType.returnType());
+		                                 llvm::ArrayRef<Type> argumentTypes,
+		                                 RegisterUsage* const registerUsage) {
+			if (functionType.callingConvention() == CC_FastInternal) {
+				// fastcc takes arguments in the same registers as the C
+				// convention, and returns in RAX/RDX/RCX and XMM0-3.
+				const FastInternalRegisterBudget budget(/*numIntArgRegs=*/6,
+				                                        /*numFloatArgRegs=*/8,
+				                                        /*numIntReturnRegs=*/3,
+				                                        /*numFloatReturnRegs=*/4,
+				                                        /*useInRegForArgs=*/false);
+				FastInternalClassifier classifier(typeInfo_, budget);
+				return classifier.classifyFunctionType(functionType,
+				                                       argumentTypes,
+				                                       registerUsage);
+			}
 			
-			llvm::SmallVector<ArgInfo, 8> argInfoArray;
-			argInfoArray.push_back(returnInfo);
+			const bool isRegCall = functionType.callingConvention() == CC_RegCall;
 			
 			// Keep track of the number of assigned registers.
-			unsigned freeIntRegs = 6;
-			unsigned freeSseRegs = 8;
+			const unsigned numIntRegs = isRegCall ? 11 : 6;
+			const unsigned numSseRegs = isRegCall ? 16 : 8;
+			unsigned freeIntRegs = numIntRegs;
+			unsigned freeSseRegs = numSseRegs;
+			
+			const auto returnType = functionType.returnType();
+			ArgInfo returnInfo;
+			if (isRegCall && returnType.isStruct()) {
+				unsigned neededInt = 0;
+				unsigned neededSse = 0;
+				returnInfo = classifyRegCallStructType(returnType,
+				                                       neededInt,
+				                                       neededSse);
+				if (freeIntRegs >= neededInt && freeSseRegs >= neededSse) {
+					freeIntRegs -= neededInt;
+					freeSseRegs -= neededSse;
+				} else {
+					returnInfo = getIndirectReturnResult(returnType);
+				}
+			} else if (isRegCall && returnType.isComplex() &&
+			           returnType.complexKind() == LongDouble) {
+				// Complex long double is returned in memory for regcall.
+				returnInfo = getIndirectReturnResult(returnType);
+			} else if (functionType.callingConvention() == CC_Swift) {
+				returnInfo = classifySwiftReturnType(returnType);
+			} else {
+				returnInfo = classifyReturnType(returnType);
+			}
+			
+			llvm::SmallVector<ArgInfo, 8> argInfoArray;
+			argInfoArray.push_back(returnInfo);
 			
 			// If the return value is indirect, then the hidden argument
 			// is consuming one integer register.
@@ -667,17 +977,23 @@ namespace llvm_abi {
 				const bool isArgument = true;
 				unsigned neededInt = 0;
 				unsigned neededSse = 0;
-				ArgInfo argInfo = classifyType(argType,
-				                               isArgument,
-				                               freeIntRegs,
-				                               neededInt,
-				                               neededSse,
-				                               isNamedArg);
+				ArgInfo argInfo = (isRegCall && argType.isStruct()) ?
+					classifyRegCallStructType(argType,
+					                          neededInt,
+					                          neededSse) :
+					classifyType(argType,
+					             isArgument,
+					             freeIntRegs,
+					             neededInt,
+					             neededSse,
+					             isNamedArg);
 				// AMD64-ABI 3.2.3p3: If there are no registers available for any
 				// eightbyte of an argument, the whole argument is passed on the
 				// stack. If registers have already been assigned for some
 				// eightbytes of such an argument, the assignments get reverted.
-				if (freeIntRegs >= neededInt && freeSseRegs >= neededSse) {
+				// (regcall structs that can't be expanded also go on the stack.)
+				if (freeIntRegs >= neededInt && freeSseRegs >= neededSse &&
+				    !(isRegCall && argInfo.isIndirect())) {
 					freeIntRegs -= neededInt;
 					freeSseRegs -= neededSse;
 				} else {
@@ -689,6 +1005,11 @@ namespace llvm_abi {
 				argInfoArray.push_back(argInfo);
 			}
 			
+			if (registerUsage != nullptr) {
+				*registerUsage = RegisterUsage(numIntRegs - freeIntRegs,
+				                               numSseRegs - freeSseRegs);
+			}
+			
 			return argInfoArray;
 		}
 		
@@ -0,0 +1,420 @@
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/ADT/StringSwitch.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+
+#include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/Builder.hpp>
+#include <llvm-abi/DataSize.hpp>
+#include <llvm-abi/FunctionEncoder.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/Type.hpp>
+#include <llvm-abi/TypedValue.hpp>
+
+#include <llvm-abi/x86/FunctionDispatcher.hpp>
+
+namespace llvm_abi {
+	
+	namespace x86 {
+		
+		namespace {
+			
+			// Emits code into a new function.
+			class FunctionBuilder: public Builder {
+			public:
+				FunctionBuilder(llvm::BasicBlock* const entryBlock)
+				: entryBlock_(entryBlock),
+				entryBuilder_(entryBlock),
+				builder_(entryBlock) { }
+				
+				IRBuilder& getEntryBuilder() {
+					if (!entryBlock_->empty()) {
+						entryBuilder_.SetInsertPoint(&(entryBlock_->front()));
+					}
+					return entryBuilder_;
+				}
+				
+				IRBuilder& getBuilder() {
+					return builder_;
+				}
+				
+			private:
+				llvm::BasicBlock* entryBlock_;
+				IRBuilder entryBuilder_;
+				IRBuilder builder_;
+				
+			};
+			
+		}
+		
+		// Returns the bit of a feature in '__cpu_model.__cpu_features[0]'
+		// (libgcc's 'enum processor_features'), or -1 if it isn't there.
+		static int getRuntimeFeatureBit(const llvm::StringRef feature) {
+			return llvm::StringSwitch<int>(feature)
+				.Case("cmov", 0)
+				.Case("mmx", 1)
+				.Case("popcnt", 2)
+				.Case("sse", 3)
+				.Case("sse2", 4)
+				.Case("sse3", 5)
+				.Case("ssse3", 6)
+				.Case("sse4.1", 7)
+				.Case("sse4.2", 8)
+				.Case("avx", 9)
+				.Case("avx2", 10)
+				.Case("sse4a", 11)
+				.Case("fma4", 12)
+				.Case("xop", 13)
+				.Case("fma", 14)
+				.Case("avx512f", 15)
+				.Case("bmi", 16)
+				.Case("bmi2", 17)
+				.Case("aes", 18)
+				.Case("pclmul", 19)
+				.Case("avx512vl", 20)
+				.Case("avx512bw", 21)
+				.Case("avx512dq", 22)
+				.Case("avx512cd", 23)
+				.Case("avx512er", 24)
+				.Case("avx512pf", 25)
+				.Default(-1);
+		}
+		
+		// Returns a feature that implies the given feature (which
+		// '__cpu_model' doesn't report) on every CPU that has it, or
+		// an empty string if every CPU the runtime supports has the
+		// feature; returns null for features that can't be checked.
+		//
+		// Clang's "target-features" for a CPU (e.g. -march=haswell)
+		// list all of these, so without this they couldn't be used.
+		static const char* getImplyingRuntimeFeature(const llvm::StringRef feature) {
+			return llvm::StringSwitch<const char*>(feature)
+				.Case("x87", "")
+				.Case("cx8", "")
+				.Case("fxsr", "")
+				.Case("cx16", "ssse3")
+				.Case("sahf", "ssse3")
+				.Case("xsave", "avx")
+				.Case("f16c", "avx2")
+				.Case("lzcnt", "avx2")
+				.Case("movbe", "avx2")
+				.Default(nullptr);
+		}
+		
+		static uint32_t getRuntimeFeatureMask(llvm::StringRef targetFeatures) {
+			// Disabling features never requires a check.
+			llvm::SmallVector<llvm::StringRef, 16> features;
+			while (!targetFeatures.empty()) {
+				const auto split = targetFeatures.split(',');
+				const auto featureString = split.first.trim();
+				targetFeatures = split.second;
+				if (!featureString.empty() && featureString[0] == '+') {
+					features.push_back(featureString.substr(1));
+				}
+			}
+			
+			uint32_t mask = 0;
+			for (const auto& feature: features) {
+				const auto bit = getRuntimeFeatureBit(feature);
+				if (bit >= 0) {
+					mask |= uint32_t(1) << bit;
+					continue;
+				}
+				
+				const auto implyingFeature = getImplyingRuntimeFeature(feature);
+				if (implyingFeature != nullptr &&
+				    (implyingFeature[0] == '\0' ||
+				     std::find(features.begin(), features.end(),
+				               llvm::StringRef(implyingFeature)) != features.end())) {
+					// Checked via the implying feature.
+					continue;
+				}
+				
+				std::string errorString = "Target feature can't be checked at run time: +";
+				errorString += feature.str();
+				throw std::runtime_error(errorString);
+			}
+			return mask;
+		}
+		
+		static llvm::Function* createFunction(const ABI& abi,
+		                                      llvm::Module& module,
+		                                      const FunctionType& functionType,
+		                                      const llvm::GlobalValue::LinkageTypes linkage,
+		                                      const std::string& name) {
+			const auto function = llvm::Function::Create(abi.getFunctionType(functionType),
+			                                             linkage, name, &module);
+			function->setAttributes(abi.getAttributes(functionType,
+			                                          functionType.argumentTypes()));
+			function->setCallingConv(abi.getCallingConvention(functionType.callingConvention()));
+			return function;
+		}
+		
+		static bool hasTargetFeature(llvm::StringRef targetFeatures,
+		                             const llvm::StringRef feature) {
+			while (!targetFeatures.empty()) {
+				const auto split = targetFeatures.split(',');
+				if (split.first.trim() == feature) {
+					return true;
+				}
+				targetFeatures = split.second;
+			}
+			return false;
+		}
+		
+		static std::string getMergedTargetFeatures(const llvm::Function& function,
+		                                           const std::string& targetFeatures) {
+			const auto attribute = function.getAttributes().getAttribute(llvm::AttributeSet::FunctionIndex,
+			                                                             "target-features");
+			if (!attribute.isStringAttribute() ||
+			    attribute.getValueAsString().empty()) {
+				return targetFeatures;
+			}
+			
+			// Append the features that the function doesn't list.
+			const auto functionFeatures = attribute.getValueAsString();
+			std::string mergedFeatures = functionFeatures.str();
+			llvm::StringRef remainingFeatures = targetFeatures;
+			while (!remainingFeatures.empty()) {
+				const auto split = remainingFeatures.split(',');
+				const auto featureString = split.first.trim();
+				remainingFeatures = split.second;
+				if (featureString.empty() ||
+				    hasTargetFeature(functionFeatures, featureString)) {
+					continue;
+				}
+				
+				mergedFeatures += ",";
+				mergedFeatures += featureString.str();
+			}
+			return mergedFeatures;
+		}
+		
+		static llvm::Function* createBridge(const ABI& abi,
+		                                    llvm::Module& module,
+		                                    const FunctionType& functionType,
+		                                    const FunctionVersion& version,
+		                                    const std::string& name) {
+			const auto& versionABI = abi.withTargetFeatures(version.targetFeatures);
+			const auto versionFunction = version.function;
+			
+			// If the version is lowered the same way it can be
+			// called directly.
+			if (versionABI.getFunctionType(functionType) == abi.getFunctionType(functionType) &&
+			    versionABI.getAttributes(functionType,
+			                             functionType.argumentTypes()) ==
+			    abi.getAttributes(functionType,
+			                      functionType.argumentTypes())) {
+				return versionFunction;
+			}
+			
+			const auto bridge = createFunction(abi, module, functionType,
+			                                   llvm::GlobalValue::InternalLinkage,
+			                                   name);
+			
+			// The bridge passes the arguments with the version's
+			// lowering (e.g. in YMM registers), so it must be compiled
+			// with the version's features.
+			bridge->addFnAttr("target-features",
+			                  getMergedTargetFeatures(*versionFunction,
+			                                          version.targetFeatures));
+			const auto entryBlock = llvm::BasicBlock::Create(module.getContext(), "",
+			                                                 bridge);
+			FunctionBuilder builder(entryBlock);
+			
+			llvm::SmallVector<llvm::Value*, 8> encodedArguments;
+			for (auto it = bridge->arg_begin(); it != bridge->arg_end(); ++it) {
+				encodedArguments.push_back(&*it);
+			}
+			
+			auto functionEncoder = abi.createFunctionEncoder(builder,
+			                                                 functionType,
+			                                                 encodedArguments);
+			
+			llvm::SmallVector<TypedValue, 8> arguments;
+			for (size_t i = 0; i < functionType.argumentTypes().size(); i++) {
+				arguments.push_back(TypedValue(functionEncoder->argument(i),
+				                               functionType.argumentTypes()[i]));
+			}
+			
+			const auto returnValue = versionABI.createCall(
+				builder,
+				functionType,
+				[&](llvm::ArrayRef<llvm::Value*> values) -> llvm::Value* {
+					const auto callInst = builder.getBuilder().CreateCall(versionFunction, values);
+					callInst->setAttributes(versionFunction->getAttributes());
+					callInst->setCallingConv(versionFunction->getCallingConv());
+					return callInst;
+				},
+				arguments
+			);
+			
+			functionEncoder->returnValue(returnValue);
+			return bridge;
+		}
+		
+		static llvm::Function* createResolver(llvm::Module& module,
+		                                      llvm::ArrayRef<FunctionVersion> versions,
+		                                      llvm::ArrayRef<llvm::Function*> targets,
+		                                      llvm::PointerType* const targetPtrType,
+		                                      const std::string& name) {
+			auto& context = module.getContext();
+			const auto int32Type = llvm::Type::getInt32Ty(context);
+			
+			const auto resolverType = llvm::FunctionType::get(targetPtrType,
+			                                                  /*isVarArg=*/false);
+			const auto resolver = llvm::Function::Create(resolverType,
+			                                             llvm::GlobalValue::InternalLinkage,
+			                                             name, &module);
+			
+			// The runtime's CPU model, as used by __builtin_cpu_supports():
+			// struct { unsigned vendor, type, subtype; unsigned features[1]; }.
+			llvm::Type* const cpuModelMembers[] = {
+				int32Type,
+				int32Type,
+				int32Type,
+				llvm::ArrayType::get(int32Type, 1)
+			};
+			const auto cpuModelType = llvm::StructType::get(context,
+			                                                llvm::ArrayRef<llvm::Type*>(cpuModelMembers));
+			const auto cpuModel = module.getOrInsertGlobal("__cpu_model", cpuModelType);
+			const auto cpuIndicatorInit = module.getOrInsertFunction("__cpu_indicator_init",
+			                                                         llvm::FunctionType::get(llvm::Type::getVoidTy(context),
+			                                                                                 /*isVarArg=*/false));
+			
+			IRBuilder builder(llvm::BasicBlock::Create(context, "", resolver));
+			builder.CreateCall(cpuIndicatorInit);
+			llvm::Value* const indices[] = {
+				builder.getInt32(0),
+				builder.getInt32(3),
+				builder.getInt32(0)
+			};
+			const auto cpuFeatures = builder.CreateLoad(builder.CreateInBoundsGEP(cpuModel, indices),
+			                                            "cpu_features");
+			
+			for (size_t i = 0; i + 1 < versions.size(); i++) {
+				const auto mask = getRuntimeFeatureMask(versions[i].targetFeatures);
+				const auto maskValue = builder.getInt32(mask);
+				const auto isSupported = builder.CreateICmpEQ(builder.CreateAnd(cpuFeatures, maskValue),
+				                                              maskValue);
+				const auto supportedBlock = llvm::BasicBlock::Create(context, "", resolver);
+				const auto nextBlock = llvm::BasicBlock::Create(context, "", resolver);
+				builder.CreateCondBr(isSupported, supportedBlock, nextBlock);
+				
+				builder.SetInsertPoint(supportedBlock);
+				builder.CreateRet(targets[i]);
+				
+				builder.SetInsertPoint(nextBlock);
+			}
+			
+			builder.CreateRet(targets.back());
+			return resolver;
+		}
+		
+		llvm::Function* createFunctionDispatcher(const ABI& abi,
+		                                         llvm::Module& module,
+		                                         const FunctionType& functionType,
+		                                         const std::string& name,
+		                                         llvm::ArrayRef<FunctionVersion> versions) {
+			if (versions.empty()) {
+				throw std::runtime_error("Function dispatcher requires at least one version.");
+			}
+			
+			if (functionType.isVarArg()) {
+				throw std::runtime_error("Function dispatcher can't forward varargs.");
+			}
+			
+			auto& context = module.getContext();
+			
+			const auto dispatcher = createFunction(abi, module, functionType,
+			                                       llvm::GlobalValue::ExternalLinkage,
+			                                       name);
+			const auto targetPtrType = dispatcher->getFunctionType()->getPointerTo();
+			
+			// Each version is called with the dispatcher's lowering,
+			// via a bridge if necessary.
+			llvm::SmallVector<llvm::Function*, 8> targets;
+			for (size_t i = 0; i < versions.size(); i++) {
+				const auto target = createBridge(abi, module, functionType,
+				                                 versions[i],
+				                                 name + "." + std::to_string(i) + ".bridge");
+				targets.push_back(target);
+			}
+			
+			const auto resolver = createResolver(module, versions, targets,
+			                                     targetPtrType,
+			                                     name + ".resolver");
+			
+			const auto table = new llvm::GlobalVariable(module, targetPtrType,
+			                                            /*isConstant=*/false,
+			                                            llvm::GlobalValue::InternalLinkage,
+			                                            llvm::ConstantPointerNull::get(targetPtrType),
+			                                            name + ".table");
+			const auto tableAlign = abi.typeInfo().getTypeRequiredAlign(PointerTy).asBytes();
+			table->setAlignment(tableAlign);
+			
+#if LLVMABI_LLVM_VERSION >= 309
+			const auto monotonic = llvm::AtomicOrdering::Monotonic;
+#else
+			const auto monotonic = llvm::Monotonic;
+#endif
+
+			const auto entryBlock = llvm::BasicBlock::Create(context, "", dispatcher);
+			const auto resolveBlock = llvm::BasicBlock::Create(context, "resolve", dispatcher);
+			const auto callBlock = llvm::BasicBlock::Create(context, "call", dispatcher);
+			
+			IRBuilder builder(entryBlock);
+			const auto cachedTarget = builder.CreateLoad(table, "target");
+			cachedTarget->setAlignment(tableAlign);
+			cachedTarget->setAtomic(monotonic);
+			builder.CreateCondBr(builder.CreateIsNull(cachedTarget),
+			                     resolveBlock, callBlock);
+			
+			// Threads may race to resolve the target, which is
+			// harmless since the result is always the same.
+			builder.SetInsertPoint(resolveBlock);
+			const auto resolvedTarget = builder.CreateCall(resolver);
+			const auto storeInst = builder.CreateStore(resolvedTarget, table);
+			storeInst->setAlignment(tableAlign);
+			storeInst->setAtomic(monotonic);
+			builder.CreateBr(callBlock);
+			
+			builder.SetInsertPoint(callBlock);
+			const auto target = builder.CreatePHI(targetPtrType, 2);
+			target->addIncoming(cachedTarget, entryBlock);
+			target->addIncoming(resolvedTarget, resolveBlock);
+			
+			llvm::SmallVector<llvm::Value*, 8> arguments;
+			for (auto it = dispatcher->arg_begin(); it != dispatcher->arg_end(); ++it) {
+				arguments.push_back(&*it);
+			}
+			
+			const auto callInst = builder.CreateCall(target, arguments);
+			callInst->setAttributes(dispatcher->getAttributes());
+			callInst->setCallingConv(dispatcher->getCallingConv());
+			callInst->setTailCall();
+			
+			if (callInst->getType()->isVoidTy()) {
+				builder.CreateRetVoid();
+			} else {
+				builder.CreateRet(callInst);
+			}
+			
+			return dispatcher;
+		}
+		
+	}
+	
+}
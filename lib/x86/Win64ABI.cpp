@@ -36,6 +36,17 @@ namespace llvm_abi {
 			llvm_unreachable("TODO");
 		}
 		
+		LoweringPlan Win64ABI::getLoweringPlan(const FunctionType& /*functionType*/,
+		                                       llvm::ArrayRef<Type> /*argumentTypes*/) const {
+			llvm_unreachable("TODO");
+		}
+		
+		std::vector<LoweredFunctionType>
+		Win64ABI::lowerBatch(llvm::ArrayRef<FunctionType> /*functionTypes*/,
+		                     const unsigned /*numThreads*/) const {
+			llvm_unreachable("TODO");
+		}
+		
 		llvm::AttributeSet Win64ABI::getAttributes(const FunctionType& /*functionType*/,
 		                                           llvm::ArrayRef<Type> /*argumentTypes*/,
 		                                           const llvm::AttributeSet /*existingAttributes*/) const {
@@ -49,12 +60,47 @@ namespace llvm_abi {
 			llvm_unreachable("TODO");
 		}
 		
+		bool Win64ABI::isTailCallCompatible(const FunctionType& /*callerType*/,
+		                                    const FunctionType& /*calleeType*/) const {
+			llvm_unreachable("TODO");
+		}
+		
+		llvm::Value* Win64ABI::createTailCall(Builder& /*builder*/,
+		                                      const FunctionType& /*functionType*/,
+		                                      std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> /*callBuilder*/,
+		                                      llvm::ArrayRef<TypedValue> /*arguments*/,
+		                                      llvm::Value* /*returnValuePtr*/) const {
+			llvm_unreachable("TODO");
+		}
+		
+		llvm::Value* Win64ABI::createInMemoryCall(Builder& /*builder*/,
+		                                          const FunctionType& /*functionType*/,
+		                                          std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> /*callBuilder*/,
+		                                          llvm::ArrayRef<TypedValue> /*arguments*/,
+		                                          llvm::Value* /*returnValuePtr*/) const {
+			llvm_unreachable("TODO");
+		}
+		
+		llvm::Value* Win64ABI::createConstructingCall(Builder& /*builder*/,
+		                                              const FunctionType& /*functionType*/,
+		                                              std::function<void (size_t, llvm::Value*)> /*argumentConstructor*/,
+		                                              std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> /*callBuilder*/,
+		                                              llvm::ArrayRef<TypedValue> /*arguments*/,
+		                                              llvm::Value* /*returnValuePtr*/) const {
+			llvm_unreachable("TODO");
+		}
+		
 		std::unique_ptr<FunctionEncoder> Win64ABI::createFunctionEncoder(Builder& /*builder*/,
 		                                                                  const FunctionType& /*functionType*/,
 		                                                                  llvm::ArrayRef<llvm::Value*> /*arguments*/) const {
 			llvm_unreachable("TODO");
 		}
 		
+		const ABI& Win64ABI::withTargetFeatures(const std::string& /*targetFeatures*/) const {
+			// Lowering doesn't depend on CPU features.
+			return *this;
+		}
+		
 	}
 	
 }
@@ -1,28 +1,47 @@
+#include <memory>
 #include <stdexcept>
 #include <vector>
 
 #include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABITargetData.hpp>
+#include <llvm-abi/BatchLowering.hpp>
 #include <llvm-abi/Builder.hpp>
-#include <llvm-abi/Callee.hpp>
 #include <llvm-abi/Caller.hpp>
+#include <llvm-abi/DefaultFunctionEncoder.hpp>
 #include <llvm-abi/FunctionEncoder.hpp>
 #include <llvm-abi/FunctionIRMapping.hpp>
+#include <llvm-abi/LLVMUtils.hpp>
+#include <llvm-abi/LoweringPlan.hpp>
 #include <llvm-abi/Type.hpp>
 #include <llvm-abi/TypePromoter.hpp>
 
 #include <llvm-abi/x86/X86_32Classifier.hpp>
 #include <llvm-abi/x86/X86_32ABI.hpp>
 #include <llvm-abi/x86/X86_32ABITypeInfo.hpp>
+#include <llvm-abi/x86/X86_32LoweringPlanner.hpp>
+#include <llvm-abi/x86/X86_32VAArg.hpp>
 
 namespace llvm_abi {
 	
 	namespace x86 {
 		
 		X86_32ABI::X86_32ABI(llvm::Module* const module,
-		               const llvm::Triple targetTriple)
+		               const llvm::Triple targetTriple,
+		               const unsigned numRegisterParameters)
+		: X86_32ABI(module,
+		            targetTriple,
+		            std::make_shared<ABITargetData>(),
+		            numRegisterParameters) { }
+		
+		X86_32ABI::X86_32ABI(llvm::Module* const module,
+		               const llvm::Triple targetTriple,
+		               std::shared_ptr<const ABITargetData> targetData,
+		               const unsigned numRegisterParameters)
 		: llvmContext_(module->getContext()),
 		targetTriple_(targetTriple),
-		typeInfo_(llvmContext_) { }
+		numRegisterParameters_(numRegisterParameters),
+		targetData_(std::move(targetData)),
+		typeInfo_(llvmContext_, *targetData_) { }
 		
 		X86_32ABI::~X86_32ABI() { }
 		
@@ -54,22 +73,41 @@ namespace llvm_abi {
 #else
 					throw std::runtime_error("VectorCall not supported by version of LLVM built against (need LLVM 3.6+.)");
 #endif
+				case CC_RegCall:
+#if LLVMABI_LLVM_VERSION >= 400
+					return llvm::CallingConv::X86_RegCall;
+#else
+					throw std::runtime_error("RegCall not supported by version of LLVM built against (need LLVM 4.0+.)");
+#endif
+				case CC_FastInternal:
+					return llvm::CallingConv::Fast;
 				default:
 					llvm_unreachable("Invalid calling convention for ABI.");
 			}
 		}
 		
+		static
+		FunctionIRMapping computeIRMapping(const ABITypeInfo& typeInfo,
+		                                   const ABITargetData& targetData,
+		                                   const llvm::Triple targetTriple,
+		                                   const unsigned numRegisterParameters,
+		                                   const FunctionType& functionType,
+		                                   llvm::ArrayRef<Type> argumentTypes) {
+			return getX86_32LoweringPlan(typeInfo,
+			                             targetData,
+			                             targetTriple,
+			                             numRegisterParameters,
+			                             functionType,
+			                             argumentTypes).irMapping();
+		}
+		
 		llvm::FunctionType* X86_32ABI::getFunctionType(const FunctionType& functionType) const {
-			X86_32Classifier classifier(typeInfo_,
-			                            typeBuilder_,
-			                            targetTriple_);
-			const auto argInfoArray =
-				classifier.classifyFunctionType(functionType,
-				                                functionType.argumentTypes());
-			assert(argInfoArray.size() >= 1);
-			
-			const auto functionIRMapping = getFunctionIRMapping(typeInfo(),
-			                                                    argInfoArray);
+			const auto functionIRMapping = computeIRMapping(typeInfo_,
+			                                                *targetData_,
+			                                                targetTriple_,
+			                                                numRegisterParameters_,
+			                                                functionType,
+			                                                functionType.argumentTypes());
 			
 			return llvm_abi::getFunctionType(llvmContext_,
 			                                 typeInfo_,
@@ -77,6 +115,28 @@ namespace llvm_abi {
 			                                 functionIRMapping);
 		}
 		
+		LoweringPlan X86_32ABI::getLoweringPlan(const FunctionType& functionType,
+		                                        llvm::ArrayRef<Type> rawArgumentTypes) const {
+			TypePromoter typePromoter(typeInfo());
+			const auto argumentTypes = typePromoter.promoteArgumentTypes(functionType,
+			                                                             rawArgumentTypes);
+			return getX86_32LoweringPlan(typeInfo_,
+			                             *targetData_,
+			                             targetTriple_,
+			                             numRegisterParameters_,
+			                             functionType,
+			                             argumentTypes);
+		}
+		
+		std::vector<LoweredFunctionType>
+		X86_32ABI::lowerBatch(llvm::ArrayRef<FunctionType> functionTypes,
+		                      const unsigned numThreads) const {
+			return llvm_abi::lowerBatch(llvmContext_,
+			                            *this,
+			                            functionTypes,
+			                            numThreads);
+		}
+		
 		llvm::AttributeSet X86_32ABI::getAttributes(const FunctionType& functionType,
 		                                         llvm::ArrayRef<Type> rawArgumentTypes,
 		                                         const llvm::AttributeSet existingAttributes) const {
@@ -87,19 +147,17 @@ namespace llvm_abi {
 			const auto argumentTypes = typePromoter.promoteArgumentTypes(functionType,
 			                                                             rawArgumentTypes);
 			
-			X86_32Classifier classifier(typeInfo_,
-			                            typeBuilder_,
-			                            targetTriple_);
-			const auto argInfoArray =
-				classifier.classifyFunctionType(functionType,
-				                                argumentTypes);
-			assert(argInfoArray.size() >= 1);
-			
-			const auto functionIRMapping = getFunctionIRMapping(typeInfo(),
-			                                                    argInfoArray);
+			const auto functionIRMapping = computeIRMapping(typeInfo_,
+			                                                *targetData_,
+			                                                targetTriple_,
+			                                                numRegisterParameters_,
+			                                                functionType,
+			                                                argumentTypes);
 			
 			return llvm_abi::getFunctionAttributes(llvmContext_,
 			                                       typeInfo_,
+			                                       functionType,
+			                                       argumentTypes,
 			                                       functionIRMapping,
 			                                       existingAttributes);
 		}
@@ -121,16 +179,12 @@ namespace llvm_abi {
 				argumentTypes.push_back(value.type());
 			}
 			
-			X86_32Classifier classifier(typeInfo_,
-			                            typeBuilder_,
-			                            targetTriple_);
-			const auto argInfoArray =
-				classifier.classifyFunctionType(functionType,
-				                                argumentTypes);
-			assert(argInfoArray.size() >= 1);
-			
-			const auto functionIRMapping = getFunctionIRMapping(typeInfo(),
-			                                                    argInfoArray);
+			const auto functionIRMapping = computeIRMapping(typeInfo_,
+			                                                *targetData_,
+			                                                targetTriple_,
+			                                                numRegisterParameters_,
+			                                                functionType,
+			                                                argumentTypes);
 			
 			Caller caller(typeInfo_,
 			              functionType,
@@ -144,70 +198,168 @@ namespace llvm_abi {
 			return caller.decodeReturnValue(encodedArguments, returnValue);
 		}
 		
-		static
-		FunctionIRMapping computeIRMapping(const ABITypeInfo& typeInfo,
-		                                   const TypeBuilder& typeBuilder,
-		                                   const llvm::Triple targetTriple,
-		                                   const FunctionType& functionType,
-		                                   llvm::ArrayRef<Type> argumentTypes) {
-			X86_32Classifier classifier(typeInfo,
-			                            typeBuilder,
-			                            targetTriple);
-			const auto argInfoArray =
-				classifier.classifyFunctionType(functionType,
-				                                argumentTypes);
-			assert(argInfoArray.size() >= 1);
-			
-			return getFunctionIRMapping(typeInfo,
-			                            argInfoArray);
+		bool X86_32ABI::isTailCallCompatible(const FunctionType& callerType,
+		                                     const FunctionType& calleeType) const {
+			const auto callerIRMapping = computeIRMapping(typeInfo_,
+			                                              *targetData_,
+			                                              targetTriple_,
+			                                              numRegisterParameters_,
+			                                              callerType,
+			                                              callerType.argumentTypes());
+			const auto calleeIRMapping = computeIRMapping(typeInfo_,
+			                                              *targetData_,
+			                                              targetTriple_,
+			                                              numRegisterParameters_,
+			                                              calleeType,
+			                                              calleeType.argumentTypes());
+			return llvm_abi::isTailCallCompatible(llvmContext_,
+			                                      typeInfo_,
+			                                      callerType,
+			                                      callerIRMapping,
+			                                      calleeType,
+			                                      calleeIRMapping);
+		}
+		
+		llvm::Value* X86_32ABI::createTailCall(Builder& builder,
+		                                       const FunctionType& functionType,
+		                                       std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+		                                       llvm::ArrayRef<TypedValue> arguments,
+		                                       llvm::Value* const returnValuePtr) const {
+			llvm::SmallVector<Type, 8> rawArgumentTypes;
+			for (const auto& value: arguments) {
+				rawArgumentTypes.push_back(value.type());
+			}
+			
+			TypePromoter typePromoter(typeInfo());
+			const auto argumentTypes = typePromoter.promoteArgumentTypes(functionType,
+			                                                             rawArgumentTypes);
+			
+			const auto functionIRMapping = computeIRMapping(typeInfo_,
+			                                                *targetData_,
+			                                                targetTriple_,
+			                                                numRegisterParameters_,
+			                                                functionType,
+			                                                argumentTypes);
+			
+			return llvm_abi::createTailCall(typeInfo_,
+			                                builder,
+			                                functionType,
+			                                functionIRMapping,
+			                                callBuilder,
+			                                arguments,
+			                                returnValuePtr);
+		}
+		
+		llvm::Value* X86_32ABI::createInMemoryCall(Builder& builder,
+		                                           const FunctionType& functionType,
+		                                           std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+		                                           llvm::ArrayRef<TypedValue> arguments,
+		                                           llvm::Value* const returnValuePtr) const {
+			// Without an argument constructor, non-trivial records are
+			// given like other arguments.
+			return createConstructingCall(builder,
+			                              functionType,
+			                              nullptr,
+			                              callBuilder,
+			                              arguments,
+			                              returnValuePtr);
+		}
+		
+		llvm::Value* X86_32ABI::createConstructingCall(Builder& builder,
+		                                               const FunctionType& functionType,
+		                                               std::function<void (size_t, llvm::Value*)> argumentConstructor,
+		                                               std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+		                                               llvm::ArrayRef<TypedValue> rawArguments,
+		                                               llvm::Value* const returnValuePtr) const {
+			llvm::SmallVector<TypedValue, 8> inputArguments(rawArguments.begin(),
+			                                                rawArguments.end());
+			const auto argumentsInMemory = prepareInMemoryArguments(typeInfo_,
+			                                                        builder,
+			                                                        functionType,
+			                                                        inputArguments);
+			
+			TypePromoter typePromoter(typeInfo());
+			const auto arguments = typePromoter.promoteArguments(builder,
+			                                                     functionType,
+			                                                     inputArguments);
+			
+			llvm::SmallVector<Type, 8> argumentTypes;
+			for (const auto& value: arguments) {
+				argumentTypes.push_back(value.type());
+			}
+			
+			const auto functionIRMapping = computeIRMapping(typeInfo_,
+			                                                *targetData_,
+			                                                targetTriple_,
+			                                                numRegisterParameters_,
+			                                                functionType,
+			                                                argumentTypes);
+			
+			Caller caller(typeInfo_,
+			              functionType,
+			              functionIRMapping,
+			              builder);
+			
+			const auto encodedArguments = caller.encodeArguments(arguments,
+			                                                     returnValuePtr,
+			                                                     argumentsInMemory,
+			                                                     argumentConstructor);
+			
+			const auto returnValue = callBuilder(encodedArguments);
+			
+			return caller.decodeReturnValue(encodedArguments,
+			                                returnValue,
+			                                returnValuePtr,
+			                                /*inMemory=*/true);
 		}
 		
-		class FunctionEncoder_x86: public FunctionEncoder {
+		class FunctionEncoder_x86: public DefaultFunctionEncoder {
 		public:
 			FunctionEncoder_x86(const ABITypeInfo& typeInfo,
-			                    const TypeBuilder& typeBuilder,
+			                    const ABITargetData& targetData,
 			                    const llvm::Triple targetTriple,
+			                    const unsigned numRegisterParameters,
 			                    Builder& builder,
 			                    const FunctionType& functionType,
 			                    llvm::ArrayRef<llvm::Value*> pArguments)
-			: builder_(builder),
-			functionIRMapping_(computeIRMapping(typeInfo,
-			                                    typeBuilder,
-			                                    targetTriple,
-			                                    functionType,
-			                                    functionType.argumentTypes())),
-			callee_(typeInfo,
-			        functionType,
-			        functionIRMapping_,
-			        builder),
-			encodedArguments_(pArguments.begin(), pArguments.end()),
-			arguments_(callee_.decodeArguments(pArguments)) { }
-			
-			llvm::ArrayRef<llvm::Value*> arguments() const {
-				return arguments_;
+			: DefaultFunctionEncoder(typeInfo,
+			                         builder,
+			                         functionType,
+			                         computeIRMapping(typeInfo,
+			                                          targetData,
+			                                          targetTriple,
+			                                          numRegisterParameters,
+			                                          functionType,
+			                                          functionType.argumentTypes()),
+			                         pArguments),
+			classifier_(typeInfo,
+			            targetData.typeBuilder(),
+			            targetTriple,
+			            numRegisterParameters) { }
+			
+			llvm::Type* vaListType() const {
+				// va_list is a pointer to the next argument.
+				return builder().getBuilder().getInt8PtrTy();
 			}
 			
-			llvm::ReturnInst* returnValue(llvm::Value* const value) {
-				const auto encodedReturnValue = callee_.encodeReturnValue(value,
-				                                                          encodedArguments_);
-				if (encodedReturnValue->getType()->isVoidTy()) {
-					return builder_.getBuilder().CreateRetVoid();
-				} else {
-					return builder_.getBuilder().CreateRet(encodedReturnValue);
-				}
+			llvm::Value* vaArg(llvm::Value* const vaList, const Type type) {
+				return emitX86_32VAArg(classifier_, typeInfo(), builder(), vaList, type);
 			}
 			
-			llvm::Value* returnValuePointer() const {
-				// TODO!
-				return nullptr;
+			void vaCopy(llvm::Value* const destVaList, llvm::Value* const sourceVaList) {
+				emitX86_32VACopy(builder(), destVaList, sourceVaList);
+			}
+			
+			llvm::Value* vaListArgument(llvm::Value* const vaList) {
+				// va_list is a pointer, which is passed by value.
+				auto& irBuilder = builder().getBuilder();
+				const auto i8PtrType = irBuilder.getInt8PtrTy();
+				return irBuilder.CreateLoad(irBuilder.CreateBitCast(vaList,
+				                                                    i8PtrType->getPointerTo()));
 			}
 			
 		private:
-			Builder& builder_;
-			FunctionIRMapping functionIRMapping_;
-			Callee callee_;
-			llvm::SmallVector<llvm::Value*, 8> encodedArguments_;
-			llvm::SmallVector<llvm::Value*, 8> arguments_;
+			X86_32Classifier classifier_;
 			
 		};
 		
@@ -216,13 +368,19 @@ namespace llvm_abi {
 		                               const FunctionType& functionType,
 		                               llvm::ArrayRef<llvm::Value*> arguments) const {
 			return std::unique_ptr<FunctionEncoder>(new FunctionEncoder_x86(typeInfo_,
-			                                                                typeBuilder_,
+			                                                                *targetData_,
 			                                                                targetTriple_,
+			                                                                numRegisterParameters_,
 			                                                                builder,
 			                                                                functionType,
 			                                                                arguments));
 		}
 		
+		const ABI& X86_32ABI::withTargetFeatures(const std::string& /*targetFeatures*/) const {
+			// Lowering doesn't depend on CPU features.
+			return *this;
+		}
+		
 	}
 	
 }
@@ -2,7 +2,10 @@
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 
+#include <llvm-abi/ABILayoutCache.hpp>
+#include <llvm-abi/ABITargetData.hpp>
 #include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/ConcurrentCache.hpp>
 #include <llvm-abi/DataSize.hpp>
 #include <llvm-abi/DefaultABITypeInfo.hpp>
 #include <llvm-abi/Type.hpp>
@@ -13,38 +16,71 @@ namespace llvm_abi {
 	
 	namespace x86 {
 		
-		X86_32ABITypeInfo::X86_32ABITypeInfo(llvm::LLVMContext& llvmContext)
-		: llvmContext_(llvmContext),
+		X86_32ABITypeInfo::X86_32ABITypeInfo(llvm::LLVMContext& llvmContext,
+		                                     const ABITargetData& targetData)
+		: targetData_(targetData),
 		defaultABITypeInfo_(llvmContext, /*typeInfo=*/*this,
 		                    /*delegate=*/*this)
 		{ }
 		
+		X86_32ABITypeInfo::X86_32ABITypeInfo(const ABITargetData& targetData)
+		: targetData_(targetData),
+		defaultABITypeInfo_(/*typeInfo=*/*this, /*delegate=*/*this)
+		{ }
+		
 		const TypeBuilder& X86_32ABITypeInfo::typeBuilder() const {
-			return typeBuilder_;
+			return targetData_.typeBuilder();
 		}
 		
 		DataSize X86_32ABITypeInfo::getTypeRawSize(const Type type) const {
-			return defaultABITypeInfo_.getDefaultTypeRawSize(type);
+			if (!type.isAggregateType()) {
+				return defaultABITypeInfo_.getDefaultTypeRawSize(type);
+			}
+			return targetData_.layoutCache().get(ABILayoutCache::RawSize, type,
+			                                     [&] { return defaultABITypeInfo_.getDefaultTypeRawSize(type); });
 		}
 		
 		DataSize X86_32ABITypeInfo::getTypeAllocSize(const Type type) const {
-			return defaultABITypeInfo_.getDefaultTypeAllocSize(type);
+			if (!type.isAggregateType()) {
+				return defaultABITypeInfo_.getDefaultTypeAllocSize(type);
+			}
+			return targetData_.layoutCache().get(ABILayoutCache::AllocSize, type,
+			                                     [&] { return defaultABITypeInfo_.getDefaultTypeAllocSize(type); });
 		}
 		
 		DataSize X86_32ABITypeInfo::getTypeStoreSize(const Type type) const {
-			return defaultABITypeInfo_.getDefaultTypeStoreSize(type);
+			if (!type.isAggregateType()) {
+				return defaultABITypeInfo_.getDefaultTypeStoreSize(type);
+			}
+			return targetData_.layoutCache().get(ABILayoutCache::StoreSize, type,
+			                                     [&] { return defaultABITypeInfo_.getDefaultTypeStoreSize(type); });
 		}
 		
 		DataSize X86_32ABITypeInfo::getTypeRequiredAlign(const Type type) const {
-			return defaultABITypeInfo_.getDefaultTypeRequiredAlign(type);
+			if (!type.isAggregateType()) {
+				return defaultABITypeInfo_.getDefaultTypeRequiredAlign(type);
+			}
+			return targetData_.layoutCache().get(ABILayoutCache::RequiredAlign, type,
+			                                     [&] { return defaultABITypeInfo_.getDefaultTypeRequiredAlign(type); });
 		}
 		
 		DataSize X86_32ABITypeInfo::getTypePreferredAlign(const Type type) const {
-			return defaultABITypeInfo_.getDefaultTypePreferredAlign(type);
+			if (!type.isAggregateType()) {
+				return defaultABITypeInfo_.getDefaultTypePreferredAlign(type);
+			}
+			return targetData_.layoutCache().get(ABILayoutCache::PreferredAlign, type,
+			                                     [&] { return defaultABITypeInfo_.getDefaultTypePreferredAlign(type); });
 		}
 		
 		llvm::Type* X86_32ABITypeInfo::getLLVMType(const Type type) const {
-			return defaultABITypeInfo_.getDefaultLLVMType(type);
+			if (!type.isAggregateType()) {
+				return defaultABITypeInfo_.getDefaultLLVMType(type);
+			}
+			
+			// LLVM types belong to an LLVM context, so unlike the
+			// layout cache this can't be shared between modules.
+			return llvmTypeCache_.get(type,
+			                          [&] { return defaultABITypeInfo_.getDefaultLLVMType(type); });
 		}
 		
 		llvm::SmallVector<DataSize, 8>
@@ -56,6 +92,13 @@ namespace llvm_abi {
 			llvm_unreachable("TODO");
 		}
 		
+		DataSize X86_32ABITypeInfo::getMaxCopyUnitSize() const {
+			// SSE isn't guaranteed to be available, so use 64-bit
+			// integers (which are split into 32-bit accesses if
+			// necessary).
+			return DataSize::Bytes(8);
+		}
+		
 		bool X86_32ABITypeInfo::isBigEndian() const {
 			return false;
 		}
@@ -74,9 +117,9 @@ namespace llvm_abi {
 				// vectorcall can pass XMM, YMM, and ZMM vectors.
 				// We don't pass SSE1 MMX registers specially.
 				const auto size = typeInfo.getTypeAllocSize(type);
-				return size.asBytes() == 128 &&
-				       size.asBytes() == 256 &&
-				       size.asBytes() == 512;
+				return size.asBits() == 128 ||
+				       size.asBits() == 256 ||
+				       size.asBits() == 512;
 			}
 			return false;
 		}
@@ -171,7 +214,7 @@ namespace llvm_abi {
 		DataSize X86_32ABITypeInfo::getFloatSize(const FloatingPointKind kind) const {
 			switch (kind) {
 				case HalfFloat:
-					llvm_unreachable("TODO");
+					return DataSize::Bytes(2);
 				case Float:
 					return DataSize::Bytes(4);
 				case Double:
@@ -188,7 +231,7 @@ namespace llvm_abi {
 		DataSize X86_32ABITypeInfo::getFloatAlign(const FloatingPointKind kind) const {
 			switch (kind) {
 				case HalfFloat:
-					llvm_unreachable("TODO");
+					return DataSize::Bytes(2);
 				case Float:
 					return DataSize::Bytes(4);
 				case Double:
@@ -204,7 +247,7 @@ namespace llvm_abi {
 		DataSize X86_32ABITypeInfo::getComplexSize(const FloatingPointKind kind) const {
 			switch (kind) {
 				case HalfFloat:
-					llvm_unreachable("TODO");
+					return DataSize::Bytes(4);
 				case Float:
 					return DataSize::Bytes(8);
 				case Double:
@@ -221,7 +264,7 @@ namespace llvm_abi {
 		DataSize X86_32ABITypeInfo::getComplexAlign(const FloatingPointKind kind) const {
 			switch (kind) {
 				case HalfFloat:
-					llvm_unreachable("TODO");
+					return DataSize::Bytes(2);
 				case Float:
 					return DataSize::Bytes(4);
 				case Double:
@@ -259,7 +302,7 @@ namespace llvm_abi {
 		}
 		
 		llvm::Type* X86_32ABITypeInfo::getLongDoubleIRType() const {
-			return llvm::Type::getX86_FP80Ty(llvmContext_);
+			return llvm::Type::getX86_FP80Ty(defaultABITypeInfo_.context());
 		}
 		
 	}
@@ -1,9 +1,15 @@
+#include <stdexcept>
+
 #include <llvm/IR/CallingConv.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
+#include <llvm/Support/ErrorHandling.h>
 
+#include <llvm-abi/FastInternalClassifier.hpp>
+#include <llvm-abi/RegisterUsage.hpp>
 #include <llvm-abi/Type.hpp>
+#include <llvm-abi/TypeBuilder.hpp>
 #include <llvm-abi/x86/X86_32Classifier.hpp>
 
 namespace llvm_abi {
@@ -16,10 +22,12 @@ namespace llvm_abi {
 		
 		X86_32Classifier::X86_32Classifier(const ABITypeInfo& typeInfo,
 		                                   const TypeBuilder& typeBuilder,
-		                                   const llvm::Triple targetTriple)
+		                                   const llvm::Triple targetTriple,
+		                                   const unsigned numRegisterParameters)
 		: typeInfo_(typeInfo),
 		typeBuilder_(typeBuilder),
-		targetTriple_(targetTriple) {
+		targetTriple_(targetTriple),
+		numRegisterParameters_(numRegisterParameters) {
 			assert(targetTriple_.getArch() == llvm::Triple::x86);
 		}
 		
@@ -132,9 +140,16 @@ namespace llvm_abi {
 				return ArgInfo::getIgnore();
 			}
 			
+			// Non-trivial C++ records can't be copied, so they're
+			// always constructed in memory provided by the caller.
+			if (returnType.isNonTrivialRecord()) {
+				return getIndirectReturnResult(state);
+			}
+			
 			Type base = VoidTy;
 			uint64_t numElements = 0;
-			if (state.callingConvention == CC_VectorCall &&
+			if ((state.callingConvention == CC_VectorCall ||
+			     state.callingConvention == CC_RegCall) &&
 			    returnType.isHomogeneousAggregate(typeInfo_, base, numElements)) {
 				// The LLVM struct type for such an aggregate should lower properly.
 				return ArgInfo::getDirect(returnType);
@@ -165,7 +180,8 @@ namespace llvm_abi {
 				return ArgInfo::getDirect(returnType);
 			}
 			
-			if (returnType.isAggregateType()) {
+			// Complex values are returned like structs of two elements.
+			if (returnType.isAggregateType() || returnType.isComplex()) {
 				if (returnType.isStruct() && returnType.hasFlexibleArrayMember()) {
 					// Structures with flexible arrays are always indirect.
 					return getIndirectReturnResult(state);
@@ -323,7 +339,8 @@ namespace llvm_abi {
 			state.freeRegs -= sizeInRegs;
 			
 			if (state.callingConvention == CC_FastCall ||
-			    state.callingConvention == CC_VectorCall) {
+			    state.callingConvention == CC_VectorCall ||
+			    state.callingConvention == CC_RegCall) {
 				if (size.asBits() > 32) {
 					return false;
 				}
@@ -343,11 +360,14 @@ namespace llvm_abi {
 		}
 		
 		bool X86_32Classifier::isX86_MMXType(const Type type) const {
-			const auto irType = typeInfo_.getLLVMType(type);
 			// Return true if the type is an MMX type <2 x i32>, <4 x i16>, or <8 x i8>.
-			return irType->isVectorTy() && irType->getPrimitiveSizeInBits() == 64 &&
-				llvm::cast<llvm::VectorType>(irType)->getElementType()->isIntegerTy() &&
-				irType->getScalarSizeInBits() != 64;
+			if (!type.isVector()) {
+				return false;
+			}
+			const auto elementType = type.vectorElementType();
+			return typeInfo_.getTypeRawSize(type).asBits() == 64 &&
+				elementType.isInteger() &&
+				typeInfo_.getTypeRawSize(elementType).asBits() != 64;
 		}
 		
 		bool X86_32Classifier::is32Or64BitBasicType(Type type) const {
@@ -373,6 +393,13 @@ namespace llvm_abi {
 			// should probably make this smarter, or better yet make the LLVM backend
 			// capable of handling it.
 			
+			// A complex value expands to its real and imaginary parts;
+			// x87 parts don't match the layout of the stack slots.
+			if (type.isComplex()) {
+				return type.complexKind() == Float ||
+				       type.complexKind() == Double;
+			}
+			
 			// We can only expand structure types.
 			if (!type.isStruct()) {
 				return false;
@@ -407,11 +434,12 @@ namespace llvm_abi {
 		                                               CCState& state) const {
 			// FIXME: Set alignment on indirect arguments.
 			
-			// vectorcall adds the concept of a homogenous vector aggregate, similar
-			// to other targets.
+			// vectorcall and regcall add the concept of a homogenous vector
+			// aggregate, similar to other targets.
 			Type base = VoidTy;
 			uint64_t numElements = 0;
-			if (state.callingConvention == CC_VectorCall &&
+			if ((state.callingConvention == CC_VectorCall ||
+			     state.callingConvention == CC_RegCall) &&
 			    type.isHomogeneousAggregate(typeInfo_, base, numElements)) {
 				if (state.freeSSERegs >= numElements) {
 					state.freeSSERegs -= numElements;
@@ -426,7 +454,27 @@ namespace llvm_abi {
 				                         state);
 			}
 			
-			if (type.isAggregateType()) {
+			// Complex values are passed like structs of two elements.
+			if (type.isAggregateType() || type.isComplex()) {
+				// Non-trivial C++ records can't be copied, so they're
+				// always passed in memory. MSVC constructs them directly
+				// in the outgoing argument area, which requires inalloca.
+				if (type.isNonTrivialRecord()) {
+#if LLVMABI_LLVM_VERSION >= 305
+					if (isWin32StructABI()) {
+						// The field index doesn't matter, we'll fix it up later.
+						return ArgInfo::getInAlloca(/*fieldIndex=*/0);
+					}
+#else
+					if (isWin32StructABI()) {
+						throw std::runtime_error("InAlloca not supported by version of LLVM built against (need LLVM 3.5+.)");
+					}
+#endif
+					return getIndirectResult(type,
+					                         /*isByVal=*/false,
+					                         state);
+				}
+				
 				if (type.isStruct()) {
 					// Structs are always byval on win32, regardless of what they contain.
 					if (isWin32StructABI()) {
@@ -468,7 +516,8 @@ namespace llvm_abi {
 					return ArgInfo::getExpandWithPadding(
 						type,
 						state.callingConvention == CC_FastCall ||
-						state.callingConvention == CC_VectorCall,
+						state.callingConvention == CC_VectorCall ||
+						state.callingConvention == CC_RegCall,
 						paddingType);
 				}
 				
@@ -509,13 +558,122 @@ namespace llvm_abi {
 			return ArgInfo::getDirect(type);
 		}
 		
+		static bool isArgInAlloca(const ArgInfo& argInfo) {
+			// Leave ignored and inreg arguments alone.
+			switch (argInfo.getKind()) {
+				case ArgInfo::InAlloca:
+					return true;
+				case ArgInfo::Indirect:
+					if (argInfo.getInReg()) {
+						return false;
+					}
+					assert(argInfo.getIndirectByVal());
+					return true;
+				case ArgInfo::Ignore:
+					return false;
+				case ArgInfo::Direct:
+				case ArgInfo::ExtendInteger:
+					return !argInfo.getInReg();
+				case ArgInfo::Expand:
+					// These are aggregate types which are never passed in registers
+					// when inalloca is involved.
+					return true;
+			}
+			
+			llvm_unreachable("Unknown ArgInfo kind.");
+		}
+		
+		void X86_32Classifier::addFieldToArgStruct(llvm::SmallVectorImpl<Type>& fieldTypes,
+		                                           DataSize& stackOffset,
+		                                           ArgInfo& argInfo,
+		                                           const Type type) const {
+			// Don't add padding before the field; the stack
+			// offset is always aligned to a stack slot.
+			argInfo = ArgInfo::getInAlloca(fieldTypes.size());
+			fieldTypes.push_back(type);
+			stackOffset += typeInfo_.getTypeAllocSize(type);
+			
+			// Insert padding bytes to respect alignment.
+			const auto fieldEnd = stackOffset;
+			stackOffset = fieldEnd.roundUpToAlign(MinABIStackAlign);
+			if (stackOffset != fieldEnd) {
+				const auto numBytes = (stackOffset - fieldEnd).asBytes();
+				fieldTypes.push_back(typeBuilder_.getArrayTy(numBytes, UInt8Ty));
+			}
+		}
+		
+		void X86_32Classifier::rewriteWithInAlloca(const FunctionType& functionType,
+		                                           llvm::ArrayRef<Type> argumentTypes,
+		                                           llvm::SmallVectorImpl<ArgInfo>& argInfoArray,
+		                                           llvm::SmallVectorImpl<Type>& inallocaFieldTypes) const {
+			assert(argInfoArray.size() == argumentTypes.size() + 1);
+			assert(inallocaFieldTypes.empty());
+			
+			auto stackOffset = DataSize::Zero();
+			size_t argIndex = 0;
+			
+			// Put 'this' into the struct before 'sret', if necessary.
+			const bool isThisCall = functionType.callingConvention() == CC_ThisCall;
+			auto& returnArgInfo = argInfoArray[0];
+			if (returnArgInfo.isIndirect() && returnArgInfo.isSRetAfterThis() &&
+			    !isThisCall && !argumentTypes.empty() &&
+			    isArgInAlloca(argInfoArray[1])) {
+				addFieldToArgStruct(inallocaFieldTypes, stackOffset,
+				                    argInfoArray[1], argumentTypes[0]);
+				argIndex++;
+			}
+			
+			// Put the sret parameter into the inalloca struct if it's in memory.
+			if (returnArgInfo.isIndirect() && !returnArgInfo.getInReg()) {
+				addFieldToArgStruct(inallocaFieldTypes, stackOffset,
+				                    returnArgInfo, PointerTy);
+				// On Windows, the hidden sret parameter is always returned in eax.
+				returnArgInfo.setinAllocaSRet(isWin32StructABI());
+			}
+			
+			// Skip the 'this' parameter in ecx.
+			if (isThisCall) {
+				argIndex++;
+			}
+			
+			// Put arguments passed in memory into the struct.
+			for (; argIndex < argumentTypes.size(); argIndex++) {
+				auto& argInfo = argInfoArray[argIndex + 1];
+				if (isArgInAlloca(argInfo)) {
+					addFieldToArgStruct(inallocaFieldTypes, stackOffset,
+					                    argInfo, argumentTypes[argIndex]);
+				}
+			}
+		}
+		
 		llvm::SmallVector<ArgInfo, 8>
 		X86_32Classifier::classifyFunctionType(const FunctionType& functionType,
 		                                       llvm::ArrayRef<Type> argumentTypes) const {
-			// FIXME: This needs to be user-configurable; by default
-			// we don't pass arguments in registers but users can
-			// enable this.
-			const auto DefaultNumRegisterParameters = 0;
+			llvm::SmallVector<Type, 8> inallocaFieldTypes;
+			return classifyFunctionType(functionType,
+			                            argumentTypes,
+			                            inallocaFieldTypes);
+		}
+		
+		llvm::SmallVector<ArgInfo, 8>
+		X86_32Classifier::classifyFunctionType(const FunctionType& functionType,
+		                                       llvm::ArrayRef<Type> argumentTypes,
+		                                       llvm::SmallVectorImpl<Type>& inallocaFieldTypes,
+		                                       RegisterUsage* const registerUsage) const {
+			if (functionType.callingConvention() == CC_FastInternal) {
+				// fastcc passes 'inreg' arguments in ECX/EDX (and
+				// XMM0-2 with SSE2), and returns in EAX/EDX/ECX
+				// and XMM0-2.
+				const FastInternalRegisterBudget budget(/*numIntArgRegs=*/2,
+				                                        /*numFloatArgRegs=*/3,
+				                                        /*numIntReturnRegs=*/3,
+				                                        /*numFloatReturnRegs=*/3,
+				                                        /*useInRegForArgs=*/true);
+				FastInternalClassifier classifier(typeInfo_, budget);
+				return classifier.classifyFunctionType(functionType,
+				                                       argumentTypes,
+				                                       registerUsage);
+			}
 			
 			CCState state(functionType.callingConvention());
 			if (state.callingConvention == CC_FastCall) {
@@ -523,16 +681,32 @@ namespace llvm_abi {
 			} else if (state.callingConvention == CC_VectorCall) {
 				state.freeRegs = 2;
 				state.freeSSERegs = 6;
-// 			} else if (FI.getHasRegParm()) {
-// 				state.freeRegs = FI.getRegParm();
+			} else if (functionType.hasRegParm()) {
+				state.freeRegs = functionType.regParm();
+			} else if (state.callingConvention == CC_RegCall) {
+				state.freeRegs = 5;
+				state.freeSSERegs = 8;
 			} else {
-				state.freeRegs = DefaultNumRegisterParameters;
+				state.freeRegs = numRegisterParameters_;
 			}
 			
+			const auto initialState = state;
+			
 			llvm::SmallVector<ArgInfo, 8> argInfoArray;
 			
-			argInfoArray.push_back(classifyReturnType(functionType.returnType(),
-			                                          state));
+			if (state.callingConvention == CC_ThisCall &&
+			    isWin32StructABI() &&
+			    functionType.returnType().isRecordType()) {
+				// MSVC instance methods always return aggregates
+				// indirectly, with the sret pointer passed after 'this'
+				// (which the backend places in ECX).
+				auto returnArgInfo = getIndirectReturnResult(state);
+				returnArgInfo.setSRetAfterThis(true);
+				argInfoArray.push_back(returnArgInfo);
+			} else {
+				argInfoArray.push_back(classifyReturnType(functionType.returnType(),
+				                                          state));
+			}
 			
 			// The chain argument effectively gives us another free register.
 // 			if (FI.isChainCall()) {
@@ -548,10 +722,18 @@ namespace llvm_abi {
 			
 			// If we needed to use inalloca for any argument, do a second pass and rewrite
 			// all the memory arguments to use inalloca.
-			// TODO!
-			(void) usedInAlloca;
-// 			if (UsedInAlloca)
-// 				rewriteWithInAlloca(FI);
+			if (usedInAlloca) {
+				rewriteWithInAlloca(functionType,
+				                    argumentTypes,
+				                    argInfoArray,
+				                    inallocaFieldTypes);
+			}
+			
+			if (registerUsage != nullptr) {
+				*registerUsage = RegisterUsage(initialState.freeRegs - state.freeRegs,
+				                               initialState.freeSSERegs - state.freeSSERegs);
+			}
+			
 			return argInfoArray;
 		}
 		
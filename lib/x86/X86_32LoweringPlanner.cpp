@@ -0,0 +1,99 @@
+#include <memory>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/Attributes.h>
+#include <llvm/IR/DerivedTypes.h>
+
+#include <llvm-abi/ABITargetData.hpp>
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/FunctionIRMapping.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/LoweringPlan.hpp>
+#include <llvm-abi/LoweringPlanCache.hpp>
+#include <llvm-abi/RegisterUsage.hpp>
+#include <llvm-abi/Type.hpp>
+#include <llvm-abi/TypeBuilder.hpp>
+#include <llvm-abi/TypePromoter.hpp>
+
+#include <llvm-abi/x86/X86_32Classifier.hpp>
+#include <llvm-abi/x86/X86_32LoweringPlanner.hpp>
+
+namespace llvm_abi {
+	
+	namespace x86 {
+		
+		static
+		LoweringPlan computeX86_32LoweringPlan(const ABITypeInfo& typeInfo,
+		                                       const TypeBuilder& typeBuilder,
+		                                       const llvm::Triple& targetTriple,
+		                                       const unsigned numRegisterParameters,
+		                                       const FunctionType& functionType,
+		                                       llvm::ArrayRef<Type> argumentTypes) {
+			X86_32Classifier classifier(typeInfo,
+			                            typeBuilder,
+			                            targetTriple,
+			                            numRegisterParameters);
+			RegisterUsage registerUsage;
+			llvm::SmallVector<Type, 8> inallocaFieldTypes;
+			const auto argInfoArray =
+				classifier.classifyFunctionType(functionType,
+				                                argumentTypes,
+				                                inallocaFieldTypes,
+				                                &registerUsage);
+			assert(argInfoArray.size() >= 1);
+			
+			auto functionIRMapping = getFunctionIRMapping(typeInfo,
+			                                              argInfoArray);
+			functionIRMapping.setInallocaFieldTypes(inallocaFieldTypes);
+			
+			return LoweringPlan(functionType,
+			                    argumentTypes,
+			                    std::move(functionIRMapping),
+			                    registerUsage);
+		}
+		
+		LoweringPlan getX86_32LoweringPlan(const ABITypeInfo& typeInfo,
+		                                   const ABITargetData& targetData,
+		                                   const llvm::Triple& targetTriple,
+		                                   const unsigned numRegisterParameters,
+		                                   const FunctionType& functionType,
+		                                   llvm::ArrayRef<Type> argumentTypes) {
+			return targetData.loweringPlanCache().get(functionType, argumentTypes,
+			                                          numRegisterParameters,
+			                                          [&] { return computeX86_32LoweringPlan(typeInfo, targetData.typeBuilder(),
+			                                                                                 targetTriple, numRegisterParameters,
+			                                                                                 functionType, argumentTypes); });
+		}
+		
+		X86_32LoweringPlanner::X86_32LoweringPlanner(const llvm::Triple& targetTriple,
+		                                             std::shared_ptr<const ABITargetData> targetData,
+		                                             const unsigned numRegisterParameters)
+		: targetTriple_(targetTriple),
+		numRegisterParameters_(numRegisterParameters),
+		targetData_(std::move(targetData)),
+		typeInfo_(*targetData_) { }
+		
+		const ABITypeInfo& X86_32LoweringPlanner::typeInfo() const {
+			return typeInfo_;
+		}
+		
+		LoweringPlan
+		X86_32LoweringPlanner::getLoweringPlan(const FunctionType& functionType,
+		                                       llvm::ArrayRef<Type> rawArgumentTypes) const {
+			TypePromoter typePromoter(typeInfo_);
+			const auto argumentTypes = typePromoter.promoteArgumentTypes(functionType,
+			                                                             rawArgumentTypes);
+			return getX86_32LoweringPlan(typeInfo_,
+			                             *targetData_,
+			                             targetTriple_,
+			                             numRegisterParameters_,
+			                             functionType,
+			                             argumentTypes);
+		}
+		
+	}
+	
+}
+
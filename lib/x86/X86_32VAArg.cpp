@@ -0,0 +1,108 @@
+#include <algorithm>
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Instructions.h>
+
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/Builder.hpp>
+#include <llvm-abi/DataSize.hpp>
+#include <llvm-abi/Type.hpp>
+
+#include <llvm-abi/x86/X86_32Classifier.hpp>
+#include <llvm-abi/x86/X86_32VAArg.hpp>
+
+namespace llvm_abi {
+	
+	namespace x86 {
+		
+		// Every argument occupies a whole number of 4 byte slots.
+		static const DataSize ArgSlotSize = DataSize::Bytes(4);
+		
+		static llvm::Value* emitVAArgAddress(const ABITypeInfo& typeInfo,
+		                                     Builder& builder,
+		                                     llvm::Value* const vaList,
+		                                     const Type type,
+		                                     const DataSize stackAlign) {
+			auto& irBuilder = builder.getBuilder();
+			const auto i8PtrType = irBuilder.getInt8PtrTy();
+			const auto vaListPtr = irBuilder.CreateBitCast(vaList,
+			                                               i8PtrType->getPointerTo());
+			llvm::Value* argPtr = irBuilder.CreateLoad(vaListPtr, "ap.cur");
+			
+			// Realign the pointer if the argument was given a larger
+			// stack alignment than a slot.
+			if (stackAlign > ArgSlotSize) {
+				const auto align = stackAlign.asBytes();
+				const auto intPtrType = typeInfo.getLLVMType(IntPtrTy);
+				auto offset = irBuilder.CreatePtrToInt(argPtr, intPtrType);
+				offset = irBuilder.CreateAdd(offset,
+				                             llvm::ConstantInt::get(intPtrType, align - 1));
+				offset = irBuilder.CreateAnd(offset,
+				                             llvm::ConstantInt::get(intPtrType, -((int64_t) align)));
+				argPtr = irBuilder.CreateIntToPtr(offset, i8PtrType, "ap.align");
+			}
+			
+			const auto size = typeInfo.getTypeAllocSize(type).roundUpToAlign(ArgSlotSize);
+			const auto nextArgPtr = irBuilder.CreateConstGEP1_32(argPtr,
+			                                                     size.asBytes(),
+			                                                     "ap.next");
+			irBuilder.CreateStore(nextArgPtr, vaListPtr);
+			
+			return irBuilder.CreateBitCast(argPtr,
+			                               typeInfo.getLLVMType(type)->getPointerTo());
+		}
+		
+		llvm::Value* emitX86_32VAArg(const X86_32Classifier& classifier,
+		                             const ABITypeInfo& typeInfo,
+		                             Builder& builder,
+		                             llvm::Value* const vaList,
+		                             const Type type) {
+			auto& irBuilder = builder.getBuilder();
+			const auto llvmType = typeInfo.getLLVMType(type);
+			const auto typeAlign = typeInfo.getTypeRequiredAlign(type);
+			
+			// Non-trivial C++ records are passed by reference, unless
+			// MSVC constructed them in the argument area.
+			if (type.isNonTrivialRecord() && !classifier.isWin32StructABI()) {
+				const auto argPtrPtr = emitVAArgAddress(typeInfo, builder,
+				                                        vaList, PointerTy,
+				                                        ArgSlotSize);
+				const auto argPtr = irBuilder.CreateBitCast(irBuilder.CreateLoad(argPtrPtr),
+				                                            llvmType->getPointerTo());
+				const auto loadInst = irBuilder.CreateLoad(argPtr);
+				loadInst->setAlignment(typeAlign.asBytes());
+				return loadInst;
+			}
+			
+			// x86_32 changes the alignment of certain arguments on the
+			// stack; zero means the default slot alignment.
+			auto stackAlign = classifier.getTypeStackAlignInBytes(type, typeAlign);
+			if (stackAlign.asBytes() == 0) {
+				stackAlign = ArgSlotSize;
+			}
+			
+			const auto argPtr = emitVAArgAddress(typeInfo, builder,
+			                                     vaList, type,
+			                                     stackAlign);
+			const auto loadInst = irBuilder.CreateLoad(argPtr);
+			loadInst->setAlignment(std::min(typeAlign, stackAlign).asBytes());
+			return loadInst;
+		}
+		
+		void emitX86_32VACopy(Builder& builder,
+		                      llvm::Value* const destVaList,
+		                      llvm::Value* const sourceVaList) {
+			// A va_list is just a pointer, so copy it directly.
+			auto& irBuilder = builder.getBuilder();
+			const auto vaListPtrType = irBuilder.getInt8PtrTy()->getPointerTo();
+			const auto sourcePtr = irBuilder.CreateBitCast(sourceVaList,
+			                                               vaListPtrType);
+			const auto destPtr = irBuilder.CreateBitCast(destVaList,
+			                                             vaListPtrType);
+			irBuilder.CreateStore(irBuilder.CreateLoad(sourcePtr), destPtr);
+		}
+		
+	}
+	
+}
@@ -1,13 +1,20 @@
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <vector>
 
 #include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABITargetData.hpp>
+#include <llvm-abi/BatchLowering.hpp>
 #include <llvm-abi/Builder.hpp>
-#include <llvm-abi/Callee.hpp>
 #include <llvm-abi/Caller.hpp>
 #include <llvm-abi/DataSize.hpp>
+#include <llvm-abi/DefaultFunctionEncoder.hpp>
 #include <llvm-abi/FunctionEncoder.hpp>
 #include <llvm-abi/FunctionIRMapping.hpp>
 #include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/LLVMUtils.hpp>
+#include <llvm-abi/LoweringPlan.hpp>
 #include <llvm-abi/Type.hpp>
 #include <llvm-abi/TypePromoter.hpp>
 
@@ -17,6 +24,8 @@
 #include <llvm-abi/x86/CPUKind.hpp>
 #include <llvm-abi/x86/X86_64ABI.hpp>
 #include <llvm-abi/x86/X86_64ABITypeInfo.hpp>
+#include <llvm-abi/x86/X86_64LoweringPlanner.hpp>
+#include <llvm-abi/x86/X86_64VAArg.hpp>
 
 namespace llvm_abi {
 	
@@ -29,9 +38,23 @@ namespace llvm_abi {
 		cpuKind_(getCPUKind(targetTriple,
 		                    cpuName)),
 		cpuFeatures_(getCPUFeatures(targetTriple,
-		                            cpuKind_)),
+		                            cpuName)),
 		module_(module),
-		typeInfo_(llvmContext_, cpuFeatures_) {
+		targetData_(std::make_shared<ABITargetData>()),
+		typeInfo_(llvmContext_, cpuFeatures_, *targetData_) {
+			(void) module_;
+		}
+		
+		X86_64ABI::X86_64ABI(llvm::Module* module,
+		                     const CPUKind cpuKind,
+		                     const CPUFeatures& cpuFeatures,
+		                     std::shared_ptr<const ABITargetData> targetData)
+		: llvmContext_(module->getContext()),
+		cpuKind_(cpuKind),
+		cpuFeatures_(cpuFeatures),
+		module_(module),
+		targetData_(std::move(targetData)),
+		typeInfo_(llvmContext_, cpuFeatures_, *targetData_) {
 			(void) module_;
 		}
 		
@@ -50,20 +73,38 @@ namespace llvm_abi {
 				case CC_CDefault:
 				case CC_CppDefault:
 					return llvm::CallingConv::C;
+				case CC_RegCall:
+#if LLVMABI_LLVM_VERSION >= 400
+					return llvm::CallingConv::X86_RegCall;
+#else
+					throw std::runtime_error("RegCall not supported by version of LLVM built against (need LLVM 4.0+.)");
+#endif
+				case CC_FastInternal:
+					return llvm::CallingConv::Fast;
+				case CC_Swift:
+#if LLVMABI_LLVM_VERSION >= 309
+					return llvm::CallingConv::Swift;
+#else
+					throw std::runtime_error("Swift calling convention not supported by version of LLVM built against (need LLVM 3.9+.)");
+#endif
 				default:
 					llvm_unreachable("Invalid calling convention for ABI.");
 			}
 		}
 		
+		static
+		FunctionIRMapping computeIRMapping(const X86_64ABITypeInfo& typeInfo,
+		                                   const FunctionType& functionType,
+		                                   llvm::ArrayRef<Type> argumentTypes) {
+			return getX86_64LoweringPlan(typeInfo,
+			                             functionType,
+			                             argumentTypes).irMapping();
+		}
+		
 		llvm::FunctionType* X86_64ABI::getFunctionType(const FunctionType& functionType) const {
-			Classifier classifier(typeInfo_);
-			const auto argInfoArray =
-				classifier.classifyFunctionType(functionType,
-				                                functionType.argumentTypes());
-			assert(argInfoArray.size() >= 1);
-			
-			const auto functionIRMapping = getFunctionIRMapping(typeInfo(),
-			                                                    argInfoArray);
+			const auto functionIRMapping = computeIRMapping(typeInfo_,
+			                                                functionType,
+			                                                functionType.argumentTypes());
 			
 			return llvm_abi::getFunctionType(llvmContext_,
 			                                 typeInfo_,
@@ -71,17 +112,23 @@ namespace llvm_abi {
 			                                 functionIRMapping);
 		}
 		
-		static
-		FunctionIRMapping computeIRMapping(const ABITypeInfo& typeInfo,
-		                                   const FunctionType& functionType,
-		                                   llvm::ArrayRef<Type> argumentTypes) {
-			Classifier classifier(typeInfo);
-			const auto argInfoArray =
-				classifier.classifyFunctionType(functionType,
-				                                argumentTypes);
-			assert(argInfoArray.size() >= 1);
-			
-			return getFunctionIRMapping(typeInfo, argInfoArray);
+		LoweringPlan X86_64ABI::getLoweringPlan(const FunctionType& functionType,
+		                                        llvm::ArrayRef<Type> rawArgumentTypes) const {
+			TypePromoter typePromoter(typeInfo());
+			const auto argumentTypes = typePromoter.promoteArgumentTypes(functionType,
+			                                                             rawArgumentTypes);
+			return getX86_64LoweringPlan(typeInfo_,
+			                             functionType,
+			                             argumentTypes);
+		}
+		
+		std::vector<LoweredFunctionType>
+		X86_64ABI::lowerBatch(llvm::ArrayRef<FunctionType> functionTypes,
+		                      const unsigned numThreads) const {
+			return llvm_abi::lowerBatch(llvmContext_,
+			                            *this,
+			                            functionTypes,
+			                            numThreads);
 		}
 		
 		llvm::AttributeSet X86_64ABI::getAttributes(const FunctionType& functionType,
@@ -100,6 +147,8 @@ namespace llvm_abi {
 			
 			return llvm_abi::getFunctionAttributes(llvmContext_,
 			                                       typeInfo_,
+			                                       functionType,
+			                                       argumentTypes,
 			                                       functionIRMapping,
 			                                       existingAttributes);
 		}
@@ -142,48 +191,140 @@ namespace llvm_abi {
 			return caller.decodeReturnValue(encodedArguments, returnValue);
 		}
 		
-		class FunctionEncoder_x86_64: public FunctionEncoder {
+		bool X86_64ABI::isTailCallCompatible(const FunctionType& callerType,
+		                                     const FunctionType& calleeType) const {
+			const auto callerIRMapping = computeIRMapping(typeInfo_,
+			                                              callerType,
+			                                              callerType.argumentTypes());
+			const auto calleeIRMapping = computeIRMapping(typeInfo_,
+			                                              calleeType,
+			                                              calleeType.argumentTypes());
+			return llvm_abi::isTailCallCompatible(llvmContext_,
+			                                      typeInfo_,
+			                                      callerType,
+			                                      callerIRMapping,
+			                                      calleeType,
+			                                      calleeIRMapping);
+		}
+		
+		llvm::Value* X86_64ABI::createTailCall(Builder& builder,
+		                                       const FunctionType& functionType,
+		                                       std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+		                                       llvm::ArrayRef<TypedValue> arguments,
+		                                       llvm::Value* const returnValuePtr) const {
+			llvm::SmallVector<Type, 8> rawArgumentTypes;
+			for (const auto& value: arguments) {
+				rawArgumentTypes.push_back(value.type());
+			}
+			
+			TypePromoter typePromoter(typeInfo());
+			const auto argumentTypes = typePromoter.promoteArgumentTypes(functionType,
+			                                                             rawArgumentTypes);
+			
+			const auto functionIRMapping = computeIRMapping(typeInfo_,
+			                                                functionType,
+			                                                argumentTypes);
+			
+			return llvm_abi::createTailCall(typeInfo_,
+			                                builder,
+			                                functionType,
+			                                functionIRMapping,
+			                                callBuilder,
+			                                arguments,
+			                                returnValuePtr);
+		}
+		
+		llvm::Value* X86_64ABI::createInMemoryCall(Builder& builder,
+		                                           const FunctionType& functionType,
+		                                           std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+		                                           llvm::ArrayRef<TypedValue> arguments,
+		                                           llvm::Value* const returnValuePtr) const {
+			// Without an argument constructor, non-trivial records are
+			// given like other arguments.
+			return createConstructingCall(builder,
+			                              functionType,
+			                              nullptr,
+			                              callBuilder,
+			                              arguments,
+			                              returnValuePtr);
+		}
+		
+		llvm::Value* X86_64ABI::createConstructingCall(Builder& builder,
+		                                               const FunctionType& functionType,
+		                                               std::function<void (size_t, llvm::Value*)> argumentConstructor,
+		                                               std::function<llvm::Value* (llvm::ArrayRef<llvm::Value*>)> callBuilder,
+		                                               llvm::ArrayRef<TypedValue> rawArguments,
+		                                               llvm::Value* const returnValuePtr) const {
+			llvm::SmallVector<TypedValue, 8> inputArguments(rawArguments.begin(),
+			                                                rawArguments.end());
+			const auto argumentsInMemory = prepareInMemoryArguments(typeInfo_,
+			                                                        builder,
+			                                                        functionType,
+			                                                        inputArguments);
+			
+			TypePromoter typePromoter(typeInfo());
+			const auto arguments = typePromoter.promoteArguments(builder,
+			                                                     functionType,
+			                                                     inputArguments);
+			
+			llvm::SmallVector<Type, 8> argumentTypes;
+			for (const auto& value: arguments) {
+				argumentTypes.push_back(value.type());
+			}
+			
+			const auto functionIRMapping = computeIRMapping(typeInfo_,
+			                                                functionType,
+			                                                argumentTypes);
+			
+			Caller caller(typeInfo_,
+			              functionType,
+			              functionIRMapping,
+			              builder);
+			
+			const auto encodedArguments = caller.encodeArguments(arguments,
+			                                                     returnValuePtr,
+			                                                     argumentsInMemory,
+			                                                     argumentConstructor);
+			
+			const auto returnValue = callBuilder(encodedArguments);
+			
+			return caller.decodeReturnValue(encodedArguments,
+			                                returnValue,
+			                                returnValuePtr,
+			                                /*inMemory=*/true);
+		}
+		
+		class FunctionEncoder_x86_64: public DefaultFunctionEncoder {
 		public:
-			FunctionEncoder_x86_64(const X86_64ABI& abi,
+			FunctionEncoder_x86_64(const X86_64ABITypeInfo& typeInfo,
 			                       Builder& builder,
-		                               const FunctionType& functionType,
+			                       const FunctionType& functionType,
 			                       llvm::ArrayRef<llvm::Value*> pArguments)
-			: builder_(builder),
-			functionIRMapping_(computeIRMapping(abi.typeInfo(),
-			                                    functionType,
-			                                    functionType.argumentTypes())),
-			callee_(abi.typeInfo(),
-			        functionType,
-			        functionIRMapping_,
-			        builder),
-			encodedArguments_(pArguments.begin(), pArguments.end()),
-			arguments_(callee_.decodeArguments(pArguments)) { }
-			
-			llvm::ArrayRef<llvm::Value*> arguments() const {
-				return arguments_;
+			: DefaultFunctionEncoder(typeInfo,
+			                         builder,
+			                         functionType,
+			                         computeIRMapping(typeInfo,
+			                                          functionType,
+			                                          functionType.argumentTypes()),
+			                         pArguments) { }
+			
+			llvm::Type* vaListType() const {
+				return getX86_64VAListType(builder().getBuilder().getContext());
 			}
 			
-			llvm::ReturnInst* returnValue(llvm::Value* const value) {
-				const auto encodedReturnValue = callee_.encodeReturnValue(value,
-				                                                          encodedArguments_);
-				if (encodedReturnValue->getType()->isVoidTy()) {
-					return builder_.getBuilder().CreateRetVoid();
-				} else {
-					return builder_.getBuilder().CreateRet(encodedReturnValue);
-				}
+			llvm::Value* vaArg(llvm::Value* const vaList, const Type type) {
+				return emitX86_64VAArg(typeInfo(), builder(), vaList, type);
 			}
 			
-			llvm::Value* returnValuePointer() const {
-				// TODO!
-				return nullptr;
+			void vaCopy(llvm::Value* const destVaList, llvm::Value* const sourceVaList) {
+				emitX86_64VACopy(typeInfo(), builder(), destVaList, sourceVaList);
 			}
 			
-		private:
-			Builder& builder_;
-			FunctionIRMapping functionIRMapping_;
-			Callee callee_;
-			llvm::SmallVector<llvm::Value*, 8> encodedArguments_;
-			llvm::SmallVector<llvm::Value*, 8> arguments_;
+			llvm::Value* vaListArgument(llvm::Value* const vaList) {
+				// va_list is an array type, so it decays to a pointer.
+				return builder().getBuilder().CreateBitCast(vaList,
+				                                            builder().getBuilder().getInt8PtrTy());
+			}
 			
 		};
 		
@@ -191,12 +332,33 @@ namespace llvm_abi {
 		X86_64ABI::createFunctionEncoder(Builder& builder,
 		                                 const FunctionType& functionType,
 		                                 llvm::ArrayRef<llvm::Value*> arguments) const {
-			return std::unique_ptr<FunctionEncoder>(new FunctionEncoder_x86_64(*this,
+			return std::unique_ptr<FunctionEncoder>(new FunctionEncoder_x86_64(typeInfo_,
 			                                                               builder,
 			                                                               functionType,
 			                                                               arguments));
 		}
 		
+		const ABI& X86_64ABI::withTargetFeatures(const std::string& targetFeatures) const {
+			const auto features = applyTargetFeatures(cpuFeatures_,
+			                                          targetFeatures);
+			if (features == cpuFeatures_) {
+				return *this;
+			}
+			
+			// Share an ABI between all functions with the same
+			// feature set. Features don't affect type layout, so
+			// the variants share this ABI's target data.
+			std::lock_guard<std::mutex> lock(featureABICacheMutex_);
+			auto& abi = featureABICache_[features.mask()];
+			if (abi == nullptr) {
+				abi.reset(new X86_64ABI(module_,
+				                        cpuKind_,
+				                        features,
+				                        targetData_));
+			}
+			return *abi;
+		}
+		
 	}
 	
 }
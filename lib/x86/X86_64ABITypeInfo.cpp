@@ -3,7 +3,10 @@
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 
+#include <llvm-abi/ABILayoutCache.hpp>
+#include <llvm-abi/ABITargetData.hpp>
 #include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/ConcurrentCache.hpp>
 #include <llvm-abi/DataSize.hpp>
 #include <llvm-abi/DefaultABITypeInfo.hpp>
 #include <llvm-abi/Type.hpp>
@@ -17,39 +20,82 @@ namespace llvm_abi {
 	namespace x86 {
 		
 		X86_64ABITypeInfo::X86_64ABITypeInfo(llvm::LLVMContext& llvmContext,
-		                                     const CPUFeatures& cpuFeatures)
-		: llvmContext_(llvmContext),
-		cpuFeatures_(cpuFeatures),
+		                                     const CPUFeatures& cpuFeatures,
+		                                     const ABITargetData& targetData)
+		: cpuFeatures_(cpuFeatures),
+		targetData_(targetData),
 		defaultABITypeInfo_(llvmContext, /*typeInfo=*/*this,
 		                    /*delegate=*/*this)
 		{ }
 		
+		X86_64ABITypeInfo::X86_64ABITypeInfo(const CPUFeatures& cpuFeatures,
+		                                     const ABITargetData& targetData)
+		: cpuFeatures_(cpuFeatures),
+		targetData_(targetData),
+		defaultABITypeInfo_(/*typeInfo=*/*this, /*delegate=*/*this)
+		{ }
+		
 		const TypeBuilder& X86_64ABITypeInfo::typeBuilder() const {
-			return typeBuilder_;
+			return targetData_.typeBuilder();
+		}
+		
+		const CPUFeatures& X86_64ABITypeInfo::cpuFeatures() const {
+			return cpuFeatures_;
+		}
+		
+		const ABITargetData& X86_64ABITypeInfo::targetData() const {
+			return targetData_;
 		}
 		
 		DataSize X86_64ABITypeInfo::getTypeRawSize(const Type type) const {
-			return defaultABITypeInfo_.getDefaultTypeRawSize(type);
+			if (!type.isAggregateType()) {
+				return defaultABITypeInfo_.getDefaultTypeRawSize(type);
+			}
+			return targetData_.layoutCache().get(ABILayoutCache::RawSize, type,
+			                                     [&] { return defaultABITypeInfo_.getDefaultTypeRawSize(type); });
 		}
 		
 		DataSize X86_64ABITypeInfo::getTypeAllocSize(const Type type) const {
-			return defaultABITypeInfo_.getDefaultTypeAllocSize(type);
+			if (!type.isAggregateType()) {
+				return defaultABITypeInfo_.getDefaultTypeAllocSize(type);
+			}
+			return targetData_.layoutCache().get(ABILayoutCache::AllocSize, type,
+			                                     [&] { return defaultABITypeInfo_.getDefaultTypeAllocSize(type); });
 		}
 		
 		DataSize X86_64ABITypeInfo::getTypeStoreSize(const Type type) const {
-			return defaultABITypeInfo_.getDefaultTypeStoreSize(type);
+			if (!type.isAggregateType()) {
+				return defaultABITypeInfo_.getDefaultTypeStoreSize(type);
+			}
+			return targetData_.layoutCache().get(ABILayoutCache::StoreSize, type,
+			                                     [&] { return defaultABITypeInfo_.getDefaultTypeStoreSize(type); });
 		}
 		
 		DataSize X86_64ABITypeInfo::getTypeRequiredAlign(const Type type) const {
-			return defaultABITypeInfo_.getDefaultTypeRequiredAlign(type);
+			if (!type.isAggregateType()) {
+				return defaultABITypeInfo_.getDefaultTypeRequiredAlign(type);
+			}
+			return targetData_.layoutCache().get(ABILayoutCache::RequiredAlign, type,
+			                                     [&] { return defaultABITypeInfo_.getDefaultTypeRequiredAlign(type); });
 		}
 		
 		DataSize X86_64ABITypeInfo::getTypePreferredAlign(const Type type) const {
-			return defaultABITypeInfo_.getDefaultTypePreferredAlign(type);
+			if (!type.isAggregateType()) {
+				return defaultABITypeInfo_.getDefaultTypePreferredAlign(type);
+			}
+			return targetData_.layoutCache().get(ABILayoutCache::PreferredAlign, type,
+			                                     [&] { return defaultABITypeInfo_.getDefaultTypePreferredAlign(type); });
 		}
 		
 		llvm::Type* X86_64ABITypeInfo::getLLVMType(const Type type) const  {
-			return defaultABITypeInfo_.getDefaultLLVMType(type);
+			if (!type.isAggregateType()) {
+				return defaultABITypeInfo_.getDefaultLLVMType(type);
+			}
+			
+			// LLVM types belong to an LLVM context, so unlike the
+			// layout cache this can't be shared between modules.
+			return llvmTypeCache_.get(type,
+			                          [&] { return defaultABITypeInfo_.getDefaultLLVMType(type); });
 		}
 		
 		llvm::SmallVector<DataSize, 8>
@@ -60,8 +106,23 @@ namespace llvm_abi {
 		bool X86_64ABITypeInfo::isLegalVectorType(const Type type) const {
 			assert(type.isVector());
 			const auto size = getTypeAllocSize(type);
-			const size_t largestVector = cpuFeatures_.hasAVX() ? 256 : 128;
-			return size.asBits() > 64 && size.asBits() <= largestVector;
+			return size.asBits() > 64 && size.asBits() <= getNativeVectorSize().asBits();
+		}
+		
+		DataSize X86_64ABITypeInfo::getNativeVectorSize() const {
+			// ZMM registers with AVX-512, YMM registers with AVX,
+			// otherwise XMM registers.
+			if (cpuFeatures_.hasAVX512F()) {
+				return DataSize::Bytes(64);
+			} else if (cpuFeatures_.hasAVX()) {
+				return DataSize::Bytes(32);
+			} else {
+				return DataSize::Bytes(16);
+			}
+		}
+		
+		DataSize X86_64ABITypeInfo::getMaxCopyUnitSize() const {
+			return getNativeVectorSize();
 		}
 		
 		bool X86_64ABITypeInfo::isBigEndian() const {
@@ -137,7 +198,7 @@ namespace llvm_abi {
 		DataSize X86_64ABITypeInfo::getFloatSize(const FloatingPointKind kind) const {
 			switch (kind) {
 				case HalfFloat:
-					llvm_unreachable("TODO");
+					return DataSize::Bytes(2);
 				case Float:
 					return DataSize::Bytes(4);
 				case Double:
@@ -153,7 +214,7 @@ namespace llvm_abi {
 		DataSize X86_64ABITypeInfo::getFloatAlign(const FloatingPointKind kind) const {
 			switch (kind) {
 				case HalfFloat:
-					llvm_unreachable("TODO");
+					return DataSize::Bytes(2);
 				case Float:
 					return DataSize::Bytes(4);
 				case Double:
@@ -169,7 +230,7 @@ namespace llvm_abi {
 		DataSize X86_64ABITypeInfo::getComplexSize(const FloatingPointKind kind) const {
 			switch (kind) {
 				case HalfFloat:
-					llvm_unreachable("TODO");
+					return DataSize::Bytes(4);
 				case Float:
 					return DataSize::Bytes(8);
 					
@@ -186,20 +247,22 @@ namespace llvm_abi {
 		}
 		
 		DataSize X86_64ABITypeInfo::getComplexAlign(const FloatingPointKind kind) const {
+			// Complex values are aligned like their real and
+			// imaginary parts.
 			switch (kind) {
 				case HalfFloat:
-					llvm_unreachable("TODO");
+					return DataSize::Bytes(2);
 				case Float:
-					return DataSize::Bytes(8);
+					return DataSize::Bytes(4);
 					
 				case Double:
-					return DataSize::Bytes(16);
+					return DataSize::Bytes(8);
 					
 				case LongDouble:
-					return DataSize::Bytes(32);
+					return DataSize::Bytes(16);
 					
 				case Float128:
-					return DataSize::Bytes(32);
+					return DataSize::Bytes(16);
 			}
 			llvm_unreachable("Unknown Complex type kind.");
 		}
@@ -220,7 +283,7 @@ namespace llvm_abi {
 		}
 		
 		llvm::Type* X86_64ABITypeInfo::getLongDoubleIRType() const {
-			return llvm::Type::getX86_FP80Ty(llvmContext_);
+			return llvm::Type::getX86_FP80Ty(defaultABITypeInfo_.context());
 		}
 		
 	}
@@ -0,0 +1,75 @@
+#include <memory>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/IR/Attributes.h>
+#include <llvm/IR/DerivedTypes.h>
+
+#include <llvm-abi/ABITargetData.hpp>
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/FunctionIRMapping.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/LoweringPlan.hpp>
+#include <llvm-abi/LoweringPlanCache.hpp>
+#include <llvm-abi/RegisterUsage.hpp>
+#include <llvm-abi/Type.hpp>
+#include <llvm-abi/TypePromoter.hpp>
+
+#include <llvm-abi/x86/Classifier.hpp>
+#include <llvm-abi/x86/CPUFeatures.hpp>
+#include <llvm-abi/x86/X86_64LoweringPlanner.hpp>
+
+namespace llvm_abi {
+	
+	namespace x86 {
+		
+		static
+		LoweringPlan computeX86_64LoweringPlan(const ABITypeInfo& typeInfo,
+		                                       const FunctionType& functionType,
+		                                       llvm::ArrayRef<Type> argumentTypes) {
+			RegisterUsage registerUsage;
+			Classifier classifier(typeInfo);
+			const auto argInfoArray =
+				classifier.classifyFunctionType(functionType,
+				                                argumentTypes,
+				                                &registerUsage);
+			assert(argInfoArray.size() >= 1);
+			
+			return LoweringPlan(functionType,
+			                    argumentTypes,
+			                    getFunctionIRMapping(typeInfo, argInfoArray),
+			                    registerUsage);
+		}
+		
+		LoweringPlan getX86_64LoweringPlan(const X86_64ABITypeInfo& typeInfo,
+		                                   const FunctionType& functionType,
+		                                   llvm::ArrayRef<Type> argumentTypes) {
+			return typeInfo.targetData().loweringPlanCache().get(functionType, argumentTypes,
+			                                                     typeInfo.cpuFeatures().mask(),
+			                                                     [&] { return computeX86_64LoweringPlan(typeInfo, functionType, argumentTypes); });
+		}
+		
+		X86_64LoweringPlanner::X86_64LoweringPlanner(const CPUFeatures& cpuFeatures,
+		                                             std::shared_ptr<const ABITargetData> targetData)
+		: cpuFeatures_(cpuFeatures),
+		targetData_(std::move(targetData)),
+		typeInfo_(cpuFeatures_, *targetData_) { }
+		
+		const ABITypeInfo& X86_64LoweringPlanner::typeInfo() const {
+			return typeInfo_;
+		}
+		
+		LoweringPlan
+		X86_64LoweringPlanner::getLoweringPlan(const FunctionType& functionType,
+		                                       llvm::ArrayRef<Type> rawArgumentTypes) const {
+			TypePromoter typePromoter(typeInfo_);
+			const auto argumentTypes = typePromoter.promoteArgumentTypes(functionType,
+			                                                             rawArgumentTypes);
+			return getX86_64LoweringPlan(typeInfo_,
+			                             functionType,
+			                             argumentTypes);
+		}
+		
+	}
+	
+}
+
@@ -0,0 +1,329 @@
+#include <algorithm>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/ArgInfo.hpp>
+#include <llvm-abi/Builder.hpp>
+#include <llvm-abi/DataSize.hpp>
+#include <llvm-abi/LLVMUtils.hpp>
+#include <llvm-abi/Type.hpp>
+
+#include <llvm-abi/x86/Classifier.hpp>
+#include <llvm-abi/x86/X86_64VAArg.hpp>
+
+namespace llvm_abi {
+	
+	namespace x86 {
+		
+		// Offsets past the end of the general purpose and SSE parts
+		// of the register save area (6 * 8 and 6 * 8 + 8 * 16).
+		static const unsigned GPRegSaveAreaEnd = 48;
+		static const unsigned FPRegSaveAreaEnd = 176;
+		
+		enum VAListField {
+			VAListGPOffset = 0,
+			VAListFPOffset = 1,
+			VAListOverflowArgArea = 2,
+			VAListRegSaveArea = 3
+		};
+		
+		static llvm::StructType* getVAListTagType(llvm::LLVMContext& context) {
+			// AMD64-ABI 3.5.7p5: the va_list element type.
+			llvm::Type* const members[] = {
+				llvm::Type::getInt32Ty(context), // gp_offset
+				llvm::Type::getInt32Ty(context), // fp_offset
+				llvm::Type::getInt8PtrTy(context), // overflow_arg_area
+				llvm::Type::getInt8PtrTy(context) // reg_save_area
+			};
+			return llvm::StructType::get(context, llvm::ArrayRef<llvm::Type*>(members));
+		}
+		
+		llvm::Type* getX86_64VAListType(llvm::LLVMContext& context) {
+			return llvm::ArrayType::get(getVAListTagType(context), 1);
+		}
+		
+		static llvm::Value* emitVAArgFromMemory(const ABITypeInfo& typeInfo,
+		                                        Builder& builder,
+		                                        llvm::StructType* const vaListType,
+		                                        llvm::Value* const vaList,
+		                                        const Type type) {
+			auto& irBuilder = builder.getBuilder();
+			const auto overflowAreaPtr = createStructGEP(builder, vaListType, vaList,
+			                                             VAListOverflowArgArea,
+			                                             "overflow_arg_area_p");
+			llvm::Value* overflowArea = irBuilder.CreateLoad(overflowAreaPtr,
+			                                                 "overflow_arg_area");
+			
+			// AMD64-ABI 3.5.7p5: Step 7. Align l->overflow_arg_area upwards
+			// to a 16 byte boundary if alignment needed by type exceeds 8
+			// byte boundary.
+			const auto align = typeInfo.getTypeRequiredAlign(type).asBytes();
+			if (align > 8) {
+				const auto intPtrType = typeInfo.getLLVMType(IntPtrTy);
+				auto offset = irBuilder.CreatePtrToInt(overflowArea, intPtrType);
+				offset = irBuilder.CreateAdd(offset,
+				                             llvm::ConstantInt::get(intPtrType, align - 1));
+				offset = irBuilder.CreateAnd(offset,
+				                             llvm::ConstantInt::get(intPtrType, -((int64_t) align)));
+				overflowArea = irBuilder.CreateIntToPtr(offset,
+				                                        overflowArea->getType(),
+				                                        "overflow_arg_area.align");
+			}
+			
+			// AMD64-ABI 3.5.7p5: Step 8. Fetch type from l->overflow_arg_area.
+			const auto argPtr = irBuilder.CreateBitCast(overflowArea,
+			                                            typeInfo.getLLVMType(type)->getPointerTo());
+			
+			// AMD64-ABI 3.5.7p5: Step 9. Set l->overflow_arg_area to:
+			// l->overflow_arg_area + sizeof(type).
+			// AMD64-ABI 3.5.7p5: Step 10. Align l->overflow_arg_area upwards
+			// to an 8 byte boundary.
+			const auto size = typeInfo.getTypeAllocSize(type).roundUpToAlign(DataSize::Bytes(8));
+			const auto nextOverflowArea = irBuilder.CreateConstGEP1_32(overflowArea,
+			                                                           size.asBytes(),
+			                                                           "overflow_arg_area.next");
+			irBuilder.CreateStore(nextOverflowArea, overflowAreaPtr);
+			
+			return argPtr;
+		}
+		
+		static llvm::Value* getRegSaveAreaPtr(Builder& builder,
+		                                      llvm::Value* const regSaveArea,
+		                                      llvm::Value* const offset,
+		                                      const unsigned extraOffset,
+		                                      llvm::Type* const type) {
+			auto& irBuilder = builder.getBuilder();
+			llvm::Value* ptr = irBuilder.CreateGEP(regSaveArea, offset);
+			if (extraOffset != 0) {
+				ptr = irBuilder.CreateConstGEP1_32(ptr, extraOffset);
+			}
+			return irBuilder.CreateBitCast(ptr, type->getPointerTo());
+		}
+		
+		llvm::Value* emitX86_64VAArg(const ABITypeInfo& typeInfo,
+		                             Builder& builder,
+		                             llvm::Value* const vaListArg,
+		                             const Type type) {
+			auto& irBuilder = builder.getBuilder();
+			auto& context = irBuilder.getContext();
+			const auto llvmType = typeInfo.getLLVMType(type);
+			const auto align = typeInfo.getTypeRequiredAlign(type).asBytes();
+			const auto vaListType = getVAListTagType(context);
+			const auto vaList = irBuilder.CreateBitCast(vaListArg,
+			                                            vaListType->getPointerTo());
+			
+			// AMD64-ABI 3.5.7p5: Step 1. Determine whether type may be passed
+			// in the registers. If not go to step 7.
+			// AMD64-ABI 3.5.7p5: Step 2. Compute num_gp to hold the number
+			// of general purpose registers needed to pass type and num_fp to
+			// hold the number of floating point registers needed.
+			unsigned neededInt, neededSse;
+			Classifier classifier(typeInfo);
+			const auto argInfo = classifier.classifyType(type,
+			                                             /*isArgument=*/true,
+			                                             /*freeIntRegs=*/0,
+			                                             neededInt,
+			                                             neededSse,
+			                                             /*isNamedArg=*/false);
+			
+			if (argInfo.isIgnore()) {
+				// Empty records don't consume any argument space.
+				return llvm::UndefValue::get(llvmType);
+			}
+			
+			if (neededInt == 0 && neededSse == 0) {
+				if (argInfo.isIndirect() && !argInfo.getIndirectByVal()) {
+					// The argument was passed by reference, so
+					// fetch the pointer and then the value.
+					const auto argPtrPtr = emitVAArgFromMemory(typeInfo, builder,
+					                                           vaListType, vaList,
+					                                           PointerTy);
+					const auto argPtr = irBuilder.CreateBitCast(irBuilder.CreateLoad(argPtrPtr),
+					                                            llvmType->getPointerTo());
+					const auto loadInst = irBuilder.CreateLoad(argPtr);
+					loadInst->setAlignment(align);
+					return loadInst;
+				}
+				
+				const auto argPtr = emitVAArgFromMemory(typeInfo, builder,
+				                                        vaListType, vaList,
+				                                        type);
+				const auto loadInst = irBuilder.CreateLoad(argPtr);
+				loadInst->setAlignment(align);
+				return loadInst;
+			}
+			
+			// AMD64-ABI 3.5.7p5: Step 3. Verify whether arguments fit into
+			// registers. In the case: l->gp_offset > 48 - num_gp * 8 or
+			// l->fp_offset > 304 - num_fp * 16 go to step 7.
+			//
+			// NOTE: 304 is a typo; there are (6 * 8 + 8 * 16) = 176 bytes of
+			// register save space.
+			llvm::Value* inRegs = nullptr;
+			llvm::Value* gpOffsetPtr = nullptr;
+			llvm::Value* gpOffset = nullptr;
+			llvm::Value* fpOffsetPtr = nullptr;
+			llvm::Value* fpOffset = nullptr;
+			if (neededInt != 0) {
+				gpOffsetPtr = createStructGEP(builder, vaListType, vaList,
+				                              VAListGPOffset, "gp_offset_p");
+				gpOffset = irBuilder.CreateLoad(gpOffsetPtr, "gp_offset");
+				inRegs = irBuilder.CreateICmpULE(gpOffset,
+				                                 irBuilder.getInt32(GPRegSaveAreaEnd - neededInt * 8),
+				                                 "fits_in_gp");
+			}
+			
+			if (neededSse != 0) {
+				fpOffsetPtr = createStructGEP(builder, vaListType, vaList,
+				                              VAListFPOffset, "fp_offset_p");
+				fpOffset = irBuilder.CreateLoad(fpOffsetPtr, "fp_offset");
+				const auto fitsInFP = irBuilder.CreateICmpULE(fpOffset,
+				                                              irBuilder.getInt32(FPRegSaveAreaEnd - neededSse * 16),
+				                                              "fits_in_fp");
+				inRegs = inRegs != nullptr ? irBuilder.CreateAnd(inRegs, fitsInFP) : fitsInFP;
+			}
+			
+			const auto function = irBuilder.GetInsertBlock()->getParent();
+			const auto inRegBlock = llvm::BasicBlock::Create(context, "vaarg.in_reg", function);
+			const auto inMemBlock = llvm::BasicBlock::Create(context, "vaarg.in_mem", function);
+			const auto endBlock = llvm::BasicBlock::Create(context, "vaarg.end", function);
+			irBuilder.CreateCondBr(inRegs, inRegBlock, inMemBlock);
+			
+			// Emit code to load the value if it was passed in registers.
+			irBuilder.SetInsertPoint(inRegBlock);
+			
+			// AMD64-ABI 3.5.7p5: Step 4. Fetch type from l->reg_save_area
+			// with an offset of l->gp_offset and/or l->fp_offset. This may
+			// require copying to a temporary location in case the parameter
+			// is passed in different register classes or requires an
+			// alignment greater than 8 for general purpose registers and 16
+			// for XMM registers.
+			const auto regSaveAreaPtr = createStructGEP(builder, vaListType, vaList,
+			                                            VAListRegSaveArea,
+			                                            "reg_save_area_p");
+			const auto regSaveArea = irBuilder.CreateLoad(regSaveAreaPtr,
+			                                              "reg_save_area");
+			
+			const auto coerceType = argInfo.getCoerceToType();
+			const auto coerceLLVMType = typeInfo.getLLVMType(coerceType);
+			const bool isSplit = neededInt + neededSse == 2 && neededSse != 0;
+			const bool isOverAligned = neededSse == 0 && align > 8;
+			
+			llvm::Value* regAddr = nullptr;
+			if (isSplit || isOverAligned || argInfo.getDirectOffset() != 0) {
+				// The value isn't contiguous (or suitably aligned) in the
+				// register save area, so copy its parts to a temporary.
+				const auto tempType = typeInfo.getTypeAllocSize(coerceType) > typeInfo.getTypeAllocSize(type) ?
+				                      coerceType : type;
+				const auto tempAlloca = createMemTemp(typeInfo, builder, tempType, "vaarg.tmp");
+				tempAlloca->setAlignment(std::max<size_t>(align,
+				                                          typeInfo.getTypeRequiredAlign(coerceType).asBytes()));
+				
+				if (isSplit) {
+					// The coerced type is a pair of eightbytes, each in
+					// a general purpose register or an XMM register.
+					const auto coercePtr = irBuilder.CreateBitCast(tempAlloca,
+					                                               coerceLLVMType->getPointerTo());
+					const auto coerceStructType = llvm::cast<llvm::StructType>(coerceLLVMType);
+					unsigned sseIndex = 0;
+					for (unsigned i = 0; i < 2; i++) {
+						const auto elementType = coerceStructType->getElementType(i);
+						llvm::Value* elementPtr;
+						if (elementType->isFPOrFPVectorTy()) {
+							elementPtr = getRegSaveAreaPtr(builder, regSaveArea, fpOffset,
+							                               sseIndex * 16, elementType);
+							sseIndex++;
+						} else {
+							elementPtr = getRegSaveAreaPtr(builder, regSaveArea, gpOffset,
+							                               0, elementType);
+						}
+						const auto element = irBuilder.CreateLoad(elementPtr);
+						element->setAlignment(8);
+						irBuilder.CreateStore(element,
+						                      createStructGEP(builder, coerceLLVMType,
+						                                      coercePtr, i));
+					}
+				} else {
+					// The value is in consecutive registers of one class,
+					// possibly after a leading eightbyte of padding.
+					const auto sourcePtr = neededInt != 0 ?
+					                       getRegSaveAreaPtr(builder, regSaveArea, gpOffset,
+					                                         0, coerceLLVMType) :
+					                       getRegSaveAreaPtr(builder, regSaveArea, fpOffset,
+					                                         0, coerceLLVMType);
+					const auto loadInst = irBuilder.CreateLoad(sourcePtr);
+					loadInst->setAlignment(8);
+					llvm::Value* destPtr = irBuilder.CreateBitCast(tempAlloca,
+					                                               irBuilder.getInt8PtrTy());
+					if (argInfo.getDirectOffset() != 0) {
+						destPtr = irBuilder.CreateConstGEP1_32(destPtr,
+						                                       argInfo.getDirectOffset());
+					}
+					const auto storeInst = createStore(irBuilder, loadInst, destPtr);
+					storeInst->setAlignment(std::min<size_t>(align, 8));
+				}
+				
+				regAddr = irBuilder.CreateBitCast(tempAlloca, llvmType->getPointerTo());
+			} else if (neededInt != 0) {
+				regAddr = getRegSaveAreaPtr(builder, regSaveArea, gpOffset,
+				                            0, llvmType);
+			} else {
+				regAddr = getRegSaveAreaPtr(builder, regSaveArea, fpOffset,
+				                            0, llvmType);
+			}
+			
+			// AMD64-ABI 3.5.7p5: Step 5. Set:
+			// l->gp_offset = l->gp_offset + num_gp * 8
+			// l->fp_offset = l->fp_offset + num_fp * 16.
+			if (neededInt != 0) {
+				irBuilder.CreateStore(irBuilder.CreateAdd(gpOffset,
+				                                          irBuilder.getInt32(neededInt * 8)),
+				                      gpOffsetPtr);
+			}
+			if (neededSse != 0) {
+				irBuilder.CreateStore(irBuilder.CreateAdd(fpOffset,
+				                                          irBuilder.getInt32(neededSse * 16)),
+				                      fpOffsetPtr);
+			}
+			const auto inRegEndBlock = irBuilder.GetInsertBlock();
+			irBuilder.CreateBr(endBlock);
+			
+			// Emit code to load the value if it was passed in memory.
+			irBuilder.SetInsertPoint(inMemBlock);
+			const auto memAddr = emitVAArgFromMemory(typeInfo, builder,
+			                                         vaListType, vaList,
+			                                         type);
+			const auto inMemEndBlock = irBuilder.GetInsertBlock();
+			irBuilder.CreateBr(endBlock);
+			
+			// Return the appropriate result.
+			irBuilder.SetInsertPoint(endBlock);
+			const auto phiNode = irBuilder.CreatePHI(llvmType->getPointerTo(), 2,
+			                                         "vaarg.addr");
+			phiNode->addIncoming(regAddr, inRegEndBlock);
+			phiNode->addIncoming(memAddr, inMemEndBlock);
+			
+			const auto loadInst = irBuilder.CreateLoad(phiNode);
+			loadInst->setAlignment(align);
+			return loadInst;
+		}
+		
+		void emitX86_64VACopy(const ABITypeInfo& typeInfo,
+		                      Builder& builder,
+		                      llvm::Value* const destVaList,
+		                      llvm::Value* const sourceVaList) {
+			// AMD64-ABI 3.5.7p5: the va_list is a 24 byte structure, so
+			// it's copied like any other aggregate.
+			createMemCpy(typeInfo, builder, destVaList, sourceVaList,
+			             DataSize::Bytes(24), /*align=*/8);
+		}
+		
+	}
+	
+}
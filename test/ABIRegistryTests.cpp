@@ -0,0 +1,134 @@
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABIRegistry.hpp>
+#include <llvm-abi/ABITargetData.hpp>
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/LoweringPlan.hpp>
+#include <llvm-abi/LoweringPlanCache.hpp>
+#include <llvm-abi/Type.hpp>
+#include <llvm-abi/TypeBuilder.hpp>
+
+#include <llvm-abi/x86/CPUFeatures.hpp>
+#include <llvm-abi/x86/X86_64ABITypeInfo.hpp>
+
+#include "UnitTest.hpp"
+
+using namespace llvm_abi;
+
+// The type builder and layout cache are both owned by the target
+// data, so ABIs with the same type builder share their layouts.
+static bool sharesTargetData(const ABITypeInfo& first, const ABITypeInfo& second) {
+	return &(first.typeBuilder()) == &(second.typeBuilder());
+}
+
+UNIT_TEST(ABIRegistrySharesTargetData) {
+	ABIRegistry registry;
+	const llvm::Triple triple("x86_64-none-linux-gnu");
+	
+	llvm::LLVMContext firstContext;
+	llvm::Module firstModule("", firstContext);
+	const auto firstABI = registry.createABI(firstModule, triple, "haswell");
+	
+	llvm::LLVMContext secondContext;
+	llvm::Module secondModule("", secondContext);
+	const auto secondABI = registry.createABI(secondModule, triple, "haswell");
+	UNIT_CHECK(sharesTargetData(firstABI->typeInfo(), secondABI->typeInfo()));
+	
+	// Types built for one module can be used with the other.
+	const auto& typeBuilder = firstABI->typeInfo().typeBuilder();
+	const auto structType = typeBuilder.getStructTy({ IntTy, DoubleTy, CharTy });
+	UNIT_CHECK(firstABI->typeInfo().getTypeAllocSize(structType) ==
+	           secondABI->typeInfo().getTypeAllocSize(structType));
+	UNIT_CHECK(&(firstABI->typeInfo().getLLVMType(structType)->getContext()) == &firstContext);
+	UNIT_CHECK(&(secondABI->typeInfo().getLLVMType(structType)->getContext()) == &secondContext);
+	
+	const FunctionType functionType(CC_CDefault, structType, { structType });
+	UNIT_CHECK(firstABI->getFunctionType(functionType) != secondABI->getFunctionType(functionType));
+	
+	// Planners for the same target share it too.
+	const auto planner = registry.createLoweringPlanner(triple, "haswell");
+	UNIT_CHECK(sharesTargetData(firstABI->typeInfo(), planner->typeInfo()));
+	
+	// A different CPU is a different target.
+	const auto otherABI = registry.createABI(secondModule, triple, "x86-64");
+	UNIT_CHECK(!sharesTargetData(firstABI->typeInfo(), otherABI->typeInfo()));
+	
+	const llvm::Triple triple32("i386-none-linux-gnu");
+	const auto firstABI32 = registry.createABI(firstModule, triple32);
+	const auto secondABI32 = registry.createABI(secondModule, triple32);
+	UNIT_CHECK(sharesTargetData(firstABI32->typeInfo(), secondABI32->typeInfo()));
+	UNIT_CHECK(!sharesTargetData(firstABI->typeInfo(), firstABI32->typeInfo()));
+}
+
+UNIT_TEST(ABIRegistryFeaturesShareTargetData) {
+	ABIRegistry registry;
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = registry.createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	
+	// Target features change the lowering but not the layout.
+	const auto& avxABI = abi->withTargetFeatures("+avx");
+	UNIT_CHECK(&avxABI != abi.get());
+	UNIT_CHECK(sharesTargetData(abi->typeInfo(), avxABI.typeInfo()));
+	
+	const auto& noSSE3ABI = avxABI.withTargetFeatures("-sse3");
+	UNIT_CHECK(&noSSE3ABI != &avxABI);
+	UNIT_CHECK(sharesTargetData(abi->typeInfo(), noSSE3ABI.typeInfo()));
+	
+	const auto vectorType = abi->typeInfo().typeBuilder().getVectorTy(8, FloatTy);
+	const FunctionType functionType(CC_CDefault, VoidTy, { vectorType });
+	UNIT_CHECK(abi->getFunctionType(functionType) != avxABI.getFunctionType(functionType));
+	UNIT_CHECK(abi->typeInfo().getTypeAllocSize(vectorType) ==
+	           avxABI.typeInfo().getTypeAllocSize(vectorType));
+	UNIT_CHECK(abi->typeInfo().getTypeRequiredAlign(vectorType) ==
+	           avxABI.typeInfo().getTypeRequiredAlign(vectorType));
+}
+
+UNIT_TEST(ABIRegistrySharesLoweringPlans) {
+	ABIRegistry registry;
+	const llvm::Triple triple("x86_64-none-linux-gnu");
+	
+	llvm::LLVMContext firstContext;
+	llvm::Module firstModule("", firstContext);
+	const auto firstABI = registry.createABI(firstModule, triple);
+	
+	llvm::LLVMContext secondContext;
+	llvm::Module secondModule("", secondContext);
+	const auto secondABI = registry.createABI(secondModule, triple);
+	
+	const auto& typeBuilder = firstABI->typeInfo().typeBuilder();
+	const auto structType = typeBuilder.getStructTy({ LongTy, DoubleTy });
+	const FunctionType functionType(CC_CDefault, structType, { structType, IntTy });
+	(void) firstABI->getFunctionType(functionType);
+	
+	// The plan computed for the first module is found by the second.
+	const auto& typeInfo = static_cast<const x86::X86_64ABITypeInfo&>(secondABI->typeInfo());
+	bool isComputed = false;
+	const auto plan = typeInfo.targetData().loweringPlanCache().get(functionType,
+	                                                                 functionType.argumentTypes(),
+	                                                                 typeInfo.cpuFeatures().mask(),
+		[&] {
+			isComputed = true;
+			return secondABI->getLoweringPlan(functionType, functionType.argumentTypes());
+		});
+	UNIT_CHECK(!isComputed);
+	UNIT_CHECK(plan.returnInfo().isDirect());
+	UNIT_CHECK(plan.toString() == secondABI->getLoweringPlan(functionType, functionType.argumentTypes()).toString());
+	
+	// Different CPU features get their own plans.
+	const auto& avxTypeInfo = static_cast<const x86::X86_64ABITypeInfo&>(secondABI->withTargetFeatures("+avx").typeInfo());
+	isComputed = false;
+	(void) avxTypeInfo.targetData().loweringPlanCache().get(functionType,
+	                                                         functionType.argumentTypes(),
+	                                                         avxTypeInfo.cpuFeatures().mask(),
+		[&] {
+			isComputed = true;
+			return secondABI->getLoweringPlan(functionType, functionType.argumentTypes());
+		});
+	UNIT_CHECK(isComputed);
+}
@@ -0,0 +1,93 @@
+#include <vector>
+
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/Attributes.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABIRegistry.hpp>
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/BatchLowering.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/LoweringPlan.hpp>
+#include <llvm-abi/Type.hpp>
+#include <llvm-abi/TypeBuilder.hpp>
+
+#include "UnitTest.hpp"
+
+using namespace llvm_abi;
+
+// Enough function types that every thread gets several chunks.
+static std::vector<FunctionType> getBatchFunctionTypes(const TypeBuilder& typeBuilder) {
+	const Type types[] = {
+		IntTy,
+		CharTy,
+		DoubleTy,
+		LongDoubleTy,
+		PointerTy,
+		typeBuilder.getStructTy({ FloatTy, FloatTy }),
+		typeBuilder.getStructTy({ IntTy, DoubleTy }),
+		typeBuilder.getStructTy({ LongTy, LongTy, LongTy }),
+		typeBuilder.getUnionTy({ FloatTy, IntTy }),
+		typeBuilder.getVectorTy(4, FloatTy),
+		Type::Complex(Float)
+	};
+	const size_t numTypes = sizeof(types) / sizeof(types[0]);
+	
+	std::vector<FunctionType> functionTypes;
+	for (size_t i = 0; i < 1000; i++) {
+		std::vector<Type> argumentTypes;
+		for (size_t j = 0; j < i % 7; j++) {
+			argumentTypes.push_back(types[(i + j * 3) % numTypes]);
+		}
+		const auto returnType = i % 5 == 0 ? VoidTy : types[i % numTypes];
+		const bool isVarArg = i % 4 == 0 && !argumentTypes.empty();
+		functionTypes.push_back(FunctionType(CC_CDefault, returnType,
+		                                     argumentTypes, isVarArg));
+	}
+	return functionTypes;
+}
+
+static void checkBatchMatchesABI(const llvm::Triple& triple) {
+	ABIRegistry registry;
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = registry.createABI(module, triple);
+	const auto planner = registry.createLoweringPlanner(triple);
+	const auto functionTypes = getBatchFunctionTypes(abi->typeInfo().typeBuilder());
+	
+	const unsigned threadCounts[] = { 1, 4, 0 };
+	for (const auto numThreads: threadCounts) {
+		const auto loweredTypes = abi->lowerBatch(functionTypes, numThreads);
+		UNIT_CHECK(loweredTypes.size() == functionTypes.size());
+		
+		const auto plans = getLoweringPlans(*planner, functionTypes, numThreads);
+		UNIT_CHECK(plans.size() == functionTypes.size());
+		
+		for (size_t i = 0; i < functionTypes.size(); i++) {
+			const auto& functionType = functionTypes[i];
+			UNIT_CHECK(loweredTypes[i].functionType == abi->getFunctionType(functionType));
+			UNIT_CHECK(loweredTypes[i].attributes ==
+			           abi->getAttributes(functionType, functionType.argumentTypes()));
+			UNIT_CHECK(getFunctionType(context, abi->typeInfo(), plans[i]) ==
+			           loweredTypes[i].functionType);
+		}
+	}
+}
+
+UNIT_TEST(BatchLoweringMatchesABIX86_64) {
+	checkBatchMatchesABI(llvm::Triple("x86_64-none-linux-gnu"));
+}
+
+UNIT_TEST(BatchLoweringMatchesABIX86_32) {
+	checkBatchMatchesABI(llvm::Triple("i386-none-linux-gnu"));
+}
+
+UNIT_TEST(BatchLoweringEmpty) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const std::vector<FunctionType> functionTypes;
+	UNIT_CHECK(abi->lowerBatch(functionTypes, 4).empty());
+}
@@ -1,3 +1,4 @@
+#include <cassert>
 #include <sstream>
 #include <string>
 
@@ -89,7 +90,7 @@ namespace llvm_abi {
 			case FloatingPointType:
 				switch (type.floatingPointKind()) {
 					case HalfFloat:
-						llvm_unreachable("TODO");
+						return "_Float16";
 					case Float:
 						return "float";
 					case Double:
@@ -103,7 +104,7 @@ namespace llvm_abi {
 			case ComplexType:
 				switch (type.complexKind()) {
 					case HalfFloat:
-						llvm_unreachable("TODO");
+						return "_Float16 _Complex";
 					case Float:
 						return "float _Complex";
 					case Double:
@@ -216,10 +217,55 @@ namespace llvm_abi {
 		return functionId_++;
 	}
 	
+	std::string CCodeGenerator::emitFunctionAttributes(const FunctionType& functionType) {
+		std::string attributes;
+		switch (functionType.callingConvention()) {
+			case CC_CDefault:
+			case CC_CppDefault:
+				break;
+			case CC_CDecl:
+				attributes += "__attribute__((cdecl)) ";
+				break;
+			case CC_StdCall:
+				attributes += "__attribute__((stdcall)) ";
+				break;
+			case CC_FastCall:
+				attributes += "__attribute__((fastcall)) ";
+				break;
+			case CC_ThisCall:
+				attributes += "__attribute__((thiscall)) ";
+				break;
+			case CC_Pascal:
+				attributes += "__attribute__((pascal)) ";
+				break;
+			case CC_VectorCall:
+				attributes += "__attribute__((vectorcall)) ";
+				break;
+			case CC_RegCall:
+				attributes += "__attribute__((regcall)) ";
+				break;
+			case CC_FastInternal:
+				// No C equivalent.
+				break;
+			case CC_Swift:
+				attributes += "__attribute__((swiftcall)) ";
+				break;
+		}
+		
+		if (functionType.hasRegParm()) {
+			attributes += "__attribute__((regparm(";
+			attributes += std::to_string(functionType.regParm());
+			attributes += "))) ";
+		}
+		
+		return attributes;
+	}
+	
 	void CCodeGenerator::emitCalleeFunction(const TestFunctionType& testFunctionType,
 	                                        const size_t functionId) {
 		const auto& functionType = testFunctionType.functionType;
-		sourceCodeStream_ << "Fn" << functionId << "ReturnType callee(";
+		sourceCodeStream_ << "Fn" << functionId << "ReturnType ";
+		sourceCodeStream_ << emitFunctionAttributes(functionType) << "callee(";
 		bool first = true;
 		int argId = 0;
 		for (const auto& argType: functionType.argumentTypes()) {
@@ -247,7 +293,8 @@ namespace llvm_abi {
 	void CCodeGenerator::emitCallerFunction(const TestFunctionType& testFunctionType,
 	                                        const size_t functionId) {
 		const auto& functionType = testFunctionType.functionType;
-		sourceCodeStream_ << "Fn" << functionId << "ReturnType caller(";
+		sourceCodeStream_ << "Fn" << functionId << "ReturnType ";
+		sourceCodeStream_ << emitFunctionAttributes(functionType) << "caller(";
 		bool first = true;
 		int argId = 0;
 		for (const auto& argType: functionType.argumentTypes()) {
@@ -312,4 +359,133 @@ namespace llvm_abi {
 		emitCallerFunction(functionType, functionId);
 	}
 	
+	void CCodeGenerator::emitVAArgCalleeFunction(const TestFunctionType& testFunctionType,
+	                                             const size_t functionId,
+	                                             const bool copyVAList) {
+		const auto& functionType = testFunctionType.functionType;
+		sourceCodeStream_ << "Fn" << functionId << "ReturnType ";
+		sourceCodeStream_ << emitFunctionAttributes(functionType) << "callee(";
+		bool first = true;
+		int argId = 0;
+		for (const auto& argType: functionType.argumentTypes()) {
+			(void) argType;
+			if (first) {
+				first = false;
+			} else {
+				sourceCodeStream_ << ", ";
+			}
+			sourceCodeStream_ << "Fn" << functionId << "ArgType" << argId << " arg" << argId;
+			argId++;
+		}
+		
+		int varArgId = 0;
+		for (const auto& varArgType: testFunctionType.varArgsTypes) {
+			(void) varArgType;
+			sourceCodeStream_ << ", ";
+			sourceCodeStream_ << "Fn" << functionId << "VarArgType" << varArgId << " varArg" << varArgId;
+			varArgId++;
+		}
+		
+		if (copyVAList) {
+			sourceCodeStream_ << ", va_list vaCopy";
+		}
+		sourceCodeStream_ << ");" << std::endl << std::endl;
+	}
+	
+	void CCodeGenerator::emitVAArgCallerFunction(const TestFunctionType& testFunctionType,
+	                                             const size_t functionId,
+	                                             const bool copyVAList) {
+		const auto& functionType = testFunctionType.functionType;
+		assert(functionType.isVarArg() && !functionType.argumentTypes().empty());
+		
+		sourceCodeStream_ << "Fn" << functionId << "ReturnType ";
+		sourceCodeStream_ << emitFunctionAttributes(functionType) << "caller(";
+		int argId = 0;
+		for (const auto& argType: functionType.argumentTypes()) {
+			(void) argType;
+			sourceCodeStream_ << "Fn" << functionId << "ArgType" << argId << " arg" << argId;
+			sourceCodeStream_ << ", ";
+			argId++;
+		}
+		sourceCodeStream_ << "...) {" << std::endl;
+		
+		sourceCodeStream_ << "    va_list va;" << std::endl;
+		sourceCodeStream_ << "    va_start(va, arg" << (argId - 1) << ");" << std::endl;
+		
+		if (copyVAList) {
+			sourceCodeStream_ << "    va_list vaCopy;" << std::endl;
+			sourceCodeStream_ << "    va_copy(vaCopy, va);" << std::endl;
+		}
+		
+		int varArgId = 0;
+		for (const auto& varArgType: testFunctionType.varArgsTypes) {
+			(void) varArgType;
+			sourceCodeStream_ << "    Fn" << functionId << "VarArgType" << varArgId;
+			sourceCodeStream_ << " varArg" << varArgId << " = va_arg(va, ";
+			sourceCodeStream_ << "Fn" << functionId << "VarArgType" << varArgId << ");" << std::endl;
+			varArgId++;
+		}
+		
+		if (!copyVAList) {
+			sourceCodeStream_ << "    va_end(va);" << std::endl;
+		}
+		
+		const bool hasResult = functionType.returnType() != VoidTy;
+		if (hasResult && !copyVAList) {
+			sourceCodeStream_ << "    return ";
+		} else if (hasResult) {
+			sourceCodeStream_ << "    Fn" << functionId << "ReturnType result = ";
+		} else {
+			sourceCodeStream_ << "    ";
+		}
+		
+		sourceCodeStream_ << "callee(";
+		bool first = true;
+		argId = 0;
+		for (const auto& argType: functionType.argumentTypes()) {
+			(void) argType;
+			if (first) {
+				first = false;
+			} else {
+				sourceCodeStream_ << ", ";
+			}
+			sourceCodeStream_ << "arg" << argId;
+			argId++;
+		}
+		
+		varArgId = 0;
+		for (const auto& varArgType: testFunctionType.varArgsTypes) {
+			(void) varArgType;
+			sourceCodeStream_ << ", ";
+			sourceCodeStream_ << "varArg" << varArgId;
+			varArgId++;
+		}
+		
+		if (copyVAList) {
+			sourceCodeStream_ << ", vaCopy";
+		}
+		
+		sourceCodeStream_ << ");" << std::endl;
+		
+		if (copyVAList) {
+			// The callee reads the copy, so it can only be ended
+			// after the call.
+			sourceCodeStream_ << "    va_end(vaCopy);" << std::endl;
+			sourceCodeStream_ << "    va_end(va);" << std::endl;
+			if (hasResult) {
+				sourceCodeStream_ << "    return result;" << std::endl;
+			}
+		}
+		
+		sourceCodeStream_ << "}" << std::endl;
+	}
+	
+	void CCodeGenerator::emitVAArgCalleeAndCallerFunctions(const TestFunctionType& functionType,
+	                                                       const bool copyVAList) {
+		sourceCodeStream_ << "#include <stdarg.h>" << std::endl << std::endl;
+		const auto functionId = emitFunctionTypes(functionType);
+		emitVAArgCalleeFunction(functionType, functionId, copyVAList);
+		emitVAArgCallerFunction(functionType, functionId, copyVAList);
+	}
+	
 }
@@ -7,6 +7,7 @@
 namespace llvm_abi {
 	
 	class ABITypeInfo;
+	class FunctionType;
 	struct TestFunctionType;
 	class Type;
 	
@@ -28,6 +29,8 @@ namespace llvm_abi {
 		
 		size_t emitFunctionTypes(const TestFunctionType& testFunctionType);
 		
+		std::string emitFunctionAttributes(const FunctionType& functionType);
+		
 		void emitCalleeFunction(const TestFunctionType& testFunctionType,
 		                        size_t functionId);
 		
@@ -36,6 +39,23 @@ namespace llvm_abi {
 		
 		void emitCalleeAndCallerFunctions(const TestFunctionType& functionType);
 		
+		void emitVAArgCalleeFunction(const TestFunctionType& testFunctionType,
+		                             size_t functionId, bool copyVAList);
+		
+		void emitVAArgCallerFunction(const TestFunctionType& testFunctionType,
+		                             size_t functionId, bool copyVAList);
+		
+		/**
+		 * \brief Emit functions for a 'va_arg' test.
+		 * 
+		 * The caller is variadic and reads its variadic arguments
+		 * with 'va_arg', passing them to a non-variadic callee. If
+		 * requested, it also passes a copy (made with 'va_copy') of
+		 * its va_list.
+		 */
+		void emitVAArgCalleeAndCallerFunctions(const TestFunctionType& functionType,
+		                                       bool copyVAList);
+		
 	private:
 		std::ostringstream sourceCodeStream_;
 		const ABITypeInfo& typeInfo_;
@@ -0,0 +1,94 @@
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABIRegistry.hpp>
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/Type.hpp>
+#include <llvm-abi/TypeBuilder.hpp>
+
+#include <llvm-abi/x86/CPUFeatures.hpp>
+#include <llvm-abi/x86/CPUKind.hpp>
+
+#include "UnitTest.hpp"
+
+using namespace llvm_abi;
+
+UNIT_TEST(CPUKindAcceptsHostCPUNames) {
+	const llvm::Triple triple("x86_64-none-linux-gnu");
+	UNIT_CHECK(x86::getCPUKind(triple, "skylake-avx512") == x86::CK_Skylake);
+	
+	// Unknown names are only accepted from the host.
+	UNIT_CHECK_THROWS(x86::getCPUKind(triple, "generic"));
+	UNIT_CHECK_THROWS(x86::getCPUKind(triple, "not-a-cpu"));
+	UNIT_CHECK(x86::getCPUKind(triple, "native") != x86::CK_Generic);
+	
+	const llvm::Triple triple32("i386-none-linux-gnu");
+	UNIT_CHECK(x86::getCPUKind(triple32, "native") != x86::CK_Generic);
+}
+
+UNIT_TEST(CPUNativeCreatesABI) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	UNIT_CHECK(createABI(module, llvm::Triple("x86_64-none-linux-gnu"), "native") != nullptr);
+	UNIT_CHECK(createABI(module, llvm::Triple("i386-none-linux-gnu"), "native") != nullptr);
+	
+	ABIRegistry registry;
+	UNIT_CHECK(registry.createABI(module, llvm::Triple("x86_64-none-linux-gnu"), "native") != nullptr);
+}
+
+UNIT_TEST(CPUFeaturesRemoveDependents) {
+	auto features = x86::getCPUFeatures(llvm::Triple("x86_64-none-linux-gnu"),
+	                                    x86::CK_Haswell);
+	UNIT_CHECK(features.has(x86::FeatureAVX2));
+	UNIT_CHECK(features.has(x86::FeatureFMA));
+	
+	features.remove(x86::FeatureAVX);
+	UNIT_CHECK(!features.has(x86::FeatureAVX));
+	UNIT_CHECK(!features.has(x86::FeatureAVX2));
+	UNIT_CHECK(!features.has(x86::FeatureFMA));
+	UNIT_CHECK(!features.hasAVX());
+	
+	// Features that AVX depends on are kept.
+	UNIT_CHECK(features.has(x86::FeatureSSE42));
+	UNIT_CHECK(features.sseLevel() == x86::SSE42);
+}
+
+UNIT_TEST(CPUTargetFeaturesApply) {
+	const auto baseFeatures = x86::getCPUFeatures(llvm::Triple("x86_64-none-linux-gnu"),
+	                                              x86::CK_x86_64);
+	UNIT_CHECK(!baseFeatures.hasAVX());
+	
+	const auto avxFeatures = x86::applyTargetFeatures(baseFeatures, "+avx, +unknown");
+	UNIT_CHECK(avxFeatures.hasAVX());
+	UNIT_CHECK(avxFeatures.has(x86::FeatureSSE2));
+	
+	const auto noAVXFeatures = x86::applyTargetFeatures(avxFeatures, "+avx2,-avx");
+	UNIT_CHECK(noAVXFeatures == baseFeatures);
+}
+
+UNIT_TEST(CPUFunctionTargetFeatures) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const auto vectorType = abi->typeInfo().typeBuilder().getVectorTy(8, FloatTy);
+	const FunctionType functionType(CC_CDefault, VoidTy, { vectorType });
+	
+	// Without AVX the vector is passed in memory.
+	const auto function = createABIFunction(*abi, module, functionType, "function");
+	UNIT_CHECK(&getFunctionABI(*abi, *function) == abi.get());
+	UNIT_CHECK(function->getFunctionType()->getParamType(0)->isPointerTy());
+	
+	function->addFnAttr("target-features", "+avx");
+	const auto& avxABI = getFunctionABI(*abi, *function);
+	UNIT_CHECK(&avxABI == &(abi->withTargetFeatures("+avx")));
+	UNIT_CHECK(avxABI.getFunctionType(functionType)->getParamType(0)->isVectorTy());
+	
+	// Removing AVX again gives the baseline lowering.
+	const auto& noAVXABI = avxABI.withTargetFeatures("-avx");
+	UNIT_CHECK(noAVXABI.getFunctionType(functionType)->getParamType(0)->isPointerTy());
+}
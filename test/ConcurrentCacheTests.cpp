@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABIRegistry.hpp>
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/ConcurrentCache.hpp>
+#include <llvm-abi/LoweringPlan.hpp>
+#include <llvm-abi/Type.hpp>
+#include <llvm-abi/TypeBuilder.hpp>
+
+#include "UnitTest.hpp"
+
+using namespace llvm_abi;
+
+// These tests are most useful when built with LLVMABI_ENABLE_TSAN.
+static const size_t NumThreads = 8;
+
+static size_t getExpectedValue(const size_t key) {
+	return key * 3 + 1;
+}
+
+// Computes the value via a smaller key, as layout queries do for
+// aggregate members.
+static size_t computeValue(ConcurrentCache<size_t, size_t>& cache,
+                           const size_t key) {
+	if (key == 0) {
+		return getExpectedValue(0);
+	}
+	
+	const auto memberKey = key / 2;
+	const auto memberValue = cache.get(memberKey, [&] {
+		return computeValue(cache, memberKey);
+	});
+	return memberValue - getExpectedValue(memberKey) + getExpectedValue(key);
+}
+
+UNIT_TEST(ConcurrentCacheComputesOnce) {
+	ConcurrentCache<size_t, size_t> cache;
+	size_t numComputed = 0;
+	
+	// Pending entries are looked up repeatedly before they're published.
+	for (size_t round = 0; round < 4; round++) {
+		for (size_t key = 0; key < 1000; key++) {
+			const auto value = cache.get(key, [&] {
+				numComputed++;
+				return getExpectedValue(key);
+			});
+			UNIT_CHECK(value == getExpectedValue(key));
+		}
+	}
+	
+	UNIT_CHECK(numComputed == 1000);
+}
+
+UNIT_TEST(ConcurrentCacheStress) {
+	const size_t numKeys = 4096;
+	ConcurrentCache<size_t, size_t> cache;
+	std::atomic<size_t> numWrong(0);
+	
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < NumThreads; i++) {
+		threads.push_back(std::thread([&cache, &numWrong, i] {
+			// Each thread queries the keys in a different order, so
+			// they race to compute and publish them.
+			std::vector<size_t> keys;
+			for (size_t key = 0; key < numKeys; key++) {
+				keys.push_back(key);
+			}
+			std::mt19937 generator(i);
+			std::shuffle(keys.begin(), keys.end(), generator);
+			
+			for (size_t round = 0; round < 4; round++) {
+				for (const auto key: keys) {
+					const auto value = cache.get(key, [&] {
+						return computeValue(cache, key);
+					});
+					if (value != getExpectedValue(key)) {
+						numWrong++;
+					}
+				}
+			}
+		}));
+	}
+	
+	for (auto& thread: threads) {
+		thread.join();
+	}
+	
+	UNIT_CHECK(numWrong == 0);
+}
+
+UNIT_TEST(ConcurrentCachePublishesWarmEntries) {
+	// Fewer entries than MinPublishSize are still published once
+	// they're looked up again.
+	ConcurrentCache<size_t, size_t> cache;
+	const size_t numKeys = 4;
+	for (size_t key = 0; key < numKeys; key++) {
+		(void) cache.get(key, [&] { return getExpectedValue(key); });
+		UNIT_CHECK(!cache.isPublished(key));
+	}
+	
+	for (size_t key = 0; key < numKeys; key++) {
+		UNIT_CHECK(cache.get(key, [&] { return getExpectedValue(key); }) ==
+		           getExpectedValue(key));
+		UNIT_CHECK(cache.isPublished(key));
+	}
+}
+
+UNIT_TEST(ConcurrentCacheStressPublishesWarmEntries) {
+	const size_t numKeys = 4096;
+	ConcurrentCache<size_t, size_t> cache;
+	std::atomic<size_t> numWrong(0);
+	std::atomic<size_t> numUnpublished(0);
+	
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < NumThreads; i++) {
+		threads.push_back(std::thread([&cache, &numWrong, &numUnpublished, i] {
+			std::vector<size_t> keys;
+			for (size_t key = 0; key < numKeys; key++) {
+				keys.push_back(key);
+			}
+			std::mt19937 generator(i);
+			std::shuffle(keys.begin(), keys.end(), generator);
+			
+			// Once a thread has looked up a key twice, lookups
+			// of it don't take the lock.
+			for (size_t round = 0; round < 2; round++) {
+				for (const auto key: keys) {
+					const auto value = cache.get(key, [&] {
+						return computeValue(cache, key);
+					});
+					if (value != getExpectedValue(key)) {
+						numWrong++;
+					}
+					if (round == 1 && !cache.isPublished(key)) {
+						numUnpublished++;
+					}
+				}
+			}
+		}));
+	}
+	
+	for (auto& thread: threads) {
+		thread.join();
+	}
+	
+	UNIT_CHECK(numWrong == 0);
+	UNIT_CHECK(numUnpublished == 0);
+	for (size_t key = 0; key < numKeys; key++) {
+		UNIT_CHECK(cache.isPublished(key));
+	}
+}
+
+static Type createStructType(const TypeBuilder& typeBuilder, const size_t index) {
+	const Type memberTypes[] = { CharTy, ShortTy, IntTy, DoubleTy, LongDoubleTy };
+	llvm::SmallVector<Type, 8> structMembers;
+	for (size_t i = 0; i <= index % 6; i++) {
+		structMembers.push_back(memberTypes[(index + i) % 5]);
+	}
+	if (index % 3 == 0) {
+		structMembers.push_back(typeBuilder.getArrayTy(index % 7 + 1, IntTy));
+	}
+	return typeBuilder.getStructTy(structMembers);
+}
+
+UNIT_TEST(ConcurrentCacheSharedLayouts) {
+	const size_t numTypes = 512;
+	const llvm::Triple triple("x86_64-none-linux-gnu");
+	ABIRegistry registry;
+	
+	// Compute the expected layouts without sharing.
+	const auto expectedPlanner = createLoweringPlanner(triple);
+	const auto& expectedTypeInfo = expectedPlanner->typeInfo();
+	std::vector<DataSize> expectedSizes;
+	std::vector<DataSize> expectedAligns;
+	for (size_t i = 0; i < numTypes; i++) {
+		const auto type = createStructType(expectedTypeInfo.typeBuilder(), i);
+		expectedSizes.push_back(expectedTypeInfo.getTypeAllocSize(type));
+		expectedAligns.push_back(expectedTypeInfo.getTypeRequiredAlign(type));
+	}
+	
+	std::atomic<size_t> numWrong(0);
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < NumThreads; i++) {
+		threads.push_back(std::thread([&, i] {
+			// Each thread has its own module and visits the types in
+			// a different order, but they all intern types into and
+			// query the same target data.
+			llvm::LLVMContext context;
+			llvm::Module module("", context);
+			const auto abi = registry.createABI(module, triple);
+			const auto& typeInfo = abi->typeInfo();
+			
+			for (size_t j = 0; j < numTypes; j++) {
+				const auto index = (j * (2 * i + 1)) % numTypes;
+				const auto type = createStructType(typeInfo.typeBuilder(), index);
+				if (typeInfo.getTypeAllocSize(type) != expectedSizes[index] ||
+				    typeInfo.getTypeRequiredAlign(type) != expectedAligns[index] ||
+				    typeInfo.getLLVMType(type) == nullptr) {
+					numWrong++;
+				}
+			}
+		}));
+	}
+	
+	for (auto& thread: threads) {
+		thread.join();
+	}
+	
+	UNIT_CHECK(numWrong == 0);
+}
@@ -0,0 +1,198 @@
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/Type.hpp>
+#include <llvm-abi/TypeBuilder.hpp>
+
+#include "UnitTest.hpp"
+
+using namespace llvm_abi;
+
+typedef std::vector<std::pair<size_t, llvm::Value*>> ConstructedArguments;
+
+// Emits a call where each constructed argument is passed to a
+// 'construct' function (standing in for a copy constructor).
+static llvm::CallInst*
+emitConstructingCall(const ABI& abi, llvm::Function& caller, llvm::Function& callee,
+                     const FunctionType& functionType,
+                     llvm::ArrayRef<TypedValue> arguments,
+                     ConstructedArguments& constructedArguments) {
+	auto& module = *(caller.getParent());
+	auto& context = module.getContext();
+	llvm::Type* const constructArgumentTypes[] = { llvm::Type::getInt8PtrTy(context) };
+	const auto constructFunction =
+		llvm::Function::Create(llvm::FunctionType::get(llvm::Type::getVoidTy(context),
+		                                               constructArgumentTypes, false),
+		                       llvm::Function::ExternalLinkage, "construct", &module);
+		
+	UnitTestBuilder builder(caller);
+	llvm::CallInst* callInst = nullptr;
+	abi.createConstructingCall(builder, functionType,
+		[&](const size_t index, llvm::Value* const address) {
+			constructedArguments.push_back(std::make_pair(index, address));
+			auto& irBuilder = builder.getBuilder();
+			irBuilder.CreateCall(constructFunction,
+			                     irBuilder.CreateBitCast(address, irBuilder.getInt8PtrTy()));
+		},
+		[&](llvm::ArrayRef<llvm::Value*> values) -> llvm::Value* {
+			callInst = builder.getBuilder().CreateCall(&callee, values);
+			callInst->setCallingConv(callee.getCallingConv());
+			callInst->setAttributes(callee.getAttributes());
+			return callInst;
+		}, arguments, nullptr);
+	builder.getBuilder().CreateRetVoid();
+	return callInst;
+}
+
+// Returns the position of the instruction in its basic block.
+static size_t getPosition(const llvm::Instruction& instruction) {
+	size_t position = 0;
+	for (const auto& other: *(instruction.getParent())) {
+		if (&other == &instruction) {
+			return position;
+		}
+		position++;
+	}
+	throw std::runtime_error("Instruction isn't in its basic block.");
+}
+
+UNIT_TEST(ConstructingCallUsesInallocaSlots) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("i686-pc-windows-msvc"));
+	const auto& typeInfo = abi->typeInfo();
+	
+	// Non-trivial arguments are passed in an inalloca block.
+	const auto classType = typeInfo.typeBuilder().getNonTrivialStructTy({ IntTy });
+	const FunctionType functionType(CC_CDefault, VoidTy, { classType, IntTy, classType });
+	const auto caller = createABIFunction(*abi, module, functionType, "caller");
+	const auto callee = createABIFunction(*abi, module, functionType, "callee");
+	
+	const auto intValue = llvm::ConstantInt::get(typeInfo.getLLVMType(IntTy), 7);
+	const TypedValue arguments[] = {
+		TypedValue(nullptr, classType),
+		TypedValue(intValue, IntTy),
+		TypedValue(nullptr, classType)
+	};
+	ConstructedArguments constructedArguments;
+	const auto callInst = emitConstructingCall(*abi, *caller, *callee, functionType,
+	                                           arguments, constructedArguments);
+	UNIT_CHECK(callInst != nullptr);
+	
+	// Each argument is constructed in its slot, after the block is
+	// allocated and before the call.
+	UNIT_CHECK(constructedArguments.size() == 2);
+	UNIT_CHECK(constructedArguments[0].first == 0);
+	UNIT_CHECK(constructedArguments[1].first == 2);
+	
+	const auto argMemory = llvm::cast<llvm::AllocaInst>(callInst->getArgOperand(0));
+	UNIT_CHECK(argMemory->isUsedWithInAlloca());
+	for (const auto& constructedArgument: constructedArguments) {
+		const auto address = llvm::cast<llvm::GetElementPtrInst>(constructedArgument.second);
+		UNIT_CHECK(address->getPointerOperand() == argMemory);
+		UNIT_CHECK(address->getType() == typeInfo.getLLVMType(classType)->getPointerTo());
+		UNIT_CHECK(getPosition(*argMemory) < getPosition(*address));
+		UNIT_CHECK(getPosition(*address) < getPosition(*callInst));
+	}
+	
+	// Only the integer is stored, and nothing is copied.
+	UNIT_CHECK(countInstructions<llvm::StoreInst>(*caller) == 1);
+	UNIT_CHECK(countInstructions<llvm::MemCpyInst>(*caller) == 0);
+	checkModule(module);
+}
+
+UNIT_TEST(ConstructingCallUsesIndirectTemporaries) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeInfo = abi->typeInfo();
+	
+	// Non-trivial arguments are passed by reference.
+	const auto classType = typeInfo.typeBuilder().getNonTrivialStructTy({ IntTy });
+	const FunctionType functionType(CC_CDefault, VoidTy, { classType });
+	const auto caller = createABIFunction(*abi, module, functionType, "caller");
+	const auto callee = createABIFunction(*abi, module, functionType, "callee");
+	
+	const TypedValue arguments[] = { TypedValue(nullptr, classType) };
+	ConstructedArguments constructedArguments;
+	const auto callInst = emitConstructingCall(*abi, *caller, *callee, functionType,
+	                                           arguments, constructedArguments);
+	
+	UNIT_CHECK(constructedArguments.size() == 1);
+	UNIT_CHECK(constructedArguments[0].first == 0);
+	UNIT_CHECK(llvm::isa<llvm::AllocaInst>(constructedArguments[0].second));
+	UNIT_CHECK(callInst->getArgOperand(0) == constructedArguments[0].second);
+	UNIT_CHECK(countInstructions<llvm::StoreInst>(*caller) == 0);
+	checkModule(module);
+}
+
+UNIT_TEST(ConstructingCallRequiredForInMemoryObject) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("i686-pc-windows-msvc"));
+	const auto& typeInfo = abi->typeInfo();
+	
+	const auto classType = typeInfo.typeBuilder().getNonTrivialStructTy({ IntTy });
+	const FunctionType functionType(CC_CDefault, VoidTy, { classType });
+	const auto caller = createABIFunction(*abi, module, functionType, "caller");
+	const auto callee = createABIFunction(*abi, module, functionType, "callee");
+	
+	// An object in memory can't be copied into the inalloca block
+	// without its copy constructor.
+	UnitTestBuilder builder(*caller);
+	const auto object = builder.getEntryBuilder().CreateAlloca(typeInfo.getLLVMType(classType));
+	UNIT_CHECK_THROWS(abi->createInMemoryCall(builder, functionType,
+		[&](llvm::ArrayRef<llvm::Value*> values) -> llvm::Value* {
+			return builder.getBuilder().CreateCall(callee, values);
+		}, { TypedValue(object, classType) }, nullptr));
+}
+
+#if LLVMABI_LLVM_VERSION >= 309
+UNIT_TEST(ConstructingCallStoresReturnValueInPlace) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeInfo = abi->typeInfo();
+	
+	// A swiftcc struct returned in several registers.
+	const auto structType = typeInfo.typeBuilder().getStructTy({ LongTy, LongTy, LongTy });
+	const FunctionType functionType(CC_Swift, structType, {});
+	const auto caller = createABIFunction(*abi, module, FunctionType(CC_CDefault, VoidTy, {}), "caller");
+	const auto callee = createABIFunction(*abi, module, functionType, "callee");
+	
+	UnitTestBuilder builder(*caller);
+	const auto returnValuePtr = builder.getEntryBuilder().CreateAlloca(typeInfo.getLLVMType(structType));
+	const auto returnValue = abi->createConstructingCall(builder, functionType, nullptr,
+		[&](llvm::ArrayRef<llvm::Value*> values) -> llvm::Value* {
+			const auto callInst = builder.getBuilder().CreateCall(callee, values);
+			callInst->setCallingConv(callee->getCallingConv());
+			return callInst;
+		}, {}, returnValuePtr);
+	builder.getBuilder().CreateRetVoid();
+	UNIT_CHECK(returnValue == returnValuePtr);
+	
+	// Each register is stored straight into the return value,
+	// without a temporary.
+	UNIT_CHECK(countInstructions<llvm::AllocaInst>(*caller) == 1);
+	UNIT_CHECK(countInstructions<llvm::StoreInst>(*caller) == 3);
+	for (const auto& instruction: caller->getEntryBlock()) {
+		if (const auto storeInst = llvm::dyn_cast<llvm::StoreInst>(&instruction)) {
+			const auto address = llvm::cast<llvm::GetElementPtrInst>(storeInst->getPointerOperand());
+			UNIT_CHECK(address->getPointerOperand()->stripPointerCasts() == returnValuePtr);
+		}
+	}
+	checkModule(module);
+}
+#endif
@@ -0,0 +1,164 @@
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/Type.hpp>
+#include <llvm-abi/TypeBuilder.hpp>
+
+#include <llvm-abi/x86/FunctionDispatcher.hpp>
+
+#include "UnitTest.hpp"
+
+using namespace llvm_abi;
+
+static llvm::Function* createVersion(const ABI& abi, llvm::Module& module,
+                                     const FunctionType& functionType,
+                                     const std::string& targetFeatures,
+                                     const std::string& name) {
+	const auto& versionABI = abi.withTargetFeatures(targetFeatures);
+	const auto function = createABIFunction(versionABI, module, functionType, name);
+	if (!targetFeatures.empty()) {
+		function->addFnAttr("target-features", targetFeatures);
+	}
+	return function;
+}
+
+// Returns the feature mask the resolver checks for the first version.
+static uint64_t getFirstVersionMask(const llvm::Function& resolver) {
+	for (const auto& basicBlock: resolver) {
+		for (const auto& instruction: basicBlock) {
+			if (instruction.getOpcode() != llvm::Instruction::And) {
+				continue;
+			}
+			const auto mask = llvm::cast<llvm::ConstantInt>(instruction.getOperand(1));
+			return mask->getZExtValue();
+		}
+	}
+	throw std::runtime_error("Resolver has no feature check.");
+}
+
+static std::string getTargetFeatures(const llvm::Function& function) {
+	const auto attribute = function.getAttributes().getAttribute(llvm::AttributeSet::FunctionIndex,
+	                                                             "target-features");
+	return attribute.isStringAttribute() ? attribute.getValueAsString().str() : "";
+}
+
+UNIT_TEST(FunctionDispatcherCallsVersionsDirectly) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	
+	// Integers are lowered the same way for every feature set.
+	const FunctionType functionType(CC_CDefault, IntTy, { IntTy });
+	const x86::FunctionVersion versions[] = {
+		x86::FunctionVersion("+avx2", createVersion(*abi, module, functionType,
+		                                            "+avx2", "function.avx2")),
+		x86::FunctionVersion("", createVersion(*abi, module, functionType,
+		                                       "", "function.default"))
+	};
+	
+	const auto dispatcher = x86::createFunctionDispatcher(*abi, module, functionType,
+	                                                      "function", versions);
+	UNIT_CHECK(dispatcher->getFunctionType() == abi->getFunctionType(functionType));
+	UNIT_CHECK(module.getFunction("function.0.bridge") == nullptr);
+	UNIT_CHECK(module.getFunction("function.1.bridge") == nullptr);
+	UNIT_CHECK(module.getNamedGlobal("function.table") != nullptr);
+	
+	const auto resolver = module.getFunction("function.resolver");
+	UNIT_CHECK(resolver != nullptr);
+	UNIT_CHECK(getFirstVersionMask(*resolver) == (1 << 10));
+	checkModule(module);
+}
+
+UNIT_TEST(FunctionDispatcherBridgesVectorToAVX) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const auto vectorType = abi->typeInfo().typeBuilder().getVectorTy(8, FloatTy);
+	const FunctionType functionType(CC_CDefault, vectorType, { vectorType });
+	
+	const auto avxFunction = createVersion(*abi, module, functionType,
+	                                       "+avx", "function.avx");
+	const auto defaultFunction = createVersion(*abi, module, functionType,
+	                                           "", "function.default");
+	UNIT_CHECK(avxFunction->getFunctionType()->getParamType(0)->isVectorTy());
+	UNIT_CHECK(defaultFunction->getFunctionType()->getParamType(0)->isPointerTy());
+	
+	const x86::FunctionVersion versions[] = {
+		x86::FunctionVersion("+avx", avxFunction),
+		x86::FunctionVersion("", defaultFunction)
+	};
+	const auto dispatcher = x86::createFunctionDispatcher(*abi, module, functionType,
+	                                                      "function", versions);
+	UNIT_CHECK(dispatcher->getFunctionType() == defaultFunction->getFunctionType());
+	
+	// The AVX version passes the vector in a YMM register, so it's
+	// called via a bridge that is compiled with AVX.
+	const auto bridge = module.getFunction("function.0.bridge");
+	UNIT_CHECK(bridge != nullptr);
+	UNIT_CHECK(bridge->getFunctionType() == dispatcher->getFunctionType());
+	UNIT_CHECK(getTargetFeatures(*bridge) == "+avx");
+	
+	size_t numCalls = 0;
+	for (const auto& basicBlock: *bridge) {
+		for (const auto& instruction: basicBlock) {
+			const auto callInst = llvm::dyn_cast<llvm::CallInst>(&instruction);
+			if (callInst == nullptr || callInst->getCalledFunction() != avxFunction) {
+				continue;
+			}
+			UNIT_CHECK(callInst->getArgOperand(0)->getType()->isVectorTy());
+			numCalls++;
+		}
+	}
+	UNIT_CHECK(numCalls == 1);
+	
+	UNIT_CHECK(module.getFunction("function.1.bridge") == nullptr);
+	UNIT_CHECK(getFirstVersionMask(*module.getFunction("function.resolver")) == (1 << 9));
+	checkModule(module);
+}
+
+UNIT_TEST(FunctionDispatcherChecksImpliedFeatures) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const FunctionType functionType(CC_CDefault, VoidTy, {});
+	const auto defaultFunction = createVersion(*abi, module, functionType,
+	                                           "", "function.default");
+	
+	// As Clang generates for -march=haswell; only the features that
+	// '__cpu_model' reports are checked.
+	const std::string haswellFeatures = "+avx,+avx2,+bmi,+bmi2,+cx16,+cx8,+f16c,+fma,"
+	                                    "+fxsr,+lzcnt,+mmx,+movbe,+pclmul,+popcnt,+sahf,"
+	                                    "+sse,+sse2,+sse3,+sse4.1,+sse4.2,+ssse3,+x87,+xsave";
+	const x86::FunctionVersion versions[] = {
+		x86::FunctionVersion(haswellFeatures,
+		                     createVersion(*abi, module, functionType,
+		                                   haswellFeatures, "function.haswell")),
+		x86::FunctionVersion("", defaultFunction)
+	};
+	x86::createFunctionDispatcher(*abi, module, functionType, "function", versions);
+	
+	const uint64_t expectedMask = (1 << 1) | (1 << 2) | (1 << 3) | (1 << 4) |
+	                              (1 << 5) | (1 << 6) | (1 << 7) | (1 << 8) |
+	                              (1 << 9) | (1 << 10) | (1 << 14) | (1 << 16) |
+	                              (1 << 17) | (1 << 19);
+	UNIT_CHECK(getFirstVersionMask(*module.getFunction("function.resolver")) == expectedMask);
+	checkModule(module);
+	
+	// F16C can only be assumed along with AVX2.
+	const x86::FunctionVersion f16cVersions[] = {
+		x86::FunctionVersion("+avx,+f16c",
+		                     createVersion(*abi, module, functionType,
+		                                   "+avx,+f16c", "function.f16c")),
+		x86::FunctionVersion("", defaultFunction)
+	};
+	UNIT_CHECK_THROWS(x86::createFunctionDispatcher(*abi, module, functionType,
+	                                                "function.f16c", f16cVersions));
+}
@@ -0,0 +1,289 @@
+#include <iterator>
+#include <vector>
+
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/FunctionEncoder.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/Type.hpp>
+#include <llvm-abi/TypeBuilder.hpp>
+
+#include "UnitTest.hpp"
+
+using namespace llvm_abi;
+
+static std::vector<llvm::Value*> getArguments(llvm::Function& function) {
+	std::vector<llvm::Value*> arguments;
+	for (auto it = function.arg_begin(); it != function.arg_end(); ++it) {
+		arguments.push_back(&*it);
+	}
+	return arguments;
+}
+
+UNIT_TEST(FunctionEncoderDecodesArgumentsOnUse) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeBuilder = abi->typeInfo().typeBuilder();
+	
+	// Coerced to <2 x double>, so decoding it needs a temporary.
+	const auto structType = typeBuilder.getStructTy({ FloatTy, FloatTy, FloatTy, FloatTy });
+	const FunctionType functionType(CC_CDefault, VoidTy, { IntTy, structType });
+	
+	const auto function = createABIFunction(*abi, module, functionType, "function");
+	UnitTestBuilder builder(*function);
+	const auto encoder = abi->createFunctionEncoder(builder, functionType,
+	                                                getArguments(*function));
+	
+	// Nothing is emitted for arguments that haven't been requested.
+	UNIT_CHECK(function->getEntryBlock().empty());
+	
+	UNIT_CHECK(encoder->argument(0) == &*(function->arg_begin()));
+	UNIT_CHECK(function->getEntryBlock().empty());
+	
+	const auto argument = encoder->argument(1);
+	UNIT_CHECK(argument->getType() == abi->typeInfo().getLLVMType(structType));
+	UNIT_CHECK(countInstructions<llvm::AllocaInst>(*function) == 1);
+	
+	// Decoded arguments are reused.
+	UNIT_CHECK(encoder->argument(1) == argument);
+	UNIT_CHECK(countInstructions<llvm::AllocaInst>(*function) == 1);
+	
+	builder.getBuilder().CreateRetVoid();
+	checkModule(module);
+}
+
+UNIT_TEST(FunctionEncoderLoadsArgumentFromPointer) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeBuilder = abi->typeInfo().typeBuilder();
+	
+	// Passed in memory, with 'byval'.
+	const auto structType = typeBuilder.getStructTy({ LongTy, LongTy, LongTy });
+	const FunctionType functionType(CC_CDefault, VoidTy, { structType });
+	
+	const auto function = createABIFunction(*abi, module, functionType, "function");
+	UnitTestBuilder builder(*function);
+	const auto encoder = abi->createFunctionEncoder(builder, functionType,
+	                                                getArguments(*function));
+	
+	const auto pointer = encoder->argumentPointer(0);
+	UNIT_CHECK(pointer == &*(function->arg_begin()));
+	
+	// The value is loaded from the 'byval' pointer.
+	const auto argument = encoder->argument(0);
+	UNIT_CHECK(llvm::isa<llvm::LoadInst>(argument));
+	UNIT_CHECK(llvm::cast<llvm::LoadInst>(argument)->getPointerOperand() == pointer);
+	UNIT_CHECK(encoder->argumentPointer(0) == pointer);
+	UNIT_CHECK(countInstructions<llvm::LoadInst>(*function) == 1);
+	UNIT_CHECK(countInstructions<llvm::AllocaInst>(*function) == 0);
+	
+	builder.getBuilder().CreateRetVoid();
+	checkModule(module);
+}
+
+UNIT_TEST(FunctionEncoderSharesArgumentMemory) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeBuilder = abi->typeInfo().typeBuilder();
+	
+	// Coerced to <2 x float> and double, so decoding it needs a
+	// temporary.
+	const auto structType = typeBuilder.getStructTy({ FloatTy, FloatTy, DoubleTy });
+	const FunctionType functionType(CC_CDefault, VoidTy, { structType });
+	
+	const auto function = createABIFunction(*abi, module, functionType, "function");
+	UnitTestBuilder builder(*function);
+	const auto encoder = abi->createFunctionEncoder(builder, functionType,
+	                                                getArguments(*function));
+	
+	// Requesting the value first still decodes into memory that's
+	// then reused for the pointer.
+	const auto argument = encoder->argument(0);
+	const auto pointer = encoder->argumentPointer(0);
+	UNIT_CHECK(llvm::isa<llvm::LoadInst>(argument));
+	UNIT_CHECK(llvm::cast<llvm::LoadInst>(argument)->getPointerOperand() == pointer);
+	UNIT_CHECK(countInstructions<llvm::AllocaInst>(*function) == 1);
+	UNIT_CHECK(countInstructions<llvm::LoadInst>(*function) == 1);
+	
+	builder.getBuilder().CreateRetVoid();
+	checkModule(module);
+}
+
+UNIT_TEST(FunctionEncoderPassesThroughDirectAggregate) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeBuilder = abi->typeInfo().typeBuilder();
+	
+	// Passed as a first class aggregate.
+	const auto unionType = typeBuilder.getUnionTy({ LongTy, DoubleTy });
+	const FunctionType functionType(CC_FastInternal, VoidTy, { unionType });
+	
+	const auto function = createABIFunction(*abi, module, functionType, "function");
+	UnitTestBuilder builder(*function);
+	const auto encoder = abi->createFunctionEncoder(builder, functionType,
+	                                                getArguments(*function));
+	
+	// The value doesn't need to go through memory.
+	UNIT_CHECK(encoder->argument(0) == &*(function->arg_begin()));
+	UNIT_CHECK(function->getEntryBlock().empty());
+	
+	builder.getBuilder().CreateRetVoid();
+	checkModule(module);
+}
+
+UNIT_TEST(FunctionEncoderReturnsCoercedValue) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeBuilder = abi->typeInfo().typeBuilder();
+	
+	// Returned in RAX and XMM0 as { i64, double }.
+	const auto structType = typeBuilder.getStructTy({ IntTy, IntTy, DoubleTy });
+	const FunctionType functionType(CC_CDefault, structType, { structType });
+	
+	const auto function = createABIFunction(*abi, module, functionType, "function");
+	UnitTestBuilder builder(*function);
+	const auto encoder = abi->createFunctionEncoder(builder, functionType,
+	                                                getArguments(*function));
+	UNIT_CHECK(encoder->returnValuePointer() == nullptr);
+	
+	const auto value = llvm::UndefValue::get(abi->typeInfo().getLLVMType(structType));
+	const auto returnInst = encoder->returnValue(value);
+	
+	// The argument isn't decoded to encode the return value.
+	UNIT_CHECK(returnInst->getReturnValue()->getType() == function->getReturnType());
+	UNIT_CHECK(countInstructions<llvm::ReturnInst>(*function) == 1);
+	UNIT_CHECK(function->getEntryBlock().size() > 1);
+	UNIT_CHECK(countInstructions<llvm::AllocaInst>(*function) == 1);
+	checkModule(module);
+}
+
+UNIT_TEST(FunctionEncoderReturnsThroughStructRetPointer) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeBuilder = abi->typeInfo().typeBuilder();
+	
+	// Returned in memory, with 'sret'.
+	const auto structType = typeBuilder.getStructTy({ LongTy, LongTy, LongTy });
+	const FunctionType functionType(CC_CDefault, structType, { IntTy });
+	
+	const auto function = createABIFunction(*abi, module, functionType, "function");
+	UnitTestBuilder builder(*function);
+	const auto encoder = abi->createFunctionEncoder(builder, functionType,
+	                                                getArguments(*function));
+	
+	UNIT_CHECK(encoder->returnValuePointer() == &*(function->arg_begin()));
+	UNIT_CHECK(encoder->argument(0) == &*(std::next(function->arg_begin())));
+	
+	const auto value = llvm::UndefValue::get(abi->typeInfo().getLLVMType(structType));
+	const auto returnInst = encoder->returnValue(value);
+	UNIT_CHECK(returnInst->getReturnValue() == nullptr);
+	UNIT_CHECK(countInstructions<llvm::StoreInst>(*function) == 1);
+	checkModule(module);
+}
+
+UNIT_TEST(FunctionEncoderX86_32) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("i386-none-linux-gnu"));
+	const auto& typeBuilder = abi->typeInfo().typeBuilder();
+	
+	// Both returned in memory and passed on the stack.
+	const auto structType = typeBuilder.getStructTy({ IntTy, IntTy });
+	const FunctionType functionType(CC_CDefault, structType, { IntTy, structType });
+	
+	const auto function = createABIFunction(*abi, module, functionType, "function");
+	UnitTestBuilder builder(*function);
+	const auto encoder = abi->createFunctionEncoder(builder, functionType,
+	                                                getArguments(*function));
+	UNIT_CHECK(function->getEntryBlock().empty());
+	
+	UNIT_CHECK(encoder->returnValuePointer() == &*(function->arg_begin()));
+	
+	const auto arguments = encoder->arguments();
+	UNIT_CHECK(arguments.size() == 2);
+	UNIT_CHECK(arguments[1]->getType() == abi->typeInfo().getLLVMType(structType));
+	
+	const auto returnInst = encoder->returnValue(arguments[1]);
+	UNIT_CHECK(returnInst->getReturnValue() == nullptr);
+	checkModule(module);
+}
+
+static void emitReturnSites(FunctionEncoder& encoder, UnitTestBuilder& builder,
+                            llvm::Function& function, llvm::Type* const valueType) {
+	auto& irBuilder = builder.getBuilder();
+	const auto firstBlock = llvm::BasicBlock::Create(function.getContext(), "first", &function);
+	const auto secondBlock = llvm::BasicBlock::Create(function.getContext(), "second", &function);
+	irBuilder.CreateCondBr(irBuilder.getTrue(), firstBlock, secondBlock);
+	
+	irBuilder.SetInsertPoint(firstBlock);
+	encoder.branchToReturn(llvm::UndefValue::get(valueType));
+	
+	irBuilder.SetInsertPoint(secondBlock);
+	encoder.branchToReturn(llvm::Constant::getNullValue(valueType));
+}
+
+UNIT_TEST(FunctionEncoderSharesReturnBlock) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeBuilder = abi->typeInfo().typeBuilder();
+	
+	// Returned in RAX and XMM0 as { i64, double }.
+	const auto structType = typeBuilder.getStructTy({ LongTy, DoubleTy });
+	const FunctionType functionType(CC_CDefault, structType, {});
+	
+	const auto function = createABIFunction(*abi, module, functionType, "function");
+	UnitTestBuilder builder(*function);
+	const auto encoder = abi->createFunctionEncoder(builder, functionType,
+	                                                getArguments(*function));
+	emitReturnSites(*encoder, builder, *function,
+	                abi->typeInfo().getLLVMType(structType));
+	
+	// The return value is only encoded in the return block.
+	UNIT_CHECK(countInstructions<llvm::PHINode>(*function) == 1);
+	UNIT_CHECK(countInstructions<llvm::ReturnInst>(*function) == 1);
+	
+	const auto& phi = llvm::cast<llvm::PHINode>(function->back().front());
+	UNIT_CHECK(phi.getNumIncomingValues() == 2);
+	checkModule(module);
+}
+
+UNIT_TEST(FunctionEncoderSharesReturnBlockForStructRet) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeBuilder = abi->typeInfo().typeBuilder();
+	
+	// Returned in memory, with 'sret'.
+	const auto structType = typeBuilder.getStructTy({ LongTy, LongTy, LongTy });
+	const FunctionType functionType(CC_CDefault, structType, {});
+	
+	const auto function = createABIFunction(*abi, module, functionType, "function");
+	UnitTestBuilder builder(*function);
+	const auto encoder = abi->createFunctionEncoder(builder, functionType,
+	                                                getArguments(*function));
+	emitReturnSites(*encoder, builder, *function,
+	                abi->typeInfo().getLLVMType(structType));
+	
+	// Each return site stores into the 'sret' pointer, rather than
+	// merging aggregates with a phi.
+	UNIT_CHECK(countInstructions<llvm::PHINode>(*function) == 0);
+	UNIT_CHECK(countInstructions<llvm::StoreInst>(*function) == 2);
+	UNIT_CHECK(countInstructions<llvm::ReturnInst>(*function) == 1);
+	
+	const auto& returnBlock = function->back();
+	UNIT_CHECK(returnBlock.size() == 1);
+	UNIT_CHECK(llvm::cast<llvm::ReturnInst>(returnBlock.front()).getReturnValue() == nullptr);
+	checkModule(module);
+}
@@ -0,0 +1,295 @@
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/Attributes.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABIRegistry.hpp>
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/LoweringPlan.hpp>
+#include <llvm-abi/Type.hpp>
+#include <llvm-abi/TypeBuilder.hpp>
+
+#include "UnitTest.hpp"
+
+using namespace llvm_abi;
+
+struct PlanTestCase {
+	PlanTestCase(FunctionType argFunctionType,
+	             std::vector<Type> argVarArgTypes = std::vector<Type>())
+	: functionType(std::move(argFunctionType)),
+	argumentTypes(functionType.argumentTypes().begin(),
+	              functionType.argumentTypes().end()) {
+		argumentTypes.insert(argumentTypes.end(),
+		                     argVarArgTypes.begin(),
+		                     argVarArgTypes.end());
+	}
+	
+	FunctionType functionType;
+	std::vector<Type> argumentTypes;
+};
+
+static std::vector<PlanTestCase> getPlanTestCases(const TypeBuilder& typeBuilder) {
+	const auto floatsType = typeBuilder.getStructTy({ FloatTy, FloatTy, FloatTy });
+	const auto mixedType = typeBuilder.getStructTy({ IntTy, DoubleTy });
+	const auto largeType = typeBuilder.getStructTy({ LongTy, LongTy, LongTy });
+	const auto arrayType = typeBuilder.getStructTy({ typeBuilder.getArrayTy(3, CharTy) });
+	const auto unionType = typeBuilder.getUnionTy({ FloatTy, IntTy });
+	const auto vectorType = typeBuilder.getVectorTy(4, FloatTy);
+	const auto largeVectorType = typeBuilder.getVectorTy(8, FloatTy);
+	const auto complexType = Type::Complex(Double);
+	const auto longDoubleType = typeBuilder.getStructTy({ LongDoubleTy });
+	
+	std::vector<PlanTestCase> testCases;
+	testCases.push_back(PlanTestCase(FunctionType(CC_CDefault, VoidTy, {})));
+	testCases.push_back(PlanTestCase(FunctionType(CC_CDefault, CharTy, { BoolTy, ShortTy, IntTy })));
+	testCases.push_back(PlanTestCase(FunctionType(CC_CDefault, LongDoubleTy, { LongDoubleTy, DoubleTy })));
+	testCases.push_back(PlanTestCase(FunctionType(CC_CDefault, floatsType, { floatsType, mixedType })));
+	testCases.push_back(PlanTestCase(FunctionType(CC_CDefault, largeType, { largeType, IntTy })));
+	testCases.push_back(PlanTestCase(FunctionType(CC_CDefault, arrayType, { arrayType, unionType })));
+	testCases.push_back(PlanTestCase(FunctionType(CC_CDefault, vectorType, { vectorType, largeVectorType })));
+	testCases.push_back(PlanTestCase(FunctionType(CC_CDefault, complexType, { complexType, longDoubleType })));
+	testCases.push_back(PlanTestCase(FunctionType(CC_CDefault, Int128Ty, { Int128Ty, PointerTy })));
+	
+	// Eight structs use up the integer registers.
+	const std::vector<Type> mixedTypes(8, mixedType);
+	testCases.push_back(PlanTestCase(FunctionType(CC_CDefault, VoidTy, mixedTypes)));
+	
+	// Varargs are promoted.
+	testCases.push_back(PlanTestCase(FunctionType(CC_CDefault, IntTy, { PointerTy }, /*isVarArg=*/true)));
+	testCases.push_back(PlanTestCase(FunctionType(CC_CDefault, IntTy, { PointerTy }, /*isVarArg=*/true),
+	                                 { CharTy, FloatTy, mixedType, largeType }));
+	return testCases;
+}
+
+static void checkPlansMatchABI(const llvm::Triple& triple) {
+	ABIRegistry registry;
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = registry.createABI(module, triple);
+	const auto planner = registry.createLoweringPlanner(triple);
+	
+	for (const auto& testCase: getPlanTestCases(abi->typeInfo().typeBuilder())) {
+		const auto& functionType = testCase.functionType;
+		const auto& argumentTypes = testCase.argumentTypes;
+		
+		// Planning only uses layouts, so it mustn't need LLVM types.
+		const auto plan = planner->getLoweringPlan(functionType, argumentTypes);
+		const auto abiPlan = abi->getLoweringPlan(functionType, argumentTypes);
+		UNIT_CHECK(plan.toString() == abiPlan.toString());
+		
+		const auto& irMapping = plan.irMapping();
+		const auto& abiIRMapping = abiPlan.irMapping();
+		UNIT_CHECK(irMapping.totalIRArgs() == abiIRMapping.totalIRArgs());
+		UNIT_CHECK(irMapping.hasStructRetArg() == abiIRMapping.hasStructRetArg());
+		UNIT_CHECK(irMapping.hasInallocaArg() == abiIRMapping.hasInallocaArg());
+		UNIT_CHECK(irMapping.arguments().size() == argumentTypes.size());
+		for (size_t i = 0; i < argumentTypes.size(); i++) {
+			const auto& argument = irMapping.arguments()[i];
+			const auto& abiArgument = abiIRMapping.arguments()[i];
+			UNIT_CHECK(argument.argInfo.getKind() == abiArgument.argInfo.getKind());
+			UNIT_CHECK(argument.firstArgIndex == abiArgument.firstArgIndex);
+			UNIT_CHECK(argument.numberOfIRArgs == abiArgument.numberOfIRArgs);
+			UNIT_CHECK(irMapping.hasPaddingArg(i) == abiIRMapping.hasPaddingArg(i));
+		}
+		UNIT_CHECK(plan.registerUsage().numIntRegs == abiPlan.registerUsage().numIntRegs);
+		UNIT_CHECK(plan.registerUsage().numVectorRegs == abiPlan.registerUsage().numVectorRegs);
+		
+		// The plan gives the same LLVM types and attributes as the
+		// ABI (function types are only for the fixed arguments).
+		if (argumentTypes.size() == functionType.argumentTypes().size()) {
+			UNIT_CHECK(getFunctionType(context, abi->typeInfo(), plan) ==
+			           abi->getFunctionType(functionType));
+		}
+		UNIT_CHECK(getFunctionAttributes(context, abi->typeInfo(), plan,
+		                                 llvm::AttributeSet()) ==
+		           abi->getAttributes(functionType, argumentTypes));
+	}
+}
+
+UNIT_TEST(LoweringPlanMatchesABIX86_64) {
+	checkPlansMatchABI(llvm::Triple("x86_64-none-linux-gnu"));
+}
+
+UNIT_TEST(LoweringPlanMatchesABIX86_32) {
+	checkPlansMatchABI(llvm::Triple("i386-none-linux-gnu"));
+	checkPlansMatchABI(llvm::Triple("i386-apple-darwin"));
+	checkPlansMatchABI(llvm::Triple("i386-pc-windows-msvc"));
+}
+
+UNIT_TEST(LoweringPlanLayoutOnlyHasNoLLVMTypes) {
+	const auto planner = createLoweringPlanner(llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeInfo = planner->typeInfo();
+	const auto structType = typeInfo.typeBuilder().getStructTy({ IntTy, DoubleTy });
+	UNIT_CHECK(typeInfo.getTypeAllocSize(structType) == DataSize::Bytes(16));
+	
+	std::string errorString;
+	try {
+		typeInfo.getLLVMType(structType);
+	} catch (const std::runtime_error& error) {
+		errorString = error.what();
+	}
+	UNIT_CHECK(errorString == "LLVM types aren't available from layout-only ABI type information.");
+	
+	UNIT_CHECK_THROWS(typeInfo.getLLVMType(LongDoubleTy));
+	
+	// Plans can only be turned into LLVM types with an ABI's type
+	// information.
+	llvm::LLVMContext context;
+	const FunctionType functionType(CC_CDefault, VoidTy, { structType });
+	const auto plan = planner->getLoweringPlan(functionType, functionType.argumentTypes());
+	UNIT_CHECK_THROWS(getFunctionType(context, typeInfo, plan));
+}
+
+static LoweringPlan getPlan(const LoweringPlanner& planner,
+                            const FunctionType& functionType) {
+	return planner.getLoweringPlan(functionType, functionType.argumentTypes());
+}
+
+UNIT_TEST(LoweringPlanRegCallX86_64) {
+	const auto planner = createLoweringPlanner(llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeBuilder = planner->typeInfo().typeBuilder();
+	
+	// Structs are expanded into their fields if they fit in the
+	// remaining registers (11 integer and 16 SSE).
+	const auto mixedType = typeBuilder.getStructTy({ LongTy, LongTy, DoubleTy, DoubleTy });
+	const auto mixedPlan = getPlan(*planner, FunctionType(CC_RegCall, VoidTy, { mixedType }));
+	UNIT_CHECK(mixedPlan.argumentInfo(0).isDirect());
+	UNIT_CHECK(mixedPlan.irMapping().arguments()[0].numberOfIRArgs == 4);
+	UNIT_CHECK(mixedPlan.registerUsage().numIntRegs == 2);
+	UNIT_CHECK(mixedPlan.registerUsage().numVectorRegs == 2);
+	
+	const std::vector<Type> sixLongs(6, LongTy);
+	const auto longsType = typeBuilder.getStructTy(sixLongs);
+	const auto longsPlan = getPlan(*planner, FunctionType(CC_RegCall, VoidTy,
+	                                                      { longsType, longsType, IntTy }));
+	UNIT_CHECK(longsPlan.argumentInfo(0).isDirect());
+	UNIT_CHECK(longsPlan.irMapping().arguments()[0].numberOfIRArgs == 6);
+	
+	// The second struct doesn't fit, so it goes on the stack, but
+	// the integer after it still gets a register.
+	UNIT_CHECK(longsPlan.argumentInfo(1).isIndirect());
+	UNIT_CHECK(longsPlan.argumentInfo(1).getIndirectByVal());
+	UNIT_CHECK(longsPlan.argumentInfo(2).isDirect());
+	UNIT_CHECK(longsPlan.registerUsage().numIntRegs == 7);
+	
+	const std::vector<Type> sixteenDoubles(16, DoubleTy);
+	const auto doublesPlan = getPlan(*planner, FunctionType(CC_RegCall, VoidTy,
+	                                                        { typeBuilder.getStructTy(sixteenDoubles) }));
+	UNIT_CHECK(doublesPlan.argumentInfo(0).isDirect());
+	UNIT_CHECK(doublesPlan.registerUsage().numVectorRegs == 16);
+	
+	const std::vector<Type> seventeenDoubles(17, DoubleTy);
+	const auto overflowPlan = getPlan(*planner, FunctionType(CC_RegCall, VoidTy,
+	                                                         { typeBuilder.getStructTy(seventeenDoubles) }));
+	UNIT_CHECK(overflowPlan.argumentInfo(0).isIndirect());
+	UNIT_CHECK(overflowPlan.registerUsage().numVectorRegs == 0);
+	
+	// Returned structs use the same registers.
+	const auto returnPlan = getPlan(*planner, FunctionType(CC_RegCall, mixedType, { mixedType }));
+	UNIT_CHECK(returnPlan.returnInfo().isDirect());
+	UNIT_CHECK(returnPlan.registerUsage().numIntRegs == 4);
+	UNIT_CHECK(returnPlan.registerUsage().numVectorRegs == 4);
+	
+	// Complex long double is returned in memory, unlike for C.
+	const auto complexType = Type::Complex(LongDouble);
+	const auto complexPlan = getPlan(*planner, FunctionType(CC_RegCall, complexType, { IntTy }));
+	UNIT_CHECK(complexPlan.returnInfo().isIndirect());
+	UNIT_CHECK(complexPlan.irMapping().hasStructRetArg());
+	UNIT_CHECK(complexPlan.registerUsage().numIntRegs == 2);
+	
+	const auto cPlan = getPlan(*planner, FunctionType(CC_CDefault, complexType, { IntTy }));
+	UNIT_CHECK(cPlan.returnInfo().isDirect());
+}
+
+UNIT_TEST(LoweringPlanRegCallX86_32) {
+	const auto planner = createLoweringPlanner(llvm::Triple("i386-none-linux-gnu"));
+	const auto& typeBuilder = planner->typeInfo().typeBuilder();
+	
+	// Five integer registers.
+	const std::vector<Type> sixInts(6, IntTy);
+	const auto intsPlan = getPlan(*planner, FunctionType(CC_RegCall, VoidTy, sixInts));
+	for (size_t i = 0; i < 5; i++) {
+		UNIT_CHECK(intsPlan.argumentInfo(i).getInReg());
+	}
+	UNIT_CHECK(!intsPlan.argumentInfo(5).getInReg());
+	UNIT_CHECK(intsPlan.registerUsage().numIntRegs == 5);
+	
+	// Small structs are expanded.
+	const auto pairType = typeBuilder.getStructTy({ IntTy, IntTy });
+	const auto pairPlan = getPlan(*planner, FunctionType(CC_RegCall, VoidTy, { pairType }));
+	UNIT_CHECK(pairPlan.argumentInfo(0).isExpand());
+	UNIT_CHECK(pairPlan.irMapping().arguments()[0].numberOfIRArgs == 2);
+	
+	// Homogeneous vector aggregates are expanded into SSE registers
+	// (8 of them), and returned directly.
+	const auto vectorType = typeBuilder.getVectorTy(4, FloatTy);
+	const auto hvaType = typeBuilder.getStructTy({ vectorType, vectorType, vectorType });
+	const auto hvaPlan = getPlan(*planner, FunctionType(CC_RegCall, hvaType,
+	                                                    { hvaType, hvaType, hvaType }));
+	UNIT_CHECK(hvaPlan.returnInfo().isDirect());
+	UNIT_CHECK(hvaPlan.argumentInfo(0).isExpand());
+	UNIT_CHECK(hvaPlan.irMapping().arguments()[0].numberOfIRArgs == 3);
+	UNIT_CHECK(hvaPlan.argumentInfo(1).isExpand());
+	UNIT_CHECK(hvaPlan.registerUsage().numVectorRegs == 6);
+	
+	// The third doesn't fit, so it's passed by reference.
+	UNIT_CHECK(hvaPlan.argumentInfo(2).isIndirect());
+	UNIT_CHECK(!hvaPlan.argumentInfo(2).getIndirectByVal());
+	
+	// Floating point aggregates are homogeneous too.
+	const auto doublesType = typeBuilder.getStructTy({ DoubleTy, DoubleTy });
+	const auto doublesPlan = getPlan(*planner, FunctionType(CC_RegCall, VoidTy, { doublesType }));
+	UNIT_CHECK(doublesPlan.argumentInfo(0).isExpand());
+	UNIT_CHECK(doublesPlan.registerUsage().numVectorRegs == 2);
+}
+
+UNIT_TEST(LoweringPlanSwiftX86_64) {
+	const auto planner = createLoweringPlanner(llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeBuilder = planner->typeInfo().typeBuilder();
+	
+	// Structs that C returns in memory are returned in up to four
+	// integer and four SSE registers, one element per eightbyte.
+	const auto longsType = typeBuilder.getStructTy({ LongTy, LongTy, LongTy });
+	const auto longsPlan = getPlan(*planner, FunctionType(CC_Swift, longsType, {}));
+	UNIT_CHECK(longsPlan.returnInfo().isDirect());
+	UNIT_CHECK(longsPlan.returnInfo().getCoerceToType() ==
+	           typeBuilder.getStructTy({ Int64Ty, Int64Ty, Int64Ty }));
+	UNIT_CHECK(!longsPlan.irMapping().hasStructRetArg());
+	
+	const auto cPlan = getPlan(*planner, FunctionType(CC_CDefault, longsType, {}));
+	UNIT_CHECK(cPlan.returnInfo().isIndirect());
+	
+	// Floats that share an eightbyte are returned as a vector, and
+	// the final element is narrowed to the bytes in use.
+	const auto mixedType = typeBuilder.getStructTy({ LongTy, DoubleTy, FloatTy, FloatTy, IntTy });
+	const auto mixedPlan = getPlan(*planner, FunctionType(CC_Swift, mixedType, {}));
+	UNIT_CHECK(mixedPlan.returnInfo().isDirect());
+	UNIT_CHECK(mixedPlan.returnInfo().getCoerceToType() ==
+	           typeBuilder.getStructTy({ Int64Ty, DoubleTy, typeBuilder.getVectorTy(2, FloatTy), Int32Ty }));
+	
+	const auto charType = typeBuilder.getStructTy({ LongTy, LongTy, CharTy });
+	const auto charPlan = getPlan(*planner, FunctionType(CC_Swift, charType, {}));
+	UNIT_CHECK(charPlan.returnInfo().isDirect());
+	UNIT_CHECK(charPlan.returnInfo().getCoerceToType() ==
+	           typeBuilder.getStructTy({ Int64Ty, Int64Ty, Int8Ty }));
+	
+	// Too many integer registers, or an x87 member, fall back to
+	// a struct-return.
+	const std::vector<Type> fiveLongs(5, LongTy);
+	const auto fiveLongsPlan = getPlan(*planner, FunctionType(CC_Swift, typeBuilder.getStructTy(fiveLongs), {}));
+	UNIT_CHECK(fiveLongsPlan.returnInfo().isIndirect());
+	UNIT_CHECK(fiveLongsPlan.irMapping().hasStructRetArg());
+	
+	const auto x87Type = typeBuilder.getStructTy({ LongDoubleTy, LongTy });
+	const auto x87Plan = getPlan(*planner, FunctionType(CC_Swift, x87Type, {}));
+	UNIT_CHECK(x87Plan.returnInfo().isIndirect());
+	UNIT_CHECK(x87Plan.irMapping().hasStructRetArg());
+}
@@ -41,14 +41,20 @@ std::string runClangOnFunction(const ABITypeInfo& typeInfo,
                                const std::string& abiString,
                                const std::string& cpuString,
                                const std::string& clangPath,
-                               const TestFunctionType& testFunctionType) {
+                               const TestFunctionType& testFunctionType,
+                               const TestArguments testArguments) {
 	if (clangPath.empty()) {
 		printf("WARNING: No clang path provided!\n");
 		return "";
 	}
 	
 	CCodeGenerator cCodeGenerator(typeInfo);
-	cCodeGenerator.emitCalleeAndCallerFunctions(testFunctionType);
+	if (testArguments == VAArgArguments || testArguments == VACopyArguments) {
+		cCodeGenerator.emitVAArgCalleeAndCallerFunctions(testFunctionType,
+		                                                 /*copyVAList=*/testArguments == VACopyArguments);
+	} else {
+		cCodeGenerator.emitCalleeAndCallerFunctions(testFunctionType);
+	}
 	
 	std::ofstream tempFile("tempfile.c");
 	tempFile << cCodeGenerator.generatedSourceCode();
@@ -774,18 +780,26 @@ std::string getCanonicalInstruction(const std::string& instruction) {
 	return parser.parseInstruction();
 }
 
-static const std::string MEMCPY_START = "declare void @llvm.memcpy";
+/**
+ * \brief Check whether a line declares an intrinsic or its attributes.
+ * 
+ * Intrinsics (e.g. 'llvm.memcpy' or 'llvm.va_start') have different
+ * attributes for different versions of LLVM, but we don't care about
+ * these differences.
+ */
+bool isIntrinsicDeclaration(const std::string& line) {
+	return (startsWith(line, "declare ") &&
+	        line.find(" @llvm.") != std::string::npos) ||
+	       startsWith(line, "attributes #");
+}
 
 bool linesAreEqual(const std::string& expected, const std::string& actual) {
 	if (expected == actual) {
 		return true;
 	}
 	
-	if (startsWith(expected, MEMCPY_START) &&
-	    startsWith(actual, MEMCPY_START)) {
-		// The memcpy intrinsic has different attributes
-		// for different versions of LLVM, but we don't
-		// care about these differences.
+	if (isIntrinsicDeclaration(expected) &&
+	    isIntrinsicDeclaration(actual)) {
 		return true;
 	}
 	
@@ -821,12 +835,16 @@ int main(int argc, char** argv) {
 	std::string abiString;
 	std::string cpuString;
 	std::string functionTypeString = "";
+	std::string argumentsString;
+	std::string targetFeaturesString;
 	
 	std::ifstream file(string.c_str());
 	
 	const std::string ABI_COMMAND = "ABI";
 	const std::string CPU_COMMAND = "CPU";
 	const std::string FUNCTION_TYPE_COMMAND = "FUNCTION-TYPE";
+	const std::string ARGUMENTS_COMMAND = "ARGUMENTS";
+	const std::string TARGET_FEATURES_COMMAND = "TARGET-FEATURES";
 	
 	std::vector<std::string> compareLines;
 	
@@ -849,6 +867,10 @@ int main(int argc, char** argv) {
 				cpuString = line.substr(i + CPU_COMMAND.size() + 2);
 			} else if (line.substr(i, FUNCTION_TYPE_COMMAND.size()) == FUNCTION_TYPE_COMMAND) {
 				functionTypeString = line.substr(i + FUNCTION_TYPE_COMMAND.size() + 1);
+			} else if (line.substr(i, ARGUMENTS_COMMAND.size()) == ARGUMENTS_COMMAND) {
+				argumentsString = line.substr(i + ARGUMENTS_COMMAND.size() + 2);
+			} else if (line.substr(i, TARGET_FEATURES_COMMAND.size()) == TARGET_FEATURES_COMMAND) {
+				targetFeaturesString = line.substr(i + TARGET_FEATURES_COMMAND.size() + 2);
 			}
 		} else {
 			compareLines.push_back(line);
@@ -860,6 +882,18 @@ int main(int argc, char** argv) {
 		return EXIT_FAILURE;
 	}
 	
+	TestArguments testArguments = DecodedArguments;
+	if (argumentsString == "constant") {
+		testArguments = ConstantArguments;
+	} else if (argumentsString == "va_arg") {
+		testArguments = VAArgArguments;
+	} else if (argumentsString == "va_copy") {
+		testArguments = VACopyArguments;
+	} else if (!argumentsString.empty()) {
+		printf("ERROR: Unknown arguments '%s'.\n", argumentsString.c_str());
+		return EXIT_FAILURE;
+	}
+	
 	llvm_abi::TokenStream stream(functionTypeString);
 	llvm_abi::TypeParser parser(stream);
 	
@@ -872,7 +906,15 @@ int main(int argc, char** argv) {
 	const auto fileName = getBaseName(getFileName(string));
 	printf("filename = %s\n", fileName.c_str());
 	
-	testSystem.doTest(fileName, testFunctionType);
+	if ((testArguments == VAArgArguments || testArguments == VACopyArguments) &&
+	    !testFunctionType.functionType.isVarArg()) {
+		printf("ERROR: '%s' tests need a variadic function type.\n",
+		       argumentsString.c_str());
+		return EXIT_FAILURE;
+	}
+	
+	testSystem.doTest(fileName, testFunctionType, testArguments,
+	                  targetFeaturesString);
 	
 	{
 		std::string filename;
@@ -895,11 +937,8 @@ int main(int argc, char** argv) {
 			}
 			
 			if (nextLine < compareLines.size() &&
-			    startsWith(line, MEMCPY_START) &&
-			    startsWith(compareLines[nextLine], MEMCPY_START)) {
-				// The memcpy intrinsic has different attributes
-				// for different versions of LLVM, but we don't
-				// care about these differences.
+			    isIntrinsicDeclaration(line) &&
+			    isIntrinsicDeclaration(compareLines[nextLine])) {
 				nextLine++;
 				continue;
 			}
@@ -928,7 +967,8 @@ int main(int argc, char** argv) {
 					                   abiString,
 					                   cpuString,
 					                   clangPath,
-					                   testFunctionType);
+					                   testFunctionType,
+					                   testArguments);
 				printf("\n---- C compiler output (%s):\n%s\n\n",
 				       clangPath.c_str(),
 				       cCompilerOutput.c_str());
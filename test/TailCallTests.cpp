@@ -0,0 +1,179 @@
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <llvm-abi/ABI.hpp>
+#include <llvm-abi/ABITypeInfo.hpp>
+#include <llvm-abi/FunctionType.hpp>
+#include <llvm-abi/Type.hpp>
+#include <llvm-abi/TypeBuilder.hpp>
+
+#include "UnitTest.hpp"
+
+using namespace llvm_abi;
+
+static llvm::CallInst*
+emitTailCall(const ABI& abi, llvm::Function& caller, llvm::Function& callee,
+             const FunctionType& functionType,
+             llvm::ArrayRef<TypedValue> arguments,
+             llvm::Value* const returnValuePtr) {
+	UnitTestBuilder builder(caller);
+	llvm::CallInst* callInst = nullptr;
+	const auto returnValue =
+		abi.createTailCall(builder, functionType,
+			[&](llvm::ArrayRef<llvm::Value*> values) -> llvm::Value* {
+				callInst = builder.getBuilder().CreateCall(&callee, values);
+				callInst->setCallingConv(callee.getCallingConv());
+				callInst->setAttributes(callee.getAttributes());
+#if LLVMABI_LLVM_VERSION >= 305
+				callInst->setTailCallKind(llvm::CallInst::TCK_MustTail);
+#else
+				callInst->setTailCall();
+#endif
+				return callInst;
+			}, arguments, returnValuePtr);
+	
+	if (returnValue->getType()->isVoidTy()) {
+		builder.getBuilder().CreateRetVoid();
+	} else {
+		builder.getBuilder().CreateRet(returnValue);
+	}
+	return callInst;
+}
+
+UNIT_TEST(TailCallForwardsByValArgument) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeBuilder = abi->typeInfo().typeBuilder();
+	
+	// Passed in memory, with 'byval'.
+	const auto structType = typeBuilder.getStructTy({ LongTy, LongTy, LongTy });
+	const FunctionType functionType(CC_CDefault, VoidTy, { structType });
+	UNIT_CHECK(abi->isTailCallCompatible(functionType, functionType));
+	
+	const auto caller = createABIFunction(*abi, module, functionType, "caller");
+	const auto callee = createABIFunction(*abi, module, functionType, "callee");
+	
+	const auto argument = &*(caller->arg_begin());
+	const auto callInst = emitTailCall(*abi, *caller, *callee, functionType,
+	                                   { TypedValue(argument, structType) },
+	                                   nullptr);
+	
+	// The caller's own 'byval' argument is forwarded, rather than
+	// being copied into the caller's frame.
+	UNIT_CHECK(callInst->getArgOperand(0) == argument);
+	UNIT_CHECK(countInstructions<llvm::AllocaInst>(*caller) == 0);
+	checkModule(module);
+}
+
+UNIT_TEST(TailCallForwardsStructReturnPointer) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeBuilder = abi->typeInfo().typeBuilder();
+	
+	// Returned in memory, with 'sret'.
+	const auto structType = typeBuilder.getStructTy({ LongTy, LongTy, LongTy });
+	const FunctionType functionType(CC_CDefault, structType, { IntTy });
+	UNIT_CHECK(abi->isTailCallCompatible(functionType, functionType));
+	
+	const auto caller = createABIFunction(*abi, module, functionType, "caller");
+	const auto callee = createABIFunction(*abi, module, functionType, "callee");
+	
+	auto argIterator = caller->arg_begin();
+	const auto structRetPtr = &*(argIterator++);
+	const auto argument = &*(argIterator++);
+	
+	// A temporary for the return value would be in the caller's frame.
+	UNIT_CHECK_THROWS(emitTailCall(*abi, *caller, *callee, functionType,
+	                               { TypedValue(argument, IntTy) },
+	                               nullptr));
+	
+	const auto callInst = emitTailCall(*abi, *caller, *callee, functionType,
+	                                   { TypedValue(argument, IntTy) },
+	                                   structRetPtr);
+	
+	UNIT_CHECK(callInst->getArgOperand(0) == structRetPtr);
+	UNIT_CHECK(callInst->getArgOperand(1) == argument);
+	UNIT_CHECK(countInstructions<llvm::AllocaInst>(*caller) == 0);
+	checkModule(module);
+}
+
+UNIT_TEST(TailCallRejectsIndirectArgumentByValue) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeBuilder = abi->typeInfo().typeBuilder();
+	
+	const auto structType = typeBuilder.getStructTy({ LongTy, LongTy, LongTy });
+	const FunctionType functionType(CC_CDefault, VoidTy, { structType });
+	
+	const auto caller = createABIFunction(*abi, module, functionType, "caller");
+	const auto callee = createABIFunction(*abi, module, functionType, "callee");
+	
+	// Passing the value would need a temporary in the caller's frame.
+	const auto value = llvm::UndefValue::get(abi->typeInfo().getLLVMType(structType));
+	UNIT_CHECK_THROWS(emitTailCall(*abi, *caller, *callee, functionType,
+	                               { TypedValue(value, structType) },
+	                               nullptr));
+}
+
+UNIT_TEST(TailCallRejectsStructReturnMismatch) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeBuilder = abi->typeInfo().typeBuilder();
+	
+	const auto structType = typeBuilder.getStructTy({ LongTy, LongTy, LongTy });
+	const FunctionType callerType(CC_CDefault, VoidTy, { PointerTy });
+	const FunctionType calleeType(CC_CDefault, structType, {});
+	
+	// The callee's 'sret' pointer would point into the caller's frame.
+	UNIT_CHECK(!abi->isTailCallCompatible(callerType, calleeType));
+}
+
+UNIT_TEST(TailCallRejectsByValMismatch) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("x86_64-none-linux-gnu"));
+	const auto& typeBuilder = abi->typeInfo().typeBuilder();
+	
+	const auto longStructType = typeBuilder.getStructTy({ LongTy, LongTy, LongTy });
+	const auto doubleStructType = typeBuilder.getStructTy({ DoubleTy, DoubleTy, DoubleTy });
+	const auto smallStructType = typeBuilder.getStructTy({ LongTy, LongTy });
+	
+	// Both 'byval', but of different types.
+	UNIT_CHECK(!abi->isTailCallCompatible(FunctionType(CC_CDefault, VoidTy, { longStructType }),
+	                                      FunctionType(CC_CDefault, VoidTy, { doubleStructType })));
+	
+	// A 'byval' argument in the callee but not the caller.
+	UNIT_CHECK(!abi->isTailCallCompatible(FunctionType(CC_CDefault, VoidTy, { smallStructType }),
+	                                      FunctionType(CC_CDefault, VoidTy, { longStructType })));
+	
+	// Same LLVM signature and attributes: { long, long } is passed
+	// as two integers.
+	UNIT_CHECK(abi->isTailCallCompatible(FunctionType(CC_CDefault, VoidTy, { smallStructType }),
+	                                     FunctionType(CC_CDefault, VoidTy, { LongTy, LongTy })));
+}
+
+UNIT_TEST(TailCallRejectsInAlloca) {
+	llvm::LLVMContext context;
+	llvm::Module module("", context);
+	const auto abi = createABI(module, llvm::Triple("i686-pc-windows-msvc"));
+	const auto& typeBuilder = abi->typeInfo().typeBuilder();
+	
+	// Non-trivial arguments are passed in an inalloca block.
+	const auto structType = typeBuilder.getNonTrivialStructTy({ IntTy });
+	const FunctionType functionType(CC_CDefault, VoidTy, { structType });
+	UNIT_CHECK(!abi->isTailCallCompatible(functionType, functionType));
+	
+	const auto caller = createABIFunction(*abi, module, functionType, "caller");
+	const auto callee = createABIFunction(*abi, module, functionType, "callee");
+	
+	const auto value = llvm::UndefValue::get(abi->typeInfo().getLLVMType(structType));
+	UNIT_CHECK_THROWS(emitTailCall(*abi, *caller, *callee, functionType,
+	                               { TypedValue(value, structType) },
+	                               nullptr));
+}
@@ -5,6 +5,8 @@
 #include <memory>
 #include <stdexcept>
 
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Intrinsics.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
 #include <llvm/Support/raw_os_ostream.h>
@@ -23,26 +25,107 @@ class TestBuilder: public Builder {
 public:
 	TestBuilder(llvm::Function& function)
 	: function_(function),
+	entryBuilder_(&(function.getEntryBlock())),
 	builder_(&(function.getEntryBlock())) { }
 	
 	IRBuilder& getEntryBuilder() {
 		if (!function_.getEntryBlock().empty()) {
-			builder_.SetInsertPoint(&(function_.getEntryBlock().front()));
+			entryBuilder_.SetInsertPoint(&(function_.getEntryBlock().front()));
 		}
-		return builder_;
+		return entryBuilder_;
 	}
 	
 	IRBuilder& getBuilder() {
-		builder_.SetInsertPoint(&(function_.getEntryBlock()));
+		// Code is emitted in order, continuing from wherever the
+		// last instruction went (e.g. after the blocks of a va_arg).
 		return builder_;
 	}
 	
 private:
 	llvm::Function& function_;
+	IRBuilder entryBuilder_;
 	IRBuilder builder_;
 	
 };
 
+/**
+ * \brief Test arguments.
+ * 
+ * Specifies how the test's caller gets the arguments it passes to the
+ * callee.
+ */
+enum TestArguments {
+	// The caller's own (decoded) arguments.
+	DecodedArguments,
+	
+	// Test constants (see createTestConstant()).
+	ConstantArguments,
+	
+	// The caller is the variadic function and reads its variadic
+	// arguments with 'va_arg', to pass to a non-variadic callee.
+	VAArgArguments,
+	
+	// As above, but the caller also passes a copy (made with
+	// 'va_copy' before reading) of its va_list to the callee.
+	VACopyArguments
+};
+
+/**
+ * \brief Create a test constant.
+ * 
+ * Scalars are numbered 1, 2, 3, etc. in the order they appear, so the
+ * encoded constants show where each value ends up.
+ */
+inline llvm::Constant* createTestConstant(const ABITypeInfo& typeInfo,
+                                          const Type type,
+                                          unsigned& nextValue) {
+	const auto llvmType = typeInfo.getLLVMType(type);
+	if (type.isInteger()) {
+		return llvm::ConstantInt::get(llvmType, nextValue++);
+	} else if (type.isFloatingPoint()) {
+		return llvm::ConstantFP::get(llvmType, nextValue++);
+	} else if (type.isPointer()) {
+		return llvm::ConstantPointerNull::get(llvm::cast<llvm::PointerType>(llvmType));
+	}
+	
+	llvm::SmallVector<llvm::Constant*, 8> elements;
+	if (type.isStruct()) {
+		for (const auto& member: type.structMembers()) {
+			elements.push_back(createTestConstant(typeInfo, member.type(),
+			                                      nextValue));
+		}
+		return llvm::ConstantStruct::get(llvm::cast<llvm::StructType>(llvmType),
+		                                 elements);
+	} else if (type.isUnion()) {
+		// The IR type of a union only holds its largest member.
+		const auto structType = llvm::cast<llvm::StructType>(llvmType);
+		for (const auto& member: type.unionMembers()) {
+			if (structType->getNumElements() != 0 &&
+			    typeInfo.getLLVMType(member.type()) == structType->getElementType(0)) {
+				elements.push_back(createTestConstant(typeInfo, member.type(),
+				                                      nextValue));
+				break;
+			}
+		}
+		return llvm::ConstantStruct::get(structType, elements);
+	} else if (type.isArray()) {
+		for (size_t i = 0; i < type.arrayElementCount(); i++) {
+			elements.push_back(createTestConstant(typeInfo, type.arrayElementType(),
+			                                      nextValue));
+		}
+		return llvm::ConstantArray::get(llvm::cast<llvm::ArrayType>(llvmType),
+		                                elements);
+	} else if (type.isVector()) {
+		for (size_t i = 0; i < type.vectorElementCount(); i++) {
+			elements.push_back(createTestConstant(typeInfo, type.vectorElementType(),
+			                                      nextValue));
+		}
+		return llvm::ConstantVector::get(elements);
+	}
+	
+	throw std::runtime_error("Can't create test constant for type.");
+}
+
 class TestSystem {
 public:
 	TestSystem(const std::string& triple,
@@ -74,24 +157,105 @@ public:
 			argumentTypes.push_back(argType);
 		}
 		
-		return FunctionType(CC_CDefault,
-		                    functionType.returnType(),
-		                    argumentTypes,
-		                    /*isVarArg=*/false);
+		FunctionType callerFunctionType(functionType.callingConvention(),
+		                                functionType.returnType(),
+		                                argumentTypes,
+		                                /*isVarArg=*/false);
+		if (functionType.hasRegParm()) {
+			callerFunctionType.setRegParm(functionType.regParm());
+		}
+		return callerFunctionType;
+	}
+	
+	FunctionType makeVAListFunctionType(const FunctionType& functionType) const {
+		llvm::SmallVector<Type, 8> argumentTypes(functionType.argumentTypes().begin(),
+		                                         functionType.argumentTypes().end());
+		argumentTypes.push_back(PointerTy);
+		
+		FunctionType vaListFunctionType(functionType.callingConvention(),
+		                                functionType.returnType(),
+		                                argumentTypes,
+		                                /*isVarArg=*/false);
+		if (functionType.hasRegParm()) {
+			vaListFunctionType.setRegParm(functionType.regParm());
+		}
+		return vaListFunctionType;
 	}
 	
-	void doTest(const std::string& testName, const TestFunctionType& testFunctionType) {
-		const auto& calleeFunctionType = testFunctionType.functionType;
-		const auto calleeFunction = llvm::cast<llvm::Function>(module_.getOrInsertFunction("callee", abi_->getFunctionType(calleeFunctionType)));
-		const auto calleeAttributes = abi_->getAttributes(calleeFunctionType,
-		                                                  calleeFunctionType.argumentTypes());
+	/**
+	 * \brief Generate the test's caller and callee.
+	 * 
+	 * The caller passes its own (decoded) arguments to the callee,
+	 * or test constants (see createTestConstant()) if requested.
+	 * 
+	 * For variadic function types, the caller normally passes the
+	 * variadic argument types as fixed arguments to the variadic
+	 * callee; when testing 'va_arg' this is reversed, and when
+	 * testing 'va_copy' the callee also gets a va_list argument.
+	 * 
+	 * If target features are given (e.g. "+avx"), a second caller
+	 * and callee with those "target-features" are generated in the
+	 * same module, so that both lowerings can be compared.
+	 */
+	void doTest(const std::string& testName, const TestFunctionType& testFunctionType,
+	            const TestArguments testArguments = DecodedArguments,
+	            const std::string& targetFeatures = "") {
+		const auto functionTypes = emitFunctions(*abi_, /*nameSuffix=*/"",
+		                                         /*targetFeatures=*/"",
+		                                         testFunctionType, testArguments);
+		if (!targetFeatures.empty()) {
+			emitFunctions(abi_->withTargetFeatures(targetFeatures),
+			              ".features", targetFeatures,
+			              testFunctionType, testArguments);
+		}
+		
+		std::string filename;
+		filename += "test-";
+		filename += abi_->name();
+		filename += "-" + testName;
+		filename += ".output.ll";
+		
+		std::ofstream file(filename.c_str());
+		file << functionTypes;
+		
+		llvm::raw_os_ostream ostream(file);
+		ostream << module_;
+	}
+	
+	/**
+	 * \brief Generate a caller and callee.
+	 * 
+	 * \return Comments describing the callee and caller function types.
+	 */
+	std::string emitFunctions(const ABI& abi, const std::string& nameSuffix,
+	                          const std::string& targetFeatures,
+	                          const TestFunctionType& testFunctionType,
+	                          const TestArguments testArguments) {
+		const bool isVAArgTest = testArguments == VAArgArguments ||
+		                         testArguments == VACopyArguments;
+		const auto fixedFunctionType = makeCallerFunctionType(testFunctionType);
+		
+		const auto calleeFunctionType =
+			testArguments == VACopyArguments ? makeVAListFunctionType(fixedFunctionType) :
+			isVAArgTest ? fixedFunctionType : testFunctionType.functionType;
+		const auto calleeFunction = llvm::cast<llvm::Function>(module_.getOrInsertFunction("callee" + nameSuffix, abi.getFunctionType(calleeFunctionType)));
+		const auto calleeAttributes = abi.getAttributes(calleeFunctionType,
+		                                                 calleeFunctionType.argumentTypes());
 		calleeFunction->setAttributes(calleeAttributes);
+		calleeFunction->setCallingConv(abi.getCallingConvention(calleeFunctionType.callingConvention()));
 		
-		const auto callerFunctionType = makeCallerFunctionType(testFunctionType);
-		const auto callerFunction = llvm::cast<llvm::Function>(module_.getOrInsertFunction("caller", abi_->getFunctionType(callerFunctionType)));
-		const auto callerAttributes = abi_->getAttributes(callerFunctionType,
-		                                                  callerFunctionType.argumentTypes());
+		const auto& callerFunctionType = isVAArgTest ? testFunctionType.functionType :
+		                                 fixedFunctionType;
+		const auto callerFunction = llvm::cast<llvm::Function>(module_.getOrInsertFunction("caller" + nameSuffix, abi.getFunctionType(callerFunctionType)));
+		const auto callerAttributes = abi.getAttributes(callerFunctionType,
+		                                                 callerFunctionType.argumentTypes());
 		callerFunction->setAttributes(callerAttributes);
+		callerFunction->setCallingConv(abi.getCallingConvention(callerFunctionType.callingConvention()));
+		
+		if (!targetFeatures.empty()) {
+			calleeFunction->addFnAttr("target-features", targetFeatures);
+			callerFunction->addFnAttr("target-features", targetFeatures);
+		}
 		
 		const auto entryBasicBlock = llvm::BasicBlock::Create(context_, "", callerFunction);
 		(void) entryBasicBlock;
@@ -104,53 +268,121 @@ public:
 			encodedArgumentValues.push_back(&*it);
 		}
 		
-		auto functionEncoder = abi_->createFunctionEncoder(builder,
-		                                                   callerFunctionType,
-		                                                   encodedArgumentValues);
+		auto functionEncoder = abi.createFunctionEncoder(builder,
+		                                                  callerFunctionType,
+		                                                  encodedArgumentValues);
 		
 		llvm::SmallVector<TypedValue, 8> arguments;
 		
-		for (size_t i = 0; i < functionEncoder->arguments().size(); i++) {
-			const auto argValue = functionEncoder->arguments()[i];
+		unsigned nextConstantValue = 1;
+		
+		for (size_t i = 0; i < callerFunctionType.argumentTypes().size(); i++) {
 			const auto argType = callerFunctionType.argumentTypes()[i];
+			if (testArguments == ConstantArguments) {
+				arguments.push_back(TypedValue(createTestConstant(abi.typeInfo(),
+				                                                  argType,
+				                                                  nextConstantValue),
+				                               argType));
+				continue;
+			}
+			
+			const auto argValue = functionEncoder->arguments()[i];
 			arguments.push_back(TypedValue(argValue, argType));
 		}
 		
-		const auto returnValue = abi_->createCall(
+		if (isVAArgTest) {
+			emitVAArgs(builder, *functionEncoder, testFunctionType.varArgsTypes,
+			           arguments, /*copyVAList=*/testArguments == VACopyArguments);
+		}
+		
+		llvm::SmallVector<Type, 8> argumentTypes;
+		for (const auto& argument: arguments) {
+			argumentTypes.push_back(argument.type());
+		}
+		
+		const auto returnValue = abi.createCall(
 			builder,
 			calleeFunctionType,
 			[&](llvm::ArrayRef<llvm::Value*> values) -> llvm::Value* {
 				const auto callInst = builder.getBuilder().CreateCall(calleeFunction, values);
-				const auto callAttributes = abi_->getAttributes(calleeFunctionType,
-				                                                callerFunctionType.argumentTypes());
+				const auto callAttributes = abi.getAttributes(calleeFunctionType,
+				                                               argumentTypes);
 				callInst->setAttributes(callAttributes);
+				callInst->setCallingConv(calleeFunction->getCallingConv());
 				return callInst;
 			},
 			arguments
 		);
 		
+		for (const auto vaList: pendingVAEnds_) {
+			builder.getBuilder().CreateCall(llvm::Intrinsic::getDeclaration(&module_, llvm::Intrinsic::vaend),
+			                                vaList);
+		}
+		
+		pendingVAEnds_.clear();
+		
 		functionEncoder->returnValue(returnValue);
 		
-		std::string filename;
-		filename += "test-";
-		filename += abi_->name();
-		filename += "-" + testName;
-		filename += ".output.ll";
+		std::string functionTypes;
+		functionTypes += "; Callee function type: \n";
+		functionTypes += "; " + calleeFunctionType.toString() + "\n";
+		functionTypes += "; Caller function type: \n";
+		functionTypes += "; " + callerFunctionType.toString() + "\n";
+		return functionTypes;
+	}
+	
+	/**
+	 * \brief Read variadic arguments.
+	 * 
+	 * Reads each of the given types from the caller's variadic
+	 * arguments, as C code does with 'va_start', 'va_arg' and
+	 * 'va_end'.
+	 * 
+	 * If requested, the va_list is first copied (as with 'va_copy')
+	 * and the copy is added to the arguments, as C code does to
+	 * forward its variadic arguments to a function like 'vprintf';
+	 * the va_lists are then ended after the call.
+	 */
+	void emitVAArgs(Builder& builder, FunctionEncoder& functionEncoder,
+	                llvm::ArrayRef<Type> varArgsTypes,
+	                llvm::SmallVectorImpl<TypedValue>& arguments,
+	                const bool copyVAList) {
+		auto& irBuilder = builder.getBuilder();
+		const auto vaList = builder.getEntryBuilder().CreateAlloca(functionEncoder.vaListType(),
+		                                                           nullptr, "va");
+		const auto vaListPtr = irBuilder.CreateBitCast(vaList, irBuilder.getInt8PtrTy());
+		irBuilder.CreateCall(llvm::Intrinsic::getDeclaration(&module_, llvm::Intrinsic::vastart),
+		                     vaListPtr);
 		
-		std::ofstream file(filename.c_str());
-		file << "; Callee function type: " << std::endl;
-		file << "; " << calleeFunctionType.toString() << std::endl;
-		file << "; Caller function type: " << std::endl;
-		file << "; " << callerFunctionType.toString() << std::endl;
+		llvm::Value* vaListCopy = nullptr;
+		if (copyVAList) {
+			vaListCopy = builder.getEntryBuilder().CreateAlloca(functionEncoder.vaListType(),
+			                                                    nullptr, "va.copy");
+			functionEncoder.vaCopy(vaListCopy, vaList);
+		}
 		
-		llvm::raw_os_ostream ostream(file);
-		ostream << module_;
+		for (const auto& varArgType: varArgsTypes) {
+			arguments.push_back(TypedValue(functionEncoder.vaArg(vaList, varArgType),
+			                               varArgType));
+		}
+		
+		if (!copyVAList) {
+			irBuilder.CreateCall(llvm::Intrinsic::getDeclaration(&module_, llvm::Intrinsic::vaend),
+			                     vaListPtr);
+			return;
+		}
+		
+		arguments.push_back(TypedValue(functionEncoder.vaListArgument(vaListCopy),
+		                               PointerTy));
+		pendingVAEnds_.push_back(irBuilder.CreateBitCast(vaListCopy, irBuilder.getInt8PtrTy()));
+		pendingVAEnds_.push_back(vaListPtr);
 	}
 	
 private:
 	llvm::LLVMContext context_;
 	llvm::Module module_;
 	std::unique_ptr<ABI> abi_;
+	llvm::SmallVector<llvm::Value*, 2> pendingVAEnds_;
 	
 };
 
@@ -39,11 +39,16 @@ namespace llvm_abi {
 		}
 		
 		Type parseNamedType() {
-			const auto text = parseString();
+			return parseNamedType(parseString());
+		}
+		
+		Type parseNamedType(const std::string& text) {
 			assert(!text.empty());
 			
 			if (text == "struct") {
 				return parseNamedStructType();
+			} else if (text == "class") {
+				return parseNamedClassType();
 			} else if (text == "union") {
 				return parseNamedUnionType();
 			}
@@ -76,12 +81,20 @@ namespace llvm_abi {
 				return LongLongTy;
 			} else if (text == "ulonglong") {
 				return ULongLongTy;
+			} else if (text == "half") {
+				return HalfFloatTy;
 			} else if (text == "float") {
 				return FloatTy;
 			} else if (text == "double") {
 				return DoubleTy;
 			} else if (text == "longdouble") {
 				return LongDoubleTy;
+			} else if (text == "complexfloat") {
+				return Type::Complex(Float);
+			} else if (text == "complexdouble") {
+				return Type::Complex(Double);
+			} else if (text == "complexlongdouble") {
+				return Type::Complex(LongDouble);
 			} else {
 				throw std::runtime_error(std::string("Unknown type '") + text + "'.");
 			}
@@ -96,7 +109,17 @@ namespace llvm_abi {
 			return parseStructType(std::move(name));
 		}
 		
-		Type parseStructType(std::string name="") {
+		Type parseNamedClassType() {
+			std::string name;
+			if (stream_.peek() != '{') {
+				name = parseString();
+				assert(!name.empty());
+			}
+			return parseStructType(std::move(name), /*isNonTrivial=*/true);
+		}
+		
+		Type parseStructType(std::string name="",
+		                     const bool isNonTrivial=false) {
 			stream_.expect('{');
 			stream_.consume();
 			
@@ -113,6 +136,10 @@ namespace llvm_abi {
 			stream_.expect('}');
 			stream_.consume();
 			
+			if (isNonTrivial) {
+				return typeBuilder_.getNonTrivialStructTy(types, std::move(name));
+			}
+			
 			return typeBuilder_.getStructTy(types, std::move(name));
 		}
 		
@@ -247,8 +274,66 @@ namespace llvm_abi {
 			return varArgsTypes;
 		}
 		
+		bool parseCallingConvention(const std::string& text,
+		                            CallingConvention& callingConvention) {
+			if (text == "cdecl") {
+				callingConvention = CC_CDecl;
+			} else if (text == "stdcall") {
+				callingConvention = CC_StdCall;
+			} else if (text == "fastcall") {
+				callingConvention = CC_FastCall;
+			} else if (text == "thiscall") {
+				callingConvention = CC_ThisCall;
+			} else if (text == "pascal") {
+				callingConvention = CC_Pascal;
+			} else if (text == "vectorcall") {
+				callingConvention = CC_VectorCall;
+			} else if (text == "regcall") {
+				callingConvention = CC_RegCall;
+			} else if (text == "fastinternal") {
+				callingConvention = CC_FastInternal;
+			} else if (text == "swift") {
+				callingConvention = CC_Swift;
+			} else {
+				return false;
+			}
+			return true;
+		}
+		
+		int parseRegParm() {
+			stream_.expect('(');
+			stream_.consume();
+			
+			const auto regParm = parseInt();
+			
+			stream_.expect(')');
+			stream_.consume();
+			
+			return regParm;
+		}
+		
 		TestFunctionType parseFunctionType() {
-			const auto returnType = parseType();
+			// Function types can be prefixed by a calling convention
+			// and/or a 'regparm(N)' attribute.
+			auto callingConvention = CC_CDefault;
+			int regParm = -1;
+			
+			Type returnType = VoidTy;
+			while (true) {
+				const auto next = stream_.peek();
+				if (!(next >= 'a' && next <= 'z')) {
+					returnType = parseType();
+					break;
+				}
+				
+				const auto text = parseString();
+				if (text == "regparm") {
+					regParm = parseRegParm();
+				} else if (!parseCallingConvention(text, callingConvention)) {
+					returnType = parseNamedType(text);
+					break;
+				}
+			}
 			
 			stream_.expect('(');
 			stream_.consume();
@@ -272,11 +357,15 @@ namespace llvm_abi {
 			stream_.expect(')');
 			stream_.consume();
 			
-			return TestFunctionType(FunctionType(CC_CDefault,
-			                                     returnType,
-			                                     argumentTypes,
-			                                     isVarArg),
-			                        varArgsTypes);
+			FunctionType functionType(callingConvention,
+			                          returnType,
+			                          argumentTypes,
+			                          isVarArg);
+			if (regParm >= 0) {
+				functionType.setRegParm(regParm);
+			}
+			
+			return TestFunctionType(functionType, varArgsTypes);
 		}
 		
 	private:
@@ -0,0 +1,94 @@
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <llvm-abi/ABI.hpp>
+#include <llvm-abi/FunctionType.hpp>
+
+#include "UnitTest.hpp"
+
+static std::map<std::string, UnitTestFunction>& getUnitTests() {
+	static std::map<std::string, UnitTestFunction> unitTests;
+	return unitTests;
+}
+
+UnitTestRegistration::UnitTestRegistration(const char* const name,
+                                           const UnitTestFunction function) {
+	getUnitTests()[name] = function;
+}
+
+void checkCondition(const bool condition, const char* const conditionString,
+                    const char* const file, const int line) {
+	if (condition) {
+		return;
+	}
+	
+	std::string message = file;
+	message += ":" + std::to_string(line) + ": check failed: ";
+	message += conditionString;
+	throw std::runtime_error(message);
+}
+
+void checkModule(const llvm::Module& module) {
+#if LLVMABI_LLVM_VERSION >= 305
+	if (llvm::verifyModule(module, &(llvm::errs()))) {
+		module.print(llvm::errs(), nullptr);
+		throw std::runtime_error("Module failed verification.");
+	}
+#else
+	(void) module;
+#endif
+}
+
+llvm::Function* createABIFunction(const llvm_abi::ABI& abi,
+                                  llvm::Module& module,
+                                  const llvm_abi::FunctionType& functionType,
+                                  const std::string& name) {
+	const auto function = llvm::Function::Create(abi.getFunctionType(functionType),
+	                                             llvm::Function::ExternalLinkage,
+	                                             name, &module);
+	function->setAttributes(abi.getAttributes(functionType,
+	                                          functionType.argumentTypes()));
+	function->setCallingConv(abi.getCallingConvention(functionType.callingConvention()));
+	return function;
+}
+
+static bool runUnitTest(const std::string& name,
+                        const UnitTestFunction function) {
+	try {
+		function();
+	} catch (const std::exception& e) {
+		printf("%s: FAILED: %s\n", name.c_str(), e.what());
+		return false;
+	}
+	
+	printf("%s: PASSED\n", name.c_str());
+	return true;
+}
+
+int main(int argc, char** argv) {
+	const auto& unitTests = getUnitTests();
+	
+	if (argc < 2) {
+		// Run all tests.
+		bool passed = true;
+		for (const auto& unitTest: unitTests) {
+			passed = runUnitTest(unitTest.first, unitTest.second) && passed;
+		}
+		return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	
+	const std::string name(argv[1]);
+	const auto iterator = unitTests.find(name);
+	if (iterator == unitTests.end()) {
+		printf("ERROR: Unknown unit test '%s'.\n", name.c_str());
+		return EXIT_FAILURE;
+	}
+	
+	return runUnitTest(name, iterator->second) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
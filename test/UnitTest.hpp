@@ -0,0 +1,129 @@
+#ifndef UNITTEST_HPP
+#define UNITTEST_HPP
+
+#include <stdexcept>
+#include <string>
+
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+
+#include <llvm-abi/Builder.hpp>
+
+namespace llvm_abi {
+	
+	class ABI;
+	class FunctionType;
+	
+}
+
+/**
+ * \brief Define a unit test.
+ * 
+ * Unit tests are run by name with 'UnitTest <name>'.
+ */
+#define UNIT_TEST(name) \
+	static void unitTest_##name(); \
+	static UnitTestRegistration unitTestRegistration_##name(#name, unitTest_##name); \
+	static void unitTest_##name()
+	
+/**
+ * \brief Check a condition, failing the test if it's false.
+ */
+#define UNIT_CHECK(condition) \
+	checkCondition((condition), #condition, __FILE__, __LINE__)
+	
+/**
+ * \brief Check that an expression throws std::runtime_error.
+ */
+#define UNIT_CHECK_THROWS(expression) \
+	do { \
+		bool unitTestThrew = false; \
+		try { \
+			(void) (expression); \
+		} catch (const std::runtime_error&) { \
+			unitTestThrew = true; \
+		} \
+		checkCondition(unitTestThrew, "throws: " #expression, __FILE__, __LINE__); \
+	} while (false)
+	
+typedef void (*UnitTestFunction)();
+
+class UnitTestRegistration {
+public:
+	UnitTestRegistration(const char* name, UnitTestFunction function);
+	
+};
+
+void checkCondition(bool condition, const char* conditionString,
+                    const char* file, int line);
+
+/**
+ * \brief Check that a module passes the LLVM verifier.
+ */
+void checkModule(const llvm::Module& module);
+
+/**
+ * \brief Unit Test Builder
+ * 
+ * Emits instructions at a position controlled by the test, with
+ * allocas at the start of the function's entry block.
+ */
+class UnitTestBuilder: public llvm_abi::Builder {
+public:
+	UnitTestBuilder(llvm::Function& function)
+	: function_(function),
+	entryBuilder_(getOrCreateEntryBlock(function)),
+	builder_(&(function.getEntryBlock())) { }
+	
+	llvm_abi::IRBuilder& getEntryBuilder() {
+		if (!function_.getEntryBlock().empty()) {
+			entryBuilder_.SetInsertPoint(&(function_.getEntryBlock().front()));
+		}
+		return entryBuilder_;
+	}
+	
+	llvm_abi::IRBuilder& getBuilder() {
+		return builder_;
+	}
+	
+private:
+	static llvm::BasicBlock* getOrCreateEntryBlock(llvm::Function& function) {
+		if (function.empty()) {
+			return llvm::BasicBlock::Create(function.getContext(), "", &function);
+		}
+		return &(function.getEntryBlock());
+	}
+	
+	llvm::Function& function_;
+	llvm_abi::IRBuilder entryBuilder_;
+	llvm_abi::IRBuilder builder_;
+	
+};
+
+/**
+ * \brief Declare a function with the ABI's lowering of a function type.
+ */
+llvm::Function* createABIFunction(const llvm_abi::ABI& abi,
+                                  llvm::Module& module,
+                                  const llvm_abi::FunctionType& functionType,
+                                  const std::string& name);
+
+/**
+ * \brief Count the instructions of a given kind in a function.
+ */
+template <typename InstType>
+size_t countInstructions(const llvm::Function& function) {
+	size_t count = 0;
+	for (const auto& basicBlock: function) {
+		for (const auto& instruction: basicBlock) {
+			if (llvm::isa<InstType>(instruction)) {
+				count++;
+			}
+		}
+	}
+	return count;
+}
+
+#endif
@@ -1,11 +1,11 @@
 ; ABI: i386-apple-darwin9
 ; FUNCTION-TYPE: {<1 x double>} ()
 
-declare void @callee({ <1 x double> }* noalias sret)
+declare void @callee({ <1 x double> }* noalias nonnull sret align 8 dereferenceable(8))
 
-define void @caller({ <1 x double> }* noalias sret %agg.result) {
+define void @caller({ <1 x double> }* noalias nonnull sret align 8 dereferenceable(8) %agg.result) {
   %1 = alloca { <1 x double> }, align 8
-  call void @callee({ <1 x double> }* noalias sret %1)
+  call void @callee({ <1 x double> }* noalias nonnull sret align 8 dereferenceable(8) %1)
   %2 = load { <1 x double> }* %1
   store { <1 x double> } %2, { <1 x double> }* %agg.result
   ret void
@@ -1,11 +1,11 @@
 ; ABI: i386-apple-darwin9
 ; FUNCTION-TYPE: {<2 x int>} ()
 
-declare void @callee({ <2 x i32> }* noalias sret)
+declare void @callee({ <2 x i32> }* noalias nonnull sret align 8 dereferenceable(8))
 
-define void @caller({ <2 x i32> }* noalias sret %agg.result) {
+define void @caller({ <2 x i32> }* noalias nonnull sret align 8 dereferenceable(8) %agg.result) {
   %1 = alloca { <2 x i32> }, align 8
-  call void @callee({ <2 x i32> }* noalias sret %1)
+  call void @callee({ <2 x i32> }* noalias nonnull sret align 8 dereferenceable(8) %1)
   %2 = load { <2 x i32> }* %1
   store { <2 x i32> } %2, { <2 x i32> }* %agg.result
   ret void
@@ -0,0 +1,31 @@
+; ABI: i386-apple-darwin9
+; ARGUMENTS: va_arg
+; SSE vectors are 16 byte aligned on the stack, so va_arg realigns
+; the argument pointer.
+; FUNCTION-TYPE: void (int, ...(<4 x float>))
+
+declare void @callee(i32, <4 x float>)
+
+define void @caller(i32, ...) {
+  %va = alloca i8*
+  %2 = bitcast i8** %va to i8*
+  call void @llvm.va_start(i8* %2)
+  %ap.cur = load i8** %va
+  %3 = ptrtoint i8* %ap.cur to i32
+  %4 = add i32 %3, 15
+  %5 = and i32 %4, -16
+  %ap.align = inttoptr i32 %5 to i8*
+  %ap.next = getelementptr i8* %ap.align, i32 16
+  store i8* %ap.next, i8** %va
+  %6 = bitcast i8* %ap.align to <4 x float>*
+  %7 = load <4 x float>* %6, align 16
+  call void @llvm.va_end(i8* %2)
+  call void @callee(i32 %0, <4 x float> %7)
+  ret void
+}
+
+declare void @llvm.va_start(i8*) #0
+
+declare void @llvm.va_end(i8*) #0
+
+attributes #0 = { nounwind }
@@ -0,0 +1,9 @@
+; ABI: i386-none-linux-gnu
+; FUNCTION-TYPE: fastcall void (int, int, int)
+
+declare x86_fastcallcc void @callee(i32 inreg, i32 inreg, i32)
+
+define x86_fastcallcc void @caller(i32 inreg, i32 inreg, i32) {
+  call x86_fastcallcc void @callee(i32 inreg %0, i32 inreg %1, i32 %2)
+  ret void
+}
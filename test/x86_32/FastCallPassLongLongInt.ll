@@ -0,0 +1,9 @@
+; ABI: i386-none-linux-gnu
+; FUNCTION-TYPE: fastcall void (longlong, int)
+
+declare x86_fastcallcc void @callee(i64, i32)
+
+define x86_fastcallcc void @caller(i64, i32) {
+  call x86_fastcallcc void @callee(i64 %0, i32 %1)
+  ret void
+}
@@ -0,0 +1,9 @@
+; ABI: i386-none-linux-gnu
+; FUNCTION-TYPE: fastinternal int (int, int, int)
+
+declare fastcc i32 @callee(i32 inreg, i32 inreg, i32)
+
+define fastcc i32 @caller(i32 inreg, i32 inreg, i32) {
+  %4 = call fastcc i32 @callee(i32 inreg %0, i32 inreg %1, i32 %2)
+  ret i32 %4
+}
@@ -0,0 +1,21 @@
+; ABI: i386-none-linux-gnu
+; FUNCTION-TYPE: void (complexdouble)
+
+declare void @callee(double, double)
+
+define void @caller(double, double) {
+  %expand.source.arg = alloca { double, double }, align 4
+  %expand.dest.arg = alloca { double, double }, align 4
+  %3 = getelementptr { double, double }* %expand.dest.arg, i32 0, i32 0
+  store double %0, double* %3, align 4
+  %4 = getelementptr { double, double }* %expand.dest.arg, i32 0, i32 1
+  store double %1, double* %4, align 4
+  %5 = load { double, double }* %expand.dest.arg, align 4
+  store { double, double } %5, { double, double }* %expand.source.arg, align 4
+  %6 = getelementptr { double, double }* %expand.source.arg, i32 0, i32 0
+  %7 = load double* %6, align 4
+  %8 = getelementptr { double, double }* %expand.source.arg, i32 0, i32 1
+  %9 = load double* %8, align 4
+  call void @callee(double %7, double %9)
+  ret void
+}
@@ -3,12 +3,12 @@
 
 %NamedUnion = type { i32 }
 
-declare void @callee(%NamedUnion* byval align 4)
+declare void @callee(%NamedUnion* byval noalias nocapture nonnull align 4 dereferenceable(4))
 
-define void @caller(%NamedUnion* byval align 4) {
+define void @caller(%NamedUnion* byval noalias nocapture nonnull align 4 dereferenceable(4)) {
   %indirect.arg.mem = alloca %NamedUnion, align 4
   %2 = load %NamedUnion* %0, align 4
   store %NamedUnion %2, %NamedUnion* %indirect.arg.mem, align 4
-  call void @callee(%NamedUnion* byval align 4 %indirect.arg.mem)
+  call void @callee(%NamedUnion* byval noalias nocapture nonnull align 4 dereferenceable(4) %indirect.arg.mem)
   ret void
 }
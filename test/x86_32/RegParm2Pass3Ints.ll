@@ -0,0 +1,9 @@
+; ABI: i386-none-linux-gnu
+; FUNCTION-TYPE: regparm(2) void (int, int, int)
+
+declare void @callee(i32 inreg, i32 inreg, i32)
+
+define void @caller(i32 inreg, i32 inreg, i32) {
+  call void @callee(i32 inreg %0, i32 inreg %1, i32 %2)
+  ret void
+}
@@ -0,0 +1,9 @@
+; ABI: i386-none-linux-gnu
+; FUNCTION-TYPE: regparm(3) void (int, int, int)
+
+declare void @callee(i32 inreg, i32 inreg, i32 inreg)
+
+define void @caller(i32 inreg, i32 inreg, i32 inreg) {
+  call void @callee(i32 inreg %0, i32 inreg %1, i32 inreg %2)
+  ret void
+}
@@ -0,0 +1,9 @@
+; ABI: i386-none-linux-gnu
+; FUNCTION-TYPE: regparm(3) void (longlong, int)
+
+declare void @callee(i64 inreg, i32 inreg)
+
+define void @caller(i64 inreg, i32 inreg) {
+  call void @callee(i64 inreg %0, i32 inreg %1)
+  ret void
+}
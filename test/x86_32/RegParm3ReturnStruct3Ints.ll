@@ -0,0 +1,12 @@
+; ABI: i386-none-linux-gnu
+; FUNCTION-TYPE: regparm(3) {int, int, int} (int)
+
+declare void @callee({ i32, i32, i32 }* inreg noalias nonnull sret align 4 dereferenceable(12), i32 inreg)
+
+define void @caller({ i32, i32, i32 }* inreg noalias nonnull sret align 4 dereferenceable(12) %agg.result, i32 inreg) {
+  %2 = alloca { i32, i32, i32 }, align 4
+  call void @callee({ i32, i32, i32 }* inreg noalias nonnull sret align 4 dereferenceable(12) %2, i32 inreg %0)
+  %3 = load { i32, i32, i32 }* %2
+  store { i32, i32, i32 } %3, { i32, i32, i32 }* %agg.result
+  ret void
+}
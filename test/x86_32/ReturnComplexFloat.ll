@@ -0,0 +1,19 @@
+; ABI: i386-none-linux-gnu
+; FUNCTION-TYPE: complexfloat ()
+; 
+; Complex float is returned in EDX:EAX, unlike a struct of two floats.
+
+declare i64 @callee()
+
+define i64 @caller() {
+  %coerce1 = alloca { float, float }, align 4
+  %coerce = alloca { float, float }, align 4
+  %1 = call i64 @callee()
+  %2 = bitcast { float, float }* %coerce to i64*
+  store i64 %1, i64* %2, align 1
+  %3 = load { float, float }* %coerce, align 4
+  store { float, float } %3, { float, float }* %coerce1, align 4
+  %4 = bitcast { float, float }* %coerce1 to i64*
+  %5 = load i64* %4, align 1
+  ret i64 %5
+}
@@ -1,11 +1,11 @@
 ; ABI: i386-none-linux-gnu
 ; FUNCTION-TYPE: {float, float} ()
 
-declare void @callee({ float, float }* noalias sret)
+declare void @callee({ float, float }* noalias nonnull sret align 4 dereferenceable(8))
 
-define void @caller({ float, float }* noalias sret %agg.result) {
+define void @caller({ float, float }* noalias nonnull sret align 4 dereferenceable(8) %agg.result) {
   %1 = alloca { float, float }, align 4
-  call void @callee({ float, float }* noalias sret %1)
+  call void @callee({ float, float }* noalias nonnull sret align 4 dereferenceable(8) %1)
   %2 = load { float, float }* %1
   store { float, float } %2, { float, float }* %agg.result
   ret void
@@ -1,11 +1,11 @@
 ; ABI: i386-none-linux-gnu
 ; FUNCTION-TYPE: {ptr, ptr} ()
 
-declare void @callee({ i8*, i8* }* noalias sret)
+declare void @callee({ i8*, i8* }* noalias nonnull sret align 4 dereferenceable(8))
 
-define void @caller({ i8*, i8* }* noalias sret %agg.result) {
+define void @caller({ i8*, i8* }* noalias nonnull sret align 4 dereferenceable(8) %agg.result) {
   %1 = alloca { i8*, i8* }, align 4
-  call void @callee({ i8*, i8* }* noalias sret %1)
+  call void @callee({ i8*, i8* }* noalias nonnull sret align 4 dereferenceable(8) %1)
   %2 = load { i8*, i8* }* %1
   store { i8*, i8* } %2, { i8*, i8* }* %agg.result
   ret void
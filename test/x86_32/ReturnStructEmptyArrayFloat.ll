@@ -1,11 +1,11 @@
 ; ABI: i386-none-linux-gnu
 ; FUNCTION-TYPE: {[0 x char], float} ()
 
-declare void @callee({ [0 x i8], float }* noalias sret)
+declare void @callee({ [0 x i8], float }* noalias nonnull sret align 4 dereferenceable(4))
 
-define void @caller({ [0 x i8], float }* noalias sret %agg.result) {
+define void @caller({ [0 x i8], float }* noalias nonnull sret align 4 dereferenceable(4) %agg.result) {
   %1 = alloca { [0 x i8], float }, align 4
-  call void @callee({ [0 x i8], float }* noalias sret %1)
+  call void @callee({ [0 x i8], float }* noalias nonnull sret align 4 dereferenceable(4) %1)
   %2 = load { [0 x i8], float }* %1
   store { [0 x i8], float } %2, { [0 x i8], float }* %agg.result
   ret void
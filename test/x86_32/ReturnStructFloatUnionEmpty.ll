@@ -1,11 +1,11 @@
 ; ABI: i386-none-linux-gnu
 ; FUNCTION-TYPE: {float, union{}} ()
 
-declare void @callee({ float, {} }* noalias sret)
+declare void @callee({ float, {} }* noalias nonnull sret align 4 dereferenceable(4))
 
-define void @caller({ float, {} }* noalias sret %agg.result) {
+define void @caller({ float, {} }* noalias nonnull sret align 4 dereferenceable(4) %agg.result) {
   %1 = alloca { float, {} }, align 4
-  call void @callee({ float, {} }* noalias sret %1)
+  call void @callee({ float, {} }* noalias nonnull sret align 4 dereferenceable(4) %1)
   %2 = load { float, {} }* %1
   store { float, {} } %2, { float, {} }* %agg.result
   ret void
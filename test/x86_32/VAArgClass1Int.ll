@@ -0,0 +1,31 @@
+; ABI: i386-pc-linux-gnu
+; ARGUMENTS: va_arg
+; Non-trivial classes are passed by reference, so va_arg reads the
+; pointer and then loads the value.
+; FUNCTION-TYPE: void (int, ...(class{ int }))
+
+declare void @callee(i32, { i32 }* nonnull dereferenceable(4))
+
+define void @caller(i32, ...) {
+  %indirect.arg.mem = alloca { i32 }, align 4
+  %va = alloca i8*
+  %2 = bitcast i8** %va to i8*
+  call void @llvm.va_start(i8* %2)
+  %ap.cur = load i8** %va
+  %ap.next = getelementptr i8* %ap.cur, i32 4
+  store i8* %ap.next, i8** %va
+  %3 = bitcast i8* %ap.cur to i8**
+  %4 = load i8** %3
+  %5 = bitcast i8* %4 to { i32 }*
+  %6 = load { i32 }* %5, align 4
+  call void @llvm.va_end(i8* %2)
+  store { i32 } %6, { i32 }* %indirect.arg.mem, align 4
+  call void @callee(i32 %0, { i32 }* nonnull dereferenceable(4) %indirect.arg.mem)
+  ret void
+}
+
+declare void @llvm.va_start(i8*) #0
+
+declare void @llvm.va_end(i8*) #0
+
+attributes #0 = { nounwind }
@@ -0,0 +1,26 @@
+; ABI: i386-pc-linux-gnu
+; ARGUMENTS: va_arg
+; Doubles only need 4 byte alignment on the stack.
+; FUNCTION-TYPE: void (int, ...(double))
+
+declare void @callee(i32, double)
+
+define void @caller(i32, ...) {
+  %va = alloca i8*
+  %2 = bitcast i8** %va to i8*
+  call void @llvm.va_start(i8* %2)
+  %ap.cur = load i8** %va
+  %ap.next = getelementptr i8* %ap.cur, i32 8
+  store i8* %ap.next, i8** %va
+  %3 = bitcast i8* %ap.cur to double*
+  %4 = load double* %3, align 4
+  call void @llvm.va_end(i8* %2)
+  call void @callee(i32 %0, double %4)
+  ret void
+}
+
+declare void @llvm.va_start(i8*) #0
+
+declare void @llvm.va_end(i8*) #0
+
+attributes #0 = { nounwind }
@@ -0,0 +1,33 @@
+; ABI: i386-pc-linux-gnu
+; ARGUMENTS: va_copy
+; The caller copies its va_list before reading from it and passes
+; the copy to the callee.
+; FUNCTION-TYPE: void (int, ...(int))
+
+declare void @callee(i32, i32, i8*)
+
+define void @caller(i32, ...) {
+  %va.copy = alloca i8*
+  %va = alloca i8*
+  %2 = bitcast i8** %va to i8*
+  call void @llvm.va_start(i8* %2)
+  %3 = load i8** %va
+  store i8* %3, i8** %va.copy
+  %ap.cur = load i8** %va
+  %ap.next = getelementptr i8* %ap.cur, i32 4
+  store i8* %ap.next, i8** %va
+  %4 = bitcast i8* %ap.cur to i32*
+  %5 = load i32* %4, align 4
+  %6 = load i8** %va.copy
+  %7 = bitcast i8** %va.copy to i8*
+  call void @callee(i32 %0, i32 %5, i8* %6)
+  call void @llvm.va_end(i8* %7)
+  call void @llvm.va_end(i8* %2)
+  ret void
+}
+
+declare void @llvm.va_start(i8*) #0
+
+declare void @llvm.va_end(i8*) #0
+
+attributes #0 = { nounwind }
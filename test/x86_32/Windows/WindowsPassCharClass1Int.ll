@@ -0,0 +1,28 @@
+; ABI: i686-pc-windows-msvc
+; FUNCTION-TYPE: void (char, class{ int })
+
+declare void @callee(<{ i8, [3 x i8], { i32 } }>* inalloca)
+
+define void @caller(<{ i8, [3 x i8], { i32 } }>* inalloca) {
+  %inalloca.arg = getelementptr inbounds <{ i8, [3 x i8], { i32 } }>* %0, i32 0, i32 0
+  %2 = load i8* %inalloca.arg, align 1
+  %inalloca.arg1 = getelementptr inbounds <{ i8, [3 x i8], { i32 } }>* %0, i32 0, i32 2
+  %3 = load { i32 }* %inalloca.arg1, align 4
+  %inalloca.save = call i8* @llvm.stacksave()
+  %argmem = alloca inalloca <{ i8, [3 x i8], { i32 } }>, align 4
+  %4 = getelementptr inbounds <{ i8, [3 x i8], { i32 } }>* %argmem, i32 0, i32 0
+  store i8 %2, i8* %4, align 1
+  %5 = getelementptr inbounds <{ i8, [3 x i8], { i32 } }>* %argmem, i32 0, i32 2
+  store { i32 } %3, { i32 }* %5, align 4
+  call void @callee(<{ i8, [3 x i8], { i32 } }>* inalloca %argmem)
+  call void @llvm.stackrestore(i8* %inalloca.save)
+  ret void
+}
+
+; Function Attrs: nounwind
+declare i8* @llvm.stacksave() #0
+
+; Function Attrs: nounwind
+declare void @llvm.stackrestore(i8*) #0
+
+attributes #0 = { nounwind }
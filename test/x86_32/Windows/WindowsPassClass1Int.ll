@@ -0,0 +1,24 @@
+; ABI: i686-pc-windows-msvc
+; FUNCTION-TYPE: void (class{ int })
+
+declare void @callee(<{ { i32 } }>* inalloca)
+
+define void @caller(<{ { i32 } }>* inalloca) {
+  %inalloca.arg = getelementptr inbounds <{ { i32 } }>* %0, i32 0, i32 0
+  %2 = load { i32 }* %inalloca.arg, align 4
+  %inalloca.save = call i8* @llvm.stacksave()
+  %argmem = alloca inalloca <{ { i32 } }>, align 4
+  %3 = getelementptr inbounds <{ { i32 } }>* %argmem, i32 0, i32 0
+  store { i32 } %2, { i32 }* %3, align 4
+  call void @callee(<{ { i32 } }>* inalloca %argmem)
+  call void @llvm.stackrestore(i8* %inalloca.save)
+  ret void
+}
+
+; Function Attrs: nounwind
+declare i8* @llvm.stacksave() #0
+
+; Function Attrs: nounwind
+declare void @llvm.stackrestore(i8*) #0
+
+attributes #0 = { nounwind }
@@ -0,0 +1,33 @@
+; ABI: i686-pc-windows-msvc
+; FUNCTION-TYPE: class{ int } (class{ int })
+
+declare { i32 }* @callee(<{ i8*, { i32 } }>* inalloca)
+
+define { i32 }* @caller(<{ i8*, { i32 } }>* inalloca) {
+  %2 = alloca { i32 }, align 4
+  %inalloca.arg = getelementptr inbounds <{ i8*, { i32 } }>* %0, i32 0, i32 1
+  %3 = load { i32 }* %inalloca.arg, align 4
+  %inalloca.save = call i8* @llvm.stacksave()
+  %argmem = alloca inalloca <{ i8*, { i32 } }>, align 4
+  %4 = getelementptr inbounds <{ i8*, { i32 } }>* %argmem, i32 0, i32 0
+  %5 = bitcast i8** %4 to { i32 }**
+  store { i32 }* %2, { i32 }** %5, align 4
+  %6 = getelementptr inbounds <{ i8*, { i32 } }>* %argmem, i32 0, i32 1
+  store { i32 } %3, { i32 }* %6, align 4
+  %7 = call { i32 }* @callee(<{ i8*, { i32 } }>* inalloca %argmem)
+  call void @llvm.stackrestore(i8* %inalloca.save)
+  %8 = load { i32 }* %2, align 4
+  %9 = getelementptr inbounds <{ i8*, { i32 } }>* %0, i32 0, i32 0
+  %sret = load i8** %9, align 4
+  %10 = bitcast i8* %sret to { i32 }*
+  store { i32 } %8, { i32 }* %10
+  ret { i32 }* %10
+}
+
+; Function Attrs: nounwind
+declare i8* @llvm.stacksave() #0
+
+; Function Attrs: nounwind
+declare void @llvm.stackrestore(i8*) #0
+
+attributes #0 = { nounwind }
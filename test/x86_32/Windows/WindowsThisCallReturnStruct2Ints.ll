@@ -0,0 +1,12 @@
+; ABI: i686-pc-windows-msvc
+; FUNCTION-TYPE: thiscall {int, int} (ptr, int)
+
+declare x86_thiscallcc void @callee(i8*, { i32, i32 }* noalias nonnull sret align 4 dereferenceable(8), i32)
+
+define x86_thiscallcc void @caller(i8*, { i32, i32 }* noalias nonnull sret align 4 dereferenceable(8) %agg.result, i32) {
+  %3 = alloca { i32, i32 }, align 4
+  call x86_thiscallcc void @callee(i8* %0, { i32, i32 }* noalias nonnull sret align 4 dereferenceable(8) %3, i32 %1)
+  %4 = load { i32, i32 }* %3
+  store { i32, i32 } %4, { i32, i32 }* %agg.result
+  ret void
+}
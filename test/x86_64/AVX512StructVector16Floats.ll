@@ -0,0 +1,27 @@
+; ABI: x86_64-none-linux-gnu
+; Knights Landing has the AVX-512 support this test needs.
+; CPU: knl
+; FUNCTION-TYPE: {<16 x float>} ({<16 x float>})
+
+declare <16 x float> @callee(<16 x float>)
+
+define <16 x float> @caller(<16 x float> %coerce) {
+  %coerce4 = alloca { <16 x float> }, align 64
+  %coerce2 = alloca { <16 x float> }, align 64
+  %coerce.arg.source = alloca { <16 x float> }, align 64
+  %coerce.mem = alloca { <16 x float> }, align 64
+  %coerce.dive = getelementptr { <16 x float> }* %coerce.mem, i32 0, i32 0
+  store <16 x float> %coerce, <16 x float>* %coerce.dive, align 1
+  %1 = load { <16 x float> }* %coerce.mem
+  store { <16 x float> } %1, { <16 x float> }* %coerce.arg.source
+  %coerce.dive1 = getelementptr { <16 x float> }* %coerce.arg.source, i32 0, i32 0
+  %2 = load <16 x float>* %coerce.dive1, align 1
+  %3 = call <16 x float> @callee(<16 x float> %2)
+  %coerce.dive3 = getelementptr { <16 x float> }* %coerce2, i32 0, i32 0
+  store <16 x float> %3, <16 x float>* %coerce.dive3, align 1
+  %4 = load { <16 x float> }* %coerce2, align 64
+  store { <16 x float> } %4, { <16 x float> }* %coerce4, align 64
+  %coerce.dive5 = getelementptr { <16 x float> }* %coerce4, i32 0, i32 0
+  %5 = load <16 x float>* %coerce.dive5, align 1
+  ret <16 x float> %5
+}
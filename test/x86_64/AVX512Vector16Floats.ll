@@ -0,0 +1,11 @@
+; ABI: x86_64-none-linux-gnu
+; Knights Landing has the AVX-512 support this test needs.
+; CPU: knl
+; FUNCTION-TYPE: <16 x float> (<16 x float>)
+
+declare <16 x float> @callee(<16 x float>)
+
+define <16 x float> @caller(<16 x float>) {
+  %2 = call <16 x float> @callee(<16 x float> %0)
+  ret <16 x float> %2
+}
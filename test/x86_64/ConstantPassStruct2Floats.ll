@@ -0,0 +1,10 @@
+; ABI: x86_64-none-linux-gnu
+; ARGUMENTS: constant
+; FUNCTION-TYPE: void ({ float, float })
+
+declare void @callee(<2 x float>)
+
+define void @caller(<2 x float>) {
+  call void @callee(<2 x float> <float 1.000000e+00, float 2.000000e+00>)
+  ret void
+}
@@ -0,0 +1,10 @@
+; ABI: x86_64-none-linux-gnu
+; ARGUMENTS: constant
+; FUNCTION-TYPE: void ({ int, int })
+
+declare void @callee(i64)
+
+define void @caller(i64) {
+  call void @callee(i64 8589934593)
+  ret void
+}
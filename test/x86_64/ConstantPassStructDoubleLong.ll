@@ -0,0 +1,10 @@
+; ABI: x86_64-none-linux-gnu
+; ARGUMENTS: constant
+; FUNCTION-TYPE: void ({ double, long })
+
+declare void @callee(double, i64)
+
+define void @caller(double, i64) {
+  call void @callee(double 1.000000e+00, i64 2)
+  ret void
+}
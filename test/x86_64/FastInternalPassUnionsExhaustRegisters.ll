@@ -0,0 +1,12 @@
+; ABI: x86_64-none-linux-gnu
+; FUNCTION-TYPE: fastinternal void (union{ {long, long}, double }, union{ {long, long}, double }, union{ {long, long}, double }, {long})
+
+declare fastcc void @callee({ { i64, i64 } }, { { i64, i64 } }, { { i64, i64 } }, { i64 }* nonnull align 8 dereferenceable(8))
+
+define fastcc void @caller({ { i64, i64 } }, { { i64, i64 } }, { { i64, i64 } }, { i64 }* nonnull align 8 dereferenceable(8)) {
+  %indirect.arg.mem = alloca { i64 }, align 8
+  %5 = load { i64 }* %3, align 8
+  store { i64 } %5, { i64 }* %indirect.arg.mem, align 8
+  call fastcc void @callee({ { i64, i64 } } %0, { { i64, i64 } } %1, { { i64, i64 } } %2, { i64 }* nonnull align 8 dereferenceable(8) %indirect.arg.mem)
+  ret void
+}
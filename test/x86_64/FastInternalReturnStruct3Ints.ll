@@ -0,0 +1,20 @@
+; ABI: x86_64-none-linux-gnu
+; FUNCTION-TYPE: fastinternal {int, int, int} (int, int)
+
+declare fastcc { i32, i32, i32 } @callee(i32, i32)
+
+define fastcc { i32, i32, i32 } @caller(i32, i32) {
+  %agg.tmp = alloca { i32, i32, i32 }, align 4
+  %3 = call fastcc { i32, i32, i32 } @callee(i32 %0, i32 %1)
+  %4 = getelementptr { i32, i32, i32 }* %agg.tmp, i32 0, i32 0
+  %5 = extractvalue { i32, i32, i32 } %3, 0
+  store i32 %5, i32* %4
+  %6 = getelementptr { i32, i32, i32 }* %agg.tmp, i32 0, i32 1
+  %7 = extractvalue { i32, i32, i32 } %3, 1
+  store i32 %7, i32* %6
+  %8 = getelementptr { i32, i32, i32 }* %agg.tmp, i32 0, i32 2
+  %9 = extractvalue { i32, i32, i32 } %3, 2
+  store i32 %9, i32* %8
+  %10 = load { i32, i32, i32 }* %agg.tmp, align 4
+  ret { i32, i32, i32 } %10
+}
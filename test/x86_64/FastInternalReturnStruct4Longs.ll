@@ -0,0 +1,12 @@
+; ABI: x86_64-none-linux-gnu
+; FUNCTION-TYPE: fastinternal {long, long, long, long} ()
+
+declare fastcc void @callee({ i64, i64, i64, i64 }* noalias nonnull sret align 8 dereferenceable(32))
+
+define fastcc void @caller({ i64, i64, i64, i64 }* noalias nonnull sret align 8 dereferenceable(32) %agg.result) {
+  %1 = alloca { i64, i64, i64, i64 }, align 8
+  call fastcc void @callee({ i64, i64, i64, i64 }* noalias nonnull sret align 8 dereferenceable(32) %1)
+  %2 = load { i64, i64, i64, i64 }* %1
+  store { i64, i64, i64, i64 } %2, { i64, i64, i64, i64 }* %agg.result
+  ret void
+}
@@ -3,10 +3,10 @@
 
 declare void @callee(i32, ...)
 
-define void @caller(i32, <8 x float>* byval align 32) {
+define void @caller(i32, <8 x float>* byval noalias nocapture nonnull align 32 dereferenceable(32)) {
   %indirect.arg.mem = alloca <8 x float>, align 32
   %3 = load <8 x float>* %1, align 32
   store <8 x float> %3, <8 x float>* %indirect.arg.mem, align 32
-  call void (i32, ...)* @callee(i32 %0, <8 x float>* byval align 32 %indirect.arg.mem)
+  call void (i32, ...)* @callee(i32 %0, <8 x float>* byval noalias nocapture nonnull align 32 dereferenceable(32) %indirect.arg.mem)
   ret void
 }
@@ -0,0 +1,9 @@
+; ABI: x86_64-none-linux-gnu
+; FUNCTION-TYPE: void (half)
+
+declare void @callee(half)
+
+define void @caller(half) {
+  call void @callee(half %0)
+  ret void
+}
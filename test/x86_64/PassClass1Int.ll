@@ -0,0 +1,12 @@
+; ABI: x86_64-none-linux-gnu
+; FUNCTION-TYPE: void (class{ int })
+
+declare void @callee({ i32 }* nonnull align 4 dereferenceable(4))
+
+define void @caller({ i32 }* nonnull align 4 dereferenceable(4)) {
+  %indirect.arg.mem = alloca { i32 }, align 4
+  %2 = load { i32 }* %0, align 4
+  store { i32 } %2, { i32 }* %indirect.arg.mem, align 4
+  call void @callee({ i32 }* nonnull align 4 dereferenceable(4) %indirect.arg.mem)
+  ret void
+}
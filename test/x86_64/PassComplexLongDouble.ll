@@ -0,0 +1,14 @@
+; ABI: x86_64-none-linux-gnu
+; FUNCTION-TYPE: void (complexlongdouble)
+; 
+; Complex long double (ComplexX87) is passed in memory.
+
+declare void @callee({ x86_fp80, x86_fp80 }* byval noalias nocapture nonnull align 16 dereferenceable(32))
+
+define void @caller({ x86_fp80, x86_fp80 }* byval noalias nocapture nonnull align 16 dereferenceable(32)) {
+  %indirect.arg.mem = alloca { x86_fp80, x86_fp80 }, align 16
+  %2 = load { x86_fp80, x86_fp80 }* %0, align 16
+  store { x86_fp80, x86_fp80 } %2, { x86_fp80, x86_fp80 }* %indirect.arg.mem, align 16
+  call void @callee({ x86_fp80, x86_fp80 }* byval noalias nocapture nonnull align 16 dereferenceable(32) %indirect.arg.mem)
+  ret void
+}
@@ -14,21 +14,34 @@ define void @caller(i32, i64 %coerce0, i32 %coerce1) {
   store i32 %coerce1, i32* %3
   %4 = bitcast { i16, i32, i32 }* %coerce.mem to i8*
   %5 = bitcast { i64, i32 }* %coerce to i8*
-  call void @llvm.memcpy.p0i8.p0i8.i64(i8* %4, i8* %5, i64 12, i32 8, i1 false)
-  %6 = load { i16, i32, i32 }* %coerce.mem
-  store { i16, i32, i32 } %6, { i16, i32, i32 }* %coerce.arg.source
-  %7 = bitcast { i64, i32 }* %coerce.arg.source.coerce to i8*
-  %8 = bitcast { i16, i32, i32 }* %coerce.arg.source to i8*
-  call void @llvm.memcpy.p0i8.p0i8.i64(i8* %7, i8* %8, i64 12, i32 0, i1 false)
-  %9 = getelementptr { i64, i32 }* %coerce.arg.source.coerce, i32 0, i32 0
-  %10 = load i64* %9, align 1
-  %11 = getelementptr { i64, i32 }* %coerce.arg.source.coerce, i32 0, i32 1
-  %12 = load i32* %11, align 1
-  call void @callee(i32 %0, i64 %10, i32 %12)
+  %6 = bitcast i8* %5 to i64*
+  %7 = load i64* %6, align 8
+  %8 = bitcast i8* %4 to i64*
+  store i64 %7, i64* %8, align 8
+  %9 = getelementptr i8* %5, i32 8
+  %10 = bitcast i8* %9 to i32*
+  %11 = load i32* %10, align 8
+  %12 = getelementptr i8* %4, i32 8
+  %13 = bitcast i8* %12 to i32*
+  store i32 %11, i32* %13, align 8
+  %14 = load { i16, i32, i32 }* %coerce.mem
+  store { i16, i32, i32 } %14, { i16, i32, i32 }* %coerce.arg.source
+  %15 = bitcast { i64, i32 }* %coerce.arg.source.coerce to i8*
+  %16 = bitcast { i16, i32, i32 }* %coerce.arg.source to i8*
+  %17 = bitcast i8* %16 to i64*
+  %18 = load i64* %17, align 1
+  %19 = bitcast i8* %15 to i64*
+  store i64 %18, i64* %19, align 1
+  %20 = getelementptr i8* %16, i32 8
+  %21 = bitcast i8* %20 to i32*
+  %22 = load i32* %21, align 1
+  %23 = getelementptr i8* %15, i32 8
+  %24 = bitcast i8* %23 to i32*
+  store i32 %22, i32* %24, align 1
+  %25 = getelementptr { i64, i32 }* %coerce.arg.source.coerce, i32 0, i32 0
+  %26 = load i64* %25, align 1
+  %27 = getelementptr { i64, i32 }* %coerce.arg.source.coerce, i32 0, i32 1
+  %28 = load i32* %27, align 1
+  call void @callee(i32 %0, i64 %26, i32 %28)
   ret void
 }
-
-; Function Attrs: nounwind
-declare void @llvm.memcpy.p0i8.p0i8.i64(i8* nocapture, i8* nocapture readonly, i64, i32, i1) #0
-
-attributes #0 = { nounwind }
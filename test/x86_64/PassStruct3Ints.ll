@@ -14,21 +14,34 @@ define void @caller(i64 %coerce0, i32 %coerce1) {
   store i32 %coerce1, i32* %2
   %3 = bitcast { i32, i32, i32 }* %coerce.mem to i8*
   %4 = bitcast { i64, i32 }* %coerce to i8*
-  call void @llvm.memcpy.p0i8.p0i8.i64(i8* %3, i8* %4, i64 12, i32 8, i1 false)
-  %5 = load { i32, i32, i32 }* %coerce.mem
-  store { i32, i32, i32 } %5, { i32, i32, i32 }* %coerce.arg.source
-  %6 = bitcast { i64, i32 }* %coerce.arg.source.coerce to i8*
-  %7 = bitcast { i32, i32, i32 }* %coerce.arg.source to i8*
-  call void @llvm.memcpy.p0i8.p0i8.i64(i8* %6, i8* %7, i64 12, i32 0, i1 false)
-  %8 = getelementptr { i64, i32 }* %coerce.arg.source.coerce, i32 0, i32 0
-  %9 = load i64* %8, align 1
-  %10 = getelementptr { i64, i32 }* %coerce.arg.source.coerce, i32 0, i32 1
-  %11 = load i32* %10, align 1
-  call void @callee(i64 %9, i32 %11)
+  %5 = bitcast i8* %4 to i64*
+  %6 = load i64* %5, align 8
+  %7 = bitcast i8* %3 to i64*
+  store i64 %6, i64* %7, align 8
+  %8 = getelementptr i8* %4, i32 8
+  %9 = bitcast i8* %8 to i32*
+  %10 = load i32* %9, align 8
+  %11 = getelementptr i8* %3, i32 8
+  %12 = bitcast i8* %11 to i32*
+  store i32 %10, i32* %12, align 8
+  %13 = load { i32, i32, i32 }* %coerce.mem
+  store { i32, i32, i32 } %13, { i32, i32, i32 }* %coerce.arg.source
+  %14 = bitcast { i64, i32 }* %coerce.arg.source.coerce to i8*
+  %15 = bitcast { i32, i32, i32 }* %coerce.arg.source to i8*
+  %16 = bitcast i8* %15 to i64*
+  %17 = load i64* %16, align 1
+  %18 = bitcast i8* %14 to i64*
+  store i64 %17, i64* %18, align 1
+  %19 = getelementptr i8* %15, i32 8
+  %20 = bitcast i8* %19 to i32*
+  %21 = load i32* %20, align 1
+  %22 = getelementptr i8* %14, i32 8
+  %23 = bitcast i8* %22 to i32*
+  store i32 %21, i32* %23, align 1
+  %24 = getelementptr { i64, i32 }* %coerce.arg.source.coerce, i32 0, i32 0
+  %25 = load i64* %24, align 1
+  %26 = getelementptr { i64, i32 }* %coerce.arg.source.coerce, i32 0, i32 1
+  %27 = load i32* %26, align 1
+  call void @callee(i64 %25, i32 %27)
   ret void
 }
-
-; Function Attrs: nounwind
-declare void @llvm.memcpy.p0i8.p0i8.i64(i8* nocapture, i8* nocapture readonly, i64, i32, i1) #0
-
-attributes #0 = { nounwind }
@@ -14,21 +14,42 @@ define void @caller(i64 %coerce0, i24 %coerce1) {
   store i24 %coerce1, i24* %2
   %3 = bitcast { [8 x i8], i8, i8, i8 }* %coerce.mem to i8*
   %4 = bitcast { i64, i24 }* %coerce to i8*
-  call void @llvm.memcpy.p0i8.p0i8.i64(i8* %3, i8* %4, i64 11, i32 8, i1 false)
-  %5 = load { [8 x i8], i8, i8, i8 }* %coerce.mem
-  store { [8 x i8], i8, i8, i8 } %5, { [8 x i8], i8, i8, i8 }* %coerce.arg.source
-  %6 = bitcast { i64, i24 }* %coerce.arg.source.coerce to i8*
-  %7 = bitcast { [8 x i8], i8, i8, i8 }* %coerce.arg.source to i8*
-  call void @llvm.memcpy.p0i8.p0i8.i64(i8* %6, i8* %7, i64 11, i32 0, i1 false)
-  %8 = getelementptr { i64, i24 }* %coerce.arg.source.coerce, i32 0, i32 0
-  %9 = load i64* %8, align 1
-  %10 = getelementptr { i64, i24 }* %coerce.arg.source.coerce, i32 0, i32 1
-  %11 = load i24* %10, align 1
-  call void @callee(i64 %9, i24 %11)
+  %5 = bitcast i8* %4 to i64*
+  %6 = load i64* %5, align 8
+  %7 = bitcast i8* %3 to i64*
+  store i64 %6, i64* %7, align 8
+  %8 = getelementptr i8* %4, i32 8
+  %9 = bitcast i8* %8 to i16*
+  %10 = load i16* %9, align 8
+  %11 = getelementptr i8* %3, i32 8
+  %12 = bitcast i8* %11 to i16*
+  store i16 %10, i16* %12, align 8
+  %13 = getelementptr i8* %4, i32 10
+  %14 = load i8* %13, align 2
+  %15 = getelementptr i8* %3, i32 10
+  store i8 %14, i8* %15, align 2
+  %16 = load { [8 x i8], i8, i8, i8 }* %coerce.mem
+  store { [8 x i8], i8, i8, i8 } %16, { [8 x i8], i8, i8, i8 }* %coerce.arg.source
+  %17 = bitcast { i64, i24 }* %coerce.arg.source.coerce to i8*
+  %18 = bitcast { [8 x i8], i8, i8, i8 }* %coerce.arg.source to i8*
+  %19 = bitcast i8* %18 to i64*
+  %20 = load i64* %19, align 1
+  %21 = bitcast i8* %17 to i64*
+  store i64 %20, i64* %21, align 1
+  %22 = getelementptr i8* %18, i32 8
+  %23 = bitcast i8* %22 to i16*
+  %24 = load i16* %23, align 1
+  %25 = getelementptr i8* %17, i32 8
+  %26 = bitcast i8* %25 to i16*
+  store i16 %24, i16* %26, align 1
+  %27 = getelementptr i8* %18, i32 10
+  %28 = load i8* %27, align 1
+  %29 = getelementptr i8* %17, i32 10
+  store i8 %28, i8* %29, align 1
+  %30 = getelementptr { i64, i24 }* %coerce.arg.source.coerce, i32 0, i32 0
+  %31 = load i64* %30, align 1
+  %32 = getelementptr { i64, i24 }* %coerce.arg.source.coerce, i32 0, i32 1
+  %33 = load i24* %32, align 1
+  call void @callee(i64 %31, i24 %33)
   ret void
 }
-
-; Function Attrs: nounwind
-declare void @llvm.memcpy.p0i8.p0i8.i64(i8* nocapture, i8* nocapture readonly, i64, i32, i1) #0
-
-attributes #0 = { nounwind }
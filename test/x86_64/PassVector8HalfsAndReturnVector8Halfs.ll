@@ -0,0 +1,9 @@
+; ABI: x86_64-none-linux-gnu
+; FUNCTION-TYPE: <8 x half> (<8 x half>)
+
+declare <8 x half> @callee(<8 x half>)
+
+define <8 x half> @caller(<8 x half>) {
+  %2 = call <8 x half> @callee(<8 x half> %0)
+  ret <8 x half> %2
+}
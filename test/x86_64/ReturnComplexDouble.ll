@@ -0,0 +1,9 @@
+; ABI: x86_64-none-linux-gnu
+; FUNCTION-TYPE: complexdouble ()
+
+declare { double, double } @callee()
+
+define { double, double } @caller() {
+  %1 = call { double, double } @callee()
+  ret { double, double } %1
+}
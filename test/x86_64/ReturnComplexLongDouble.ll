@@ -0,0 +1,11 @@
+; ABI: x86_64-none-linux-gnu
+; FUNCTION-TYPE: complexlongdouble ()
+; 
+; Complex long double (ComplexX87) is returned in %st0 and %st1.
+
+declare { x86_fp80, x86_fp80 } @callee()
+
+define { x86_fp80, x86_fp80 } @caller() {
+  %1 = call { x86_fp80, x86_fp80 } @callee()
+  ret { x86_fp80, x86_fp80 } %1
+}
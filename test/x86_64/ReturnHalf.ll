@@ -0,0 +1,9 @@
+; ABI: x86_64-none-linux-gnu
+; FUNCTION-TYPE: half ()
+
+declare half @callee()
+
+define half @caller() {
+  %1 = call half @callee()
+  ret half %1
+}
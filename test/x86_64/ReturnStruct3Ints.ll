@@ -12,17 +12,30 @@ define { i64, i32 } @caller() {
   store { i64, i32 } %1, { i64, i32 }* %coerce.mem.store
   %2 = bitcast { i64, i32 }* %coerce.mem.store to i8*
   %3 = bitcast { i32, i32, i32 }* %coerce to i8*
-  call void @llvm.memcpy.p0i8.p0i8.i64(i8* %3, i8* %2, i64 12, i32 1, i1 false)
-  %4 = load { i32, i32, i32 }* %coerce, align 4
-  store { i32, i32, i32 } %4, { i32, i32, i32 }* %coerce1, align 4
-  %5 = bitcast { i64, i32 }* %coerce.mem.load to i8*
-  %6 = bitcast { i32, i32, i32 }* %coerce1 to i8*
-  call void @llvm.memcpy.p0i8.p0i8.i64(i8* %5, i8* %6, i64 12, i32 1, i1 false)
-  %7 = load { i64, i32 }* %coerce.mem.load
-  ret { i64, i32 } %7
+  %4 = bitcast i8* %2 to i64*
+  %5 = load i64* %4, align 1
+  %6 = bitcast i8* %3 to i64*
+  store i64 %5, i64* %6, align 1
+  %7 = getelementptr i8* %2, i32 8
+  %8 = bitcast i8* %7 to i32*
+  %9 = load i32* %8, align 1
+  %10 = getelementptr i8* %3, i32 8
+  %11 = bitcast i8* %10 to i32*
+  store i32 %9, i32* %11, align 1
+  %12 = load { i32, i32, i32 }* %coerce, align 4
+  store { i32, i32, i32 } %12, { i32, i32, i32 }* %coerce1, align 4
+  %13 = bitcast { i64, i32 }* %coerce.mem.load to i8*
+  %14 = bitcast { i32, i32, i32 }* %coerce1 to i8*
+  %15 = bitcast i8* %14 to i64*
+  %16 = load i64* %15, align 1
+  %17 = bitcast i8* %13 to i64*
+  store i64 %16, i64* %17, align 1
+  %18 = getelementptr i8* %14, i32 8
+  %19 = bitcast i8* %18 to i32*
+  %20 = load i32* %19, align 1
+  %21 = getelementptr i8* %13, i32 8
+  %22 = bitcast i8* %21 to i32*
+  store i32 %20, i32* %22, align 1
+  %23 = load { i64, i32 }* %coerce.mem.load
+  ret { i64, i32 } %23
 }
-
-; Function Attrs: nounwind
-declare void @llvm.memcpy.p0i8.p0i8.i64(i8* nocapture, i8* nocapture readonly, i64, i32, i1) #0
-
-attributes #0 = { nounwind }
@@ -1,11 +1,11 @@
 ; ABI: x86_64-none-linux-gnu
 ; FUNCTION-TYPE: {int, int, int, int, int} ()
 
-declare void @callee({ i32, i32, i32, i32, i32 }* noalias sret)
+declare void @callee({ i32, i32, i32, i32, i32 }* noalias nonnull sret align 4 dereferenceable(20))
 
-define void @caller({ i32, i32, i32, i32, i32 }* noalias sret %agg.result) {
+define void @caller({ i32, i32, i32, i32, i32 }* noalias nonnull sret align 4 dereferenceable(20) %agg.result) {
   %1 = alloca { i32, i32, i32, i32, i32 }, align 4
-  call void @callee({ i32, i32, i32, i32, i32 }* noalias sret %1)
+  call void @callee({ i32, i32, i32, i32, i32 }* noalias nonnull sret align 4 dereferenceable(20) %1)
   %2 = load { i32, i32, i32, i32, i32 }* %1
   store { i32, i32, i32, i32, i32 } %2, { i32, i32, i32, i32, i32 }* %agg.result
   ret void
@@ -1,11 +1,11 @@
 ; ABI: x86_64-none-linux-gnu
 ; FUNCTION-TYPE: union{longdouble, int} ()
 
-declare void @callee({ x86_fp80 }* noalias sret)
+declare void @callee({ x86_fp80 }* noalias nonnull sret align 16 dereferenceable(16))
 
-define void @caller({ x86_fp80 }* noalias sret %agg.result) {
+define void @caller({ x86_fp80 }* noalias nonnull sret align 16 dereferenceable(16) %agg.result) {
   %1 = alloca { x86_fp80 }, align 16
-  call void @callee({ x86_fp80 }* noalias sret %1)
+  call void @callee({ x86_fp80 }* noalias nonnull sret align 16 dereferenceable(16) %1)
   %2 = load { x86_fp80 }* %1
   store { x86_fp80 } %2, { x86_fp80 }* %agg.result
   ret void
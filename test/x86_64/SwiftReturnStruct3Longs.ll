@@ -0,0 +1,20 @@
+; ABI: x86_64-none-linux-gnu
+; FUNCTION-TYPE: swift {long, long, long} ()
+
+declare swiftcc { i64, i64, i64 } @callee()
+
+define swiftcc { i64, i64, i64 } @caller() {
+  %agg.tmp = alloca { i64, i64, i64 }, align 8
+  %1 = call swiftcc { i64, i64, i64 } @callee()
+  %2 = getelementptr { i64, i64, i64 }* %agg.tmp, i32 0, i32 0
+  %3 = extractvalue { i64, i64, i64 } %1, 0
+  store i64 %3, i64* %2
+  %4 = getelementptr { i64, i64, i64 }* %agg.tmp, i32 0, i32 1
+  %5 = extractvalue { i64, i64, i64 } %1, 1
+  store i64 %5, i64* %4
+  %6 = getelementptr { i64, i64, i64 }* %agg.tmp, i32 0, i32 2
+  %7 = extractvalue { i64, i64, i64 } %1, 2
+  store i64 %7, i64* %6
+  %8 = load { i64, i64, i64 }* %agg.tmp, align 8
+  ret { i64, i64, i64 } %8
+}
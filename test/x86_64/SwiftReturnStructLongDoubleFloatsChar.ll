@@ -0,0 +1,28 @@
+; ABI: x86_64-none-linux-gnu
+; FUNCTION-TYPE: swift {long, double, float, float, char} ()
+
+declare swiftcc { i64, double, <2 x float>, i8 } @callee()
+
+define swiftcc { i64, double, <2 x float>, i8 } @caller() {
+  %coerce1 = alloca { i64, double, float, float, i8 }, align 8
+  %coerce = alloca { i64, double, float, float, i8 }, align 8
+  %1 = call swiftcc { i64, double, <2 x float>, i8 } @callee()
+  %2 = bitcast { i64, double, float, float, i8 }* %coerce to { i64, double, <2 x float>, i8 }*
+  %3 = getelementptr { i64, double, <2 x float>, i8 }* %2, i32 0, i32 0
+  %4 = extractvalue { i64, double, <2 x float>, i8 } %1, 0
+  store i64 %4, i64* %3
+  %5 = getelementptr { i64, double, <2 x float>, i8 }* %2, i32 0, i32 1
+  %6 = extractvalue { i64, double, <2 x float>, i8 } %1, 1
+  store double %6, double* %5
+  %7 = getelementptr { i64, double, <2 x float>, i8 }* %2, i32 0, i32 2
+  %8 = extractvalue { i64, double, <2 x float>, i8 } %1, 2
+  store <2 x float> %8, <2 x float>* %7, align 1
+  %9 = getelementptr { i64, double, <2 x float>, i8 }* %2, i32 0, i32 3
+  %10 = extractvalue { i64, double, <2 x float>, i8 } %1, 3
+  store i8 %10, i8* %9, align 1
+  %11 = load { i64, double, float, float, i8 }* %coerce, align 8
+  store { i64, double, float, float, i8 } %11, { i64, double, float, float, i8 }* %coerce1, align 8
+  %12 = bitcast { i64, double, float, float, i8 }* %coerce1 to { i64, double, <2 x float>, i8 }*
+  %13 = load { i64, double, <2 x float>, i8 }* %12, align 1
+  ret { i64, double, <2 x float>, i8 } %13
+}
@@ -0,0 +1,24 @@
+; ABI: x86_64-none-linux-gnu
+; The baseline CPU doesn't have AVX, so only the functions with the
+; '+avx' target feature pass <8 x float> in YMM registers.
+; TARGET-FEATURES: +avx
+; FUNCTION-TYPE: <8 x float> (<8 x float>)
+
+declare <8 x float> @callee(<8 x float>* byval noalias nocapture nonnull align 32 dereferenceable(32))
+
+define <8 x float> @caller(<8 x float>* byval noalias nocapture nonnull align 32 dereferenceable(32)) {
+  %indirect.arg.mem = alloca <8 x float>, align 32
+  %2 = load <8 x float>* %0, align 32
+  store <8 x float> %2, <8 x float>* %indirect.arg.mem, align 32
+  %3 = call <8 x float> @callee(<8 x float>* byval noalias nocapture nonnull align 32 dereferenceable(32) %indirect.arg.mem)
+  ret <8 x float> %3
+}
+
+declare <8 x float> @callee.features(<8 x float>) #0
+
+define <8 x float> @caller.features(<8 x float>) #0 {
+  %2 = call <8 x float> @callee.features(<8 x float> %0)
+  ret <8 x float> %2
+}
+
+attributes #0 = { "target-features"="+avx" }
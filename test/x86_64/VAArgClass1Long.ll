@@ -0,0 +1,33 @@
+; ABI: x86_64-none-linux-gnu
+; ARGUMENTS: va_arg
+; Non-trivial classes are passed by reference, so va_arg reads the
+; pointer from the overflow area and then loads the value.
+; FUNCTION-TYPE: void (int, ...(class{ long }))
+
+declare void @callee(i32, { i64 }* nonnull align 8 dereferenceable(8))
+
+define void @caller(i32, ...) {
+  %indirect.arg.mem = alloca { i64 }, align 8
+  %va = alloca [1 x { i32, i32, i8*, i8* }]
+  %2 = bitcast [1 x { i32, i32, i8*, i8* }]* %va to i8*
+  call void @llvm.va_start(i8* %2)
+  %3 = bitcast [1 x { i32, i32, i8*, i8* }]* %va to { i32, i32, i8*, i8* }*
+  %overflow_arg_area_p = getelementptr inbounds { i32, i32, i8*, i8* }* %3, i32 0, i32 2
+  %overflow_arg_area = load i8** %overflow_arg_area_p
+  %4 = bitcast i8* %overflow_arg_area to i8**
+  %overflow_arg_area.next = getelementptr i8* %overflow_arg_area, i32 8
+  store i8* %overflow_arg_area.next, i8** %overflow_arg_area_p
+  %5 = load i8** %4
+  %6 = bitcast i8* %5 to { i64 }*
+  %7 = load { i64 }* %6, align 8
+  call void @llvm.va_end(i8* %2)
+  store { i64 } %7, { i64 }* %indirect.arg.mem, align 8
+  call void @callee(i32 %0, { i64 }* nonnull align 8 dereferenceable(8) %indirect.arg.mem)
+  ret void
+}
+
+declare void @llvm.va_start(i8*) #0
+
+declare void @llvm.va_end(i8*) #0
+
+attributes #0 = { nounwind }
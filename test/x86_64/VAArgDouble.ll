@@ -0,0 +1,46 @@
+; ABI: x86_64-none-linux-gnu
+; ARGUMENTS: va_arg
+; FUNCTION-TYPE: void (int, ...(double))
+
+declare void @callee(i32, double)
+
+define void @caller(i32, ...) {
+  %va = alloca [1 x { i32, i32, i8*, i8* }]
+  %2 = bitcast [1 x { i32, i32, i8*, i8* }]* %va to i8*
+  call void @llvm.va_start(i8* %2)
+  %3 = bitcast [1 x { i32, i32, i8*, i8* }]* %va to { i32, i32, i8*, i8* }*
+  %fp_offset_p = getelementptr inbounds { i32, i32, i8*, i8* }* %3, i32 0, i32 1
+  %fp_offset = load i32* %fp_offset_p
+  %fits_in_fp = icmp ule i32 %fp_offset, 160
+  br i1 %fits_in_fp, label %vaarg.in_reg, label %vaarg.in_mem
+
+vaarg.in_reg:                                     ; preds = %1
+  %reg_save_area_p = getelementptr inbounds { i32, i32, i8*, i8* }* %3, i32 0, i32 3
+  %reg_save_area = load i8** %reg_save_area_p
+  %4 = getelementptr i8* %reg_save_area, i32 %fp_offset
+  %5 = bitcast i8* %4 to double*
+  %6 = add i32 %fp_offset, 16
+  store i32 %6, i32* %fp_offset_p
+  br label %vaarg.end
+
+vaarg.in_mem:                                     ; preds = %1
+  %overflow_arg_area_p = getelementptr inbounds { i32, i32, i8*, i8* }* %3, i32 0, i32 2
+  %overflow_arg_area = load i8** %overflow_arg_area_p
+  %7 = bitcast i8* %overflow_arg_area to double*
+  %overflow_arg_area.next = getelementptr i8* %overflow_arg_area, i32 8
+  store i8* %overflow_arg_area.next, i8** %overflow_arg_area_p
+  br label %vaarg.end
+
+vaarg.end:                                        ; preds = %vaarg.in_mem, %vaarg.in_reg
+  %vaarg.addr = phi double* [ %5, %vaarg.in_reg ], [ %7, %vaarg.in_mem ]
+  %8 = load double* %vaarg.addr, align 8
+  call void @llvm.va_end(i8* %2)
+  call void @callee(i32 %0, double %8)
+  ret void
+}
+
+declare void @llvm.va_start(i8*) #0
+
+declare void @llvm.va_end(i8*) #0
+
+attributes #0 = { nounwind }
@@ -0,0 +1,46 @@
+; ABI: x86_64-none-linux-gnu
+; ARGUMENTS: va_arg
+; FUNCTION-TYPE: void (int, ...(long))
+
+declare void @callee(i32, i64)
+
+define void @caller(i32, ...) {
+  %va = alloca [1 x { i32, i32, i8*, i8* }]
+  %2 = bitcast [1 x { i32, i32, i8*, i8* }]* %va to i8*
+  call void @llvm.va_start(i8* %2)
+  %3 = bitcast [1 x { i32, i32, i8*, i8* }]* %va to { i32, i32, i8*, i8* }*
+  %gp_offset_p = getelementptr inbounds { i32, i32, i8*, i8* }* %3, i32 0, i32 0
+  %gp_offset = load i32* %gp_offset_p
+  %fits_in_gp = icmp ule i32 %gp_offset, 40
+  br i1 %fits_in_gp, label %vaarg.in_reg, label %vaarg.in_mem
+
+vaarg.in_reg:                                     ; preds = %1
+  %reg_save_area_p = getelementptr inbounds { i32, i32, i8*, i8* }* %3, i32 0, i32 3
+  %reg_save_area = load i8** %reg_save_area_p
+  %4 = getelementptr i8* %reg_save_area, i32 %gp_offset
+  %5 = bitcast i8* %4 to i64*
+  %6 = add i32 %gp_offset, 8
+  store i32 %6, i32* %gp_offset_p
+  br label %vaarg.end
+
+vaarg.in_mem:                                     ; preds = %1
+  %overflow_arg_area_p = getelementptr inbounds { i32, i32, i8*, i8* }* %3, i32 0, i32 2
+  %overflow_arg_area = load i8** %overflow_arg_area_p
+  %7 = bitcast i8* %overflow_arg_area to i64*
+  %overflow_arg_area.next = getelementptr i8* %overflow_arg_area, i32 8
+  store i8* %overflow_arg_area.next, i8** %overflow_arg_area_p
+  br label %vaarg.end
+
+vaarg.end:                                        ; preds = %vaarg.in_mem, %vaarg.in_reg
+  %vaarg.addr = phi i64* [ %5, %vaarg.in_reg ], [ %7, %vaarg.in_mem ]
+  %8 = load i64* %vaarg.addr, align 8
+  call void @llvm.va_end(i8* %2)
+  call void @callee(i32 %0, i64 %8)
+  ret void
+}
+
+declare void @llvm.va_start(i8*) #0
+
+declare void @llvm.va_end(i8*) #0
+
+attributes #0 = { nounwind }
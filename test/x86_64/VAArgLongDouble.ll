@@ -0,0 +1,32 @@
+; ABI: x86_64-none-linux-gnu
+; ARGUMENTS: va_arg
+; Long double is passed in memory, aligned to 16 bytes.
+; FUNCTION-TYPE: void (int, ...(longdouble))
+
+declare void @callee(i32, x86_fp80)
+
+define void @caller(i32, ...) {
+  %va = alloca [1 x { i32, i32, i8*, i8* }]
+  %2 = bitcast [1 x { i32, i32, i8*, i8* }]* %va to i8*
+  call void @llvm.va_start(i8* %2)
+  %3 = bitcast [1 x { i32, i32, i8*, i8* }]* %va to { i32, i32, i8*, i8* }*
+  %overflow_arg_area_p = getelementptr inbounds { i32, i32, i8*, i8* }* %3, i32 0, i32 2
+  %overflow_arg_area = load i8** %overflow_arg_area_p
+  %4 = ptrtoint i8* %overflow_arg_area to i64
+  %5 = add i64 %4, 15
+  %6 = and i64 %5, -16
+  %overflow_arg_area.align = inttoptr i64 %6 to i8*
+  %7 = bitcast i8* %overflow_arg_area.align to x86_fp80*
+  %overflow_arg_area.next = getelementptr i8* %overflow_arg_area.align, i32 16
+  store i8* %overflow_arg_area.next, i8** %overflow_arg_area_p
+  %8 = load x86_fp80* %7, align 16
+  call void @llvm.va_end(i8* %2)
+  call void @callee(i32 %0, x86_fp80 %8)
+  ret void
+}
+
+declare void @llvm.va_start(i8*) #0
+
+declare void @llvm.va_end(i8*) #0
+
+attributes #0 = { nounwind }
@@ -0,0 +1,69 @@
+; ABI: x86_64-none-linux-gnu
+; ARGUMENTS: va_arg
+; {long, double} is split between a general purpose register and an
+; SSE register, so va_arg copies it into a temporary.
+; FUNCTION-TYPE: void (int, ...({ long, double }))
+
+declare void @callee(i32, i64, double)
+
+define void @caller(i32, ...) {
+  %coerce.arg.source = alloca { i64, double }, align 8
+  %vaarg.tmp = alloca { i64, double }, align 8
+  %va = alloca [1 x { i32, i32, i8*, i8* }]
+  %2 = bitcast [1 x { i32, i32, i8*, i8* }]* %va to i8*
+  call void @llvm.va_start(i8* %2)
+  %3 = bitcast [1 x { i32, i32, i8*, i8* }]* %va to { i32, i32, i8*, i8* }*
+  %gp_offset_p = getelementptr inbounds { i32, i32, i8*, i8* }* %3, i32 0, i32 0
+  %gp_offset = load i32* %gp_offset_p
+  %fits_in_gp = icmp ule i32 %gp_offset, 40
+  %fp_offset_p = getelementptr inbounds { i32, i32, i8*, i8* }* %3, i32 0, i32 1
+  %fp_offset = load i32* %fp_offset_p
+  %fits_in_fp = icmp ule i32 %fp_offset, 160
+  %4 = and i1 %fits_in_gp, %fits_in_fp
+  br i1 %4, label %vaarg.in_reg, label %vaarg.in_mem
+
+vaarg.in_reg:                                     ; preds = %1
+  %reg_save_area_p = getelementptr inbounds { i32, i32, i8*, i8* }* %3, i32 0, i32 3
+  %reg_save_area = load i8** %reg_save_area_p
+  %5 = getelementptr i8* %reg_save_area, i32 %gp_offset
+  %6 = bitcast i8* %5 to i64*
+  %7 = load i64* %6, align 8
+  %8 = getelementptr inbounds { i64, double }* %vaarg.tmp, i32 0, i32 0
+  store i64 %7, i64* %8
+  %9 = getelementptr i8* %reg_save_area, i32 %fp_offset
+  %10 = bitcast i8* %9 to double*
+  %11 = load double* %10, align 8
+  %12 = getelementptr inbounds { i64, double }* %vaarg.tmp, i32 0, i32 1
+  store double %11, double* %12
+  %13 = add i32 %gp_offset, 8
+  store i32 %13, i32* %gp_offset_p
+  %14 = add i32 %fp_offset, 16
+  store i32 %14, i32* %fp_offset_p
+  br label %vaarg.end
+
+vaarg.in_mem:                                     ; preds = %1
+  %overflow_arg_area_p = getelementptr inbounds { i32, i32, i8*, i8* }* %3, i32 0, i32 2
+  %overflow_arg_area = load i8** %overflow_arg_area_p
+  %15 = bitcast i8* %overflow_arg_area to { i64, double }*
+  %overflow_arg_area.next = getelementptr i8* %overflow_arg_area, i32 16
+  store i8* %overflow_arg_area.next, i8** %overflow_arg_area_p
+  br label %vaarg.end
+
+vaarg.end:                                        ; preds = %vaarg.in_mem, %vaarg.in_reg
+  %vaarg.addr = phi { i64, double }* [ %vaarg.tmp, %vaarg.in_reg ], [ %15, %vaarg.in_mem ]
+  %16 = load { i64, double }* %vaarg.addr, align 8
+  call void @llvm.va_end(i8* %2)
+  store { i64, double } %16, { i64, double }* %coerce.arg.source
+  %17 = getelementptr { i64, double }* %coerce.arg.source, i32 0, i32 0
+  %18 = load i64* %17, align 1
+  %19 = getelementptr { i64, double }* %coerce.arg.source, i32 0, i32 1
+  %20 = load double* %19, align 1
+  call void @callee(i32 %0, i64 %18, double %20)
+  ret void
+}
+
+declare void @llvm.va_start(i8*) #0
+
+declare void @llvm.va_end(i8*) #0
+
+attributes #0 = { nounwind }
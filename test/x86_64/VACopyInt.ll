@@ -0,0 +1,63 @@
+; ABI: x86_64-none-linux-gnu
+; ARGUMENTS: va_copy
+; The va_list is copied inline, as a 24 byte structure.
+; FUNCTION-TYPE: void (int, ...(int))
+
+declare void @callee(i32, i32, i8*)
+
+define void @caller(i32, ...) {
+  %va.copy = alloca [1 x { i32, i32, i8*, i8* }]
+  %va = alloca [1 x { i32, i32, i8*, i8* }]
+  %2 = bitcast [1 x { i32, i32, i8*, i8* }]* %va to i8*
+  call void @llvm.va_start(i8* %2)
+  %3 = bitcast [1 x { i32, i32, i8*, i8* }]* %va.copy to i8*
+  %4 = bitcast [1 x { i32, i32, i8*, i8* }]* %va to i8*
+  %5 = bitcast i8* %4 to <2 x i64>*
+  %6 = load <2 x i64>* %5, align 8
+  %7 = bitcast i8* %3 to <2 x i64>*
+  store <2 x i64> %6, <2 x i64>* %7, align 8
+  %8 = getelementptr i8* %4, i32 16
+  %9 = bitcast i8* %8 to i64*
+  %10 = load i64* %9, align 8
+  %11 = getelementptr i8* %3, i32 16
+  %12 = bitcast i8* %11 to i64*
+  store i64 %10, i64* %12, align 8
+  %13 = bitcast [1 x { i32, i32, i8*, i8* }]* %va to { i32, i32, i8*, i8* }*
+  %gp_offset_p = getelementptr inbounds { i32, i32, i8*, i8* }* %13, i32 0, i32 0
+  %gp_offset = load i32* %gp_offset_p
+  %fits_in_gp = icmp ule i32 %gp_offset, 40
+  br i1 %fits_in_gp, label %vaarg.in_reg, label %vaarg.in_mem
+
+vaarg.in_reg:                                     ; preds = %1
+  %reg_save_area_p = getelementptr inbounds { i32, i32, i8*, i8* }* %13, i32 0, i32 3
+  %reg_save_area = load i8** %reg_save_area_p
+  %14 = getelementptr i8* %reg_save_area, i32 %gp_offset
+  %15 = bitcast i8* %14 to i32*
+  %16 = add i32 %gp_offset, 8
+  store i32 %16, i32* %gp_offset_p
+  br label %vaarg.end
+
+vaarg.in_mem:                                     ; preds = %1
+  %overflow_arg_area_p = getelementptr inbounds { i32, i32, i8*, i8* }* %13, i32 0, i32 2
+  %overflow_arg_area = load i8** %overflow_arg_area_p
+  %17 = bitcast i8* %overflow_arg_area to i32*
+  %overflow_arg_area.next = getelementptr i8* %overflow_arg_area, i32 8
+  store i8* %overflow_arg_area.next, i8** %overflow_arg_area_p
+  br label %vaarg.end
+
+vaarg.end:                                        ; preds = %vaarg.in_mem, %vaarg.in_reg
+  %vaarg.addr = phi i32* [ %15, %vaarg.in_reg ], [ %17, %vaarg.in_mem ]
+  %18 = load i32* %vaarg.addr, align 4
+  %19 = bitcast [1 x { i32, i32, i8*, i8* }]* %va.copy to i8*
+  %20 = bitcast [1 x { i32, i32, i8*, i8* }]* %va.copy to i8*
+  call void @callee(i32 %0, i32 %18, i8* %19)
+  call void @llvm.va_end(i8* %20)
+  call void @llvm.va_end(i8* %2)
+  ret void
+}
+
+declare void @llvm.va_start(i8*) #0
+
+declare void @llvm.va_end(i8*) #0
+
+attributes #0 = { nounwind }
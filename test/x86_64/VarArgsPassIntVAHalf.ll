@@ -0,0 +1,10 @@
+; ABI: x86_64-none-linux-gnu
+; FUNCTION-TYPE: void (int, ...(half))
+
+declare void @callee(i32, ...)
+
+define void @caller(i32, half) {
+  %3 = fpext half %1 to double
+  call void (i32, ...)* @callee(i32 %0, double %3)
+  ret void
+}